@@ -0,0 +1,76 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+
+//******************************************************************************
+//
+// File:     Benchmark.h
+//
+// Summary:  Registration and timing helpers for the benchmarks. Inputs are
+//           generated from fixed seeds so runs can be compared across changes
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#ifndef FLIGHTSIMLIB_BENCHMARKS_BENCHMARK_H
+#define FLIGHTSIMLIB_BENCHMARKS_BENCHMARK_H
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+// A benchmark is a function registered under its name at static initialization, and run by
+// BenchmarkMain.cpp when its name contains the filter given on the command line
+#define FSL_BENCHMARK(name)                                                                                            \
+    static void name();                                                                                                \
+    static const bool name##_registered = ::flightsimlib::benchmarks::RegisterBenchmark(#name, name);                  \
+    static void name()
+
+namespace flightsimlib::benchmarks
+{
+
+    using BenchmarkFunction = void (*)();
+
+    // Seed of every generated input
+    static constexpr uint64_t s_seed = 20240601;
+
+    auto RegisterBenchmark(const char* name, BenchmarkFunction function) -> bool;
+
+    // Runs fn once to warm up and then a fixed number of times, and prints the median time of a
+    // run divided by items. fn returns a value derived from its work so it cannot be optimized away
+    auto Measure(const std::string& label, int64_t items, const std::function<uint64_t()>& fn) -> void;
+
+    // A path for a file the benchmark writes, in a scratch directory emptied before the run
+    auto GetScratchPath(const std::string& name) -> std::filesystem::path;
+
+} // namespace flightsimlib::benchmarks
+
+#endif
@@ -0,0 +1,125 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     BenchmarkMain.cpp
+//
+// Summary:  Runs the registered benchmarks. Usage: benchmarks [filter], where
+//           only benchmarks whose name contains the filter are run. Build in
+//           Release, timings of a Debug build say little
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <system_error>
+#include <vector>
+
+
+namespace flightsimlib::benchmarks
+{
+
+struct SBenchmark
+{
+    const char* Name;
+    BenchmarkFunction Function;
+};
+
+static auto GetBenchmarks() -> std::vector<SBenchmark>&
+{
+    static auto benchmarks = std::vector<SBenchmark>{};
+    return benchmarks;
+}
+
+static constexpr int s_repetitions = 7;
+static auto s_scratch_directory = std::filesystem::path{};
+static volatile uint64_t s_sink = 0;
+
+auto RegisterBenchmark(const char* name, BenchmarkFunction function) -> bool
+{
+    GetBenchmarks().push_back({name, function});
+    return true;
+}
+
+auto Measure(const std::string& label, int64_t items, const std::function<uint64_t()>& fn) -> void
+{
+    s_sink = s_sink + fn();
+
+    auto durations = std::vector<double>{};
+    for (auto i = 0; i < s_repetitions; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        s_sink = s_sink + fn();
+        const auto end = std::chrono::steady_clock::now();
+        durations.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    std::sort(durations.begin(), durations.end());
+
+    const auto median = durations[durations.size() / 2];
+    std::cout << "    " << std::left << std::setw(48) << label << std::right << std::fixed << std::setprecision(2)
+              << std::setw(14) << median / static_cast<double>(std::max<int64_t>(items, 1)) << " ns/item"
+              << std::setw(12) << median / 1.0e6 << " ms\n";
+}
+
+auto GetScratchPath(const std::string& name) -> std::filesystem::path { return s_scratch_directory / name; }
+
+} // namespace flightsimlib::benchmarks
+
+
+int main(int argc, char* argv[])
+{
+    using namespace flightsimlib::benchmarks;
+
+    const auto filter = std::string{argc > 1 ? argv[1] : ""};
+
+    s_scratch_directory = std::filesystem::temp_directory_path() / "flightsimlib_benchmarks";
+    std::error_code error;
+    std::filesystem::remove_all(s_scratch_directory, error);
+    std::filesystem::create_directories(s_scratch_directory, error);
+
+    for (const auto& benchmark : GetBenchmarks())
+    {
+        if (std::string(benchmark.Name).find(filter) == std::string::npos)
+        {
+            continue;
+        }
+        std::cout << benchmark.Name << "\n";
+        benchmark.Function();
+    }
+
+    std::filesystem::remove_all(s_scratch_directory, error);
+    return 0;
+}
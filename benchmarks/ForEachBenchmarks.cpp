@@ -0,0 +1,148 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     ForEachBenchmarks.cpp
+//
+// Summary:  Visiting every record of a worldwide navdata file with the typed
+//           CBglFile::ForEach, and by probing each record with the As*()
+//           accessors
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Benchmark.h"
+
+#include "BglData.h"
+#include "BglFile.h"
+
+#include <random>
+
+
+namespace flightsimlib::benchmarks
+{
+
+using namespace flightsimlib::io;
+
+FSL_BENCHMARK(VisitNavdataRecords)
+{
+    static constexpr int s_records_per_layer = 25000;
+    // NDBs are left out, as a default NDB has a name record whose size field does not read back
+    static constexpr EBglLayerType s_layer_types[] = {
+        EBglLayerType::Nav, EBglLayerType::Marker, EBglLayerType::Waypoint};
+
+    auto random = std::mt19937_64(s_seed);
+    auto latitude = std::uniform_real_distribution<double>(-85.0, 85.0);
+    auto longitude = std::uniform_real_distribution<double>(-180.0, 180.0);
+
+    const auto path = GetScratchPath("navdata.bgl");
+    {
+        auto file = CBglFile{};
+        for (const auto type : s_layer_types)
+        {
+            auto layer = CBglIndirectQmidLayer(SBglLayerPointer{type, 0, 0, 0, 0, 0}, type);
+            auto records = BglQmidRecords{};
+            for (auto i = 0; i < s_records_per_layer; ++i)
+            {
+                auto data = CBglData::Factory(type, IBglSceneryObject::ESceneryObjectType::Unknown);
+                const auto lat = latitude(random);
+                const auto lon = longitude(random);
+                if (auto* nav = data->AsNav())
+                {
+                    nav->SetLatitude(lat);
+                    nav->SetLongitude(lon);
+                }
+                else if (auto* marker = data->AsMarker())
+                {
+                    marker->SetLatitude(lat);
+                    marker->SetLongitude(lon);
+                }
+                else if (auto* waypoint = data->AsWaypoint())
+                {
+                    waypoint->SetLatitude(lat);
+                    waypoint->SetLongitude(lon);
+                }
+                records.emplace_back(CPackedQmid::FromLatLon(lat, lon, 9), std::move(data));
+            }
+            layer.AddDataAtQmids(std::move(records));
+            file.TryMergeLayer(&layer);
+        }
+        file.Rename(path.wstring().c_str());
+        file.Write();
+    }
+
+    auto file = CBglFile(path.wstring());
+    file.Read();
+    const auto record_count = static_cast<int64_t>(s_records_per_layer) * std::size(s_layer_types);
+
+    Measure("GetDataAtIndex and As*() probing", record_count,
+        [&file]
+        {
+            auto sum = 0.0;
+            for (auto i = 0; i < file.GetLayerCount(); ++i)
+            {
+                auto* layer = file.GetLayerAt(i)->AsIndirectQmidLayer();
+                if (layer == nullptr)
+                {
+                    continue;
+                }
+                for (auto j = 0; j < layer->GetDataCount(); ++j)
+                {
+                    auto* data = layer->GetDataAtIndex(j);
+                    if (const auto* nav = data->AsNav())
+                    {
+                        sum += nav->GetLatitude();
+                    }
+                    else if (const auto* marker = data->AsMarker())
+                    {
+                        sum += marker->GetLatitude();
+                    }
+                    else if (const auto* waypoint = data->AsWaypoint())
+                    {
+                        sum += waypoint->GetLatitude();
+                    }
+                }
+            }
+            return static_cast<uint64_t>(sum);
+        });
+
+    Measure("ForEach", record_count,
+        [&file]
+        {
+            auto sum = 0.0;
+            file.ForEach<CBglNav>([&sum](const CBglNav& nav) { sum += nav.GetLatitude(); });
+            file.ForEach<CBglMarker>([&sum](const CBglMarker& marker) { sum += marker.GetLatitude(); });
+            file.ForEach<CBglWaypoint>([&sum](const CBglWaypoint& waypoint) { sum += waypoint.GetLatitude(); });
+            return static_cast<uint64_t>(sum);
+        });
+}
+
+} // namespace flightsimlib::benchmarks
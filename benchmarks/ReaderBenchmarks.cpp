@@ -0,0 +1,147 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     ReaderBenchmarks.cpp
+//
+// Summary:  CBinaryReader against the iostream path it replaced, for scalar
+//           loads from memory and for reading a large airport summary file.
+//           Vector tiles are always parsed from a BinaryMemoryStream, which
+//           has no iostream path left to compare against, so the scalar
+//           benchmark stands in for them
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Benchmark.h"
+
+#include "BglFile.h"
+#include "BinaryStream.h"
+
+#include <random>
+
+
+namespace flightsimlib::benchmarks
+{
+
+using namespace flightsimlib::io;
+
+FSL_BENCHMARK(ReadScalarsFromMemory)
+{
+    static constexpr int s_value_count = 4 * 1024 * 1024;
+
+    auto random = std::mt19937_64(s_seed);
+    auto values = std::vector<uint32_t>(s_value_count);
+    for (auto& value : values)
+    {
+        value = static_cast<uint32_t>(random());
+    }
+    const auto* data = reinterpret_cast<const uint8_t*>(values.data());
+    const auto length = static_cast<int>(values.size() * sizeof(uint32_t));
+
+    Measure("std::istream over CByteArrayStreambuf", s_value_count,
+        [&]
+        {
+            auto buffer = CByteArrayStreambuf(data, static_cast<size_t>(length));
+            auto stream = std::istream(&buffer);
+            auto sum = uint64_t{};
+            auto value = uint32_t{};
+            while (stream.read(reinterpret_cast<char*>(&value), sizeof(value)))
+            {
+                sum += value;
+            }
+            return sum;
+        });
+
+    Measure("CBinaryReader", s_value_count,
+        [&]
+        {
+            auto reader = CBinaryReader(data, length);
+            auto sum = uint64_t{};
+            auto value = uint32_t{};
+            while (reader.Read(value))
+            {
+                sum += value;
+            }
+            return sum;
+        });
+}
+
+FSL_BENCHMARK(ReadAirportSummaryFile)
+{
+    static constexpr int s_record_count = 100000;
+
+    auto random = std::mt19937_64(s_seed);
+    auto latitude = std::uniform_real_distribution<double>(-85.0, 85.0);
+    auto longitude = std::uniform_real_distribution<double>(-180.0, 180.0);
+
+    auto layer = CBglIndirectQmidLayer(
+        SBglLayerPointer{EBglLayerType::AirportSummary, 0, 0, 0, 0, 0}, EBglLayerType::AirportSummary);
+    auto records = BglQmidRecords{};
+    for (auto i = 0; i < s_record_count; ++i)
+    {
+        auto data = CBglData::Factory(EBglLayerType::AirportSummary, IBglSceneryObject::ESceneryObjectType::Unknown);
+        auto* summary = data->AsAirportSummary();
+        summary->SetLatitude(latitude(random));
+        summary->SetLongitude(longitude(random));
+        summary->SetIcaoIdent(static_cast<uint32_t>(random()));
+        const auto qmid = CPackedQmid::FromLatLon(summary->GetLatitude(), summary->GetLongitude(), 9);
+        records.emplace_back(qmid, std::move(data));
+    }
+    layer.AddDataAtQmids(std::move(records));
+
+    const auto path = GetScratchPath("airport_summaries.bgl");
+    {
+        auto file = CBglFile{};
+        file.TryMergeLayer(&layer);
+        file.Rename(path.wstring().c_str());
+        file.Write();
+    }
+
+    const auto read = [&](EBglReadFlags flags)
+    {
+        return [&path, flags]
+        {
+            auto file = CBglFile(path.wstring());
+            file.SetReadFlags(flags);
+            file.Read();
+            auto sum = uint64_t{};
+            file.ForEach<CBglAirportSummary>([&sum](const CBglAirportSummary& summary)
+                { sum += summary.GetIcaoIdent(); });
+            return sum;
+        };
+    };
+
+    Measure("fstream", s_record_count, read(EBglReadFlags::None));
+    Measure("memory mapped, CBinaryReader", s_record_count, read(EBglReadFlags::MemoryMapped));
+}
+
+} // namespace flightsimlib::benchmarks
@@ -0,0 +1,139 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     TileStoreBenchmarks.cpp
+//
+// Summary:  Random QMID probes of a large CBglDirectQmidLayer against the map
+//           of record vectors the layer used to store its tiles in
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Benchmark.h"
+
+#include "BglData.h"
+#include "BglFile.h"
+
+#include <map>
+#include <random>
+
+
+namespace flightsimlib::benchmarks
+{
+
+using namespace flightsimlib::io;
+
+FSL_BENCHMARK(ProbeDirectLayerTiles)
+{
+    static constexpr int s_level = 12;
+    static constexpr int s_tile_count = 200000;
+    static constexpr int s_probe_count = 1000000;
+
+    auto random = std::mt19937_64(s_seed);
+    auto column = std::uniform_int_distribution<uint32_t>(0, CPackedQmid::ColumnCount(s_level) - 1);
+    auto row = std::uniform_int_distribution<uint32_t>(0, CPackedQmid::RowCount(s_level) - 1);
+    const auto make_record = []
+    { return CBglData::Factory(EBglLayerType::TerrainElevation, IBglSceneryObject::ESceneryObjectType::Unknown); };
+
+    auto layer = CBglDirectQmidLayer(
+        SBglLayerPointer{EBglLayerType::TerrainElevation, 0, 0, 0, 0, 0}, EBglLayerType::TerrainElevation);
+    auto map = std::map<CPackedQmid, std::vector<std::unique_ptr<CBglData>>>{};
+    auto records = BglQmidRecords{};
+    auto qmids = std::vector<CPackedQmid>{};
+    while (static_cast<int>(map.size()) < s_tile_count)
+    {
+        const auto qmid = CPackedQmid::FromCell(s_level, column(random), row(random));
+        auto& tile = map[qmid];
+        if (tile.empty())
+        {
+            qmids.push_back(qmid);
+            records.emplace_back(qmid, make_record());
+        }
+        tile.emplace_back(make_record());
+    }
+    layer.AddDataAtQmids(std::move(records));
+
+    // About half of the probes hit a tile
+    auto probes = std::vector<CPackedQmid>{};
+    auto pick = std::uniform_int_distribution<size_t>(0, qmids.size() - 1);
+    for (auto i = 0; i < s_probe_count; ++i)
+    {
+        probes.push_back(i % 2 == 0 ? qmids[pick(random)] : CPackedQmid::FromCell(s_level, column(random), row(random)));
+    }
+
+    Measure("HasQmid, std::map", s_probe_count,
+        [&]
+        {
+            auto hits = uint64_t{};
+            for (const auto& qmid : probes)
+            {
+                hits += map.find(qmid) != map.end();
+            }
+            return hits;
+        });
+
+    Measure("HasQmid, CBglDirectQmidLayer", s_probe_count,
+        [&]
+        {
+            auto hits = uint64_t{};
+            for (const auto& qmid : probes)
+            {
+                hits += layer.HasQmid(qmid);
+            }
+            return hits;
+        });
+
+    Measure("GetDataCountAtQmid, std::map", s_probe_count,
+        [&]
+        {
+            auto count = uint64_t{};
+            for (const auto& qmid : probes)
+            {
+                const auto it = map.find(qmid);
+                count += it != map.end() ? it->second.size() : 0;
+            }
+            return count;
+        });
+
+    Measure("GetDataCountAtQmid, CBglDirectQmidLayer", s_probe_count,
+        [&]
+        {
+            auto count = uint64_t{};
+            for (const auto& qmid : probes)
+            {
+                count += layer.GetDataCountAtQmid(qmid);
+            }
+            return count;
+        });
+}
+
+} // namespace flightsimlib::benchmarks
@@ -0,0 +1,134 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+#ifndef FLIGHTSIMLIB_IO_BGLAIRPORTTABLE_H
+#define FLIGHTSIMLIB_IO_BGLAIRPORTTABLE_H
+
+#include "BglFile.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <vector>
+
+namespace flightsimlib::io
+{
+
+    // Conditions an airport has to meet to be returned. The defaults match every airport
+    struct SBglAirportFilter
+    {
+        float MinRunwayLength = 0.0f; // Longest runway, in metres
+        uint32_t RequiredFlags = 0;   // CBglAirportTable::s_flag_ bits that must all be set
+        uint32_t ExcludedFlags = 0;   // CBglAirportTable::s_flag_ bits that must all be clear
+        uint32_t FuelMask = 0;        // Fuel availability bits to compare with FuelValue
+        uint32_t FuelValue = 0;
+        double MaxDistance = std::numeric_limits<double>::infinity(); // Great circle, in metres
+    };
+
+    struct SBglAirportMatch
+    {
+        int Row = -1;
+        double Distance = 0.0; // Great circle, in metres
+    };
+
+    // Airport summaries held column by column, for nearest airport searches that run often
+    // and over every airport. Each search is a single pass over the columns: the filter is
+    // tested on the runway, flag and fuel columns first, and the distance is only worked out
+    // for the rows that pass. Built once and then only read, so any number of threads may
+    // search it
+    class FLIGHTSIMLIB_EXPORTED CBglAirportTable
+    {
+      public:
+        // Flag bits, as in the approach availability field of the summary record
+        static constexpr uint32_t s_flag_com = 1u << 0;
+        static constexpr uint32_t s_flag_paved_runway = 1u << 1;
+        static constexpr uint32_t s_flag_only_water_runway = 1u << 2;
+        static constexpr uint32_t s_flag_gps_approach = 1u << 5;
+        static constexpr uint32_t s_flag_vor_approach = 1u << 6;
+        static constexpr uint32_t s_flag_ndb_approach = 1u << 7;
+        static constexpr uint32_t s_flag_ils_approach = 1u << 8;
+        static constexpr uint32_t s_flag_loc_approach = 1u << 9;
+        static constexpr uint32_t s_flag_sdf_approach = 1u << 10;
+        static constexpr uint32_t s_flag_lda_approach = 1u << 11;
+        static constexpr uint32_t s_flag_vor_dme_approach = 1u << 12;
+        static constexpr uint32_t s_flag_ndb_dme_approach = 1u << 13;
+        static constexpr uint32_t s_flag_rnav_approach = 1u << 14;
+        static constexpr uint32_t s_flag_loc_bc_approach = 1u << 15;
+
+        // Fuel bits, as in the fuel availability field of the summary record. Each grade
+        // takes two bits holding an EFuelAvailability, and the top two bits summarize them
+        static constexpr uint32_t s_fuel_avgas = 1u << 30;
+        static constexpr uint32_t s_fuel_jet_fuel = 1u << 31;
+
+        // Replaces the contents with the airport summaries of one file, as file 0
+        auto Build(CBglFile& file) -> void;
+        // Replaces the contents with the airport summaries of the files, read on a pool of
+        // threads. Zero threads picks one per hardware thread. Files that cannot be read are
+        // left out, and make the result false
+        auto Build(const std::vector<std::filesystem::path>& files, int num_threads = 0) -> bool;
+
+        [[nodiscard]] auto GetCount() const -> int { return m_count; }
+        [[nodiscard]] auto GetLatitude(int row) const -> double { return m_latitude[row]; }
+        [[nodiscard]] auto GetLongitude(int row) const -> double { return m_longitude[row]; }
+        [[nodiscard]] auto GetLongestRunwayLength(int row) const -> float { return m_runway_length[row]; }
+        [[nodiscard]] auto GetFlags(int row) const -> uint32_t { return m_flags[row]; }
+        [[nodiscard]] auto GetFuelAvailability(int row) const -> uint32_t { return m_fuel[row]; }
+        [[nodiscard]] auto GetIcaoIdent(int row) const -> uint32_t { return m_icao[row]; }
+        [[nodiscard]] auto GetRegionIdent(int row) const -> uint32_t { return m_region[row]; }
+        [[nodiscard]] auto GetFileIndex(int row) const -> int { return m_file_index[row]; }
+
+        // The count airports passing the filter nearest to the point, nearest first
+        auto FindNearest(double latitude, double longitude, int count, const SBglAirportFilter& filter,
+            std::vector<SBglAirportMatch>& matches) const -> void;
+
+      private:
+        // Rows are tested in blocks of this many, and the columns are padded to a whole block
+        // with rows that never pass
+        static constexpr int s_block_size = 8;
+
+        struct SRow;
+
+        static auto CollectFile(CBglFile& file, int file_index, std::vector<SRow>& rows) -> void;
+        auto BuildColumns(const std::vector<std::vector<SRow>>& file_rows) -> void;
+
+        int m_count = 0;
+        std::vector<double> m_latitude;
+        std::vector<double> m_longitude;
+        // Unit vectors of the positions, for the distance
+        std::vector<double> m_x;
+        std::vector<double> m_y;
+        std::vector<double> m_z;
+        std::vector<float> m_runway_length;
+        std::vector<uint32_t> m_flags;
+        std::vector<uint32_t> m_fuel;
+        std::vector<uint32_t> m_icao;
+        std::vector<uint32_t> m_region;
+        std::vector<int> m_file_index;
+    };
+
+} // namespace flightsimlib::io
+
+#endif
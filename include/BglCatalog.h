@@ -0,0 +1,173 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+#ifndef FLIGHTSIMLIB_IO_BGLCATALOG_H
+#define FLIGHTSIMLIB_IO_BGLCATALOG_H
+
+#include "BglFile.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace flightsimlib::io
+{
+
+    // Bloom filter over 64-bit keys, sized once for the number of keys it will hold.
+    // May report a key that was never inserted, but never misses one that was
+    class CBglBloomFilter
+    {
+      public:
+        static constexpr int s_bits_per_key = 10;
+        static constexpr int s_hash_count = 7;
+
+        CBglBloomFilter() = default;
+        explicit CBglBloomFilter(int expected_count);
+
+        auto Insert(uint64_t key) -> void;
+        // An empty filter holds nothing
+        [[nodiscard]] auto MayContain(uint64_t key) const -> bool;
+
+        [[nodiscard]] auto GetWords() const -> const std::vector<uint64_t>& { return m_words; }
+        auto SetWords(std::vector<uint64_t> words) -> void { m_words = std::move(words); }
+
+      private:
+        std::vector<uint64_t> m_words;
+    };
+
+    // Where to find a tile or record without opening anything else: the catalogued file,
+    // the layer holding it, and the extent to read from the file
+    struct SBglCatalogLocation
+    {
+        int FileIndex = -1;
+        EBglLayerType LayerType = EBglLayerType::None;
+        uint32_t StreamOffset = 0;
+        uint32_t SizeBytes = 0;
+    };
+
+    struct SBglCatalogTile
+    {
+        uint64_t Qmid = 0;
+        uint32_t StreamOffset = 0;
+        uint32_t SizeBytes = 0;
+    };
+
+    struct SBglCatalogLayer
+    {
+        EBglLayerType Type = EBglLayerType::None;
+        // Sorted by QMID. Empty for layers that are not indexed by QMID
+        std::vector<SBglCatalogTile> Tiles;
+    };
+
+    struct SBglCatalogAirport
+    {
+        uint32_t Icao = 0; // Packed as in IBglAirport::GetIcaoIdent
+        EBglLayerType LayerType = EBglLayerType::None;
+        uint32_t StreamOffset = 0;
+        uint32_t SizeBytes = 0;
+    };
+
+    struct SBglCatalogModel
+    {
+        _GUID Guid{};
+        EBglLayerType LayerType = EBglLayerType::None;
+        uint32_t StreamOffset = 0;
+        uint32_t SizeBytes = 0;
+    };
+
+    // Everything the catalog knows about one BGL. Files that could not be read are kept
+    // with IsValid unset, so they are not read again until they change
+    struct SBglCatalogFile
+    {
+        std::filesystem::path Path; // Relative to the catalog root
+        int64_t ModifiedTime = 0;
+        uint64_t FileSize = 0;
+        bool IsValid = false;
+        SBglHeader Header{};
+        std::vector<SBglCatalogLayer> Layers;
+        std::vector<SBglCatalogAirport> Airports;
+        std::vector<SBglCatalogModel> Models;
+        // Every tile QMID of the file, checked before the layers are searched
+        CBglBloomFilter QmidFilter;
+    };
+
+    // Index of the BGL files below a scenery directory, persisted so that startup only has
+    // to read the files that were added or changed since the catalog was saved. Lookups by
+    // QMID, airport ICAO or model GUID return the file, layer and extent to read directly
+    class FLIGHTSIMLIB_EXPORTED CBglCatalog
+    {
+      public:
+        static constexpr uint32_t s_magic = 0x434C4742; // "BGLC"
+        static constexpr uint32_t s_version = 1;
+
+        explicit CBglCatalog(std::filesystem::path root);
+
+        // Replaces the contents with a catalog written by Save. Returns false and leaves the
+        // catalog empty if the file is missing, truncated or from another version
+        auto Load(const std::filesystem::path& catalog_file) -> bool;
+        auto Save(const std::filesystem::path& catalog_file) const -> bool;
+
+        // Walks the root for BGL files. Files whose size and modification time match the
+        // catalog are kept as they are, others are read with EBglReadFlags::IndexOnly, and
+        // files that are gone are dropped. Returns false if the root cannot be walked
+        auto Update() -> bool;
+
+        // Files read by the last Update, as opposed to those revalidated from the catalog
+        [[nodiscard]] auto GetIndexedCount() const -> int { return m_indexed_count; }
+
+        [[nodiscard]] auto GetRoot() const -> const std::filesystem::path& { return m_root; }
+        [[nodiscard]] auto GetFileCount() const -> int { return static_cast<int>(m_files.size()); }
+        [[nodiscard]] auto GetFileAt(int index) const -> const SBglCatalogFile& { return m_files[index]; }
+        [[nodiscard]] auto GetFilePath(int index) const -> std::filesystem::path
+        {
+            return m_root / m_files[index].Path;
+        }
+
+        // Each lookup appends the matches, in file order, and returns how many it found
+        auto FindQmid(CPackedQmid qmid, std::vector<SBglCatalogLocation>& locations) const -> int;
+        auto FindIcao(uint32_t icao, std::vector<SBglCatalogLocation>& locations) const -> int;
+        auto FindGuid(const _GUID& guid, std::vector<SBglCatalogLocation>& locations) const -> int;
+
+      private:
+        static auto IndexFile(const std::filesystem::path& file_name, SBglCatalogFile& entry) -> bool;
+        static auto ReadEntry(BinaryFileStream& in, SBglCatalogFile& entry) -> bool;
+        static auto WriteEntry(BinaryFileStream& out, const SBglCatalogFile& entry) -> void;
+        auto BuildLookups() -> void;
+
+        std::filesystem::path m_root;
+        // Sorted by path
+        std::vector<SBglCatalogFile> m_files;
+        // Sorted by key, rebuilt whenever the files change
+        std::vector<std::pair<uint32_t, SBglCatalogLocation>> m_icao_lookup;
+        std::vector<std::pair<_GUID, SBglCatalogLocation>> m_guid_lookup;
+        int m_indexed_count = 0;
+    };
+
+} // namespace flightsimlib::io
+
+#endif
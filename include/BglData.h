@@ -28,11 +28,17 @@
 #define FLIGHTSIMLIB_IO_BGLDATA_H
 
 #include "BglTypes.h"
-#include "../external/stlab/copy_on_write.hpp"
+#include "CopyOnWrite.h"
+#include "RecordArena.h"
+#include "StringPool.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <list>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
@@ -56,6 +62,10 @@ class CBglSceneryObject;
 class IBglSerializable
 {
 public:
+    // Records made while a file is read are placed in its CRecordArena
+    static auto operator new(std::size_t size) -> void* { return CRecordArena::AllocateRecord(size); }
+    static auto operator delete(void* pointer) -> void { CRecordArena::FreeRecord(pointer); }
+
     virtual ~IBglSerializable() = default; // TODO necessary?
     virtual auto ReadBinary(BinaryFileStream& in) -> void = 0;
     virtual auto WriteBinary(BinaryFileStream& out) -> void = 0;
@@ -139,11 +149,11 @@ public:
 // CBglFuelAvailability
 //******************************************************************************
 
-template <typename T> class CBglFuelAvailability : virtual public IBglFuelAvailability
+// Fuel accessors over the FuelAvailability field of a record's m_data. The record is reached
+// from this, so copied and moved records read their own data
+template <typename TRecord> class CBglFuelAvailability : virtual public IBglFuelAvailability
 {
 public:
-    explicit CBglFuelAvailability(T& data);
-
     auto Get73Octane() const -> EFuelAvailability override;
     auto Set73Octane(EFuelAvailability value) -> void override;
     auto Get87Octane() const -> EFuelAvailability override;
@@ -200,7 +210,8 @@ private:
 
     static constexpr int s_num_availability_bits = 2;
 
-    T& m_data;
+    auto GetData() const -> const auto& { return static_cast<const TRecord*>(this)->m_data; }
+    auto GetData() -> auto& { return static_cast<TRecord*>(this)->m_data; }
 };
 
 //******************************************************************************
@@ -214,7 +225,6 @@ struct SBglNameData
 {
     uint16_t Type;
     uint32_t Size;
-    std::string Name;
 };
 
 #pragma pack(pop)
@@ -235,18 +245,19 @@ public:
 private:
     auto CalculateRemainingSize() const -> int;
 
-    stlab::copy_on_write<SBglNameData> m_data;
+    CCopyOnWrite<SBglNameData> m_data;
+    CPooledString m_name;
 };
 
 //******************************************************************************
 // CBglLla
 //******************************************************************************
 
-template <typename T> class CBglLLA : virtual public IBglLLA
+// Position accessors over the packed Longitude, Latitude and Altitude fields of a record's
+// m_data, reached from this as in CBglFuelAvailability
+template <typename TRecord> class CBglLLA : virtual public IBglLLA
 {
 public:
-    explicit CBglLLA(T& data);
-
     auto GetLongitude() const -> double override;
     auto SetLongitude(double value) -> void override;
     auto GetLatitude() const -> double override;
@@ -255,7 +266,8 @@ public:
     auto SetAltitude(double value) -> void override;
 
 private:
-    std::reference_wrapper<T> m_data;
+    auto GetData() const -> const auto& { return static_cast<const TRecord*>(this)->m_data; }
+    auto GetData() -> auto& { return static_cast<TRecord*>(this)->m_data; }
 };
 
 //******************************************************************************
@@ -282,11 +294,9 @@ struct SBglNdbData
 
 #pragma pack(pop)
 
-class CBglNdb final : public CBglLLA<stlab::copy_on_write<SBglNdbData>>, public CBglName, public IBglNdb
+class CBglNdb final : public CBglLLA<CBglNdb>, public CBglName, public IBglNdb
 {
 public:
-    CBglNdb() : CBglLLA<stlab::copy_on_write<SBglNdbData>>(m_data) { }
-
     auto ReadBinary(BinaryFileStream& in) -> void override;
     auto WriteBinary(BinaryFileStream& out) -> void override;
     auto Validate() -> bool override;
@@ -306,7 +316,9 @@ public:
     auto SetRegion(uint32_t value) -> void override;
 
 private:
-    stlab::copy_on_write<SBglNdbData> m_data;
+    friend class CBglLLA<CBglNdb>;
+
+    CCopyOnWrite<SBglNdbData> m_data;
 };
 
 //******************************************************************************
@@ -384,13 +396,11 @@ struct SBglRunwayApproachLightsData
 
 #pragma pack(pop)
 
-class CBglRunway final : public CBglLLA<stlab::copy_on_write<SBglRunwayData>>,
+class CBglRunway final : public CBglLLA<CBglRunway>,
                          public IBglSerializable,
                          public IBglRunway
 {
 public:
-    CBglRunway() : CBglLLA<stlab::copy_on_write<SBglRunwayData>>(m_data) { }
-
     class CBglRunwayEnd final : public IBglSerializable, public IBglRunwayEnd
     {
     public:
@@ -412,7 +422,7 @@ public:
         auto SetPosition(EPosition value) -> void;
 
     private:
-        stlab::copy_on_write<SBglRunwayEndData> m_data;
+        CCopyOnWrite<SBglRunwayEndData> m_data;
     };
 
     class CBglRunwayVasi final : public IBglSerializable, public IBglRunwayVasi
@@ -440,7 +450,7 @@ public:
         auto SetPosition(EPosition value) -> void;
 
     private:
-        stlab::copy_on_write<SBglRunwayVasiData> m_data;
+        CCopyOnWrite<SBglRunwayVasiData> m_data;
     };
 
     class CBglRunwayApproachLights final : public IBglSerializable, public IBglRunwayApproachLights
@@ -468,7 +478,7 @@ public:
         auto SetPosition(EPosition value) -> void;
 
     private:
-        stlab::copy_on_write<SBglRunwayApproachLightsData> m_data;
+        CCopyOnWrite<SBglRunwayApproachLightsData> m_data;
     };
 
 private:
@@ -623,19 +633,21 @@ public:
     auto SetSecondaryApproachLights(IBglRunwayApproachLights* value) -> void override;
 
 private:
-    stlab::copy_on_write<SBglRunwayData> m_data;
-    stlab::copy_on_write<CBglRunwayEnd> m_primary_offset_threshold;
-    stlab::copy_on_write<CBglRunwayEnd> m_secondary_offset_threshold;
-    stlab::copy_on_write<CBglRunwayEnd> m_primary_blast_pad;
-    stlab::copy_on_write<CBglRunwayEnd> m_secondary_blast_pad;
-    stlab::copy_on_write<CBglRunwayEnd> m_primary_overrun;
-    stlab::copy_on_write<CBglRunwayEnd> m_secondary_overrun;
-    stlab::copy_on_write<CBglRunwayVasi> m_primary_left_vasi;
-    stlab::copy_on_write<CBglRunwayVasi> m_primary_right_vasi;
-    stlab::copy_on_write<CBglRunwayVasi> m_secondary_left_vasi;
-    stlab::copy_on_write<CBglRunwayVasi> m_secondary_right_vasi;
-    stlab::copy_on_write<CBglRunwayApproachLights> m_primary_approach_lights;
-    stlab::copy_on_write<CBglRunwayApproachLights> m_secondary_approach_lights;
+    friend class CBglLLA<CBglRunway>;
+
+    CCopyOnWrite<SBglRunwayData> m_data;
+    CCopyOnWrite<CBglRunwayEnd> m_primary_offset_threshold;
+    CCopyOnWrite<CBglRunwayEnd> m_secondary_offset_threshold;
+    CCopyOnWrite<CBglRunwayEnd> m_primary_blast_pad;
+    CCopyOnWrite<CBglRunwayEnd> m_secondary_blast_pad;
+    CCopyOnWrite<CBglRunwayEnd> m_primary_overrun;
+    CCopyOnWrite<CBglRunwayEnd> m_secondary_overrun;
+    CCopyOnWrite<CBglRunwayVasi> m_primary_left_vasi;
+    CCopyOnWrite<CBglRunwayVasi> m_primary_right_vasi;
+    CCopyOnWrite<CBglRunwayVasi> m_secondary_left_vasi;
+    CCopyOnWrite<CBglRunwayVasi> m_secondary_right_vasi;
+    CCopyOnWrite<CBglRunwayApproachLights> m_primary_approach_lights;
+    CCopyOnWrite<CBglRunwayApproachLights> m_secondary_approach_lights;
 };
 
 //******************************************************************************
@@ -659,11 +671,9 @@ struct SBglStartData
 
 #pragma pack(pop)
 
-class CBglStart final : public CBglLLA<stlab::copy_on_write<SBglStartData>>, public IBglSerializable, public IBglStart
+class CBglStart final : public CBglLLA<CBglStart>, public IBglSerializable, public IBglStart
 {
 public:
-    CBglStart() : CBglLLA<stlab::copy_on_write<SBglStartData>>(m_data) { }
-
     auto ReadBinary(BinaryFileStream& in) -> void override;
     auto WriteBinary(BinaryFileStream& out) -> void override;
     auto Validate() -> bool override;
@@ -679,7 +689,9 @@ public:
     auto SetHeading(float value) -> void override;
 
 private:
-    stlab::copy_on_write<SBglStartData> m_data;
+    friend class CBglLLA<CBglStart>;
+
+    CCopyOnWrite<SBglStartData> m_data;
 };
 
 //******************************************************************************
@@ -695,7 +707,6 @@ struct SBglComData
     uint32_t Size;
     uint16_t ComType;
     uint32_t Frequency;
-    std::string Name;
 };
 
 #pragma pack(pop)
@@ -720,7 +731,8 @@ public:
 private:
     auto CalculateRemainingSize() const -> int;
 
-    stlab::copy_on_write<SBglComData> m_data;
+    CCopyOnWrite<SBglComData> m_data;
+    CPooledString m_name;
 };
 
 //******************************************************************************
@@ -747,13 +759,11 @@ struct SBglHelipadData
 
 #pragma pack(pop)
 
-class CBglHelipad final : public CBglLLA<stlab::copy_on_write<SBglHelipadData>>,
+class CBglHelipad final : public CBglLLA<CBglHelipad>,
                           public IBglSerializable,
                           public IBglHelipad
 {
 public:
-    CBglHelipad() : CBglLLA<stlab::copy_on_write<SBglHelipadData>>(m_data) { }
-
     auto ReadBinary(BinaryFileStream& in) -> void override;
     auto WriteBinary(BinaryFileStream& out) -> void override;
     auto Validate() -> bool override;
@@ -777,7 +787,9 @@ public:
     auto SetHeading(float value) -> void override;
 
 private:
-    stlab::copy_on_write<SBglHelipadData> m_data;
+    friend class CBglLLA<CBglHelipad>;
+
+    CCopyOnWrite<SBglHelipadData> m_data;
 };
 
 //******************************************************************************
@@ -817,7 +829,7 @@ public:
     auto SetSecondaryRunwayDesignator(IBglRunway::ERunwayDesignator value) -> void override;
 
 private:
-    stlab::copy_on_write<SBglRunwayDeleteData> m_data;
+    CCopyOnWrite<SBglRunwayDeleteData> m_data;
 };
 
 //******************************************************************************
@@ -853,7 +865,7 @@ public:
     auto SetType(IBglStart::EType value) -> void override;
 
 private:
-    stlab::copy_on_write<SBglStartDeleteData> m_data;
+    CCopyOnWrite<SBglStartDeleteData> m_data;
 };
 
 //******************************************************************************
@@ -884,7 +896,7 @@ public:
     auto SetFrequency(uint32_t value) -> void override;
 
 private:
-    stlab::copy_on_write<SBglComDeleteData> m_data;
+    CCopyOnWrite<SBglComDeleteData> m_data;
 };
 
 //******************************************************************************
@@ -936,12 +948,15 @@ public:
     auto GetStartDeleteCount() const -> int override;
     auto GetComDeleteCount() const -> int override;
     auto GetRunwayDeleteAt(int index) -> IBglRunwayDelete* override;
+    auto GetRunwayDeleteAt(int index) const -> const IBglRunwayDelete* override;
     auto AddRunwayDelete(const IBglRunwayDelete* runway) -> void override;
     auto RemoveRunwayDelete(const IBglRunwayDelete* runway) -> void override;
     auto GetStartDeleteAt(int index) -> IBglStartDelete* override;
+    auto GetStartDeleteAt(int index) const -> const IBglStartDelete* override;
     auto AddStartDelete(const IBglStartDelete* start) -> void override;
     auto RemoveStartDelete(const IBglStartDelete* start) -> void override;
     auto GetComDeleteAt(int index) -> IBglComDelete* override;
+    auto GetComDeleteAt(int index) const -> const IBglComDelete* override;
     auto AddComDelete(const IBglComDelete* com) -> void override;
     auto RemoveComDelete(const IBglComDelete* com) -> void override;
 
@@ -960,10 +975,10 @@ private:
         Taxiways = 7,
     };
 
-    stlab::copy_on_write<std::vector<CBglRunwayDelete>> m_runway_deletes;
-    stlab::copy_on_write<std::vector<CBglStartDelete>> m_start_deletes;
-    stlab::copy_on_write<std::vector<CBglComDelete>> m_com_deletes;
-    stlab::copy_on_write<SBglAirportDeleteData> m_data;
+    CCopyOnWrite<std::vector<CBglRunwayDelete>> m_runway_deletes;
+    CCopyOnWrite<std::vector<CBglStartDelete>> m_start_deletes;
+    CCopyOnWrite<std::vector<CBglComDelete>> m_com_deletes;
+    CCopyOnWrite<SBglAirportDeleteData> m_data;
 };
 
 //******************************************************************************
@@ -1004,18 +1019,20 @@ public:
     auto GetMaxAltitude() const -> float override;
     auto SetMaxAltitude(float value) -> void override;
     auto GetVertexAt(int index) -> SBglVertexLL* override;
+    auto GetVertexAt(int index) const -> const SBglVertexLL* override;
     auto AddVertex(const SBglVertexLL* vertex) -> void override;
     auto RemoveVertex(const SBglVertexLL* vertex) -> void override;
     auto GetEdgeAt(int index) -> SBglEdge* override;
+    auto GetEdgeAt(int index) const -> const SBglEdge* override;
     auto AddEdge(const SBglEdge* edge) -> void override;
     auto RemoveEdge(const SBglEdge* edge) -> void override;
 
     auto IsEmpty() const -> bool;
 
 private:
-    stlab::copy_on_write<SBglApronEdgeLightsData> m_data;
-    stlab::copy_on_write<std::vector<SBglEdge>> m_edges;
-    stlab::copy_on_write<std::vector<SBglVertexLL>> m_vertices;
+    CCopyOnWrite<SBglApronEdgeLightsData> m_data;
+    CCopyOnWrite<std::vector<SBglEdge>> m_edges;
+    CCopyOnWrite<std::vector<SBglVertexLL>> m_vertices;
 };
 
 //******************************************************************************
@@ -1047,12 +1064,13 @@ public:
     auto SetSurfaceType(ESurfaceType value) -> void override;
     auto GetVertexCount() const -> int override;
     auto GetVertexAt(int index) -> SBglVertexLL* override;
+    auto GetVertexAt(int index) const -> const SBglVertexLL* override;
     auto AddVertex(const SBglVertexLL* vertex) -> void override;
     auto RemoveVertex(const SBglVertexLL* vertex) -> void override;
 
 private:
-    stlab::copy_on_write<SBglApronData> m_data;
-    stlab::copy_on_write<std::vector<SBglVertexLL>> m_vertices;
+    CCopyOnWrite<SBglApronData> m_data;
+    CCopyOnWrite<std::vector<SBglVertexLL>> m_vertices;
 
     static constexpr int s_num_pad = 3;
 };
@@ -1093,16 +1111,18 @@ public:
     auto GetVertexCount() const -> int override;
     auto GetIndexCount() const -> int override;
     auto GetVertexAt(int index) -> SBglVertexLL* override;
+    auto GetVertexAt(int index) const -> const SBglVertexLL* override;
     auto AddVertex(const SBglVertexLL* vertex) -> void override;
     auto RemoveVertex(const SBglVertexLL* vertex) -> void override;
     auto GetIndexAt(int index) -> SBglIndex* override;
+    auto GetIndexAt(int index) const -> const SBglIndex* override;
     auto AddIndex(const SBglIndex* index) -> void override;
     auto RemoveIndex(const SBglIndex* index) -> void override;
 
 private:
-    stlab::copy_on_write<SBglApronPolygonsData> m_data;
-    stlab::copy_on_write<std::vector<SBglVertexLL>> m_vertices;
-    stlab::copy_on_write<std::vector<SBglIndex>> m_indices;
+    CCopyOnWrite<SBglApronPolygonsData> m_data;
+    CCopyOnWrite<std::vector<SBglVertexLL>> m_vertices;
+    CCopyOnWrite<std::vector<SBglIndex>> m_indices;
 };
 
 //******************************************************************************
@@ -1135,10 +1155,11 @@ public:
     auto GetOrientation() const -> EOrientation override;
     auto SetOrientation(EOrientation value) -> void override;
     auto GetVertex() -> SBglVertexLL* override;
+    auto GetVertex() const -> const SBglVertexLL* override;
     auto SetVertex(SBglVertexLL* vertex) -> void override;
 
 private:
-    stlab::copy_on_write<SBglTaxiwayPointData> m_data;
+    CCopyOnWrite<SBglTaxiwayPointData> m_data;
 };
 
 //******************************************************************************
@@ -1167,14 +1188,15 @@ public:
 
     auto GetPointCount() const -> int override;
     auto GetPointAt(int index) -> IBglTaxiwayPoint* override;
+    auto GetPointAt(int index) const -> const IBglTaxiwayPoint* override;
     auto AddPoint(const IBglTaxiwayPoint* point) -> void override;
     auto RemovePoint(const IBglTaxiwayPoint* point) -> void override;
 
     auto IsEmpty() const -> bool;
 
 private:
-    stlab::copy_on_write<SBglTaxiwayPointsData> m_data;
-    stlab::copy_on_write<std::vector<CBglTaxiwayPoint>> m_points;
+    CCopyOnWrite<SBglTaxiwayPointsData> m_data;
+    CCopyOnWrite<std::vector<CBglTaxiwayPoint>> m_points;
 };
 
 //******************************************************************************
@@ -1235,8 +1257,8 @@ public:
     auto SetAirlineCodeCount(int value) -> void;
 
 private:
-    stlab::copy_on_write<SBglTaxiwayParkingData> m_data;
-    stlab::copy_on_write<std::vector<std::string>> m_codes;
+    CCopyOnWrite<SBglTaxiwayParkingData> m_data;
+    CCopyOnWrite<std::vector<CPooledString>> m_codes;
 };
 
 //******************************************************************************
@@ -1265,14 +1287,15 @@ public:
 
     auto GetParkingCount() const -> int override;
     auto GetParkingAt(int index) -> IBglTaxiwayParking* override;
+    auto GetParkingAt(int index) const -> const IBglTaxiwayParking* override;
     auto AddParking(const IBglTaxiwayParking* parking) -> void override;
     auto RemoveParking(const IBglTaxiwayParking* parking) -> void override;
 
     auto IsEmpty() const -> bool;
 
 private:
-    stlab::copy_on_write<SBglTaxiwayParkingsData> m_data;
-    stlab::copy_on_write<std::vector<CBglTaxiwayParking>> m_parkings;
+    CCopyOnWrite<SBglTaxiwayParkingsData> m_data;
+    CCopyOnWrite<std::vector<CBglTaxiwayParking>> m_parkings;
 };
 
 //******************************************************************************
@@ -1341,7 +1364,7 @@ public:
     auto SetWeightLimit(float value) -> void override;
 
 private:
-    stlab::copy_on_write<SBglTaxiwayPathData> m_data;
+    CCopyOnWrite<SBglTaxiwayPathData> m_data;
 };
 
 //******************************************************************************
@@ -1370,14 +1393,15 @@ public:
 
     auto GetPathCount() const -> int override;
     auto GetPathAt(int index) -> IBglTaxiwayPath* override;
+    auto GetPathAt(int index) const -> const IBglTaxiwayPath* override;
     auto AddPath(const IBglTaxiwayPath* path) -> void override;
     auto RemovePath(const IBglTaxiwayPath* path) -> void override;
 
     auto IsEmpty() const -> bool;
 
 private:
-    stlab::copy_on_write<SBglTaxiwayPathsData> m_data;
-    stlab::copy_on_write<std::vector<CBglTaxiwayPath>> m_paths;
+    CCopyOnWrite<SBglTaxiwayPathsData> m_data;
+    CCopyOnWrite<std::vector<CBglTaxiwayPath>> m_paths;
 };
 
 //******************************************************************************
@@ -1412,8 +1436,8 @@ public:
     auto IsEmpty() const -> bool;
 
 private:
-    stlab::copy_on_write<SBglTaxiwayNamesData> m_data;
-    stlab::copy_on_write<std::vector<std::string>> m_names;
+    CCopyOnWrite<SBglTaxiwayNamesData> m_data;
+    CCopyOnWrite<std::vector<CPooledString>> m_names;
 };
 
 //******************************************************************************
@@ -1461,7 +1485,7 @@ public:
 private:
     auto CalculatePadSize() const -> int;
 
-    stlab::copy_on_write<SBglJetwayData> m_data;
+    CCopyOnWrite<SBglJetwayData> m_data;
     std::unique_ptr<CBglSceneryObject> m_scenery_object;
 };
 
@@ -1544,7 +1568,7 @@ public:
     auto SetAltitude2(float value) -> void override;
 
 private:
-    stlab::copy_on_write<SBglLegData> m_data;
+    CCopyOnWrite<SBglLegData> m_data;
 };
 
 //******************************************************************************
@@ -1574,14 +1598,15 @@ public:
 
     auto GetLegCount() const -> int override;
     auto GetLegAt(int index) -> IBglLeg* override;
+    auto GetLegAt(int index) const -> const IBglLeg* override;
     auto AddLeg(const IBglLeg* leg) -> void override;
     auto RemoveLeg(const IBglLeg* leg) -> void override;
 
     auto IsEmpty() const -> bool;
 
 private:
-    stlab::copy_on_write<SBglLegsData> m_data;
-    stlab::copy_on_write<std::vector<CBglLeg>> m_legs;
+    CCopyOnWrite<SBglLegsData> m_data;
+    CCopyOnWrite<std::vector<CBglLeg>> m_legs;
 };
 
 //******************************************************************************
@@ -1623,7 +1648,7 @@ public:
     auto IsEmpty() const -> bool;
 
 private:
-    stlab::copy_on_write<SBglDmeArcData> m_data;
+    CCopyOnWrite<SBglDmeArcData> m_data;
 };
 
 //******************************************************************************
@@ -1668,14 +1693,16 @@ public:
     auto GetAltitude() const -> float override;
     auto SetAltitude(float value) -> void override;
     auto GetDmeArc() -> IBglDmeArc* override;
+    auto GetDmeArc() const -> const IBglDmeArc* override;
     auto SetDmeArc(IBglDmeArc* value) -> void override;
     auto GetTransitionLegs() -> IBglLegs* override;
+    auto GetTransitionLegs() const -> const IBglLegs* override;
     auto SetTransitionLegs(IBglLegs* value) -> void override;
 
 private:
-    stlab::copy_on_write<SBglTransitionData> m_data;
-    stlab::copy_on_write<CBglDmeArc> m_dme_arc;
-    stlab::copy_on_write<CBglLegs> m_legs;
+    CCopyOnWrite<SBglTransitionData> m_data;
+    CCopyOnWrite<CBglDmeArc> m_dme_arc;
+    CCopyOnWrite<CBglLegs> m_legs;
     static constexpr int s_transition_legs_type = 0x2Fu;
 };
 
@@ -1741,10 +1768,13 @@ public:
     auto GetApproachLegCount() const -> int override;
     auto GetMissedApproachLegCount() const -> int override;
     auto GetApproachLegs() -> IBglLegs* override;
+    auto GetApproachLegs() const -> const IBglLegs* override;
     auto SetApproachLegs(IBglLegs* value) -> void override;
     auto GetMissedApproachLegs() -> IBglLegs* override;
+    auto GetMissedApproachLegs() const -> const IBglLegs* override;
     auto SetMissedApproachLegs(IBglLegs* value) -> void override;
     auto GetTransitionAt(int index) -> IBglTransition* override;
+    auto GetTransitionAt(int index) const -> const IBglTransition* override;
     auto AddTransition(const IBglTransition* transition) -> void override;
     auto RemoveTransition(const IBglTransition* transition) -> void override;
 
@@ -1758,10 +1788,10 @@ private:
         TransitionLegs = 0x2F
     };
 
-    stlab::copy_on_write<SBglApproachData> m_data;
-    stlab::copy_on_write<CBglLegs> m_approach_legs;
-    stlab::copy_on_write<CBglLegs> m_missed_approach_legs;
-    stlab::copy_on_write<std::vector<CBglTransition>> m_transitions;
+    CCopyOnWrite<SBglApproachData> m_data;
+    CCopyOnWrite<CBglLegs> m_approach_legs;
+    CCopyOnWrite<CBglLegs> m_missed_approach_legs;
+    CCopyOnWrite<std::vector<CBglTransition>> m_transitions;
 };
 
 //******************************************************************************
@@ -1798,12 +1828,13 @@ public:
     auto GetProfile() const -> _GUID override;
     auto SetProfile(_GUID value) -> void override;
     auto GetVertexAt(int index) -> SBglVertexLL* override;
+    auto GetVertexAt(int index) const -> const SBglVertexLL* override;
     auto AddVertex(const SBglVertexLL* vertex) -> void override;
     auto RemoveVertex(const SBglVertexLL* vertex) -> void override;
 
 private:
-    stlab::copy_on_write<SBglFenceData> m_data;
-    stlab::copy_on_write<std::vector<SBglVertexLL>> m_vertices;
+    CCopyOnWrite<SBglFenceData> m_data;
+    CCopyOnWrite<std::vector<SBglVertexLL>> m_vertices;
 };
 
 //******************************************************************************
@@ -1839,18 +1870,12 @@ struct SBglAirportData
 
 #pragma pack(pop)
 
-class CBglAirport final : public CBglFuelAvailability<stlab::copy_on_write<SBglAirportData>>,
-                          public CBglLLA<stlab::copy_on_write<SBglAirportData>>,
+class CBglAirport final : public CBglFuelAvailability<CBglAirport>,
+                          public CBglLLA<CBglAirport>,
                           public CBglName,
                           public IBglAirport
 {
 public:
-    CBglAirport() :
-        CBglFuelAvailability<stlab::copy_on_write<SBglAirportData>>(m_data),
-        CBglLLA<stlab::copy_on_write<SBglAirportData>>(m_data)
-    {
-    }
-
     auto ReadBinary(BinaryFileStream& in) -> void override;
     auto WriteBinary(BinaryFileStream& out) -> void override;
     auto Validate() -> bool override;
@@ -1880,69 +1905,88 @@ public:
     auto SetTrafficScalar(float value) -> void override;
 
     auto GetRunwayAt(int index) -> IBglRunway* override;
+    auto GetRunwayAt(int index) const -> const IBglRunway* override;
     auto AddRunway(const IBglRunway* runway) -> void override;
     auto RemoveRunway(const IBglRunway* runway) -> void override;
     auto GetStartAt(int index) -> IBglStart* override;
+    auto GetStartAt(int index) const -> const IBglStart* override;
     auto AddStart(const IBglStart* start) -> void override;
     auto RemoveStart(const IBglStart* start) -> void override;
     auto GetComAt(int index) -> IBglCom* override;
+    auto GetComAt(int index) const -> const IBglCom* override;
     auto AddCom(const IBglCom* com) -> void override;
     auto RemoveCom(const IBglCom* com) -> void override;
     auto GetHelipadAt(int index) -> IBglHelipad* override;
+    auto GetHelipadAt(int index) const -> const IBglHelipad* override;
     auto AddHelipad(const IBglHelipad* helipad) -> void override;
     auto RemoveHelipad(const IBglHelipad* helipad) -> void override;
     auto GetDelete() -> IBglAirportDelete* override;
+    auto GetDelete() const -> const IBglAirportDelete* override;
     auto SetDelete(IBglAirportDelete* value) -> void override;
     auto GetApronEdgeLights() -> IBglApronEdgeLights* override;
+    auto GetApronEdgeLights() const -> const IBglApronEdgeLights* override;
     auto SetApronEdgeLights(IBglApronEdgeLights* value) -> void override;
     auto GetApronAt(int index) -> IBglApron* override;
+    auto GetApronAt(int index) const -> const IBglApron* override;
     auto AddApron(const IBglApron* apron) -> void override;
     auto RemoveApron(const IBglApron* apron) -> void override;
     auto GetApronPolygonsAt(int index) -> IBglApronPolygons* override;
+    auto GetApronPolygonsAt(int index) const -> const IBglApronPolygons* override;
     auto AddApronPolygons(const IBglApronPolygons* polygons) -> void override;
     auto RemoveApronPolygons(const IBglApronPolygons* polygons) -> void override;
     auto GetTaxiwayPoints() -> IBglTaxiwayPoints* override;
+    auto GetTaxiwayPoints() const -> const IBglTaxiwayPoints* override;
     auto SetTaxiwayPoints(IBglTaxiwayPoints* value) -> void override;
     auto GetTaxiwayParkings() -> IBglTaxiwayParkings* override;
+    auto GetTaxiwayParkings() const -> const IBglTaxiwayParkings* override;
     auto SetTaxiwayParkings(IBglTaxiwayParkings* value) -> void override;
     auto GetTaxiwayPaths() -> IBglTaxiwayPaths* override;
+    auto GetTaxiwayPaths() const -> const IBglTaxiwayPaths* override;
     auto SetTaxiwayPaths(IBglTaxiwayPaths* value) -> void override;
     auto GetTaxiwayNames() -> IBglTaxiwayNames* override;
+    auto GetTaxiwayNames() const -> const IBglTaxiwayNames* override;
     auto SetTaxiwayNames(IBglTaxiwayNames* value) -> void override;
     auto GetJetwayCount() const -> int override;
     auto GetJetwayAt(int index) -> IBglJetway* override;
+    auto GetJetwayAt(int index) const -> const IBglJetway* override;
     auto AddJetway(const IBglJetway* jetway) -> void override;
     auto RemoveJetway(const IBglJetway* jetway) -> void override;
     auto GetApproachAt(int index) -> IBglApproach* override;
+    auto GetApproachAt(int index) const -> const IBglApproach* override;
     auto AddApproach(const IBglApproach* approach) -> void override;
     auto RemoveApproach(const IBglApproach* approach) -> void override;
     auto GetBlastFenceCount() const -> int override;
     auto GetBlastFenceAt(int index) -> IBglFence* override;
+    auto GetBlastFenceAt(int index) const -> const IBglFence* override;
     auto AddBlastFence(const IBglFence* fence) -> void override;
     auto RemoveBlastFence(const IBglFence* fence) -> void override;
     auto GetBoundaryFenceCount() const -> int override;
     auto GetBoundaryFenceAt(int index) -> IBglFence* override;
+    auto GetBoundaryFenceAt(int index) const -> const IBglFence* override;
     auto AddBoundaryFence(const IBglFence* fence) -> void override;
     auto RemoveBoundaryFence(const IBglFence* fence) -> void override;
 
 private:
-    stlab::copy_on_write<std::vector<CBglRunway>> m_runways;
-    stlab::copy_on_write<std::vector<CBglStart>> m_starts;
-    stlab::copy_on_write<std::vector<CBglCom>> m_coms;
-    stlab::copy_on_write<std::vector<CBglHelipad>> m_helipads;
-    stlab::copy_on_write<CBglAirportDelete> m_delete;
-    stlab::copy_on_write<CBglApronEdgeLights> m_apron_edge_lights;
-    stlab::copy_on_write<std::vector<CBglApron>> m_aprons;
-    stlab::copy_on_write<std::vector<CBglApronPolygons>> m_apron_polygons;
-    stlab::copy_on_write<CBglTaxiwayPoints> m_taxiway_points;
-    stlab::copy_on_write<CBglTaxiwayParkings> m_taxiway_parkings;
-    stlab::copy_on_write<CBglTaxiwayPaths> m_taxiway_paths;
-    stlab::copy_on_write<CBglTaxiwayNames> m_taxiway_names;
-    stlab::copy_on_write<std::vector<CBglJetway>> m_jetways;
-    stlab::copy_on_write<std::vector<CBglApproach>> m_approaches;
-    stlab::copy_on_write<std::vector<CBglFence>> m_blast_fences;
-    stlab::copy_on_write<std::vector<CBglFence>> m_boundary_fences;
-    stlab::copy_on_write<SBglAirportData> m_data;
+    friend class CBglLLA<CBglAirport>;
+    friend class CBglFuelAvailability<CBglAirport>;
+
+    CCopyOnWrite<std::vector<CBglRunway>> m_runways;
+    CCopyOnWrite<std::vector<CBglStart>> m_starts;
+    CCopyOnWrite<std::vector<CBglCom>> m_coms;
+    CCopyOnWrite<std::vector<CBglHelipad>> m_helipads;
+    CCopyOnWrite<CBglAirportDelete> m_delete;
+    CCopyOnWrite<CBglApronEdgeLights> m_apron_edge_lights;
+    CCopyOnWrite<std::vector<CBglApron>> m_aprons;
+    CCopyOnWrite<std::vector<CBglApronPolygons>> m_apron_polygons;
+    CCopyOnWrite<CBglTaxiwayPoints> m_taxiway_points;
+    CCopyOnWrite<CBglTaxiwayParkings> m_taxiway_parkings;
+    CCopyOnWrite<CBglTaxiwayPaths> m_taxiway_paths;
+    CCopyOnWrite<CBglTaxiwayNames> m_taxiway_names;
+    CCopyOnWrite<std::vector<CBglJetway>> m_jetways;
+    CCopyOnWrite<std::vector<CBglApproach>> m_approaches;
+    CCopyOnWrite<std::vector<CBglFence>> m_blast_fences;
+    CCopyOnWrite<std::vector<CBglFence>> m_boundary_fences;
+    CCopyOnWrite<SBglAirportData> m_data;
 };
 
 //******************************************************************************
@@ -1970,18 +2014,12 @@ struct SBglAirportSummaryData
 
 #pragma pack(pop)
 
-class CBglAirportSummary final : public CBglFuelAvailability<stlab::copy_on_write<SBglAirportSummaryData>>,
-                                 public CBglLLA<stlab::copy_on_write<SBglAirportSummaryData>>,
+class CBglAirportSummary final : public CBglFuelAvailability<CBglAirportSummary>,
+                                 public CBglLLA<CBglAirportSummary>,
                                  public IBglSerializable,
                                  public IBglAirportSummary
 {
 public:
-    CBglAirportSummary() :
-        CBglFuelAvailability<stlab::copy_on_write<SBglAirportSummaryData>>(m_data),
-        CBglLLA<stlab::copy_on_write<SBglAirportSummaryData>>(m_data)
-    {
-    }
-
     auto ReadBinary(BinaryFileStream& in) -> void override;
     auto WriteBinary(BinaryFileStream& out) -> void override;
     auto Validate() -> bool override;
@@ -2027,6 +2065,9 @@ public:
     auto SetLongestRunwayHeading(float value) -> void override;
 
 private:
+    friend class CBglLLA<CBglAirportSummary>;
+    friend class CBglFuelAvailability<CBglAirportSummary>;
+
     enum class EFlags : uint16_t
     {
         Com = 0,
@@ -2047,7 +2088,7 @@ private:
         LocBcApproach = 15
     };
 
-    stlab::copy_on_write<SBglAirportSummaryData> m_data;
+    CCopyOnWrite<SBglAirportSummaryData> m_data;
 };
 
 //******************************************************************************
@@ -2069,7 +2110,6 @@ struct SBglRouteData
     uint8_t RouteType;
     SBglConnectionData Previous;
     SBglConnectionData Next;
-    std::string Name;
 };
 
 #pragma pack(pop)
@@ -2108,7 +2148,8 @@ public:
     auto SetNextAltitudeMinimum(float value) -> void override;
 
 private:
-    stlab::copy_on_write<SBglRouteData> m_data;
+    CCopyOnWrite<SBglRouteData> m_data;
+    CPooledString m_name;
 };
 
 //******************************************************************************
@@ -2157,14 +2198,15 @@ public:
     auto GetIcaoAirport() const -> uint32_t override;
     auto SetIcaoAirport(uint32_t value) -> void override;
     auto GetRouteAt(int index) -> IBglRoute* override;
+    auto GetRouteAt(int index) const -> const IBglRoute* override;
     auto AddRoute(const IBglRoute* route) -> void override;
     auto RemoveRoute(const IBglRoute* route) -> void override;
 
 private:
     auto CalculatePadSize() const -> int;
 
-    stlab::copy_on_write<SBglWaypointData> m_data;
-    stlab::copy_on_write<std::vector<CBglRoute>> m_routes;
+    CCopyOnWrite<SBglWaypointData> m_data;
+    CCopyOnWrite<std::vector<CBglRoute>> m_routes;
 };
 
 //******************************************************************************
@@ -2206,7 +2248,7 @@ public:
     auto IsEmpty() const -> bool;
 
 private:
-    stlab::copy_on_write<SBglLocalizerData> m_data;
+    CCopyOnWrite<SBglLocalizerData> m_data;
 };
 
 //******************************************************************************
@@ -2230,13 +2272,11 @@ struct SBglGlideSlopeData
 
 #pragma pack(pop)
 
-class CBglGlideSlope final : public CBglLLA<stlab::copy_on_write<SBglGlideSlopeData>>,
+class CBglGlideSlope final : public CBglLLA<CBglGlideSlope>,
                              public IBglSerializable,
                              public IBglGlideSlope
 {
 public:
-    CBglGlideSlope() : CBglLLA<stlab::copy_on_write<SBglGlideSlopeData>>(m_data) { }
-
     auto ReadBinary(BinaryFileStream& in) -> void override;
     auto WriteBinary(BinaryFileStream& out) -> void override;
     auto Validate() -> bool override;
@@ -2250,7 +2290,9 @@ public:
     auto IsEmpty() const -> bool;
 
 private:
-    stlab::copy_on_write<SBglGlideSlopeData> m_data;
+    friend class CBglLLA<CBglGlideSlope>;
+
+    CCopyOnWrite<SBglGlideSlopeData> m_data;
 };
 
 //******************************************************************************
@@ -2273,11 +2315,9 @@ struct SBglDmeData
 
 #pragma pack(pop)
 
-class CBglDme final : public CBglLLA<stlab::copy_on_write<SBglDmeData>>, public IBglSerializable, public IBglDme
+class CBglDme final : public CBglLLA<CBglDme>, public IBglSerializable, public IBglDme
 {
 public:
-    CBglDme() : CBglLLA<stlab::copy_on_write<SBglDmeData>>(m_data) { }
-
     auto ReadBinary(BinaryFileStream& in) -> void override;
     auto WriteBinary(BinaryFileStream& out) -> void override;
     auto Validate() -> bool override;
@@ -2289,7 +2329,9 @@ public:
     auto IsEmpty() const -> bool;
 
 private:
-    stlab::copy_on_write<SBglDmeData> m_data;
+    friend class CBglLLA<CBglDme>;
+
+    CCopyOnWrite<SBglDmeData> m_data;
 };
 
 //******************************************************************************
@@ -2317,11 +2359,9 @@ struct SBglNavData
 
 #pragma pack(pop)
 
-class CBglNav final : public CBglLLA<stlab::copy_on_write<SBglNavData>>, public CBglName, public IBglNav
+class CBglNav final : public CBglLLA<CBglNav>, public CBglName, public IBglNav
 {
 public:
-    CBglNav() : CBglLLA<stlab::copy_on_write<SBglNavData>>(m_data) { }
-
     auto ReadBinary(BinaryFileStream& in) -> void override;
     auto WriteBinary(BinaryFileStream& out) -> void override;
     auto Validate() -> bool override;
@@ -2352,13 +2392,18 @@ public:
     auto GetIcaoAirport() const -> uint32_t override;
     auto SetIcaoAirport(uint32_t value) -> void override;
     auto GetLocalizer() -> IBglLocalizer* override;
+    auto GetLocalizer() const -> const IBglLocalizer* override;
     auto SetLocalizer(IBglLocalizer* value) -> void override;
     auto GetGlideSlope() -> IBglGlideSlope* override;
+    auto GetGlideSlope() const -> const IBglGlideSlope* override;
     auto SetGlideSlope(IBglGlideSlope* value) -> void override;
     auto GetDmeRecord() -> IBglDme* override;
+    auto GetDmeRecord() const -> const IBglDme* override;
     auto SetDmeRecord(IBglDme* value) -> void override;
 
 private:
+    friend class CBglLLA<CBglNav>;
+
     enum class EFlags : uint8_t
     {
         NotDmeOnly = 0,
@@ -2368,10 +2413,10 @@ private:
         NavMissing = 5
     };
 
-    stlab::copy_on_write<SBglNavData> m_data;
-    stlab::copy_on_write<CBglLocalizer> m_localizer;
-    stlab::copy_on_write<CBglGlideSlope> m_glide_slope;
-    stlab::copy_on_write<CBglDme> m_dme;
+    CCopyOnWrite<SBglNavData> m_data;
+    CCopyOnWrite<CBglLocalizer> m_localizer;
+    CCopyOnWrite<CBglGlideSlope> m_glide_slope;
+    CCopyOnWrite<CBglDme> m_dme;
 };
 
 //******************************************************************************
@@ -2398,11 +2443,9 @@ struct SBglTacanData
 
 #pragma pack(pop)
 
-class CBglTacan final : public CBglLLA<stlab::copy_on_write<SBglTacanData>>, public CBglName, public IBglTacan
+class CBglTacan final : public CBglLLA<CBglTacan>, public CBglName, public IBglTacan
 {
 public:
-    CBglTacan() : CBglLLA<stlab::copy_on_write<SBglTacanData>>(m_data) { }
-
     auto ReadBinary(BinaryFileStream& in) -> void override;
     auto WriteBinary(BinaryFileStream& out) -> void override;
     auto Validate() -> bool override;
@@ -2425,11 +2468,14 @@ public:
     auto GetIcaoAirport() const -> uint32_t override;
     auto SetIcaoAirport(uint32_t value) -> void override;
     auto GetDmeRecord() -> IBglDme* override;
+    auto GetDmeRecord() const -> const IBglDme* override;
     auto SetDmeRecord(IBglDme* value) -> void override;
 
 private:
-    stlab::copy_on_write<SBglTacanData> m_data;
-    stlab::copy_on_write<CBglDme> m_dme;
+    friend class CBglLLA<CBglTacan>;
+
+    CCopyOnWrite<SBglTacanData> m_data;
+    CCopyOnWrite<CBglDme> m_dme;
 };
 
 //******************************************************************************
@@ -2466,7 +2512,7 @@ public:
     auto SetRadius(float value) -> void override;
 
 private:
-    stlab::copy_on_write<SBglBoundaryEdgeData> m_data;
+    CCopyOnWrite<SBglBoundaryEdgeData> m_data;
 };
 
 //******************************************************************************
@@ -2495,14 +2541,15 @@ public:
 
     auto GetEdgeCount() const -> int override;
     auto GetEdgeAt(int index) -> IBglBoundaryEdge* override;
+    auto GetEdgeAt(int index) const -> const IBglBoundaryEdge* override;
     auto AddEdge(const IBglBoundaryEdge* edge) -> void override;
     auto RemoveEdge(const IBglBoundaryEdge* edge) -> void override;
 
     auto IsEmpty() const -> bool;
 
 private:
-    stlab::copy_on_write<SBglBoundaryEdgesData> m_data;
-    stlab::copy_on_write<std::vector<CBglBoundaryEdge>> m_edges;
+    CCopyOnWrite<SBglBoundaryEdgesData> m_data;
+    CCopyOnWrite<std::vector<CBglBoundaryEdge>> m_edges;
 };
 
 //******************************************************************************
@@ -2555,16 +2602,18 @@ public:
     auto GetMaxAltitude() const -> double override;
     auto SetMaxAltitude(double value) -> void override;
     auto GetCom() -> IBglCom* override;
+    auto GetCom() const -> const IBglCom* override;
     auto SetCom(IBglCom* value) -> void override;
     auto GetEdges() -> IBglBoundaryEdges* override;
+    auto GetEdges() const -> const IBglBoundaryEdges* override;
     auto SetEdges(IBglBoundaryEdges* value) -> void override;
 
 private:
     auto CalculatePadSize() const -> int;
 
-    stlab::copy_on_write<SBglBoundaryData> m_data;
-    stlab::copy_on_write<CBglBoundaryEdges> m_edges;
-    stlab::copy_on_write<CBglCom> m_com;
+    CCopyOnWrite<SBglBoundaryData> m_data;
+    CCopyOnWrite<CBglBoundaryEdges> m_edges;
+    CCopyOnWrite<CBglCom> m_com;
 };
 
 //******************************************************************************
@@ -2637,7 +2686,7 @@ private:
         ExtrusionBridge = 11,
     };
 
-    stlab::copy_on_write<SBglExclusionData> m_data;
+    CCopyOnWrite<SBglExclusionData> m_data;
 };
 
 //******************************************************************************
@@ -2687,7 +2736,7 @@ public:
     auto SetRegionIdent(uint32_t value) -> void override;
 
 private:
-    stlab::copy_on_write<SBglMarkerData> m_data;
+    CCopyOnWrite<SBglMarkerData> m_data;
 };
 
 //******************************************************************************
@@ -2730,14 +2779,15 @@ public:
     auto SetMaxLatitude(double value) -> void override;
     auto GetVertexCount() const -> int override;
     auto GetVertexAt(int index) -> SBglVertexLL* override;
+    auto GetVertexAt(int index) const -> const SBglVertexLL* override;
     auto AddVertex(const SBglVertexLL* vertex) -> void override;
     auto RemoveVertex(const SBglVertexLL* vertex) -> void override;
 
 private:
     auto SetVertexCount(int value) -> void;
 
-    stlab::copy_on_write<SBglGeopolData> m_data;
-    stlab::copy_on_write<std::vector<SBglVertexLL>> m_vertices;
+    CCopyOnWrite<SBglGeopolData> m_data;
+    CCopyOnWrite<std::vector<SBglVertexLL>> m_vertices;
 };
 
 //******************************************************************************
@@ -2834,7 +2884,7 @@ private:
         NoZTest = 1 << 6
     };
 
-    stlab::copy_on_write<SBglSceneryObjectData> m_data;
+    CCopyOnWrite<SBglSceneryObjectData> m_data;
 };
 
 //******************************************************************************
@@ -2963,7 +3013,7 @@ protected:
     auto CloneImpl() const -> CBglSceneryObject* override { return new CBglGenericBuilding(*this); }
 
 private:
-    stlab::copy_on_write<SBglGenericBuildingData> m_data;
+    CCopyOnWrite<SBglGenericBuildingData> m_data;
 };
 
 //******************************************************************************
@@ -2998,7 +3048,7 @@ protected:
     auto CloneImpl() const -> CBglSceneryObject* override { return new CBglLibraryObject(*this); }
 
 private:
-    stlab::copy_on_write<SBglLibraryObjectData> m_data;
+    CCopyOnWrite<SBglLibraryObjectData> m_data;
 };
 
 //******************************************************************************
@@ -3042,24 +3092,13 @@ protected:
     auto CloneImpl() const -> CBglSceneryObject* override { return new CBglWindsock(*this); }
 
 private:
-    stlab::copy_on_write<SBglWindsockData> m_data;
+    CCopyOnWrite<SBglWindsockData> m_data;
 };
 
 //******************************************************************************
 // CBglEffect
 //******************************************************************************
 
-#pragma pack(push)
-#pragma pack(1)
-
-struct SBglEffectData
-{
-    std::string Name;
-    std::string Params;
-};
-
-#pragma pack(pop)
-
 class CBglEffect final : public CBglSceneryObject, public IBglEffect
 {
 public:
@@ -3077,7 +3116,8 @@ protected:
     auto CloneImpl() const -> CBglSceneryObject* override { return new CBglEffect(*this); }
 
 private:
-    stlab::copy_on_write<SBglEffectData> m_data;
+    CPooledString m_name;
+    CPooledString m_params;
     static constexpr int s_name_size = 80;
 };
 
@@ -3095,7 +3135,6 @@ struct SBglTaxiwaySignData
     uint16_t Heading;
     uint8_t Size;
     uint8_t Justification;
-    std::string Label;
 };
 
 #pragma pack(pop)
@@ -3122,7 +3161,8 @@ public:
     auto SetLabel(const char* value) -> void override;
 
 private:
-    stlab::copy_on_write<SBglTaxiwaySignData> m_data;
+    CCopyOnWrite<SBglTaxiwaySignData> m_data;
+    CPooledString m_label;
     static constexpr int s_record_size = 12;
 };
 
@@ -3140,6 +3180,7 @@ public:
 
     auto GetSignCount() const -> int override;
     auto GetSignAt(int index) -> IBglTaxiwaySign* override;
+    auto GetSignAt(int index) const -> const IBglTaxiwaySign* override;
     auto AddSign(const IBglTaxiwaySign* sign) -> void override;
     auto RemoveSign(const IBglTaxiwaySign* sign) -> void override;
 
@@ -3147,7 +3188,7 @@ protected:
     auto CloneImpl() const -> CBglSceneryObject* override { return new CBglTaxiwaySigns(*this); }
 
 private:
-    stlab::copy_on_write<std::vector<CBglTaxiwaySign>> m_signs;
+    CCopyOnWrite<std::vector<CBglTaxiwaySign>> m_signs;
 };
 
 //******************************************************************************
@@ -3165,13 +3206,11 @@ struct SBglTriggerRefuelRepairData
 
 #pragma pack(pop)
 
-class CBglTriggerRefuelRepair final : public CBglFuelAvailability<stlab::copy_on_write<SBglTriggerRefuelRepairData>>,
+class CBglTriggerRefuelRepair final : public CBglFuelAvailability<CBglTriggerRefuelRepair>,
                                       public IBglSerializable,
                                       public IBglTriggerRefuelRepair
 {
 public:
-    CBglTriggerRefuelRepair() : CBglFuelAvailability<stlab::copy_on_write<SBglTriggerRefuelRepairData>>(m_data) { }
-
     auto ReadBinary(BinaryFileStream& in) -> void override;
     auto WriteBinary(BinaryFileStream& out) -> void override;
     auto Validate() -> bool override;
@@ -3179,12 +3218,15 @@ public:
 
     auto GetVertexCount() const -> int override;
     auto GetVertexAt(int index) -> SBglVertexBias* override;
+    auto GetVertexAt(int index) const -> const SBglVertexBias* override;
     auto AddVertex(const SBglVertexBias* point) -> void override;
     auto RemoveVertex(const SBglVertexBias* point) -> void override;
 
 private:
-    stlab::copy_on_write<SBglTriggerRefuelRepairData> m_data;
-    stlab::copy_on_write<std::vector<SBglVertexBias>> m_vertices;
+    friend class CBglFuelAvailability<CBglTriggerRefuelRepair>;
+
+    CCopyOnWrite<SBglTriggerRefuelRepairData> m_data;
+    CCopyOnWrite<std::vector<SBglVertexBias>> m_vertices;
 };
 
 //******************************************************************************
@@ -3218,12 +3260,13 @@ public:
     auto SetScalar(float value) -> void override;
     auto GetVertexCount() const -> int override;
     auto GetVertexAt(int index) -> SBglVertexBias* override;
+    auto GetVertexAt(int index) const -> const SBglVertexBias* override;
     auto AddVertex(const SBglVertexBias* point) -> void override;
     auto RemoveVertex(const SBglVertexBias* point) -> void override;
 
 private:
-    stlab::copy_on_write<SBglTriggerWeatherData> m_data;
-    stlab::copy_on_write<std::vector<SBglVertexBias>> m_vertices;
+    CCopyOnWrite<SBglTriggerWeatherData> m_data;
+    CCopyOnWrite<std::vector<SBglVertexBias>> m_vertices;
 };
 
 //******************************************************************************
@@ -3262,9 +3305,9 @@ protected:
     auto CloneImpl() const -> CBglSceneryObject* override { return new CBglTrigger(*this); }
 
 private:
-    stlab::copy_on_write<SBglTriggerData> m_data;
-    stlab::copy_on_write<CBglTriggerRefuelRepair> m_refuel;
-    stlab::copy_on_write<CBglTriggerWeather> m_weather;
+    CCopyOnWrite<SBglTriggerData> m_data;
+    CCopyOnWrite<CBglTriggerRefuelRepair> m_refuel;
+    CCopyOnWrite<CBglTriggerWeather> m_weather;
 };
 
 //******************************************************************************
@@ -3299,7 +3342,7 @@ protected:
     auto CloneImpl() const -> CBglSceneryObject* override { return new CBglBeacon(*this); }
 
 private:
-    stlab::copy_on_write<SBglBeaconData> m_data;
+    CCopyOnWrite<SBglBeaconData> m_data;
 };
 
 //******************************************************************************
@@ -3361,9 +3404,11 @@ public:
     auto GetPlacementCount() const -> int override;
     auto GetPointCount() const -> int override;
     auto GetPlacementAt(int index) -> _GUID* override;
+    auto GetPlacementAt(int index) const -> const _GUID* override;
     auto AddPlacement(const _GUID* placement) -> void override;
     auto RemovePlacement(const _GUID* placement) -> void override;
     auto GetPointAt(int index) -> SBglVertexLLA* override;
+    auto GetPointAt(int index) const -> const SBglVertexLLA* override;
     auto AddPoint(const SBglVertexLLA* point) -> void override;
     auto RemovePoint(const SBglVertexLLA* point) -> void override;
 
@@ -3371,9 +3416,9 @@ protected:
     auto CloneImpl() const -> CBglSceneryObject* override { return new CBglExtrusionBridge(*this); }
 
 private:
-    stlab::copy_on_write<SBglExtrusionBridgeData> m_data;
-    stlab::copy_on_write<std::vector<_GUID>> m_placements;
-    stlab::copy_on_write<std::vector<SBglVertexLLA>> m_points;
+    CCopyOnWrite<SBglExtrusionBridgeData> m_data;
+    CCopyOnWrite<std::vector<_GUID>> m_placements;
+    CCopyOnWrite<std::vector<SBglVertexLLA>> m_points;
 };
 
 //******************************************************************************
@@ -3405,7 +3450,7 @@ public:
     auto GetLength() const -> int override;
 
 private:
-    stlab::copy_on_write<std::vector<uint8_t>> m_model;
+    CCopyOnWrite<std::vector<uint8_t>> m_model;
     // std::shared_ptr<uint8_t[]> GetCompressedData();
 };
 
@@ -3486,16 +3531,67 @@ struct SBglTerrainRasterQuad1Data
 
 #pragma pack(pop)
 
+// Byte bounded LRU of compressed raster payloads. Evicting only drops the cache's
+// reference, so buffers already handed out stay valid for as long as they are held
+class CRasterBlockCache
+{
+public:
+    static constexpr size_t s_default_budget = 256 * 1024 * 1024;
+
+    explicit CRasterBlockCache(size_t budget_bytes = s_default_budget);
+    CRasterBlockCache(const CRasterBlockCache&) = delete;
+    CRasterBlockCache& operator=(const CRasterBlockCache&) = delete;
+
+    // Shared by all blocks that are not given a cache explicitly
+    static auto GetDefault() -> CRasterBlockCache&;
+
+    // Shrinking the budget evicts immediately
+    void SetBudget(size_t budget_bytes);
+    auto GetBudget() const -> size_t;
+    auto GetResidentBytes() const -> size_t;
+
+    // Returns the cached payload, reading it from source on a miss. Null if the read fails
+    auto Load(const std::shared_ptr<const IPositionalStream>& source, int offset, int length)
+        -> std::shared_ptr<uint8_t[]>;
+    void Clear();
+
+private:
+    using SEntryKey = std::pair<const IPositionalStream*, int>;
+
+    struct SEntry
+    {
+        SEntryKey Key;
+        std::weak_ptr<const IPositionalStream> Source;
+        int Length;
+        std::shared_ptr<uint8_t[]> Data;
+    };
+
+    using SEntryList = std::list<SEntry>;
+
+    void EvictToBudget();
+
+    mutable std::mutex m_mutex;
+    SEntryList m_entries; // most recently used first
+    std::map<SEntryKey, SEntryList::iterator> m_index;
+    size_t m_budget;
+    size_t m_resident;
+};
+
 // Out-Of-Core compressed raster block
 class CRasterBlock
 {
 public:
-    int DataOffset;
-    int DataLength;
-    int MaskOffset;
-    int MaskLength;
+    int DataOffset = 0;
+    int DataLength = 0;
+    int MaskOffset = 0;
+    int MaskLength = 0;
+    // File the offsets refer to, null if the raster was not read from a file
+    std::shared_ptr<const IPositionalStream> Source;
 
-    std::shared_ptr<uint8_t[]> GetCompressedData();
+    // The raw DataLength bytes of payload, including any RCS1 header. Null if the
+    // block has no source or the read fails
+    std::shared_ptr<uint8_t[]> GetCompressedData() const;
+    std::shared_ptr<uint8_t[]> GetCompressedData(CRasterBlockCache& cache) const;
 };
 
 struct SRasterImage
@@ -3528,6 +3624,13 @@ public:
     bool ReadCompressedRaster(
         BinaryFileStream& in, std::vector<uint8_t>& out_data, std::optional<SRcs1Data>& out_rcs1) const override;
     bool ReadCompressedMask(BinaryFileStream& in, std::vector<uint8_t>& out_mask) const override;
+    bool ReadCompressedRaster(
+        const BinaryFileStream& in, SByteSpan& out_data, std::optional<SRcs1Data>& out_rcs1) const override;
+    bool ReadCompressedMask(const BinaryFileStream& in, SByteSpan& out_mask) const override;
+    bool ReadCompressedRaster(
+        const IPositionalStream& in, std::vector<uint8_t>& out_data, std::optional<SRcs1Data>& out_rcs1) const override;
+    bool ReadCompressedMask(const IPositionalStream& in, std::vector<uint8_t>& out_mask) const override;
+    bool DecompressMask(const IPositionalStream& in, std::vector<uint8_t>& out_mask) const override;
     bool DecompressMask(BinaryFileStream& in, std::vector<uint8_t>& out_mask) const override;
 
     auto GetHeader() const -> const SBglTerrainRasterQuad1Data& override { return m_header.read(); }
@@ -3536,9 +3639,16 @@ public:
 
     auto GetDataLength() const -> int override { return m_data->DataLength; }
 
+    auto GetMaskOffset() const -> int override { return m_data->MaskOffset; }
+
+    auto GetMaskLength() const -> int override { return m_data->MaskLength; }
+
+    auto GetRasterBlock() const -> const CRasterBlock& { return m_data.read(); }
+
 private:
     std::unique_ptr<uint8_t[]> DecompressData(ERasterCompressionType compression_type, const uint8_t* compressed_data,
         int compressed_size, int uncompressed_size) const;
+    bool DecompressMaskData(const std::vector<uint8_t>& compressed, std::vector<uint8_t>& out_mask) const;
     // Bytes per decoded output pixel for each TRQ1 data type. Used as the
     // output pixel stride by the PTC codec (see DecompressPtc) and by the
     // CalculateLength helper. Must match the actual on-disk / in-memory
@@ -3579,8 +3689,8 @@ private:
         return GetBpp() * Cols() * Rows();
     }
 
-    stlab::copy_on_write<SBglTerrainRasterQuad1Data> m_header;
-    stlab::copy_on_write<CRasterBlock> m_data;
+    CCopyOnWrite<SBglTerrainRasterQuad1Data> m_header;
+    CCopyOnWrite<CRasterBlock> m_data;
 };
 
 class CBglTerrainElevation final : public CTerrainRasterQuad1, public IBglTerrainElevation
@@ -3680,7 +3790,7 @@ public:
     auto SetDaylightSavingsEndDayOfWeek(EStartDayOfWeek value) -> void override;
 
 private:
-    stlab::copy_on_write<SBglTimezoneData> m_data;
+    CCopyOnWrite<SBglTimezoneData> m_data;
 };
 
 } // namespace io
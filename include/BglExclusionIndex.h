@@ -0,0 +1,99 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+#ifndef FLIGHTSIMLIB_IO_BGLEXCLUSIONINDEX_H
+#define FLIGHTSIMLIB_IO_BGLEXCLUSIONINDEX_H
+
+#include "BglFile.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace flightsimlib::io
+{
+
+    // Exclusion rectangles laid out for testing many positions at once. Rectangles are filed
+    // under the one degree cells they overlap, with those that would cover too many cells
+    // kept apart and tested for every position. Within a cell the edges are packed in
+    // blocks, and a position is tested against a whole block at a time
+    class FLIGHTSIMLIB_EXPORTED CBglExclusionIndex
+    {
+      public:
+        using ESceneryObjectType = IBglSceneryObject::ESceneryObjectType;
+
+        // Exclusions are staged by Add and only take part in tests once Build has run
+        auto Add(const IBglExclusion& exclusion) -> void;
+        auto Add(const IBglExclusionLayer& layer) -> void;
+        auto Build() -> void;
+
+        // Exclusions added, built or not
+        [[nodiscard]] auto GetCount() const -> int { return m_count; }
+
+        [[nodiscard]] auto IsExcluded(double latitude, double longitude, ESceneryObjectType type) const -> bool;
+        // Sets bit i % 64 of word i / 64 in excluded for each excluded position, and returns how
+        // many there are. Positions off the globe are never excluded, and edges are as precise
+        // as the packed coordinates of the record
+        auto FilterExcluded(const double* latitudes, const double* longitudes, int count, ESceneryObjectType type,
+            std::vector<uint64_t>& excluded) const -> int;
+
+      private:
+        // Rectangles are tested in blocks of this many, and each cell is padded to a whole
+        // block with rectangles that contain nothing
+        static constexpr int s_block_size = 8;
+        static constexpr int s_columns = 360;
+        static constexpr int s_rows = 180;
+        // Rectangles over more cells than this go to the list tested for every position
+        static constexpr int s_max_cells = 64;
+
+        // Edges in units of the packed coordinates of the record, so the tests are on integers
+        struct SRect
+        {
+            int32_t MinLongitude;
+            int32_t MaxLongitude;
+            int32_t MinLatitude;
+            int32_t MaxLatitude;
+            uint32_t Types;
+        };
+
+        static auto TypeMask(ESceneryObjectType type) -> uint32_t;
+        static auto CellOf(int32_t longitude, int32_t latitude) -> int;
+
+        auto Contains(int first, int end, int32_t longitude, int32_t latitude, uint32_t type) const -> bool;
+
+        int m_count = 0;
+        std::vector<SRect> m_staged;
+        // Start of the rectangles of each cell, then of the list for every position, then the end
+        std::vector<int> m_cell_start;
+        std::vector<int32_t> m_min_longitude;
+        std::vector<int32_t> m_max_longitude;
+        std::vector<int32_t> m_min_latitude;
+        std::vector<int32_t> m_max_latitude;
+        std::vector<uint32_t> m_types;
+    };
+
+} // namespace flightsimlib::io
+
+#endif
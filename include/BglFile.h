@@ -37,13 +37,19 @@
 //******************************************************************************
 
 #include "BinaryStream.h"
+#include "CopyOnWrite.h"
 #include "Export.h"
+#include "Qmid.h"
+#include "RecordArena.h"
 
-#include "../external/stlab/copy_on_write.hpp"
-
+#include <filesystem>
+#include <fstream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 // TODO - this is for the timezone dependency
@@ -200,25 +206,46 @@ namespace flightsimlib
             TimeZone = 0x7
         };
 
-        class CPackedQmid
+        // Options controlling how IBglFile::Read accesses the file
+        enum class EBglReadFlags : uint32_t
         {
-          public:
-            explicit CPackedQmid(uint64_t value) : m_value(value) { }
-
-            explicit CPackedQmid(uint32_t low, uint32_t high) : m_value(static_cast<uint64_t>(high) << 32 | low) { }
-
-            bool operator<(const CPackedQmid& rhs) const noexcept { return this->m_value < rhs.m_value; }
+            None = 0x0,
+            MemoryMapped = 0x1, // Map the file and read records and raster payloads in place
+            IndexOnly = 0x2,    // Read only the layer and tile tables, and decode records on first access
+            Coalesced = 0x4,    // Read the tables first, then all records in one forward sweep of merged reads.
+                                // Has no effect together with IndexOnly
+            Parallel = 0x8      // Read the tables first, then decode contiguous runs of records on a pool of
+                                // worker threads. Takes precedence over Coalesced, no effect with IndexOnly
+        };
 
-            bool operator>(const CPackedQmid& rhs) const noexcept { return this->m_value > rhs.m_value; }
+        constexpr EBglReadFlags operator|(EBglReadFlags lhs, EBglReadFlags rhs)
+        {
+            return static_cast<EBglReadFlags>(static_cast<uint32_t>(lhs) | static_cast<uint32_t>(rhs));
+        }
 
-            uint32_t Low() const { return m_value & 0xFFFFFFFF; }
+        constexpr EBglReadFlags operator&(EBglReadFlags lhs, EBglReadFlags rhs)
+        {
+            return static_cast<EBglReadFlags>(static_cast<uint32_t>(lhs) & static_cast<uint32_t>(rhs));
+        }
 
-            uint32_t High() const { return m_value >> 32; }
+        constexpr bool HasReadFlag(EBglReadFlags flags, EBglReadFlags flag) { return (flags & flag) == flag; }
 
-            uint64_t Value() const { return m_value; }
+        // A record (or tile of records) left pending by CBglLayer::ReadBinaryIndex
+        struct SBglReadExtent
+        {
+            int Offset = 0;
+            int Size = 0;
+            int Item = 0; // Layer defined, handed back to CBglLayer::MaterializeExtent
+        };
 
-          private:
-            uint64_t m_value;
+        // I/O issued against the file by an EBglReadFlags::Coalesced or EBglReadFlags::Parallel read
+        struct SBglReadStatistics
+        {
+            int RecordCount = 0;        // Extents covered by the plan
+            int ReadCount = 0;          // Merged reads, not counting ranges served from a mapping
+            int64_t BytesRequested = 0; // Sum of the planned extents
+            int64_t BytesRead = 0;      // Including the gaps merged between extents
+            int FallbackCount = 0;      // Records left to be read on their own after the sweep
         };
 
         struct SBglLayerPointer
@@ -355,16 +382,21 @@ namespace flightsimlib
             virtual auto AsTacan() -> IBglTacan* = 0;
         };
 
-        class CBglData : public IBglData
+        class CBglData final : public IBglData
         {
           public:
             explicit CBglData(EBglLayerType type, std::unique_ptr<IBglSerializable> data);
 
+            // Like the records they wrap, placed in the arena of a file being read
+            static auto operator new(std::size_t size) -> void* { return CRecordArena::AllocateRecord(size); }
+            static auto operator delete(void* pointer) -> void { CRecordArena::FreeRecord(pointer); }
+
             static std::unique_ptr<CBglData> Factory(
                 EBglLayerType type, IBglSceneryObject::ESceneryObjectType child_type);
             std::unique_ptr<CBglData> Clone() const;
 
-            auto GetType() const -> EBglLayerType override;
+            // Inline so typed traversal can compare it without a virtual call
+            auto GetType() const -> EBglLayerType override { return m_type; }
             auto SetType(EBglLayerType value) -> void override;
             auto AsRasterQuad1() -> ITerrainRasterQuad1* override;
             auto AsAirport() -> IBglAirport* override;
@@ -394,13 +426,131 @@ namespace flightsimlib
             auto CalculateSize() const -> int;
             auto Validate() const -> bool;
             auto ReadBinary(BinaryFileStream& in) -> bool;
+            // Decodes the record occupying [offset, offset + size) without touching any shared cursor
+            auto ReadBinary(const IPositionalStream& in, int offset, int size) -> bool;
             auto WriteBinary(BinaryFileStream& out) -> bool;
 
+            // The concrete record, whose type follows from GetType (see IsBglRecordType)
+            auto GetRecord() const -> IBglSerializable* { return m_data.get(); }
+
           private:
             EBglLayerType m_type = EBglLayerType::None;
             std::unique_ptr<IBglSerializable> m_data;
         };
 
+        // True if records of the given type are instances of the concrete class T, matching
+        // the As*() accessors of CBglData. Used by CBglFile::ForEach
+        template <typename T>
+        constexpr auto IsBglRecordType(EBglLayerType type) -> bool
+        {
+            [[maybe_unused]] const auto in_range = [type](EBglLayerType lower, EBglLayerType upper)
+            { return type >= lower && type <= upper; };
+
+            if constexpr (std::is_same_v<T, CBglAirport>)
+            {
+                return type == EBglLayerType::Airport;
+            }
+            else if constexpr (std::is_same_v<T, CBglNav>)
+            {
+                return type == EBglLayerType::Nav;
+            }
+            else if constexpr (std::is_same_v<T, CBglNdb>)
+            {
+                return type == EBglLayerType::Ndb;
+            }
+            else if constexpr (std::is_same_v<T, CBglMarker>)
+            {
+                return type == EBglLayerType::Marker;
+            }
+            else if constexpr (std::is_same_v<T, CBglBoundary>)
+            {
+                return type == EBglLayerType::Boundary;
+            }
+            else if constexpr (std::is_same_v<T, CBglWaypoint>)
+            {
+                return type == EBglLayerType::Waypoint;
+            }
+            else if constexpr (std::is_same_v<T, CBglGeopol>)
+            {
+                return type == EBglLayerType::Geopol;
+            }
+            else if constexpr (std::is_same_v<T, CBglSceneryObject>)
+            {
+                return type == EBglLayerType::SceneryObject;
+            }
+            else if constexpr (std::is_same_v<T, CBglModelData>)
+            {
+                return type == EBglLayerType::ModelData;
+            }
+            else if constexpr (std::is_same_v<T, CBglAirportSummary>)
+            {
+                return type == EBglLayerType::AirportSummary;
+            }
+            else if constexpr (std::is_same_v<T, CBglTacan>)
+            {
+                return type == EBglLayerType::Tacan;
+            }
+            else if constexpr (std::is_same_v<T, CBglTerrainElevation>)
+            {
+                return type == EBglLayerType::TerrainElevation;
+            }
+            else if constexpr (std::is_same_v<T, CBglTerrainLandClass>)
+            {
+                return type == EBglLayerType::TerrainLandClass;
+            }
+            else if constexpr (std::is_same_v<T, CBglTerrainWaterClass>)
+            {
+                return type == EBglLayerType::TerrainWaterClass;
+            }
+            else if constexpr (std::is_same_v<T, CBglTerrainRegion>)
+            {
+                return type == EBglLayerType::TerrainRegion;
+            }
+            else if constexpr (std::is_same_v<T, CBglPopulationDensity>)
+            {
+                return type == EBglLayerType::PopulationDensity;
+            }
+            else if constexpr (std::is_same_v<T, CBglTerrainIndex>)
+            {
+                return type == EBglLayerType::TerrainIndex;
+            }
+            else if constexpr (std::is_same_v<T, CBglTerrainSeason>)
+            {
+                return in_range(EBglLayerType::TerrainSeasonJan, EBglLayerType::TerrainSeasonDec);
+            }
+            else if constexpr (std::is_same_v<T, CBglTerrainPhoto>)
+            {
+                return in_range(EBglLayerType::TerrainPhotoJan, EBglLayerType::TerrainPhotoNight);
+            }
+            else if constexpr (std::is_same_v<T, CBglTerrainPhoto32>)
+            {
+                return in_range(EBglLayerType::TerrainPhoto32Jan, EBglLayerType::TerrainPhoto32Night);
+            }
+            else if constexpr (std::is_same_v<T, CTerrainRasterQuad1>)
+            {
+                return IsBglRecordType<CBglTerrainElevation>(type) || IsBglRecordType<CBglTerrainLandClass>(type) ||
+                       IsBglRecordType<CBglTerrainWaterClass>(type) || IsBglRecordType<CBglTerrainRegion>(type) ||
+                       IsBglRecordType<CBglPopulationDensity>(type) || IsBglRecordType<CBglTerrainIndex>(type) ||
+                       IsBglRecordType<CBglTerrainSeason>(type) || IsBglRecordType<CBglTerrainPhoto>(type) ||
+                       IsBglRecordType<CBglTerrainPhoto32>(type);
+            }
+            else
+            {
+                static_assert(sizeof(T) == 0, "No layer holds records of this type");
+                return false;
+            }
+        }
+
+        // One record to add to a QMID layer in bulk
+        struct SBglQmidData
+        {
+            CPackedQmid Qmid;
+            const IBglData* Data;
+        };
+
+        // Records moved into a QMID layer in bulk
+        using BglQmidRecords = std::vector<std::pair<CPackedQmid, std::unique_ptr<CBglData>>>;
+
         class IBglIndirectQmidLayer;
         class IBglDirectQmidLayer;
         class IBglNameListLayer;
@@ -434,10 +584,20 @@ namespace flightsimlib
           public:
             virtual auto GetQmidCount() const -> int = 0;
             virtual auto HasQmid(CPackedQmid qmid) const -> bool = 0;
+            // Appends the QMID of each tile between the levels that meets the area. Only the tiles
+            // in the Morton runs covering the area are visited
+            virtual auto QueryRegion(const CQmidQuery& query, int min_level, int max_level,
+                std::vector<CPackedQmid>& qmids) const -> void = 0;
             virtual auto GetDataPointerAtIndex(int index) const -> const SBglTilePointer* = 0;
             virtual auto GetDataCountAtQmid(CPackedQmid qmid) -> int = 0;
+            // The record may be edited through the pointer, so tiles shared with another layer are
+            // copied first. Lookups that only read should go through the const overload
             virtual auto GetDataAtQmid(CPackedQmid qmid, int index) -> IBglData* = 0;
+            virtual auto GetDataAtQmid(CPackedQmid qmid, int index) const -> const IBglData* = 0;
             virtual auto AddDataAtQmid(CPackedQmid qmid, const IBglData* data) -> void = 0;
+            // Clones each record into the tile of its QMID, building the tile tables once. False,
+            // with nothing added, if a tile gaining records was left pending and cannot be decoded
+            virtual auto AddDataAtQmids(const SBglQmidData* data, int count) -> bool = 0;
             virtual auto RemoveQmid(CPackedQmid qmid) -> void = 0;
             virtual auto RemoveDataAtQmid(CPackedQmid qmid, int index) -> void = 0;
         };
@@ -446,13 +606,13 @@ namespace flightsimlib
         /// Standard flow would be:
         /// if (HasQmid(qmid)) // optional
         /// {
-        ///		const auto count = GetDataCountAtQmid(qmid);
-        ///		for (auto i = 0; i < count; ++i)
-        ///		{
-        ///			const auto index = GetDataIndexAtQmid(qmid, i);
-        ///			auto data = GetDataAtIndex(index);
-        ///			// ...
-        ///		}
+        ///     const auto count = GetDataCountAtQmid(qmid);
+        ///     for (auto i = 0; i < count; ++i)
+        ///     {
+        ///         const auto index = GetDataIndexAtQmid(qmid, i);
+        ///         auto data = GetDataAtIndex(index);
+        ///         // ...
+        ///     }
         /// }
         /// </summary>
         class IBglIndirectQmidLayer : virtual public IBglLayer
@@ -460,16 +620,27 @@ namespace flightsimlib
           public:
             virtual auto GetQmidCount() const -> int = 0;
             virtual auto HasQmid(CPackedQmid qmid) const -> bool = 0;
+            // Appends the QMID of each tile between the levels that meets the area. Only the tiles
+            // in the Morton runs covering the area are visited
+            virtual auto QueryRegion(const CQmidQuery& query, int min_level, int max_level,
+                std::vector<CPackedQmid>& qmids) const -> void = 0;
             virtual auto GetDataPointerAtQmid(CPackedQmid qmid) const -> const SBglTilePointer* = 0;
             virtual auto GetDataCountAtQmid(CPackedQmid qmid) const -> int = 0;
             virtual auto GetIndirectPointerCount() const -> int = 0;
             virtual auto GetIndirectPointerAtIndex(int index) const -> const SBglIndirectPointer* = 0;
             virtual auto GetIndirectPointerAtQmid(CPackedQmid qmid, int index) const -> const SBglIndirectPointer* = 0;
             virtual auto GetDataIndexAtQmid(CPackedQmid qmid, int index) const -> int = 0;
+            // Removed records keep their index, and read as null, until Compact
             virtual auto GetDataCount() const -> int = 0;
+            // Null as well if the record was left pending by an index-only read and cannot be decoded
             virtual auto GetDataAtIndex(int index) -> IBglData* = 0;
             virtual auto AddDataAtQmids(CPackedQmid* qmids, int count, const IBglData* data) -> void = 0;
+            // Clones each record into the tile of its QMID, building the tile tables once. Entries
+            // with the same record are stored as one record listed under each of their QMIDs
+            virtual auto AddDataAtQmids(const SBglQmidData* data, int count) -> void = 0;
             virtual auto RemoveDataAtIndex(int index) -> void = 0;
+            // Drops removed records and renumbers the rest, and packs the tile tables
+            virtual auto Compact() -> void = 0;
         };
 
         class IBglNameList;
@@ -501,6 +672,8 @@ namespace flightsimlib
             virtual auto GetDataPointer() const -> const SBglTilePointer* = 0;
             virtual auto GetGuidPointerAt(int index) const -> const SBglGuidPointer* = 0;
             virtual auto HasGuid(_GUID guid) const -> bool = 0;
+            // Null if there is no such record, or if it was left pending by an index-only read and
+            // cannot be decoded
             virtual auto GetData(_GUID guid) const -> const IBglData* = 0;
             virtual auto AddData(_GUID guid, const IBglData* data) -> void = 0;
             virtual auto RemoveData(_GUID guid) -> void = 0;
@@ -514,6 +687,7 @@ namespace flightsimlib
             virtual auto GetExclusionCount() const -> int = 0;
             virtual auto GetDataPointer() const -> const SBglTilePointer* = 0;
             virtual auto GetExclusionAt(int index) -> IBglExclusion* = 0;
+            virtual auto GetExclusionAt(int index) const -> const IBglExclusion* = 0;
             virtual auto AddExclusion(const IBglExclusion* exclusion) -> void = 0;
             virtual auto RemoveExclusion(const IBglExclusion* exclusion) -> void = 0;
         };
@@ -526,6 +700,7 @@ namespace flightsimlib
             virtual auto GetTimeZoneCount() const -> int = 0;
             virtual auto GetDataPointer() const -> const SBglTilePointer* = 0;
             virtual auto GetTimeZoneAt(int index) -> IBglTimeZone* = 0;
+            virtual auto GetTimeZoneAt(int index) const -> const IBglTimeZone* = 0;
             virtual auto AddTimeZone(const IBglTimeZone* timezone) -> void = 0;
             virtual auto RemoveTimeZone(const IBglTimeZone* timezone) -> void = 0;
         };
@@ -554,6 +729,8 @@ namespace flightsimlib
             virtual auto GetFileSize() const -> int = 0;
             virtual auto TryMergeLayer(IBglLayer* layer) -> bool = 0;
             virtual auto RemoveLayer(EBglLayerType type) -> void = 0;
+            virtual auto GetReadFlags() const -> EBglReadFlags = 0;
+            virtual auto SetReadFlags(EBglReadFlags flags) -> void = 0;
 
           protected:
             virtual ~IBglFile() = default;
@@ -569,6 +746,28 @@ namespace flightsimlib
             auto Clone() const { return std::unique_ptr<CBglLayer>(CloneImpl()); }
 
             virtual auto ReadBinary(BinaryFileStream& in) -> bool = 0;
+            // Reads only the pointer tables and keeps the stream to decode records on demand.
+            // Layers that are always small enough to read eagerly just forward to ReadBinary
+            virtual auto ReadBinaryIndex(const std::shared_ptr<BinaryFileStream>& in) -> bool
+            {
+                return ReadBinary(*in);
+            }
+            // Decodes any records still pending from ReadBinaryIndex and releases the stream
+            virtual auto Materialize() -> bool { return true; }
+            // Appends the file extents of the records still pending from ReadBinaryIndex
+            virtual auto GetPendingExtents(std::vector<SBglReadExtent>& /*extents*/) const -> void { }
+            // Decodes one pending record from a window holding its extent. Returns false and
+            // leaves the record pending if it could not be decoded from the window. Safe to call
+            // concurrently for distinct items, each thread with its own window
+            virtual auto MaterializeExtent(BinaryFileStream& /*window*/, int /*item*/) -> bool { return true; }
+            // Decoded records in storage order, or null for layers that do not hold CBglData.
+            // Entries may be null for records of an unknown type
+            virtual auto GetRecords() const -> const std::vector<std::unique_ptr<CBglData>>* { return nullptr; }
+            // Appends the QMID of every tile of the layer, for layers indexed by QMID
+            virtual auto GetTileQmids(std::vector<CPackedQmid>& /*qmids*/) const -> void { }
+            // The arena the records of this layer are read into, for layers whose records can be
+            // shared beyond the lifetime of the file
+            virtual auto SetRecordArena(const std::shared_ptr<CRecordArena>& /*arena*/) -> void { }
             virtual int CalculateSize() const = 0;
             virtual int CalculateDataPointersSize() const = 0;
             virtual bool WriteBinaryPointer(BinaryFileStream& out, int offset_to_tile, int offset_to_layer) = 0;
@@ -591,13 +790,15 @@ namespace flightsimlib
 
             static bool IsTrq1BglLayer(EBglLayerType layer_type);
             static bool IsRcs1BglLayer(EBglLayerType layer_type);
+            // Type of the records of a layer, which differs for layers stored under a reused type
+            static auto GetRecordType(EBglLayerType layer_type) -> EBglLayerType;
 
             static constexpr int CalculateLayerPointerSize() { return 20; }
 
           protected:
             virtual CBglLayer* CloneImpl() const = 0;
 
-            stlab::copy_on_write<SBglLayerPointer> m_layer_pointer;
+            CCopyOnWrite<SBglLayerPointer> m_layer_pointer;
 
           private:
             EBglLayerType m_type;
@@ -610,7 +811,21 @@ namespace flightsimlib
             explicit CBglDirectQmidLayer(const SBglLayerPointer& pointer, EBglLayerType type);
             CBglDirectQmidLayer(const CBglDirectQmidLayer& other);
 
+            // Makes this layer read the tiles of another, for a layer pointer that lists the same table
+            auto ShareTiles(const CBglDirectQmidLayer& other) -> void;
+            auto IsSharingTiles(const CBglDirectQmidLayer& other) const -> bool;
+
             auto ReadBinary(BinaryFileStream& in) -> bool override;
+            auto ReadBinaryIndex(const std::shared_ptr<BinaryFileStream>& in) -> bool override;
+            auto Materialize() -> bool override;
+            auto GetPendingExtents(std::vector<SBglReadExtent>& extents) const -> void override;
+            auto MaterializeExtent(BinaryFileStream& window, int item) -> bool override;
+            auto GetRecords() const -> const std::vector<std::unique_ptr<CBglData>>* override
+            {
+                return &m_store->Records;
+            }
+            auto SetRecordArena(const std::shared_ptr<CRecordArena>& arena) -> void override { m_store->Arena = arena; }
+            auto GetTileQmids(std::vector<CPackedQmid>& qmids) const -> void override;
             auto CalculateSize() const -> int override;
             auto CalculateDataPointersSize() const -> int override;
             auto WriteBinaryPointer(BinaryFileStream& out, int offset_to_tile, int offset_to_layer) -> bool override;
@@ -619,10 +834,17 @@ namespace flightsimlib
 
             auto GetQmidCount() const -> int override;
             auto HasQmid(CPackedQmid qmid) const -> bool override;
+            auto QueryRegion(const CQmidQuery& query, int min_level, int max_level,
+                std::vector<CPackedQmid>& qmids) const -> void override;
             auto GetDataPointerAtIndex(int index) const -> const SBglTilePointer* override;
             auto GetDataCountAtQmid(CPackedQmid qmid) -> int override;
             auto GetDataAtQmid(CPackedQmid qmid, int index) -> IBglData* override;
+            auto GetDataAtQmid(CPackedQmid qmid, int index) const -> const IBglData* override;
             auto AddDataAtQmid(CPackedQmid qmid, const IBglData* data) -> void override;
+            auto AddDataAtQmids(const SBglQmidData* data, int count) -> bool override;
+            // Takes the records instead of cloning them. Records of one QMID keep their order,
+            // after any the tile already holds. Fails as the overload above does
+            auto AddDataAtQmids(BglQmidRecords records) -> bool;
             auto RemoveQmid(CPackedQmid qmid) -> void override;
             auto RemoveDataAtQmid(CPackedQmid qmid, int index) -> void override;
 
@@ -631,8 +853,65 @@ namespace flightsimlib
 
             static auto GetSceneryObjectType(BinaryFileStream& in) -> IBglSceneryObject::ESceneryObjectType;
 
-            std::map<CPackedQmid, std::vector<std::unique_ptr<CBglData>>> m_tiles;
-            std::vector<std::unique_ptr<SBglTilePointer>> m_pointers; // TODO - why pointer?
+            // A run of the records of a tile store
+            struct STileRange
+            {
+                int First = 0;
+                int Count = 0;
+            };
+
+            // Tiles are parallel arrays sorted by QMID, searched through the packed keys alone.
+            // Clones of a layer, and layers listing the same table, share one store until an edit
+            struct STileStore
+            {
+                STileStore() = default;
+                // Deep copy, for a layer that edits a shared store
+                STileStore(const STileStore& other);
+                STileStore(STileStore&&) = delete;
+                STileStore& operator=(const STileStore&) = delete;
+                STileStore& operator=(STileStore&&) = delete;
+                ~STileStore() = default;
+
+                // Index of the tile, or -1
+                auto FindTile(CPackedQmid qmid) const -> int;
+                auto InsertRecords(int tile, std::vector<std::unique_ptr<CBglData>>& records) -> void;
+                auto EraseRecords(int tile, int index, int count) -> void;
+                // The table entries of a QMID that repeats in the table, or an empty range
+                auto FindRepeatedEntries(uint64_t key) const -> std::pair<std::vector<SBglTilePointer>::const_iterator,
+                    std::vector<SBglTilePointer>::const_iterator>;
+
+                // Keeps the memory of records read from a file alive, destroyed after them
+                std::shared_ptr<CRecordArena> Arena;
+                std::vector<uint64_t> Keys;
+                // One per tile. A QMID repeated in the table is one tile counting the records of all its entries
+                std::vector<SBglTilePointer> Pointers;
+                // Every table entry of the QMIDs that repeat in the table, in QMID order, as a pending
+                // tile of such a QMID is decoded from all of them
+                std::vector<SBglTilePointer> RepeatedEntries;
+                std::vector<STileRange> Ranges;
+                std::vector<std::unique_ptr<CBglData>> Records;
+                // Tiles not yet decoded after an index-only read
+                std::vector<bool> Pending;
+                int PendingCount = 0;
+                // Guards the records and pending flags while tiles are decoded in parallel
+                mutable std::mutex PendingMutex;
+                std::shared_ptr<BinaryFileStream> Stream;
+            };
+
+            static auto SortTilePointers(std::vector<SBglTilePointer>& pointers) -> void;
+
+            auto ReadTilePointers(BinaryFileStream& in, std::vector<SBglTilePointer>& pointers) -> bool;
+            auto ReadTile(BinaryFileStream& in, const SBglTilePointer& tile_pointer,
+                std::vector<std::unique_ptr<CBglData>>& data_list) const -> bool;
+            auto ResetTiles(const std::vector<SBglTilePointer>& sorted_pointers, bool pending) -> STileStore&;
+            // The store for an edit, copied first if another layer shares it
+            auto Detach() -> STileStore&;
+            auto LoadTile(CPackedQmid qmid) const -> bool;
+            auto LoadTileAt(int tile) const -> bool;
+
+            std::shared_ptr<STileStore> m_store;
+            // Where WriteBinaryData put each tile, for the table written after all the records
+            std::vector<SBglTilePointer> m_written_pointers;
         };
 
         class CBglIndirectQmidLayer final : public IBglIndirectQmidLayer, public CBglLayer
@@ -642,6 +921,12 @@ namespace flightsimlib
             CBglIndirectQmidLayer(const CBglIndirectQmidLayer& other);
 
             auto ReadBinary(BinaryFileStream& in) -> bool override;
+            auto ReadBinaryIndex(const std::shared_ptr<BinaryFileStream>& in) -> bool override;
+            auto Materialize() -> bool override;
+            auto GetPendingExtents(std::vector<SBglReadExtent>& extents) const -> void override;
+            auto MaterializeExtent(BinaryFileStream& window, int item) -> bool override;
+            auto GetRecords() const -> const std::vector<std::unique_ptr<CBglData>>* override { return &m_data; }
+            auto GetTileQmids(std::vector<CPackedQmid>& qmids) const -> void override;
             auto CalculateSize() const -> int override;
             auto CalculateDataPointersSize() const -> int override;
             auto WriteBinaryPointer(BinaryFileStream& out, int offset_to_tile, int offset_to_layer) -> bool override;
@@ -650,6 +935,8 @@ namespace flightsimlib
 
             auto GetQmidCount() const -> int override;
             auto HasQmid(CPackedQmid qmid) const -> bool override;
+            auto QueryRegion(const CQmidQuery& query, int min_level, int max_level,
+                std::vector<CPackedQmid>& qmids) const -> void override;
             auto GetDataPointerAtQmid(CPackedQmid qmid) const -> const SBglTilePointer* override;
             auto GetDataCountAtQmid(CPackedQmid qmid) const -> int override;
             auto GetIndirectPointerCount() const -> int override;
@@ -659,15 +946,50 @@ namespace flightsimlib
             auto GetDataCount() const -> int override;
             auto GetDataAtIndex(int index) -> IBglData* override;
             auto AddDataAtQmids(CPackedQmid* qmids, int count, const IBglData* data) -> void override;
+            auto AddDataAtQmids(const SBglQmidData* data, int count) -> void override;
+            // Takes the records instead of cloning them, each listed under one QMID
+            auto AddDataAtQmids(BglQmidRecords records) -> void;
             auto RemoveDataAtIndex(int index) -> void override;
+            auto Compact() -> void override;
+
+            auto GetRemovedCount() const -> int { return m_removed_count; }
 
           private:
             auto CloneImpl() const -> CBglLayer* override { return new CBglIndirectQmidLayer(*this); }
 
-            stlab::copy_on_write<std::map<CPackedQmid, SBglTilePointer>> m_tiles;
-            stlab::copy_on_write<std::vector<SBglIndirectPointer>> m_pointers;
-            stlab::copy_on_write<std::vector<int>> m_offsets;
+            // Marks the entry slots of a tile past its live entries
+            static constexpr uint32_t s_free_entry = 0xFFFFFFFF;
+
+            auto ReadIndex(BinaryFileStream& in, std::map<int, int>& offsets_and_sizes) -> bool;
+            auto LoadData(int index) -> bool;
+            // Index of the tile, or -1. Tiles emptied by removals are still found until Compact
+            auto FindTile(CPackedQmid qmid) const -> int;
+            // Lists records already in m_data under tiles, as (QMID, record index) pairs
+            auto AddTileEntries(std::vector<std::pair<CPackedQmid, int>>& entries) -> void;
+            auto BuildRecordTiles() -> void;
+
+            // Tiles are compressed sparse rows over the entry slots. Keys are sorted, and tile i owns
+            // the slots from its StreamOffset up to the StreamOffset of tile i + 1. The first
+            // RecordCount slots are live, the rest were freed by removals
+            CCopyOnWrite<std::vector<uint64_t>> m_keys;
+            CCopyOnWrite<std::vector<SBglTilePointer>> m_tiles;
+            // Per entry slot, the index of the record it lists and the pointer to that record
+            CCopyOnWrite<std::vector<uint32_t>> m_entries;
+            CCopyOnWrite<std::vector<SBglIndirectPointer>> m_pointers;
             std::vector<std::unique_ptr<CBglData>> m_data; // TODO - cow doesn't work here
+            // Removed records are tombstones, with a null slot in m_data, until Compact
+            std::vector<bool> m_removed;
+            int m_removed_count = 0;
+            int m_live_tile_count = 0;
+            // The tiles listing each record, as rows over m_record_tiles. Built by the first removal
+            // after the tiles change, since removals only move entries within their tile
+            std::vector<uint32_t> m_record_rows;
+            std::vector<uint32_t> m_record_tiles;
+            // Stream offset of each record not yet decoded after an index-only read, otherwise -1,
+            // and the size the index gives for it
+            std::vector<int> m_pending_offsets;
+            std::vector<int> m_pending_sizes;
+            std::shared_ptr<BinaryFileStream> m_stream;
         };
 
         class CBglNameListLayer : public IBglNameListLayer, public CBglLayer
@@ -695,6 +1017,11 @@ namespace flightsimlib
             CBglGuidLayer(const CBglGuidLayer& other);
 
             auto ReadBinary(BinaryFileStream& in) -> bool override;
+            auto ReadBinaryIndex(const std::shared_ptr<BinaryFileStream>& in) -> bool override;
+            auto Materialize() -> bool override;
+            auto GetPendingExtents(std::vector<SBglReadExtent>& extents) const -> void override;
+            auto MaterializeExtent(BinaryFileStream& window, int item) -> bool override;
+            auto GetRecords() const -> const std::vector<std::unique_ptr<CBglData>>* override { return &m_data; }
             auto CalculateSize() const -> int override;
             auto CalculateDataPointersSize() const -> int override;
             auto WriteBinaryPointer(BinaryFileStream& out, int offset_to_tile, int offset_to_layer) -> bool override;
@@ -712,11 +1039,17 @@ namespace flightsimlib
           private:
             auto CloneImpl() const -> CBglLayer* override { return new CBglGuidLayer(*this); }
 
-            stlab::copy_on_write<SBglTilePointer> m_pointer;
+            auto ReadIndex(BinaryFileStream& in) -> bool;
+            auto LoadData(int index) const -> bool;
+
+            CCopyOnWrite<SBglTilePointer> m_pointer;
             std::map<_GUID, int, GUIDComparer> m_offsets;
             // TODO: would a pair / tuple in a single vector make more sense here?
-            stlab::copy_on_write<std::vector<SBglGuidPointer>> m_guids;
-            std::vector<std::unique_ptr<CBglData>> m_data; // TODO - cow doesn't work here
+            CCopyOnWrite<std::vector<SBglGuidPointer>> m_guids;
+            // Mutable so the const lookups can decode records left pending by an index-only read
+            mutable std::vector<std::unique_ptr<CBglData>> m_data; // TODO - cow doesn't work here
+            mutable std::vector<int> m_pending_offsets;
+            std::shared_ptr<BinaryFileStream> m_stream;
         };
 
         class CBglExclusionLayer final : public IBglExclusionLayer, public CBglLayer
@@ -735,14 +1068,15 @@ namespace flightsimlib
             auto GetExclusionCount() const -> int override;
             auto GetDataPointer() const -> const SBglTilePointer* override;
             auto GetExclusionAt(int index) -> IBglExclusion* override;
+            auto GetExclusionAt(int index) const -> const IBglExclusion* override;
             auto AddExclusion(const IBglExclusion* exclusion) -> void override;
             auto RemoveExclusion(const IBglExclusion* exclusion) -> void override;
 
           private:
             auto CloneImpl() const -> CBglLayer* override { return new CBglExclusionLayer(*this); }
 
-            stlab::copy_on_write<SBglTilePointer> m_pointer;
-            stlab::copy_on_write<std::vector<CBglExclusion>> m_exclusions;
+            CCopyOnWrite<SBglTilePointer> m_pointer;
+            CCopyOnWrite<std::vector<CBglExclusion>> m_exclusions;
         };
 
         class CBglTimeZoneLayer final : public IBglTimeZoneLayer, public CBglLayer
@@ -761,14 +1095,15 @@ namespace flightsimlib
             auto GetTimeZoneCount() const -> int override;
             auto GetDataPointer() const -> const SBglTilePointer* override;
             auto GetTimeZoneAt(int index) -> IBglTimeZone* override;
+            auto GetTimeZoneAt(int index) const -> const IBglTimeZone* override;
             auto AddTimeZone(const IBglTimeZone* timezone) -> void override;
             auto RemoveTimeZone(const IBglTimeZone* timezone) -> void override;
 
           private:
             auto CloneImpl() const -> CBglLayer* override { return new CBglTimeZoneLayer(*this); }
 
-            stlab::copy_on_write<SBglTilePointer> m_pointer;
-            stlab::copy_on_write<std::vector<CBglTimeZone>> m_timezones;
+            CCopyOnWrite<SBglTilePointer> m_pointer;
+            CCopyOnWrite<std::vector<CBglTimeZone>> m_timezones;
         };
 
         struct SBglHeader
@@ -807,6 +1142,41 @@ namespace flightsimlib
             }
         };
 
+        // Gathers the pending records of every layer, merges their extents in file order and
+        // decodes them from one forward sweep of large reads
+        class CBglReadPlanner
+        {
+          public:
+            // Skipping a gap this small is cheaper than issuing another read
+            static constexpr int s_default_merge_gap = 64 * 1024;
+            // Upper bound for a merged read, and so for the planner's buffer
+            static constexpr int s_default_max_read = 8 * 1024 * 1024;
+
+            explicit CBglReadPlanner(int merge_gap = s_default_merge_gap, int max_read = s_default_max_read);
+
+            auto AddLayer(CBglLayer& layer) -> void;
+            auto AddExtent(CBglLayer& layer, const SBglReadExtent& extent) -> void;
+            // Raster blocks decoded during the sweep load their payloads from payload_source,
+            // and names are interned into string_pool
+            auto Execute(const IPositionalStream& source,
+                const std::shared_ptr<const IPositionalStream>& payload_source,
+                const std::shared_ptr<CStringPool>& string_pool) -> bool;
+
+            auto GetStatistics() const -> const SBglReadStatistics& { return m_statistics; }
+
+          private:
+            struct SPlannedExtent
+            {
+                SBglReadExtent Extent;
+                CBglLayer* Layer;
+            };
+
+            std::vector<SPlannedExtent> m_extents;
+            int m_merge_gap;
+            int m_max_read;
+            SBglReadStatistics m_statistics;
+        };
+
         class FLIGHTSIMLIB_EXPORTED CBglFile final : IBglFile
         {
           public:
@@ -839,14 +1209,89 @@ namespace flightsimlib
             auto GetFileSize() const -> int override;
             auto TryMergeLayer(IBglLayer* layer) -> bool override;
             auto RemoveLayer(EBglLayerType type) -> void override;
+            auto GetReadFlags() const -> EBglReadFlags override;
+            auto SetReadFlags(EBglReadFlags flags) -> void override;
+
+            // Valid while the file is open in EBglReadFlags::MemoryMapped mode
+            auto GetStream() const -> const BinaryFileStream& { return *m_stream; }
+
+            auto GetHeader() const -> const SBglHeader& { return m_header; }
+
+            // Reads and checks only the fixed size header of a file, which is opened read-only
+            static auto PeekHeader(const std::filesystem::path& file_name, SBglHeader& header) -> bool;
+            // False only when the parent QMIDs of the header show that no tile lies in the region.
+            // Headers written without parent QMIDs may touch any region
+            static auto IntersectsRegion(const SBglHeader& header, const SBglRegion& region) -> bool;
+            // Decides from the header alone whether the file may hold data in the region, so a
+            // scenery library can be culled without parsing layers. False if the header is invalid
+            static auto IntersectsRegion(const std::filesystem::path& file_name, const SBglRegion& region) -> bool;
+
+            // Filled in by the last EBglReadFlags::Coalesced or EBglReadFlags::Parallel read
+            auto GetReadStatistics() const -> const SBglReadStatistics& { return m_read_statistics; }
+
+            // Calls fn(const T&) for every record of the concrete type T, e.g. ForEach<CBglNav>. Layers are
+            // matched on their type once, so the loop over their records is a plain cast rather than
+            // a probe of the As*() accessors. Pending records are decoded first, and records are
+            // visited in storage order. Returns the number of records visited, or -1 if the pending
+            // records of a layer could not be decoded
+            template <typename T, typename TFunction>
+            auto ForEach(TFunction&& fn) -> int
+            {
+                auto count = 0;
+                for (const auto& layer : m_layers)
+                {
+                    if (layer == nullptr)
+                    {
+                        continue;
+                    }
+                    const auto record_type = CBglLayer::GetRecordType(layer->GetType());
+                    if (!IsBglRecordType<T>(record_type))
+                    {
+                        continue;
+                    }
+                    if (!layer->Materialize())
+                    {
+                        return -1;
+                    }
+                    const auto* records = layer->GetRecords();
+                    if (records == nullptr)
+                    {
+                        continue;
+                    }
+                    for (const auto& record : *records)
+                    {
+                        // Edits can add records of another type to a layer
+                        if (record != nullptr && record->GetType() == record_type)
+                        {
+                            fn(*static_cast<const T*>(record->GetRecord()));
+                            ++count;
+                        }
+                    }
+                }
+                return count;
+            }
+
+            // Worker threads used by EBglReadFlags::Parallel. Zero picks one per hardware thread
+            auto GetReadThreadCount() const -> int { return m_read_thread_count; }
+            auto SetReadThreadCount(int count) -> void { m_read_thread_count = count; }
 
           private:
             bool ReadAllLayers();
-            bool WriteAllLayers();
+            bool ReadPlannedRecords();
+            bool ReadParallelRecords();
+            // A direct layer already read whose tile table is the one in the pointer, or null
+            static auto FindTileSource(const std::vector<const CBglLayer*>& layers, const SBglLayerPointer& pointer)
+                -> const CBglDirectQmidLayer*;
+            bool WriteAllLayers(BinaryFileStream& out);
             bool ReadHeader();
-            bool WriteHeader();
+            bool WriteHeader(BinaryFileStream& out);
+            int CalculateFileSize() const;
             bool BuildHeader();
             bool ComputeHeaderQmids();
+            static auto IsValidHeader(const SBglHeader& header) -> bool;
+            // Sets the parent QMIDs to the cells at the deepest level where at most eight of them
+            // cover all of the QMIDs
+            static auto SetHeaderQmids(SBglHeader& header, const std::vector<CPackedQmid>& qmids) -> void;
 
             static constexpr uint16_t Version()
             {
@@ -863,9 +1308,81 @@ namespace flightsimlib
             int m_file_size;
             SBglHeader m_header;
             bool m_dirty;
+            EBglReadFlags m_read_flags;
+            SBglReadStatistics m_read_statistics;
+            int m_read_thread_count;
+            // Holds the records decoded by Read. Declared ahead of the layers so it outlives them,
+            // and also kept by tile stores that other files share
+            std::shared_ptr<CRecordArena> m_arena;
             std::vector<std::unique_ptr<CBglLayer>> m_layers;
             std::map<EBglLayerType, int> m_layer_offsets;
-            BinaryFileStream m_stream;
+            // Shared with layers that decode records on demand (EBglReadFlags::IndexOnly)
+            std::shared_ptr<BinaryFileStream> m_stream;
+
+            friend class CBglStreamWriter;
+            friend class CBglCatalog;
+        };
+
+        // Builds a BGL from records appended one at a time, for files too large to hold as
+        // CBglData. Record bytes are spilled to a scratch file next to the target as they
+        // arrive, so memory is bounded by the tile tables rather than by the data. Only
+        // direct QMID layers (terrain rasters, scenery objects, ...) can be written this way
+        class FLIGHTSIMLIB_EXPORTED CBglStreamWriter
+        {
+          public:
+            CBglStreamWriter() = default;
+            // Discards the scratch file of a writer that was never finalized
+            ~CBglStreamWriter();
+            // copying not allowed
+            CBglStreamWriter(const CBglStreamWriter&) = delete;
+            CBglStreamWriter& operator=(const CBglStreamWriter&) = delete;
+
+            auto Open(const std::filesystem::path& file_name) -> bool;
+            // Data is one or more complete serialized records. Records of the same tile may
+            // arrive in any order relative to other tiles, and keep their relative order
+            auto AppendRecord(EBglLayerType type, CPackedQmid qmid, const uint8_t* data, int size) -> bool;
+            auto AppendRecord(CPackedQmid qmid, CBglData& data) -> bool;
+            // Writes the header, layer pointers and tile tables, copies the spilled records in
+            // tile order and then swaps the result in for the target
+            auto Finalize() -> bool;
+            // Drops everything appended so far and removes the scratch file
+            auto Abort() -> void;
+
+            auto IsOpen() const -> bool { return m_spill.is_open(); }
+            auto GetLayerCount() const -> int { return static_cast<int>(m_layers.size()); }
+            auto GetRecordCount() const -> int64_t { return m_record_count; }
+            auto GetSpilledBytes() const -> int64_t { return m_spill_size; }
+
+          private:
+            struct SSpillExtent
+            {
+                int64_t Offset;
+                int64_t Size;
+            };
+
+            struct STile
+            {
+                uint32_t RecordCount = 0;
+                int64_t SizeBytes = 0;
+                // Consecutive appends to one tile share an extent
+                std::vector<SSpillExtent> Extents;
+            };
+
+            struct SLayer
+            {
+                EBglLayerType Type;
+                std::map<CPackedQmid, STile> Tiles;
+            };
+
+            auto CopySpilledTile(const STile& tile, std::ofstream& out, std::vector<char>& buffer) -> bool;
+
+            std::filesystem::path m_file_name;
+            std::filesystem::path m_spill_name;
+            std::fstream m_spill;
+            int64_t m_spill_size = 0;
+            int64_t m_record_count = 0;
+            std::vector<SLayer> m_layers;
+            std::map<EBglLayerType, int> m_layer_offsets;
         };
 
     } // namespace io
@@ -0,0 +1,124 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+#ifndef FLIGHTSIMLIB_IO_BGLSPATIALINDEX_H
+#define FLIGHTSIMLIB_IO_BGLSPATIALINDEX_H
+
+#include "BglFile.h"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace flightsimlib::io
+{
+
+    // A positioned record: an airport, airport summary, VOR, NDB, TACAN, marker, waypoint or
+    // scenery object
+    struct SBglSpatialItem
+    {
+        EBglLayerType Type = EBglLayerType::None;
+        int FileIndex = -1;   // Position of the file in the list the index was built from
+        int RecordIndex = -1; // Among the records of its type in the file, in CBglFile::ForEach order
+        uint32_t Icao = 0;    // Packed ident, zero for scenery objects
+        double Latitude = 0.0;
+        double Longitude = 0.0;
+    };
+
+    struct SBglSpatialMatch
+    {
+        int Item = -1;
+        double Distance = 0.0; // Great circle, in metres
+    };
+
+    // Static tree of bounding boxes over the positions of records, built once and then only
+    // read, so any number of threads may query it. Positions are kept as unit vectors, which
+    // turns great circle order into straight line order and leaves no seam at the antimeridian
+    // or the poles. Each node knows the record types below it, so filtered queries skip
+    // whole subtrees
+    class FLIGHTSIMLIB_EXPORTED CBglSpatialIndex
+    {
+      public:
+        static constexpr int s_leaf_size = 16;
+        static constexpr uint64_t s_all_types = ~0ull;
+
+        // Types to match in a query, combined with |
+        static constexpr auto TypeMask(EBglLayerType type) -> uint64_t
+        {
+            const auto value = static_cast<uint32_t>(type);
+            return value < 64 ? 1ull << value : 0;
+        }
+
+        // Replaces the contents with the records of one file, as file 0
+        auto Build(CBglFile& file) -> void;
+        // Replaces the contents with the records of the files, read on a pool of threads. Zero
+        // threads picks one per hardware thread. Files that cannot be read are left out, and
+        // make the result false
+        auto Build(const std::vector<std::filesystem::path>& files, int num_threads = 0) -> bool;
+
+        [[nodiscard]] auto GetCount() const -> int { return static_cast<int>(m_items.size()); }
+        [[nodiscard]] auto GetItemAt(int index) const -> const SBglSpatialItem& { return m_items[index]; }
+
+        // The count items of the given types nearest to the point, nearest first
+        auto FindNearest(double latitude, double longitude, int count, std::vector<SBglSpatialMatch>& matches,
+            uint64_t types = s_all_types) const -> void;
+        // Every item of the given types within the radius, in metres, nearest first
+        auto FindWithinRadius(double latitude, double longitude, double radius,
+            std::vector<SBglSpatialMatch>& matches, uint64_t types = s_all_types) const -> void;
+
+      private:
+        struct SNode
+        {
+            std::array<double, 3> Min;
+            std::array<double, 3> Max;
+            uint64_t Types;
+            int First;
+            int End;
+            int Right; // The first child follows its parent. -1 for a leaf
+        };
+
+        static auto CollectFile(CBglFile& file, int file_index, std::vector<SBglSpatialItem>& items) -> void;
+        static auto NodeCount(int count) -> int;
+
+        auto BuildTree(std::vector<SBglSpatialItem> items, int num_threads) -> void;
+        auto BuildNode(int node, int first, int end, int parallel_depth) -> void;
+        // Squared chord from the point to the nearest point of the node box
+        auto NodeDistance(const SNode& node, const std::array<double, 3>& point) const -> double;
+
+        std::vector<SBglSpatialItem> m_items;
+        // Unit vectors of the items, in item order
+        std::vector<double> m_x;
+        std::vector<double> m_y;
+        std::vector<double> m_z;
+        std::vector<SNode> m_nodes;
+        // Item order while the tree is built
+        std::vector<int> m_order;
+    };
+
+} // namespace flightsimlib::io
+
+#endif
@@ -740,12 +740,15 @@ public:
 	virtual auto GetStartDeleteCount() const -> int = 0;
 	virtual auto GetComDeleteCount() const -> int = 0;
 	virtual auto GetRunwayDeleteAt(int index) -> IBglRunwayDelete* = 0;
+	virtual auto GetRunwayDeleteAt(int index) const -> const IBglRunwayDelete* = 0;
 	virtual auto AddRunwayDelete(const IBglRunwayDelete* runway) -> void = 0;
 	virtual auto RemoveRunwayDelete(const IBglRunwayDelete* runway) -> void = 0;
 	virtual auto GetStartDeleteAt(int index) -> IBglStartDelete* = 0;
+	virtual auto GetStartDeleteAt(int index) const -> const IBglStartDelete* = 0;
 	virtual auto AddStartDelete(const IBglStartDelete* start) -> void = 0;
 	virtual auto RemoveStartDelete(const IBglStartDelete* start) -> void = 0;
 	virtual auto GetComDeleteAt(int index) -> IBglComDelete* = 0;
+	virtual auto GetComDeleteAt(int index) const -> const IBglComDelete* = 0;
 	virtual auto AddComDelete(const IBglComDelete* com) -> void = 0;
 	virtual auto RemoveComDelete(const IBglComDelete* com) -> void = 0;
 };
@@ -763,9 +766,11 @@ public:
 	virtual auto GetMaxAltitude() const -> float = 0;
 	virtual auto SetMaxAltitude(float value) -> void = 0;
 	virtual auto GetVertexAt(int index) -> SBglVertexLL* = 0;
+	virtual auto GetVertexAt(int index) const -> const SBglVertexLL* = 0;
 	virtual auto AddVertex(const SBglVertexLL* vertex) -> void = 0;
 	virtual auto RemoveVertex(const SBglVertexLL* vertex) -> void = 0;
 	virtual auto GetEdgeAt(int index) -> SBglEdge* = 0;
+	virtual auto GetEdgeAt(int index) const -> const SBglEdge* = 0;
 	virtual auto AddEdge(const SBglEdge* edge) -> void = 0;
 	virtual auto RemoveEdge(const SBglEdge* edge) -> void = 0;
 };
@@ -778,6 +783,7 @@ public:
 	virtual auto SetSurfaceType(ESurfaceType value) -> void = 0;
 	virtual auto GetVertexCount() const -> int = 0;
 	virtual auto GetVertexAt(int index) -> SBglVertexLL* = 0;
+	virtual auto GetVertexAt(int index) const -> const SBglVertexLL* = 0;
 	virtual auto AddVertex(const SBglVertexLL* vertex) -> void = 0;
 	virtual auto RemoveVertex(const SBglVertexLL* vertex) -> void = 0;
 };
@@ -795,9 +801,11 @@ public:
 	virtual auto GetVertexCount() const -> int = 0;
 	virtual auto GetIndexCount() const -> int = 0;
 	virtual auto GetVertexAt(int index) -> SBglVertexLL* = 0;
+	virtual auto GetVertexAt(int index) const -> const SBglVertexLL* = 0;
 	virtual auto AddVertex(const SBglVertexLL* vertex) -> void = 0;
 	virtual auto RemoveVertex(const SBglVertexLL* vertex) -> void = 0;
 	virtual auto GetIndexAt(int index) -> SBglIndex* = 0;
+	virtual auto GetIndexAt(int index) const -> const SBglIndex* = 0;
 	virtual auto AddIndex(const SBglIndex* index) -> void = 0;
 	virtual auto RemoveIndex(const SBglIndex* index) -> void = 0;
 };
@@ -828,6 +836,7 @@ public:
 	virtual auto GetOrientation() const -> EOrientation = 0;
 	virtual auto SetOrientation(EOrientation value) -> void = 0;
 	virtual auto GetVertex() -> SBglVertexLL* = 0;
+	virtual auto GetVertex() const -> const SBglVertexLL* = 0;
 	virtual auto SetVertex(SBglVertexLL* vertex) -> void = 0;
 };
 	
@@ -837,6 +846,7 @@ class IBglTaxiwayPoints
 public:
 	virtual auto GetPointCount() const -> int = 0;
 	virtual auto GetPointAt(int index) -> IBglTaxiwayPoint* = 0;
+	virtual auto GetPointAt(int index) const -> const IBglTaxiwayPoint* = 0;
 	virtual auto AddPoint(const IBglTaxiwayPoint* point) -> void = 0;
 	virtual auto RemovePoint(const IBglTaxiwayPoint* point) -> void = 0;
 };
@@ -946,6 +956,7 @@ class IBglTaxiwayParkings
 public:
 	virtual auto GetParkingCount() const -> int = 0;
 	virtual auto GetParkingAt(int index) -> IBglTaxiwayParking* = 0;
+	virtual auto GetParkingAt(int index) const -> const IBglTaxiwayParking* = 0;
 	virtual auto AddParking(const IBglTaxiwayParking* parking) -> void = 0;
 	virtual auto RemoveParking(const IBglTaxiwayParking* parking) -> void = 0;
 };
@@ -1014,6 +1025,7 @@ class IBglTaxiwayPaths
 public:
 	virtual auto GetPathCount() const -> int = 0;
 	virtual auto GetPathAt(int index) -> IBglTaxiwayPath* = 0;
+	virtual auto GetPathAt(int index) const -> const IBglTaxiwayPath* = 0;
 	virtual auto AddPath(const IBglTaxiwayPath* path) -> void = 0;
 	virtual auto RemovePath(const IBglTaxiwayPath* path) -> void = 0;
 };
@@ -1164,6 +1176,7 @@ class IBglLegs
 public:
 	virtual auto GetLegCount() const -> int = 0;
 	virtual auto GetLegAt(int index) -> IBglLeg* = 0;
+	virtual auto GetLegAt(int index) const -> const IBglLeg* = 0;
 	virtual auto AddLeg(const IBglLeg* leg) -> void = 0;
 	virtual auto RemoveLeg(const IBglLeg* leg) -> void = 0;
 };
@@ -1209,8 +1222,10 @@ public:
 	virtual auto GetAltitude() const -> float = 0;
 	virtual auto SetAltitude(float value) -> void = 0;
 	virtual auto GetDmeArc() -> IBglDmeArc* = 0;
+	virtual auto GetDmeArc() const -> const IBglDmeArc* = 0;
 	virtual auto SetDmeArc(IBglDmeArc* value) -> void = 0;
 	virtual auto GetTransitionLegs() -> IBglLegs* = 0;
+	virtual auto GetTransitionLegs() const -> const IBglLegs* = 0;
 	virtual auto SetTransitionLegs(IBglLegs* value) -> void = 0;
 };
 	
@@ -1262,10 +1277,13 @@ public:
 	virtual auto GetApproachLegCount() const -> int = 0;
 	virtual auto GetMissedApproachLegCount() const -> int = 0;
 	virtual auto GetApproachLegs() -> IBglLegs* = 0;
+	virtual auto GetApproachLegs() const -> const IBglLegs* = 0;
 	virtual auto SetApproachLegs(IBglLegs* value) -> void = 0;
 	virtual auto GetMissedApproachLegs() -> IBglLegs* = 0;
+	virtual auto GetMissedApproachLegs() const -> const IBglLegs* = 0;
 	virtual auto SetMissedApproachLegs(IBglLegs* value) -> void = 0;
 	virtual auto GetTransitionAt(int index) -> IBglTransition* = 0;
+	virtual auto GetTransitionAt(int index) const -> const IBglTransition* = 0;
 	virtual auto AddTransition(const IBglTransition* transition) -> void = 0;
 	virtual auto RemoveTransition(const IBglTransition* transition) -> void = 0;
 };
@@ -1288,6 +1306,7 @@ public:
 	virtual auto GetProfile() const -> _GUID = 0;
 	virtual auto SetProfile(_GUID value) -> void = 0;
 	virtual auto GetVertexAt(int index) -> SBglVertexLL* = 0;
+	virtual auto GetVertexAt(int index) const -> const SBglVertexLL* = 0;
 	virtual auto AddVertex(const SBglVertexLL* vertex) -> void = 0;
 	virtual auto RemoveVertex(const SBglVertexLL* vertex) -> void = 0;
 };
@@ -1321,48 +1340,64 @@ public:
 	virtual auto SetTrafficScalar(float value) -> void = 0;
 
 	virtual auto GetRunwayAt(int index) -> IBglRunway* = 0;
+	virtual auto GetRunwayAt(int index) const -> const IBglRunway* = 0;
 	virtual auto AddRunway(const IBglRunway* runway) -> void = 0;
 	virtual auto RemoveRunway(const IBglRunway* runway) -> void = 0;
 	virtual auto GetStartAt(int index) -> IBglStart* = 0;
+	virtual auto GetStartAt(int index) const -> const IBglStart* = 0;
 	virtual auto AddStart(const IBglStart* start) -> void = 0;
 	virtual auto RemoveStart(const IBglStart* start) -> void = 0;
 	virtual auto GetComAt(int index) -> IBglCom* = 0;
+	virtual auto GetComAt(int index) const -> const IBglCom* = 0;
 	virtual auto AddCom(const IBglCom* com) -> void = 0;
 	virtual auto RemoveCom(const IBglCom* com) -> void = 0;
 	virtual auto GetHelipadAt(int index) -> IBglHelipad* = 0;
+	virtual auto GetHelipadAt(int index) const -> const IBglHelipad* = 0;
 	virtual auto AddHelipad(const IBglHelipad* helipad) -> void = 0;
 	virtual auto RemoveHelipad(const IBglHelipad* helipad) -> void = 0;
 	virtual auto GetDelete() -> IBglAirportDelete* = 0;
+	virtual auto GetDelete() const -> const IBglAirportDelete* = 0;
 	virtual auto SetDelete(IBglAirportDelete* value) -> void = 0;
 	virtual auto GetApronEdgeLights() -> IBglApronEdgeLights* = 0;
+	virtual auto GetApronEdgeLights() const -> const IBglApronEdgeLights* = 0;
 	virtual auto SetApronEdgeLights(IBglApronEdgeLights* value) -> void = 0;
 	virtual auto GetApronAt(int index) -> IBglApron* = 0; // TODO - should these be collapsed
+	virtual auto GetApronAt(int index) const -> const IBglApron* = 0;
 	virtual auto AddApron(const IBglApron* apron) -> void = 0; // into a single apron interface? 
 	virtual auto RemoveApron(const IBglApron* apron) -> void = 0; // AddApron(apron, polygons) 
 	virtual auto GetApronPolygonsAt(int index) -> IBglApronPolygons* = 0;
+	virtual auto GetApronPolygonsAt(int index) const -> const IBglApronPolygons* = 0;
 	virtual auto AddApronPolygons(const IBglApronPolygons* polygons) -> void = 0;
 	virtual auto RemoveApronPolygons(const IBglApronPolygons* polygons) -> void = 0;
 	virtual auto GetTaxiwayPoints() -> IBglTaxiwayPoints* = 0;
+	virtual auto GetTaxiwayPoints() const -> const IBglTaxiwayPoints* = 0;
 	virtual auto SetTaxiwayPoints(IBglTaxiwayPoints* value) -> void = 0;
 	virtual auto GetTaxiwayParkings() -> IBglTaxiwayParkings* = 0;
+	virtual auto GetTaxiwayParkings() const -> const IBglTaxiwayParkings* = 0;
 	virtual auto SetTaxiwayParkings(IBglTaxiwayParkings* value) -> void = 0;
 	virtual auto GetTaxiwayPaths() -> IBglTaxiwayPaths* = 0;
+	virtual auto GetTaxiwayPaths() const -> const IBglTaxiwayPaths* = 0;
 	virtual auto SetTaxiwayPaths(IBglTaxiwayPaths* value) -> void = 0;
 	virtual auto GetTaxiwayNames() -> IBglTaxiwayNames* = 0;
+	virtual auto GetTaxiwayNames() const -> const IBglTaxiwayNames* = 0;
 	virtual auto SetTaxiwayNames(IBglTaxiwayNames* value) -> void = 0;
 	virtual auto GetJetwayCount() const -> int = 0;
 	virtual auto GetJetwayAt(int index) -> IBglJetway* = 0;
+	virtual auto GetJetwayAt(int index) const -> const IBglJetway* = 0;
 	virtual auto AddJetway(const IBglJetway* jetway) -> void = 0;
 	virtual auto RemoveJetway(const IBglJetway* jetway) -> void = 0;
 	virtual auto GetApproachAt(int index)->IBglApproach* = 0;
+	virtual auto GetApproachAt(int index) const -> const IBglApproach* = 0;
 	virtual auto AddApproach(const IBglApproach* approach) -> void = 0;
 	virtual auto RemoveApproach(const IBglApproach* approach) -> void = 0;
 	virtual auto GetBlastFenceCount() const -> int = 0;
 	virtual auto GetBlastFenceAt(int index) -> IBglFence* = 0;
+	virtual auto GetBlastFenceAt(int index) const -> const IBglFence* = 0;
 	virtual auto AddBlastFence(const IBglFence* fence) -> void = 0;
 	virtual auto RemoveBlastFence(const IBglFence* fence) -> void = 0;
 	virtual auto GetBoundaryFenceCount() const -> int = 0;
 	virtual auto GetBoundaryFenceAt(int index) -> IBglFence* = 0;
+	virtual auto GetBoundaryFenceAt(int index) const -> const IBglFence* = 0;
 	virtual auto AddBoundaryFence(const IBglFence* fence) -> void = 0;
 	virtual auto RemoveBoundaryFence(const IBglFence* fence) -> void = 0;
 };
@@ -1489,6 +1524,7 @@ public:
 	virtual auto GetIcaoAirport() const -> uint32_t = 0;
 	virtual auto SetIcaoAirport(uint32_t value) -> void = 0;
 	virtual auto GetRouteAt(int index) -> IBglRoute* = 0;
+	virtual auto GetRouteAt(int index) const -> const IBglRoute* = 0;
 	virtual auto AddRoute(const IBglRoute* route) -> void = 0;
 	virtual auto RemoveRoute(const IBglRoute* route) -> void = 0;
 };
@@ -1564,10 +1600,13 @@ public:
 	virtual auto GetIcaoAirport() const -> uint32_t = 0;
 	virtual auto SetIcaoAirport(uint32_t value) -> void = 0;
 	virtual auto GetLocalizer() -> IBglLocalizer* = 0;
+	virtual auto GetLocalizer() const -> const IBglLocalizer* = 0;
 	virtual auto SetLocalizer(IBglLocalizer* value) -> void = 0;
 	virtual auto GetGlideSlope() -> IBglGlideSlope* = 0;
+	virtual auto GetGlideSlope() const -> const IBglGlideSlope* = 0;
 	virtual auto SetGlideSlope(IBglGlideSlope* value) -> void = 0;
 	virtual auto GetDmeRecord() -> IBglDme* = 0;
+	virtual auto GetDmeRecord() const -> const IBglDme* = 0;
 	virtual auto SetDmeRecord(IBglDme* value) -> void = 0;
 };
 
@@ -1592,6 +1631,7 @@ public:
 	virtual auto GetIcaoAirport() const -> uint32_t = 0;
 	virtual auto SetIcaoAirport(uint32_t value) -> void = 0;
 	virtual auto GetDmeRecord() -> IBglDme* = 0;
+	virtual auto GetDmeRecord() const -> const IBglDme* = 0;
 	virtual auto SetDmeRecord(IBglDme* value) -> void = 0;
 };
 
@@ -1626,6 +1666,7 @@ class IBglBoundaryEdges
 public:
 	virtual auto GetEdgeCount() const -> int = 0;
 	virtual auto GetEdgeAt(int index) -> IBglBoundaryEdge* = 0;
+	virtual auto GetEdgeAt(int index) const -> const IBglBoundaryEdge* = 0;
 	virtual auto AddEdge(const IBglBoundaryEdge* edge) -> void = 0;
 	virtual auto RemoveEdge(const IBglBoundaryEdge* edge) -> void = 0;
 };
@@ -1689,8 +1730,10 @@ public:
 	virtual auto GetMaxAltitude() const -> double = 0;
 	virtual auto SetMaxAltitude(double value) -> void = 0;
 	virtual auto GetCom() -> IBglCom* = 0;
+	virtual auto GetCom() const -> const IBglCom* = 0;
 	virtual auto SetCom(IBglCom* value) -> void = 0;
 	virtual auto GetEdges() -> IBglBoundaryEdges* = 0;
+	virtual auto GetEdges() const -> const IBglBoundaryEdges* = 0;
 	virtual auto SetEdges(IBglBoundaryEdges* value) -> void = 0;
 };
 	
@@ -1778,6 +1821,7 @@ public:
 	virtual auto SetMaxLatitude(double value) -> void = 0;
 	virtual auto GetVertexCount() const -> int = 0;
 	virtual auto GetVertexAt(int index) -> SBglVertexLL* = 0;
+	virtual auto GetVertexAt(int index) const -> const SBglVertexLL* = 0;
 	virtual auto AddVertex(const SBglVertexLL* vertex) -> void = 0;
 	virtual auto RemoveVertex(const SBglVertexLL* vertex) -> void = 0;
 };
@@ -2022,6 +2066,7 @@ class IBglTaxiwaySigns : virtual public IBglSceneryObject
 public:
 	virtual int GetSignCount() const = 0;
 	virtual IBglTaxiwaySign* GetSignAt(int index) = 0;
+	virtual const IBglTaxiwaySign* GetSignAt(int index) const = 0;
 	virtual void AddSign(const IBglTaxiwaySign* sign) = 0;
 	virtual void RemoveSign(const IBglTaxiwaySign* sign) = 0;
 };
@@ -2032,6 +2077,7 @@ class IBglTriggerRefuelRepair : virtual public IBglFuelAvailability
 public:
 	virtual int GetVertexCount() const = 0;
 	virtual SBglVertexBias* GetVertexAt(int index) = 0;
+	virtual const SBglVertexBias* GetVertexAt(int index) const = 0;
 	virtual void AddVertex(const SBglVertexBias* point) = 0;
 	virtual void RemoveVertex(const SBglVertexBias* point) = 0;
 };
@@ -2054,6 +2100,7 @@ public:
 	virtual void SetScalar(float value) = 0;
 	virtual int GetVertexCount() const = 0;
 	virtual SBglVertexBias* GetVertexAt(int index) = 0;
+	virtual const SBglVertexBias* GetVertexAt(int index) const = 0;
 	virtual void AddVertex(const SBglVertexBias* point) = 0;
 	virtual void RemoveVertex(const SBglVertexBias* point) = 0;
 };
@@ -2132,9 +2179,11 @@ public:
 	virtual int GetPlacementCount() const = 0;
 	virtual int GetPointCount() const = 0;
 	virtual _GUID* GetPlacementAt(int index) = 0;
+	virtual const _GUID* GetPlacementAt(int index) const = 0;
 	virtual void AddPlacement(const _GUID* placement) = 0;
 	virtual void RemovePlacement(const _GUID* placement) = 0;
 	virtual SBglVertexLLA* GetPointAt(int index) = 0;
+	virtual const SBglVertexLLA* GetPointAt(int index) const = 0;
 	virtual void AddPoint(const SBglVertexLLA* point) = 0;
 	virtual void RemovePoint(const SBglVertexLLA* point) = 0;
 };
@@ -2149,6 +2198,8 @@ public:
 };
 
 class BinaryFileStream;
+class IPositionalStream;
+struct SByteSpan;
 struct SRasterImage;
 struct SBglTerrainRasterQuad1Data;
 
@@ -2167,11 +2218,23 @@ public:
 	virtual auto GetHeader() const -> const SBglTerrainRasterQuad1Data& = 0;
 	virtual auto GetDataOffset() const -> int = 0;
 	virtual auto GetDataLength() const -> int = 0;
+	virtual auto GetMaskOffset() const -> int = 0;
+	virtual auto GetMaskLength() const -> int = 0;
 	virtual auto DecompressRaster(const uint8_t* compressed_data, int compressed_size, SRasterImage& out_image) const
 		-> bool = 0;
 	virtual auto ReadCompressedRaster(BinaryFileStream& in, std::vector<uint8_t>& out_data,
 		std::optional<SRcs1Data>& out_rcs1) const -> bool = 0;
 	virtual auto ReadCompressedMask(BinaryFileStream& in, std::vector<uint8_t>& out_mask) const -> bool = 0;
+	// Zero-copy variants for memory mapped streams. The spans point into the
+	// mapping and are only valid while the stream remains open
+	virtual auto ReadCompressedRaster(const BinaryFileStream& in, SByteSpan& out_data,
+		std::optional<SRcs1Data>& out_rcs1) const -> bool = 0;
+	virtual auto ReadCompressedMask(const BinaryFileStream& in, SByteSpan& out_mask) const -> bool = 0;
+	// Thread-safe variants for decoding many tiles of one file in parallel
+	virtual auto ReadCompressedRaster(const IPositionalStream& in, std::vector<uint8_t>& out_data,
+		std::optional<SRcs1Data>& out_rcs1) const -> bool = 0;
+	virtual auto ReadCompressedMask(const IPositionalStream& in, std::vector<uint8_t>& out_mask) const -> bool = 0;
+	virtual auto DecompressMask(const IPositionalStream& in, std::vector<uint8_t>& out_mask) const -> bool = 0;
 	virtual auto DecompressMask(BinaryFileStream& in, std::vector<uint8_t>& out_mask) const -> bool = 0;
 };
 
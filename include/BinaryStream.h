@@ -27,16 +27,117 @@
 #ifndef FLIGHTSIMLIB_IO_BINARYISTREAM_H
 #define FLIGHTSIMLIB_IO_BINARYISTREAM_H
 
+#include "StringPool.h"
+
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <istream>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 namespace flightsimlib::io
 {
 
+    // Non-owning view of a contiguous byte range, typically inside a mapped file
+    struct SByteSpan
+    {
+        const uint8_t* Data = nullptr;
+        int Length = 0;
+
+        [[nodiscard]] bool Empty() const { return Data == nullptr || Length <= 0; }
+    };
+
+    // Offset-addressed read access with no shared cursor. Implementations are safe
+    // to read from concurrently, so worker threads can share a single instance
+    class IPositionalStream
+    {
+      public:
+        virtual ~IPositionalStream() = default;
+
+        // Reads exactly size bytes starting at offset
+        virtual bool ReadAt(int offset, void* out, int size) const = 0;
+        virtual int GetLength() const = 0;
+        // View into memory backed streams, empty if the stream must be copied from
+        [[nodiscard]] virtual SByteSpan GetView(int /*offset*/, int /*length*/) const { return {}; }
+    };
+
+    // Read-only memory mapping of an entire file
+    class CMappedFile final : public IPositionalStream
+    {
+      public:
+        CMappedFile() = default;
+        ~CMappedFile();
+        // copying not allowed
+        CMappedFile(const CMappedFile&) = delete;
+        CMappedFile& operator=(const CMappedFile&) = delete;
+        CMappedFile(CMappedFile&&) = delete;
+        CMappedFile& operator=(CMappedFile&&) = delete;
+
+        bool Open(const std::filesystem::path& filename);
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const { return m_data != nullptr; }
+
+        [[nodiscard]] const uint8_t* GetData() const { return m_data; }
+
+        [[nodiscard]] size_t GetSize() const { return m_size; }
+
+        bool ReadAt(int offset, void* out, int size) const override;
+
+        int GetLength() const override { return static_cast<int>(m_size); }
+
+        [[nodiscard]] SByteSpan GetView(int offset, int length) const override;
+
+      private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+#endif
+    };
+
+    // Positional reads through pread (ReadFile with an OVERLAPPED offset on Windows)
+    class CPositionalFileStream final : public IPositionalStream
+    {
+      public:
+        CPositionalFileStream() = default;
+        explicit CPositionalFileStream(const std::filesystem::path& filename) { Open(filename); }
+        ~CPositionalFileStream() override;
+        // copying not allowed
+        CPositionalFileStream(const CPositionalFileStream&) = delete;
+        CPositionalFileStream& operator=(const CPositionalFileStream&) = delete;
+        CPositionalFileStream(CPositionalFileStream&&) = delete;
+        CPositionalFileStream& operator=(CPositionalFileStream&&) = delete;
+
+        bool Open(const std::filesystem::path& filename);
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const;
+
+        bool ReadAt(int offset, void* out, int size) const override;
+
+        int GetLength() const override { return m_length; }
+
+      private:
+#ifdef _WIN32
+        void* m_file = nullptr;
+#else
+        int m_file = -1;
+#endif
+        int m_length = 0;
+    };
+
+    // Pushes a closed file's contents from the OS cache to the disk, so it can be renamed over
+    // another file without a crash leaving the target empty
+    bool FlushFileToDisk(const std::filesystem::path& filename);
+
     class CByteArrayStreambuf final : public std::streambuf
     {
       public:
@@ -53,6 +154,7 @@ namespace flightsimlib::io
         int_type uflow() override;
         int_type pbackfail(int_type ch) override;
         std::streamsize showmanyc() override;
+        std::streamsize xsgetn(char_type* s, std::streamsize count) override;
         std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way,
             std::ios_base::openmode which = std::ios_base::in | std::ios_base::out) override;
         std::streampos seekpos(
@@ -63,25 +165,246 @@ namespace flightsimlib::io
         const uint8_t* m_current;
     };
 
+    // Non-virtual, bounds-checked reader over a contiguous byte range. Loads are
+    // inlined memcpys, and a failed read latches like an iostream failbit.
+    // IBinaryStream forwards to one of these whenever it is backed by memory
+    class CBinaryReader final
+    {
+      public:
+        CBinaryReader(const uint8_t* data, int length) : CBinaryReader(data, length, 0) { }
+
+        // base_offset is the stream position of data[0], for windows cut out of a larger file
+        CBinaryReader(const uint8_t* data, int length, int base_offset) :
+            m_begin(data), m_end(data + length), m_current(data), m_base(base_offset)
+        {
+        }
+
+        template <typename T> bool Read(T& val)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "CBinaryReader can only load trivially copyable types");
+            if (!CanRead(sizeof(T)))
+            {
+                return false;
+            }
+            std::memcpy(&val, m_current, sizeof(T));
+            m_current += sizeof(T);
+            return true;
+        }
+
+        template <typename T> T ReadType()
+        {
+            T t{};
+            Read(t);
+            return t;
+        }
+
+        template <typename T> CBinaryReader& operator>>(T& val)
+        {
+            Read(val);
+            return *this;
+        }
+
+        // For #pragma pack(1) structs whose layout matches the on-disk record
+        template <typename T> T ReadPacked()
+        {
+            static_assert(std::is_standard_layout_v<T>, "Packed records must be standard layout");
+            return ReadType<T>();
+        }
+
+        template <typename T> bool ReadArray(T* out, int count)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "CBinaryReader can only load trivially copyable types");
+            if (count < 0 || !CanRead(sizeof(T) * static_cast<size_t>(count)))
+            {
+                m_failed = true;
+                return false;
+            }
+            std::memcpy(out, m_current, sizeof(T) * static_cast<size_t>(count));
+            m_current += sizeof(T) * static_cast<size_t>(count);
+            return true;
+        }
+
+        template <typename T> std::vector<T> ReadArray(int count)
+        {
+            auto values = std::vector<T>(count > 0 ? static_cast<size_t>(count) : 0);
+            if (!ReadArray(values.data(), count))
+            {
+                values.clear();
+            }
+            return values;
+        }
+
+        bool ReadBytes(void* out, int size) { return ReadArray(static_cast<uint8_t*>(out), size); }
+
+        // Advances past size bytes and returns a view of them without copying
+        SByteSpan ReadSpan(int size)
+        {
+            if (size < 0 || !CanRead(static_cast<size_t>(size)))
+            {
+                m_failed = true;
+                return {};
+            }
+            const auto span = SByteSpan{ m_current, size };
+            m_current += size;
+            return span;
+        }
+
+        [[nodiscard]] std::string ReadString(int count)
+        {
+            const auto span = ReadSpan(count);
+            return std::string(reinterpret_cast<const char*>(span.Data), span.Data ? span.Length : 0);
+        }
+
+        [[nodiscard]] std::string ReadCString() { return std::string(ReadCStringView()); }
+
+        // Views into the underlying memory, valid for as long as it is
+        [[nodiscard]] std::string_view ReadStringView(int count)
+        {
+            const auto span = ReadSpan(count);
+            return std::string_view(reinterpret_cast<const char*>(span.Data), span.Data ? span.Length : 0);
+        }
+
+        [[nodiscard]] std::string_view ReadCStringView()
+        {
+            if (m_failed || m_current == m_end)
+            {
+                m_failed = true;
+                return {};
+            }
+            const auto* terminator = static_cast<const uint8_t*>(std::memchr(m_current, '\0', m_end - m_current));
+            const auto* end = terminator != nullptr ? terminator : m_end;
+            const auto value = std::string_view(reinterpret_cast<const char*>(m_current), end - m_current);
+            m_current = terminator != nullptr ? terminator + 1 : m_end;
+            return value;
+        }
+
+        [[nodiscard]] bool Fail() const { return m_failed; }
+
+        // Forgets a failed read so the reader can be positioned again
+        void ClearFail() { m_failed = false; }
+
+        bool operator!() const { return m_failed; }
+
+        explicit operator bool() const { return !m_failed; }
+
+        [[nodiscard]] int GetPosition() const
+        {
+            return m_failed ? -1 : m_base + static_cast<int>(m_current - m_begin);
+        }
+
+        void SetPosition(int pos, std::ios_base::seekdir dir = std::ios_base::beg)
+        {
+            if (m_failed)
+            {
+                return;
+            }
+            if (dir == std::ios_base::beg)
+            {
+                pos -= m_base;
+            }
+            const auto* base = dir == std::ios_base::beg ? m_begin : dir == std::ios_base::cur ? m_current : m_end;
+            const auto target = (base - m_begin) + static_cast<std::ptrdiff_t>(pos);
+            if (target < 0 || target > m_end - m_begin)
+            {
+                m_failed = true;
+                return;
+            }
+            m_current = m_begin + target;
+        }
+
+        [[nodiscard]] const uint8_t* GetData() const { return m_begin; }
+
+        [[nodiscard]] int GetLength() const { return static_cast<int>(m_end - m_begin); }
+
+        [[nodiscard]] int GetRemaining() const { return static_cast<int>(m_end - m_current); }
+
+      private:
+        bool CanRead(size_t size)
+        {
+            if (m_failed || size > static_cast<size_t>(m_end - m_current))
+            {
+                m_failed = true;
+                return false;
+            }
+            return true;
+        }
+
+        const uint8_t* m_begin;
+        const uint8_t* m_end;
+        const uint8_t* m_current;
+        int m_base;
+        bool m_failed = false;
+    };
+
+    // Growable in-memory buffer with a single shared read/write cursor, like a filebuf
+    class CByteBufferStreambuf final : public std::streambuf
+    {
+      public:
+        explicit CByteBufferStreambuf(size_t reserve_size);
+        ~CByteBufferStreambuf() override = default;
+        // copying not allowed
+        CByteBufferStreambuf(const CByteBufferStreambuf&) = delete;
+        CByteBufferStreambuf& operator=(const CByteBufferStreambuf&) = delete;
+        CByteBufferStreambuf(CByteBufferStreambuf&&) = delete;
+        CByteBufferStreambuf& operator=(CByteBufferStreambuf&&) = delete;
+
+        [[nodiscard]] const std::vector<uint8_t>& GetBuffer() const { return m_buffer; }
+
+      private:
+        int_type underflow() override;
+        int_type uflow() override;
+        int_type overflow(int_type ch) override;
+        std::streamsize xsgetn(char_type* s, std::streamsize count) override;
+        std::streamsize xsputn(const char_type* s, std::streamsize count) override;
+        std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way,
+            std::ios_base::openmode which = std::ios_base::in | std::ios_base::out) override;
+        std::streampos seekpos(
+            std::streampos sp, std::ios_base::openmode which = std::ios_base::in | std::ios_base::out) override;
+
+        std::vector<uint8_t> m_buffer;
+        size_t m_current;
+    };
+
     class IBinaryStream
     {
       protected:
-        explicit IBinaryStream(std::iostream& stream) : m_stream(stream) { }
+        explicit IBinaryStream(std::iostream& stream) : m_stream(stream), m_reader(nullptr) { }
 
       public:
         template <typename T> IBinaryStream& operator>>(T& val)
         {
+            if (m_reader != nullptr)
+            {
+                m_reader->Read(val);
+                return *this;
+            }
             m_stream.read(reinterpret_cast<char*>(&val), sizeof(val));
             return *this;
         }
 
         template <typename T> T ReadType()
         {
+            if (m_reader != nullptr)
+            {
+                return m_reader->ReadType<T>();
+            }
             T t{};
             m_stream.read(reinterpret_cast<char*>(&t), sizeof(t));
             return t;
         }
 
+        // Reads a #pragma pack(1) record in a single load instead of field by field
+        template <typename T> T ReadPacked()
+        {
+            if (m_reader != nullptr)
+            {
+                return m_reader->ReadPacked<T>();
+            }
+            static_assert(std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T>,
+                "Packed records must be trivially copyable and standard layout");
+            return ReadType<T>();
+        }
+
         template <typename T> IBinaryStream& operator<<(const T& val)
         {
             m_stream.write(reinterpret_cast<const char*>(&val), sizeof(val));
@@ -90,6 +413,11 @@ namespace flightsimlib::io
 
         IBinaryStream& Read(void* val, int size)
         {
+            if (m_reader != nullptr)
+            {
+                m_reader->ReadBytes(val, size);
+                return *this;
+            }
             m_stream.read(static_cast<char*>(val), size);
             return *this;
         }
@@ -102,25 +430,77 @@ namespace flightsimlib::io
 
         [[nodiscard]] std::string ReadString(int count) const
         {
-            const auto bytes = std::unique_ptr<char[]>(new char[count]);
+            if (m_reader != nullptr)
+            {
+                return m_reader->ReadString(count);
+            }
 
-            m_stream.read(bytes.get(), count);
-            return std::string(bytes.get(), count);
+            auto value = std::string(static_cast<size_t>(std::max(count, 0)), '\0');
+            m_stream.read(value.data(), static_cast<std::streamsize>(value.size()));
+            return value;
         }
 
         [[nodiscard]] std::string ReadCString() const
         {
+            if (m_reader != nullptr)
+            {
+                return m_reader->ReadCString();
+            }
+
             std::string buffer;
             std::getline(m_stream, buffer, '\0');
             return buffer;
         }
 
-        bool operator!() const { return !m_stream; }
+        // Views into the stream's memory when it has any. File streams read into a
+        // scratch buffer instead, so the view is only valid until the next string read
+        [[nodiscard]] std::string_view ReadStringView(int count) const
+        {
+            if (m_reader != nullptr)
+            {
+                return m_reader->ReadStringView(count);
+            }
+
+            m_scratch.resize(static_cast<size_t>(std::max(count, 0)));
+            m_stream.read(m_scratch.data(), static_cast<std::streamsize>(m_scratch.size()));
+            return m_scratch;
+        }
+
+        [[nodiscard]] std::string_view ReadCStringView() const
+        {
+            if (m_reader != nullptr)
+            {
+                return m_reader->ReadCStringView();
+            }
+
+            std::getline(m_stream, m_scratch, '\0');
+            return m_scratch;
+        }
+
+        bool operator!() const { return m_reader != nullptr ? !*m_reader : !m_stream; }
+
+        // Forgets a failed read so the stream can be positioned again
+        void ClearFail()
+        {
+            if (m_reader != nullptr)
+            {
+                m_reader->ClearFail();
+                return;
+            }
+            m_stream.clear();
+        }
 
-        explicit operator bool() const { return m_stream.operator bool(); }
+        explicit operator bool() const
+        {
+            return m_reader != nullptr ? static_cast<bool>(*m_reader) : m_stream.operator bool();
+        }
 
         [[nodiscard]] int GetPosition() const
         {
+            if (m_reader != nullptr)
+            {
+                return m_reader->GetPosition();
+            }
             // This is a problem with ReSharper - no issue here
             // ReSharper disable once CppRedundantCastExpression
             return static_cast<int>(m_stream.tellg());
@@ -128,43 +508,131 @@ namespace flightsimlib::io
 
         void SetPosition(int pos, std::ios_base::seekdir dir = std::fstream::beg) const
         {
+            if (m_reader != nullptr)
+            {
+                m_reader->SetPosition(pos, dir);
+                return;
+            }
             m_stream.seekg(pos, dir);
             m_stream.seekp(pos, dir);
         }
 
+        // Non-null when the stream is backed by memory. Hot loops can use the
+        // reader directly to skip the per-call dispatch
+        [[nodiscard]] CBinaryReader* GetReader() const { return m_reader; }
+
       protected:
         std::iostream& m_stream;
+        CBinaryReader* m_reader;
+        mutable std::string m_scratch;
     };
 
     // TODO - fstream leaky abstractions!
     class BinaryFileStream final : public IBinaryStream
     {
       public:
+        BinaryFileStream() : IBinaryStream(m_iostream), m_iostream(m_fstream.rdbuf()) { }
+
         explicit BinaryFileStream(const std::filesystem::path& filename) :
-            IBinaryStream(m_fstream), m_fstream(filename, std::fstream::out | std::fstream::in | std::fstream::binary)
+            IBinaryStream(m_iostream), m_fstream(filename, std::fstream::out | std::fstream::in | std::fstream::binary),
+            m_iostream(m_fstream.rdbuf()), m_path(filename)
         {
+            m_iostream.clear(m_fstream.rdstate());
         }
 
         void Open(const std::filesystem::path& filename,
             std::ios_base::openmode mode = std::fstream::out | std::fstream::in | std::fstream::binary)
         {
+            DetachMemory();
             m_fstream.open(filename, mode);
+            m_iostream.clear(m_fstream.rdstate());
+            m_path = filename;
+        }
+
+        // Maps the whole file read-only. Subsequent reads are served from memory
+        // and raster payloads can be viewed in place with GetMappedView
+        bool OpenMapped(const std::filesystem::path& filename);
+
+        [[nodiscard]] bool IsOpen() const { return m_fstream.is_open() || m_reader != nullptr || m_buffer != nullptr; }
+
+        [[nodiscard]] bool IsMapped() const { return m_mapping.IsOpen(); }
+
+        [[nodiscard]] int GetMappedSize() const { return static_cast<int>(m_mapping.GetSize()); }
+
+        // Returns an empty span if the stream is not mapped or the range is out of bounds
+        [[nodiscard]] SByteSpan GetMappedView(int offset, int length) const;
+
+        // Serializes into a growable memory buffer instead of a file, so a whole
+        // file can be built up and then written out with a single call
+        void OpenBuffer(int reserve_size);
+
+        // Reads from a caller-owned window of a file, typically filled by an IPositionalStream,
+        // so record decoders can run on a private stream. Positions stay file relative
+        void OpenView(const uint8_t* data, int length, int base_offset);
+
+        // The mapping as a thread-safe positional stream, or null if not mapped
+        [[nodiscard]] const IPositionalStream* GetMappedFile() const
+        {
+            return m_mapping.IsOpen() ? &m_mapping : nullptr;
+        }
+
+        // Shared positional handle on the same file, opened on first use. Raster blocks
+        // hold on to it so their payloads can be loaded after this stream is closed.
+        // Null for buffers, and for views unless a source was attached
+        [[nodiscard]] std::shared_ptr<const IPositionalStream> GetPayloadSource();
+
+        void SetPayloadSource(std::shared_ptr<const IPositionalStream> source) { m_payload_source = std::move(source); }
+
+        // Names read through ReadPooledString are interned here when set. Unlike the
+        // payload source the pool is kept when the stream is closed or reopened
+        [[nodiscard]] const std::shared_ptr<CStringPool>& GetStringPool() const { return m_string_pool; }
+
+        void SetStringPool(std::shared_ptr<CStringPool> pool) { m_string_pool = std::move(pool); }
+
+        [[nodiscard]] CPooledString ReadPooledString(int count) const
+        {
+            return CPooledString(ReadStringView(count), m_string_pool);
         }
 
-        [[nodiscard]] bool IsOpen() const { return m_fstream.is_open(); }
+        [[nodiscard]] CPooledString ReadPooledCString() const
+        {
+            return CPooledString(ReadCStringView(), m_string_pool);
+        }
+
+        // Null unless the stream was opened with OpenBuffer
+        [[nodiscard]] const std::vector<uint8_t>* GetBuffer() const
+        {
+            return m_buffer != nullptr ? &m_buffer->GetBuffer() : nullptr;
+        }
 
-        void Close() { m_fstream.close(); }
+        void Close()
+        {
+            DetachMemory();
+            m_fstream.close();
+            m_iostream.clear(m_fstream.rdstate());
+        }
 
       private:
+        void DetachMemory();
+
         std::fstream m_fstream;
+        std::iostream m_iostream;
+        CMappedFile m_mapping;
+        std::unique_ptr<CBinaryReader> m_mapped_reader;
+        std::unique_ptr<CByteBufferStreambuf> m_buffer;
+        std::filesystem::path m_path;
+        std::shared_ptr<const IPositionalStream> m_payload_source;
+        std::shared_ptr<CStringPool> m_string_pool;
     };
 
     class BinaryMemoryStream final : public IBinaryStream
     {
       public:
         explicit BinaryMemoryStream(uint8_t* pointer, int length) :
-            IBinaryStream(m_iostream), m_buf(pointer, length), m_iostream(&m_buf), m_pointer(pointer), m_length(length)
+            IBinaryStream(m_iostream), m_buf(pointer, length), m_iostream(&m_buf), m_memory_reader(pointer, length),
+            m_pointer(pointer), m_length(length)
         {
+            m_reader = &m_memory_reader;
         }
 
         [[nodiscard]] uint8_t* GetPointer() const { return m_pointer; }
@@ -174,6 +642,7 @@ namespace flightsimlib::io
       private:
         CByteArrayStreambuf m_buf;
         std::iostream m_iostream;
+        CBinaryReader m_memory_reader;
         uint8_t* m_pointer;
         int m_length;
     };
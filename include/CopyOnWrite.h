@@ -0,0 +1,113 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+#ifndef FLIGHTSIMLIB_IO_COPYONWRITE_H
+#define FLIGHTSIMLIB_IO_COPYONWRITE_H
+
+#include "../external/stlab/copy_on_write.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace flightsimlib::io
+{
+
+    namespace detail
+    {
+#ifndef NDEBUG
+        inline std::atomic<size_t> s_copy_on_write_detach_count{0};
+#endif
+    } // namespace detail
+
+    // Number of times CCopyOnWrite::write had to copy a value it shared with another owner.
+    // Counted in debug builds only, so tests can check that a read-only workload copies nothing
+    inline auto GetCopyOnWriteDetachCount() -> size_t
+    {
+#ifndef NDEBUG
+        return detail::s_copy_on_write_detach_count.load(std::memory_order_relaxed);
+#else
+        return 0;
+#endif
+    }
+
+    // stlab::copy_on_write, with the copies made by write() counted in debug builds
+    template <typename T>
+    class CCopyOnWrite
+    {
+      public:
+        using element_type = T;
+
+        CCopyOnWrite() = default;
+
+        template <typename U, std::enable_if_t<!std::is_same_v<std::decay_t<U>, CCopyOnWrite>, int> = 0>
+        CCopyOnWrite(U&& value) : m_value(std::forward<U>(value))
+        {
+        }
+
+        template <typename U, std::enable_if_t<!std::is_same_v<std::decay_t<U>, CCopyOnWrite>, int> = 0>
+        auto operator=(U&& value) -> CCopyOnWrite&
+        {
+            m_value = std::forward<U>(value);
+            return *this;
+        }
+
+        auto write() -> element_type&
+        {
+#ifndef NDEBUG
+            if (!m_value.unique())
+            {
+                detail::s_copy_on_write_detach_count.fetch_add(1, std::memory_order_relaxed);
+            }
+#endif
+            return m_value.write();
+        }
+
+        [[nodiscard]] auto read() const noexcept -> const element_type& { return m_value.read(); }
+
+        operator const element_type&() const noexcept { return m_value.read(); }
+
+        auto operator*() const noexcept -> const element_type& { return m_value.read(); }
+
+        auto operator->() const noexcept -> const element_type* { return &m_value.read(); }
+
+        [[nodiscard]] auto unique() const noexcept -> bool { return m_value.unique(); }
+
+        [[nodiscard]] auto identity(const CCopyOnWrite& other) const noexcept -> bool
+        {
+            return m_value.identity(other.m_value);
+        }
+
+      private:
+        stlab::copy_on_write<T> m_value;
+    };
+
+} // namespace flightsimlib::io
+
+#endif
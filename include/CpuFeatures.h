@@ -0,0 +1,61 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+#ifndef FLIGHTSIMLIB_IO_CPUFEATURES_H
+#define FLIGHTSIMLIB_IO_CPUFEATURES_H
+
+#include "Export.h"
+
+// Kernels for x64 are built into every x64 binary and chosen at run time. Functions that use
+// AVX2 or BMI2 intrinsics are marked so that GCC and Clang generate them without -mavx2.
+// MSVC takes the intrinsics in any function, whatever /arch is set to
+#if defined(_M_X64) || defined(__x86_64__)
+#define FLIGHTSIMLIB_X64
+#if defined(__GNUC__) || defined(__clang__)
+#define FLIGHTSIMLIB_TARGET_AVX2 __attribute__((target("avx2,bmi2")))
+#else
+#define FLIGHTSIMLIB_TARGET_AVX2
+#endif
+#endif
+
+namespace flightsimlib::io
+{
+
+    // Instruction set extensions of the CPU running the process
+    class FLIGHTSIMLIB_EXPORTED CCpuFeatures
+    {
+      public:
+        // True when the CPU and the OS support AVX2 and BMI2, and they have not been turned off.
+        // The CPU is checked once, on first use
+        static auto HasAvx2() -> bool;
+        // Turns the AVX2 kernels off, or back on where they are supported, so that the portable
+        // paths can be run and compared against them
+        static auto SetAvx2Enabled(bool enabled) -> void;
+    };
+
+} // namespace flightsimlib::io
+
+#endif
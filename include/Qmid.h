@@ -0,0 +1,341 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+#ifndef FLIGHTSIMLIB_IO_QMID_H
+#define FLIGHTSIMLIB_IO_QMID_H
+
+#include <cstdint>
+#include <vector>
+
+namespace flightsimlib::io
+{
+
+    // Rectangle in degrees. A minimum longitude east of the maximum wraps across the antimeridian
+    struct SBglRegion
+    {
+        double MinLongitude = 0.0;
+        double MinLatitude = 0.0;
+        double MaxLongitude = 0.0;
+        double MaxLatitude = 0.0;
+    };
+
+    // Unpacked QMID. U counts columns east from -180, V counts rows south from +90
+    struct SQmidCell
+    {
+        int Level = -1;
+        uint32_t U = 0;
+        uint32_t V = 0;
+    };
+
+    // Quad tree cell of the scenery grid. Cells are 480 by 360 degrees at level 0 and halve on each
+    // level, so from level 2 on a row of 3 * 2^(level - 2) cells spans the globe. The packed value
+    // holds U and V interleaved, U in the even bits, under a marker bit at 2 * level + 1
+    class CPackedQmid
+    {
+      public:
+        static constexpr int s_max_level = 31;
+
+        constexpr explicit CPackedQmid(uint64_t value) : m_value(value) { }
+
+        constexpr explicit CPackedQmid(uint32_t low, uint32_t high) : m_value(static_cast<uint64_t>(high) << 32 | low)
+        {
+        }
+
+        constexpr bool operator<(const CPackedQmid& rhs) const noexcept { return this->m_value < rhs.m_value; }
+
+        constexpr bool operator>(const CPackedQmid& rhs) const noexcept { return this->m_value > rhs.m_value; }
+
+        constexpr bool operator==(const CPackedQmid& rhs) const noexcept { return this->m_value == rhs.m_value; }
+
+        constexpr bool operator!=(const CPackedQmid& rhs) const noexcept { return this->m_value != rhs.m_value; }
+
+        constexpr uint32_t Low() const { return m_value & 0xFFFFFFFF; }
+
+        constexpr uint32_t High() const { return m_value >> 32; }
+
+        constexpr uint64_t Value() const { return m_value; }
+
+        // The cell at column U and row V of a level. Empty if the level is out of range
+        static constexpr auto FromCell(int level, uint32_t u, uint32_t v) -> CPackedQmid
+        {
+            if (level < 0 || level > s_max_level)
+            {
+                return CPackedQmid{0ull};
+            }
+            const auto mask = (1ull << level) - 1;
+            return CPackedQmid{2ull << (2 * level) | Interleave(u & mask, v & mask)};
+        }
+
+        static constexpr auto FromCell(const SQmidCell& cell) -> CPackedQmid
+        {
+            return FromCell(cell.Level, cell.U, cell.V);
+        }
+
+        // The cell holding a point. Longitude wraps, latitude is clamped to the poles
+        static constexpr auto FromLatLon(double latitude, double longitude, int level) -> CPackedQmid
+        {
+            if (level < 0 || level > s_max_level)
+            {
+                return CPackedQmid{0ull};
+            }
+            const auto scale = static_cast<double>(1ull << level);
+            const auto x = WrapLongitude(longitude) * (scale / 480.0);
+            const auto y = (90.0 - latitude) * (scale / 360.0);
+            // Written so that NaN lands in cell 0
+            const auto u = x > 0.0 ? (x < ColumnCount(level) ? static_cast<uint32_t>(x) : ColumnCount(level) - 1) : 0;
+            const auto v = y > 0.0 ? (y < RowCount(level) ? static_cast<uint32_t>(y) : RowCount(level) - 1) : 0;
+            return FromCell(level, u, v);
+        }
+
+        // Columns and rows of cells that cover the globe at a level
+        static constexpr auto ColumnCount(int level) -> uint32_t
+        {
+            return static_cast<uint32_t>(((3ull << level) + 3) >> 2);
+        }
+
+        static constexpr auto RowCount(int level) -> uint32_t
+        {
+            return static_cast<uint32_t>(((1ull << level) + 1) >> 1);
+        }
+
+        constexpr bool IsValid() const { return m_value >= 2; }
+
+        // Depth of the cell, from the marker bit above the interleaved coordinates. -1 if empty
+        constexpr int Level() const
+        {
+            if (m_value < 2)
+            {
+                return -1;
+            }
+            auto bit = 0;
+            auto value = m_value;
+            for (auto shift = 32; shift > 0; shift >>= 1)
+            {
+                if ((value >> shift) != 0)
+                {
+                    value >>= shift;
+                    bit += shift;
+                }
+            }
+            return (bit - 1) / 2;
+        }
+
+        constexpr uint32_t U() const { return static_cast<uint32_t>(Deinterleave(Coordinates())); }
+
+        constexpr uint32_t V() const { return static_cast<uint32_t>(Deinterleave(Coordinates() >> 1)); }
+
+        constexpr SQmidCell Cell() const { return SQmidCell{Level(), U(), V()}; }
+
+        // The cell holding this one at a shallower level
+        constexpr CPackedQmid Ancestor(int level) const
+        {
+            const auto depth = Level();
+            if (level < 0 || level >= depth)
+            {
+                return *this;
+            }
+            return CPackedQmid{m_value >> (2 * (depth - level))};
+        }
+
+        // Empty for a level 0 cell
+        constexpr CPackedQmid Parent() const
+        {
+            return Level() > 0 ? CPackedQmid{m_value >> 2} : CPackedQmid{0ull};
+        }
+
+        // Quadrant bit 0 steps east and bit 1 steps south. Empty past the deepest level
+        constexpr CPackedQmid Child(int quadrant) const
+        {
+            if (!IsValid() || Level() >= s_max_level)
+            {
+                return CPackedQmid{0ull};
+            }
+            return CPackedQmid{m_value << 2 | static_cast<uint64_t>(quadrant & 3)};
+        }
+
+        // The cell a number of columns east and rows south of this one on the same level. Columns
+        // wrap around the globe, and stepping past a pole gives an empty cell
+        constexpr CPackedQmid Neighbor(int east, int south) const
+        {
+            const auto level = Level();
+            if (level < 0)
+            {
+                return *this;
+            }
+            const auto rows = static_cast<int64_t>(RowCount(level));
+            const auto v = static_cast<int64_t>(V()) + south;
+            if (v < 0 || v >= rows)
+            {
+                return CPackedQmid{0ull};
+            }
+            const auto columns = static_cast<int64_t>(ColumnCount(level));
+            const auto u = ((static_cast<int64_t>(U()) + east) % columns + columns) % columns;
+            return FromCell(level, static_cast<uint32_t>(u), static_cast<uint32_t>(v));
+        }
+
+        // True for this cell and every cell below it
+        constexpr bool Contains(CPackedQmid other) const
+        {
+            const auto level = Level();
+            return level >= 0 && other.Level() >= level && other.Ancestor(level) == *this;
+        }
+
+        // Extent of the cell
+        constexpr SBglRegion Bounds() const
+        {
+            const auto level = Level();
+            if (level < 0)
+            {
+                return SBglRegion{};
+            }
+            const auto width = 480.0 / static_cast<double>(1ull << level);
+            const auto height = 360.0 / static_cast<double>(1ull << level);
+            auto bounds = SBglRegion{};
+            bounds.MinLongitude = -180.0 + static_cast<double>(U()) * width;
+            bounds.MaxLongitude = bounds.MinLongitude + width;
+            bounds.MaxLatitude = 90.0 - static_cast<double>(V()) * height;
+            bounds.MinLatitude = bounds.MaxLatitude - height;
+            return bounds;
+        }
+
+        // Batch conversions for tracks and tile schedules. Points map as in FromLatLon, and the
+        // center of each cell is returned as in Bounds, NaN for empty cells. Run with
+        // AVX2 and BMI2 on CPUs that have them
+        static auto FromLatLons(const double* latitudes, const double* longitudes, int count, int level,
+            uint64_t* qmids) -> void;
+        static auto ToCenters(const uint64_t* qmids, int count, double* latitudes, double* longitudes) -> void;
+
+        // U and V spread to the even and odd bits
+        static constexpr auto Interleave(uint64_t u, uint64_t v) -> uint64_t
+        {
+            return Spread(u) | Spread(v) << 1;
+        }
+
+        // The even bits gathered to the low half
+        static constexpr auto Deinterleave(uint64_t bits) -> uint64_t
+        {
+            bits &= s_even_bits;
+            bits = (bits | bits >> 1) & 0x3333333333333333ull;
+            bits = (bits | bits >> 2) & 0x0F0F0F0F0F0F0F0Full;
+            bits = (bits | bits >> 4) & 0x00FF00FF00FF00FFull;
+            bits = (bits | bits >> 8) & 0x0000FFFF0000FFFFull;
+            return (bits | bits >> 16) & 0x00000000FFFFFFFFull;
+        }
+
+      private:
+        static constexpr uint64_t s_even_bits = 0x5555555555555555ull;
+
+        static constexpr auto Spread(uint64_t bits) -> uint64_t
+        {
+            bits &= 0x00000000FFFFFFFFull;
+            bits = (bits | bits << 16) & 0x0000FFFF0000FFFFull;
+            bits = (bits | bits << 8) & 0x00FF00FF00FF00FFull;
+            bits = (bits | bits << 4) & 0x0F0F0F0F0F0F0F0Full;
+            bits = (bits | bits << 2) & 0x3333333333333333ull;
+            return (bits | bits << 1) & s_even_bits;
+        }
+
+        // Degrees east of -180, in [0, 360)
+        static constexpr auto WrapLongitude(double longitude) -> double
+        {
+            auto x = longitude + 180.0;
+            if (!(x > -1.0e15 && x < 1.0e15))
+            {
+                return 0.0;
+            }
+            if (x >= 360.0 || x < 0.0)
+            {
+                x -= 360.0 * static_cast<double>(static_cast<int64_t>(x / 360.0));
+                if (x < 0.0)
+                {
+                    x += 360.0;
+                }
+            }
+            return x;
+        }
+
+        // Interleaved bits below the marker
+        constexpr uint64_t Coordinates() const
+        {
+            const auto level = Level();
+            return level > 0 ? m_value & ((1ull << (2 * level)) - 1) : 0;
+        }
+
+        uint64_t m_value;
+    };
+
+    // Half open run of packed values. Covers whole subtrees of one level, so every value in it
+    // is a cell of that level
+    struct SQmidRange
+    {
+        uint64_t First = 0;
+        uint64_t End = 0;
+        bool Contained = false; // Every cell of the run lies in the area, none need testing
+    };
+
+    // Area to search for tiles, a rectangle or a circle around a point
+    class CQmidQuery
+    {
+      public:
+        static constexpr double s_earth_radius = 6371008.8; // Mean, in metres
+        static constexpr int s_default_max_ranges = 64;
+
+        static auto FromRegion(const SBglRegion& region) -> CQmidQuery;
+        // Radius in metres
+        static auto FromRadius(double latitude, double longitude, double radius) -> CQmidQuery;
+
+        // Bounding rectangle, which spans all longitudes once a circle reaches a pole
+        auto GetBounds() const -> const SBglRegion& { return m_bounds; }
+
+        // Edges count as inside
+        auto Intersects(CPackedQmid cell) const -> bool;
+        auto Contains(CPackedQmid cell) const -> bool;
+
+        // Sorted, merged runs of cells of a level that cover the area. Cells are split only
+        // while that keeps the count within max_ranges, so runs may hold cells outside the area
+        auto Cover(int level, std::vector<SQmidRange>& ranges, int max_ranges = s_default_max_ranges) const -> void;
+
+        // Appends the index of each sorted key between the levels that meets the area. Only the
+        // keys inside the covering runs are visited
+        auto Select(const std::vector<uint64_t>& keys, int min_level, int max_level, std::vector<int>& indices) const
+            -> void;
+
+      private:
+        CQmidQuery() = default;
+
+        // Great circle distance in metres to the nearest point of the cell
+        auto Distance(const SBglRegion& cell) const -> double;
+
+        SBglRegion m_bounds;
+        bool m_is_radius = false;
+        double m_latitude = 0.0;
+        double m_longitude = 0.0;
+        double m_radius = 0.0;
+    };
+
+} // namespace flightsimlib::io
+
+#endif
@@ -0,0 +1,118 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+#ifndef FLIGHTSIMLIB_IO_RASTERPREFETCH_H
+#define FLIGHTSIMLIB_IO_RASTERPREFETCH_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace flightsimlib::io
+{
+
+    class IPositionalStream;
+    class ITerrainRasterQuad1;
+    class CRasterBlock;
+
+    // One raster tile worth of payload to fetch. The buffers are owned by the
+    // caller and must hold at least DataLength and MaskLength bytes respectively
+    struct SRasterReadRequest
+    {
+        int DataOffset = 0;
+        int DataLength = 0;
+        int MaskOffset = 0;
+        int MaskLength = 0;
+        uint8_t* DataBuffer = nullptr;
+        uint8_t* MaskBuffer = nullptr;
+
+        static auto FromRaster(const ITerrainRasterQuad1& raster, uint8_t* data_buffer, uint8_t* mask_buffer)
+            -> SRasterReadRequest;
+        static auto FromBlock(const CRasterBlock& block, uint8_t* data_buffer, uint8_t* mask_buffer)
+            -> SRasterReadRequest;
+    };
+
+    // Reads batches of raster payloads on a pool of worker threads. Each request
+    // in a batch is an independent job, so the reads of one batch run concurrently
+    // through the positional interface of the shared stream
+    class CRasterPrefetchQueue
+    {
+      public:
+        // Invoked on a worker thread once per request as soon as its reads finish
+        using CompletionCallback = std::function<void(const SRasterReadRequest& request, bool success)>;
+
+        // Zero threads picks one per hardware thread
+        explicit CRasterPrefetchQueue(int num_threads = 0);
+        // Waits for all submitted batches to complete
+        ~CRasterPrefetchQueue();
+        // copying not allowed
+        CRasterPrefetchQueue(const CRasterPrefetchQueue&) = delete;
+        CRasterPrefetchQueue& operator=(const CRasterPrefetchQueue&) = delete;
+        CRasterPrefetchQueue(CRasterPrefetchQueue&&) = delete;
+        CRasterPrefetchQueue& operator=(CRasterPrefetchQueue&&) = delete;
+
+        // The future becomes ready once every request in the batch has completed,
+        // holding true only if all of them were read in full
+        auto Submit(std::shared_ptr<const IPositionalStream> file, std::vector<SRasterReadRequest> batch,
+            CompletionCallback on_complete = {}) -> std::future<bool>;
+
+        // Blocks until the queue is empty and no request is in flight
+        void WaitIdle();
+
+        [[nodiscard]] auto GetThreadCount() const -> int { return static_cast<int>(m_threads.size()); }
+        [[nodiscard]] auto GetPendingCount() const -> int { return m_pending; }
+
+      private:
+        struct SBatch;
+
+        struct SJob
+        {
+            std::shared_ptr<SBatch> Batch;
+            int Index = 0;
+        };
+
+        void WorkerMain();
+        static bool ExecuteRequest(const IPositionalStream& file, const SRasterReadRequest& request);
+
+        std::vector<std::thread> m_threads;
+        std::deque<SJob> m_jobs;
+        std::mutex m_mutex;
+        std::condition_variable m_job_available;
+        std::condition_variable m_idle;
+        std::atomic<int> m_pending;
+        bool m_stopping;
+    };
+
+} // namespace flightsimlib::io
+
+#endif
@@ -0,0 +1,88 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+#ifndef FLIGHTSIMLIB_IO_RECORDARENA_H
+#define FLIGHTSIMLIB_IO_RECORDARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+namespace flightsimlib::io
+{
+
+    // Monotonic memory for the records of one file. Deallocation is a no-op, and
+    // destroying the arena releases all of its blocks at once. Safe to allocate from
+    // several threads
+    class CRecordArena final : public std::pmr::memory_resource
+    {
+      public:
+        static constexpr size_t s_initial_block_size = 256 * 1024;
+
+        CRecordArena();
+        // copying not allowed
+        CRecordArena(const CRecordArena&) = delete;
+        CRecordArena& operator=(const CRecordArena&) = delete;
+        CRecordArena(CRecordArena&&) = delete;
+        CRecordArena& operator=(CRecordArena&&) = delete;
+
+        [[nodiscard]] auto GetAllocatedBytes() const -> size_t;
+
+        // Backing for the operator new of record types. Takes memory from the arena installed
+        // on this thread by CRecordArenaScope, or from the heap if there is none. Each block
+        // remembers where it came from, so FreeRecord only returns heap blocks
+        static auto AllocateRecord(size_t size) -> void*;
+        static auto FreeRecord(void* pointer) noexcept -> void;
+
+      private:
+        auto do_allocate(size_t bytes, size_t alignment) -> void* override;
+        auto do_deallocate(void* pointer, size_t bytes, size_t alignment) -> void override;
+        auto do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool override;
+
+        mutable std::mutex m_mutex;
+        std::pmr::monotonic_buffer_resource m_resource;
+        size_t m_allocated = 0;
+    };
+
+    // Installs an arena for the records allocated on the current thread while it lives.
+    // Records made outside any scope, such as clones and edits, go to the heap as before
+    class CRecordArenaScope
+    {
+      public:
+        explicit CRecordArenaScope(CRecordArena* arena);
+        ~CRecordArenaScope();
+        // copying not allowed
+        CRecordArenaScope(const CRecordArenaScope&) = delete;
+        CRecordArenaScope& operator=(const CRecordArenaScope&) = delete;
+
+      private:
+        CRecordArena* m_previous;
+    };
+
+} // namespace flightsimlib::io
+
+#endif
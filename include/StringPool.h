@@ -0,0 +1,117 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+#ifndef FLIGHTSIMLIB_IO_STRINGPOOL_H
+#define FLIGHTSIMLIB_IO_STRINGPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace flightsimlib::io
+{
+
+    // Append-only store of NUL terminated strings. Equal strings are stored once, and
+    // nothing is freed before the pool itself, so the views it hands out stay valid
+    class CStringPool
+    {
+      public:
+        CStringPool() = default;
+        // copying not allowed
+        CStringPool(const CStringPool&) = delete;
+        CStringPool& operator=(const CStringPool&) = delete;
+        CStringPool(CStringPool&&) = delete;
+        CStringPool& operator=(CStringPool&&) = delete;
+
+        // Safe to call from several threads
+        auto Intern(std::string_view value) -> std::string_view;
+
+        [[nodiscard]] auto GetCount() const -> int;
+        [[nodiscard]] auto GetAllocatedBytes() const -> size_t;
+
+      private:
+        auto Allocate(size_t size) -> char*;
+
+        static constexpr size_t s_block_size = 64 * 1024;
+
+        mutable std::mutex m_mutex;
+        std::unordered_set<std::string_view> m_strings;
+        std::vector<std::unique_ptr<char[]>> m_blocks;
+        char* m_cursor = nullptr;
+        size_t m_remaining = 0;
+        size_t m_allocated = 0;
+    };
+
+    // Immutable string field of a record. Short strings are stored inline, so they need
+    // neither a pool lookup nor a shared reference. Longer ones live either in a shared
+    // CStringPool or in a private copy, and the string keeps whichever alive
+    class CPooledString
+    {
+      public:
+        CPooledString() = default;
+        CPooledString(const char* value) : CPooledString(std::string_view{value != nullptr ? value : ""}) { }
+        CPooledString(const std::string& value) : CPooledString(std::string_view{value}) { }
+        CPooledString(std::string_view value);
+        // Interns into pool, or makes a private copy if pool is null
+        CPooledString(std::string_view value, const std::shared_ptr<CStringPool>& pool);
+
+        [[nodiscard]] auto c_str() const -> const char* { return m_data != nullptr ? m_data : m_inline; }
+
+        [[nodiscard]] auto data() const -> const char* { return c_str(); }
+
+        [[nodiscard]] auto size() const -> size_t { return m_size; }
+
+        [[nodiscard]] auto empty() const -> bool { return m_size == 0; }
+
+        [[nodiscard]] auto View() const -> std::string_view { return {c_str(), m_size}; }
+
+        operator std::string_view() const { return View(); }
+
+        static constexpr size_t s_inline_capacity = 15;
+
+      private:
+        auto AssignInline(std::string_view value) -> void;
+
+        // Null while the characters are inline
+        const char* m_data = nullptr;
+        uint32_t m_size = 0;
+        char m_inline[s_inline_capacity + 1] = {};
+        std::shared_ptr<const void> m_owner;
+    };
+
+    inline bool operator==(const CPooledString& lhs, std::string_view rhs) { return lhs.View() == rhs; }
+
+    inline bool operator!=(const CPooledString& lhs, std::string_view rhs) { return lhs.View() != rhs; }
+
+} // namespace flightsimlib::io
+
+#endif
@@ -0,0 +1,446 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     BglAirportTable.cpp
+//
+// Summary:  Column store of airport summaries with a filtered nearest airport
+//           search
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "BglAirportTable.h"
+
+#include "CpuFeatures.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iterator>
+#include <thread>
+#include <utility>
+
+#ifdef FLIGHTSIMLIB_X64
+#include <immintrin.h>
+#endif
+
+
+namespace flightsimlib::io
+{
+
+
+static constexpr auto s_pi = 3.14159265358979323846;
+static constexpr auto s_radians = s_pi / 180.0;
+
+// Great circle metres from a squared chord of the unit sphere
+static auto ToDistance(double chord_squared) -> double
+{
+    return 2.0 * std::asin(std::min(std::sqrt(chord_squared) / 2.0, 1.0)) * CQmidQuery::s_earth_radius;
+}
+
+// Max heap of the best rows so far, on squared chord. A row has to be no further than the
+// bound to be offered
+class CNearestRows
+{
+  public:
+    CNearestRows(int count, double limit) : m_count(count), m_bound(limit) { m_best.reserve(count); }
+
+    auto GetBound() const -> double { return m_bound; }
+
+    auto Offer(double distance, int row) -> void
+    {
+        if (static_cast<int>(m_best.size()) < m_count)
+        {
+            m_best.emplace_back(distance, row);
+            std::push_heap(m_best.begin(), m_best.end());
+        }
+        else if (distance < m_best.front().first)
+        {
+            std::pop_heap(m_best.begin(), m_best.end());
+            m_best.back() = { distance, row };
+            std::push_heap(m_best.begin(), m_best.end());
+        }
+        if (static_cast<int>(m_best.size()) == m_count)
+        {
+            m_bound = m_best.front().first;
+        }
+    }
+
+    // Nearest first
+    auto Sort() -> std::vector<std::pair<double, int>>&
+    {
+        std::sort_heap(m_best.begin(), m_best.end());
+        return m_best;
+    }
+
+  private:
+    int m_count;
+    double m_bound;
+    std::vector<std::pair<double, int>> m_best;
+};
+
+// Columns of the table and the point searched from, for the scans
+struct SNearestScan
+{
+    const float* RunwayLength;
+    const uint32_t* Flags;
+    const uint32_t* Fuel;
+    const double* X;
+    const double* Y;
+    const double* Z;
+    int Count; // Padded to whole blocks
+    double PointX;
+    double PointY;
+    double PointZ;
+};
+
+static auto ScanRows(const SNearestScan& scan, const SBglAirportFilter& filter, CNearestRows& best) -> void
+{
+    const auto fuel_value = filter.FuelValue & filter.FuelMask;
+    for (auto i = 0; i < scan.Count; ++i)
+    {
+        if (!(scan.RunwayLength[i] >= filter.MinRunwayLength) ||
+            (scan.Flags[i] & filter.RequiredFlags) != filter.RequiredFlags ||
+            (scan.Flags[i] & filter.ExcludedFlags) != 0 || (scan.Fuel[i] & filter.FuelMask) != fuel_value)
+        {
+            continue;
+        }
+        const auto dx = scan.X[i] - scan.PointX;
+        const auto dy = scan.Y[i] - scan.PointY;
+        const auto dz = scan.Z[i] - scan.PointZ;
+        const auto distance = dx * dx + dy * dy + dz * dz;
+        if (distance <= best.GetBound())
+        {
+            best.Offer(distance, i);
+        }
+    }
+}
+
+#ifdef FLIGHTSIMLIB_X64
+
+// As ScanRows, with the filter tested eight rows at a time and the distance four at a time
+FLIGHTSIMLIB_TARGET_AVX2 static auto ScanRowsAvx2(const SNearestScan& scan, const SBglAirportFilter& filter,
+    CNearestRows& best) -> void
+{
+    const auto min_length = _mm256_set1_ps(filter.MinRunwayLength);
+    const auto required = _mm256_set1_epi32(static_cast<int>(filter.RequiredFlags));
+    const auto excluded = _mm256_set1_epi32(static_cast<int>(filter.ExcludedFlags));
+    const auto fuel_mask = _mm256_set1_epi32(static_cast<int>(filter.FuelMask));
+    const auto fuel_value = _mm256_set1_epi32(static_cast<int>(filter.FuelValue & filter.FuelMask));
+    const auto zero = _mm256_setzero_si256();
+    const auto x = _mm256_set1_pd(scan.PointX);
+    const auto y = _mm256_set1_pd(scan.PointY);
+    const auto z = _mm256_set1_pd(scan.PointZ);
+    for (auto i = 0; i < scan.Count; i += 8)
+    {
+        const auto length = _mm256_loadu_ps(scan.RunwayLength + i);
+        auto pass = _mm256_castps_si256(_mm256_cmp_ps(length, min_length, _CMP_GE_OQ));
+        const auto flags = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(scan.Flags + i));
+        pass = _mm256_and_si256(pass, _mm256_cmpeq_epi32(_mm256_and_si256(flags, required), required));
+        pass = _mm256_and_si256(pass, _mm256_cmpeq_epi32(_mm256_and_si256(flags, excluded), zero));
+        const auto fuel = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(scan.Fuel + i));
+        pass = _mm256_and_si256(pass, _mm256_cmpeq_epi32(_mm256_and_si256(fuel, fuel_mask), fuel_value));
+        const auto passed = _mm256_movemask_ps(_mm256_castsi256_ps(pass));
+        if (passed == 0)
+        {
+            continue;
+        }
+
+        // Then the distance, for the halves with a row left
+        for (auto half = 0; half < 2; ++half)
+        {
+            const auto lanes = (passed >> (4 * half)) & 0xF;
+            if (lanes == 0)
+            {
+                continue;
+            }
+            const auto first = i + 4 * half;
+            const auto dx = _mm256_sub_pd(_mm256_loadu_pd(scan.X + first), x);
+            const auto dy = _mm256_sub_pd(_mm256_loadu_pd(scan.Y + first), y);
+            const auto dz = _mm256_sub_pd(_mm256_loadu_pd(scan.Z + first), z);
+            const auto distance = _mm256_add_pd(
+                _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz));
+            const auto bound = _mm256_set1_pd(best.GetBound());
+            const auto near = _mm256_movemask_pd(_mm256_cmp_pd(distance, bound, _CMP_LE_OQ)) & lanes;
+            if (near == 0)
+            {
+                continue;
+            }
+            double distances[4];
+            _mm256_storeu_pd(distances, distance);
+            for (auto lane = 0; lane < 4; ++lane)
+            {
+                if ((near & (1 << lane)) != 0 && distances[lane] <= best.GetBound())
+                {
+                    best.Offer(distances[lane], first + lane);
+                }
+            }
+        }
+    }
+}
+
+#endif
+
+
+//******************************************************************************
+// CBglAirportTable
+//******************************************************************************
+
+
+struct CBglAirportTable::SRow
+{
+    double Latitude;
+    double Longitude;
+    float RunwayLength;
+    uint32_t Flags;
+    uint32_t Fuel;
+    uint32_t Icao;
+    uint32_t Region;
+    int FileIndex;
+};
+
+
+auto CBglAirportTable::CollectFile(CBglFile& file, int file_index, std::vector<SRow>& rows) -> void
+{
+    file.ForEach<CBglAirportSummary>(
+        [&](const CBglAirportSummary& summary)
+        {
+            auto row = SRow{};
+            row.Latitude = summary.GetLatitude();
+            row.Longitude = summary.GetLongitude();
+            if (!std::isfinite(row.Latitude) || !std::isfinite(row.Longitude))
+            {
+                return;
+            }
+            row.RunwayLength = summary.GetLongestRunwayLength();
+            if (!std::isfinite(row.RunwayLength))
+            {
+                row.RunwayLength = 0.0f;
+            }
+
+            const std::pair<bool, uint32_t> flags[] = {
+                { summary.HasCom(), s_flag_com },
+                { summary.HasPavedRunway(), s_flag_paved_runway },
+                { summary.HasOnlyWaterRunway(), s_flag_only_water_runway },
+                { summary.HasGpsApproach(), s_flag_gps_approach },
+                { summary.HasVorApproach(), s_flag_vor_approach },
+                { summary.HasNdbApproach(), s_flag_ndb_approach },
+                { summary.HasIlsApproach(), s_flag_ils_approach },
+                { summary.HasLocApproach(), s_flag_loc_approach },
+                { summary.HasSdfApproach(), s_flag_sdf_approach },
+                { summary.HasLdaApproach(), s_flag_lda_approach },
+                { summary.HasVorDmeApproach(), s_flag_vor_dme_approach },
+                { summary.HasNdbDmeApproach(), s_flag_ndb_dme_approach },
+                { summary.HasRnavApproach(), s_flag_rnav_approach },
+                { summary.HasLocBcApproach(), s_flag_loc_bc_approach },
+            };
+            row.Flags = 0;
+            for (const auto& [set, bit] : flags)
+            {
+                row.Flags |= set ? bit : 0;
+            }
+
+            // Two bits per grade, in the order of the record
+            const IBglFuelAvailability::EFuelAvailability grades[] = { summary.Get73Octane(), summary.Get87Octane(),
+                summary.Get100Octane(), summary.Get130Octane(), summary.Get145Octane(), summary.GetMogas(),
+                summary.GetJet(), summary.GetJetA(), summary.GetJetA1(), summary.GetJetAP(), summary.GetJetB(),
+                summary.GetJet4(), summary.GetJet5() };
+            row.Fuel = 0;
+            for (auto i = 0; i < static_cast<int>(std::size(grades)); ++i)
+            {
+                row.Fuel |= static_cast<uint32_t>(grades[i]) << (2 * i);
+            }
+            row.Fuel |= summary.HasAvgas() ? s_fuel_avgas : 0;
+            row.Fuel |= summary.HasJetFuel() ? s_fuel_jet_fuel : 0;
+
+            row.Icao = summary.GetIcaoIdent();
+            row.Region = summary.GetRegionIdent();
+            row.FileIndex = file_index;
+            rows.emplace_back(row);
+        });
+}
+
+auto CBglAirportTable::Build(CBglFile& file) -> void
+{
+    auto file_rows = std::vector<std::vector<SRow>>(1);
+    CollectFile(file, 0, file_rows[0]);
+    BuildColumns(file_rows);
+}
+
+auto CBglAirportTable::Build(const std::vector<std::filesystem::path>& files, int num_threads) -> bool
+{
+    if (num_threads <= 0)
+    {
+        num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    // Each file is collected on its own, then joined in file order so the rows do not
+    // depend on scheduling
+    auto file_rows = std::vector<std::vector<SRow>>(files.size());
+    std::atomic<int> next_file{0};
+    std::atomic<bool> success{true};
+    auto worker = [&]()
+    {
+        for (auto i = next_file++; i < static_cast<int>(files.size()); i = next_file++)
+        {
+            auto file = CBglFile{files[i].wstring()};
+            if (!file.Read())
+            {
+                success = false;
+                continue;
+            }
+            CollectFile(file, i, file_rows[i]);
+        }
+    };
+
+    const auto thread_count = std::min(num_threads, static_cast<int>(files.size()));
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count > 1 ? thread_count - 1 : 0);
+    for (auto i = 1; i < thread_count; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    BuildColumns(file_rows);
+    return success;
+}
+
+auto CBglAirportTable::BuildColumns(const std::vector<std::vector<SRow>>& file_rows) -> void
+{
+    auto count = 0;
+    for (const auto& rows : file_rows)
+    {
+        count += static_cast<int>(rows.size());
+    }
+    m_count = count;
+
+    // Padding rows have a runway length that fails every comparison
+    const auto padded = (count + s_block_size - 1) / s_block_size * s_block_size;
+    m_latitude.assign(padded, 0.0);
+    m_longitude.assign(padded, 0.0);
+    m_x.assign(padded, 0.0);
+    m_y.assign(padded, 0.0);
+    m_z.assign(padded, 0.0);
+    m_runway_length.assign(padded, std::numeric_limits<float>::quiet_NaN());
+    m_flags.assign(padded, 0);
+    m_fuel.assign(padded, 0);
+    m_icao.assign(padded, 0);
+    m_region.assign(padded, 0);
+    m_file_index.assign(padded, -1);
+
+    auto i = 0;
+    for (const auto& rows : file_rows)
+    {
+        for (const auto& row : rows)
+        {
+            const auto phi = row.Latitude * s_radians;
+            const auto lambda = row.Longitude * s_radians;
+            m_latitude[i] = row.Latitude;
+            m_longitude[i] = row.Longitude;
+            m_x[i] = std::cos(phi) * std::cos(lambda);
+            m_y[i] = std::cos(phi) * std::sin(lambda);
+            m_z[i] = std::sin(phi);
+            m_runway_length[i] = row.RunwayLength;
+            m_flags[i] = row.Flags;
+            m_fuel[i] = row.Fuel;
+            m_icao[i] = row.Icao;
+            m_region[i] = row.Region;
+            m_file_index[i] = row.FileIndex;
+            ++i;
+        }
+    }
+}
+
+auto CBglAirportTable::FindNearest(double latitude, double longitude, int count, const SBglAirportFilter& filter,
+    std::vector<SBglAirportMatch>& matches) const -> void
+{
+    matches.clear();
+    if (count <= 0 || m_count == 0 || !(filter.MaxDistance >= 0.0))
+    {
+        return;
+    }
+    const auto phi = latitude * s_radians;
+    const auto lambda = longitude * s_radians;
+    const auto px = std::cos(phi) * std::cos(lambda);
+    const auto py = std::cos(phi) * std::sin(lambda);
+    const auto pz = std::sin(phi);
+
+    // Squared chord of the furthest distance allowed. Past half the earth there is no limit
+    auto limit = std::numeric_limits<double>::infinity();
+    const auto angle = filter.MaxDistance / CQmidQuery::s_earth_radius;
+    if (angle < s_pi)
+    {
+        const auto chord = 2.0 * std::sin(angle / 2.0);
+        limit = chord * chord;
+    }
+
+    auto best = CNearestRows{count, limit};
+    auto scan = SNearestScan{};
+    scan.RunwayLength = m_runway_length.data();
+    scan.Flags = m_flags.data();
+    scan.Fuel = m_fuel.data();
+    scan.X = m_x.data();
+    scan.Y = m_y.data();
+    scan.Z = m_z.data();
+    scan.Count = static_cast<int>(m_runway_length.size());
+    scan.PointX = px;
+    scan.PointY = py;
+    scan.PointZ = pz;
+#ifdef FLIGHTSIMLIB_X64
+    static_assert(s_block_size % 8 == 0, "The AVX2 scan reads whole blocks of eight rows");
+    if (CCpuFeatures::HasAvx2())
+    {
+        ScanRowsAvx2(scan, filter, best);
+    }
+    else
+    {
+        ScanRows(scan, filter, best);
+    }
+#else
+    ScanRows(scan, filter, best);
+#endif
+
+    const auto& nearest = best.Sort();
+    matches.reserve(nearest.size());
+    for (const auto& [distance, row] : nearest)
+    {
+        matches.push_back({ row, ToDistance(distance) });
+    }
+}
+
+
+}
@@ -0,0 +1,577 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+//******************************************************************************
+//
+// File:     BglCatalog.cpp
+//
+// Summary:  Persistent index of the BGL files of a scenery directory, so that
+//           tiles, airports and models can be located without opening every file
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "BglCatalog.h"
+
+#include "BglData.h"
+#include "BinaryStream.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+
+
+namespace flightsimlib::io
+{
+
+
+//******************************************************************************
+// CBglBloomFilter
+//******************************************************************************
+
+
+namespace
+{
+    // Spreads QMIDs, which differ mostly in their low bits, over the whole word
+    auto MixKey(uint64_t key) -> uint64_t
+    {
+        key ^= key >> 30;
+        key *= 0xBF58476D1CE4E5B9ull;
+        key ^= key >> 27;
+        key *= 0x94D049BB133111EBull;
+        key ^= key >> 31;
+        return key;
+    }
+}
+
+
+CBglBloomFilter::CBglBloomFilter(int expected_count)
+{
+    const auto bits = std::max<int64_t>(64, static_cast<int64_t>(expected_count) * s_bits_per_key);
+    m_words.resize(static_cast<size_t>((bits + 63) / 64));
+}
+
+auto CBglBloomFilter::Insert(uint64_t key) -> void
+{
+    if (m_words.empty())
+    {
+        return;
+    }
+    const auto hash = MixKey(key);
+    const auto bit_count = static_cast<uint64_t>(m_words.size()) * 64;
+    const auto step = (hash >> 32) | 1;
+    for (auto i = 0; i < s_hash_count; ++i)
+    {
+        const auto bit = ((hash & 0xFFFFFFFF) + i * step) % bit_count;
+        m_words[bit / 64] |= uint64_t{ 1 } << (bit % 64);
+    }
+}
+
+auto CBglBloomFilter::MayContain(uint64_t key) const -> bool
+{
+    if (m_words.empty())
+    {
+        return false;
+    }
+    const auto hash = MixKey(key);
+    const auto bit_count = static_cast<uint64_t>(m_words.size()) * 64;
+    const auto step = (hash >> 32) | 1;
+    for (auto i = 0; i < s_hash_count; ++i)
+    {
+        const auto bit = ((hash & 0xFFFFFFFF) + i * step) % bit_count;
+        if ((m_words[bit / 64] & (uint64_t{ 1 } << (bit % 64))) == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//******************************************************************************
+// CBglCatalog
+//******************************************************************************
+
+
+namespace
+{
+    auto IsBglFile(const std::filesystem::path& path) -> bool
+    {
+        auto extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension == ".bgl";
+    }
+}
+
+
+CBglCatalog::CBglCatalog(std::filesystem::path root) : m_root(std::move(root)) { }
+
+auto CBglCatalog::Load(const std::filesystem::path& catalog_file) -> bool
+{
+    m_files.clear();
+    m_icao_lookup.clear();
+    m_guid_lookup.clear();
+    m_indexed_count = 0;
+
+    auto bytes = std::vector<uint8_t>{};
+    {
+        auto file = std::ifstream(catalog_file, std::ios::in | std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            return false;
+        }
+        bytes.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0, std::ios::beg);
+        file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file)
+        {
+            return false;
+        }
+    }
+
+    auto in = BinaryFileStream{};
+    in.OpenView(bytes.data(), static_cast<int>(bytes.size()), 0);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t count = 0;
+    in >> magic >> version >> count;
+    if (!in || magic != s_magic || version != s_version)
+    {
+        return false;
+    }
+
+    // Counts are not trusted to size anything up front, a truncated file fails on the read
+    for (auto i = 0u; i < count; ++i)
+    {
+        auto entry = SBglCatalogFile{};
+        if (!ReadEntry(in, entry))
+        {
+            m_files.clear();
+            return false;
+        }
+        m_files.emplace_back(std::move(entry));
+    }
+
+    BuildLookups();
+    return true;
+}
+
+auto CBglCatalog::Save(const std::filesystem::path& catalog_file) const -> bool
+{
+    auto out = BinaryFileStream{};
+    out.OpenBuffer(64 * 1024);
+    out << s_magic << s_version << static_cast<uint32_t>(m_files.size());
+    for (const auto& entry : m_files)
+    {
+        WriteEntry(out, entry);
+    }
+    if (!out)
+    {
+        return false;
+    }
+    const auto* buffer = out.GetBuffer();
+
+    // Written next to the target and swapped in, like CBglFile::Write
+    auto temp_name = catalog_file;
+    temp_name += L".tmp";
+    {
+        auto temp = std::ofstream(temp_name, std::ios::out | std::ios::binary | std::ios::trunc);
+        temp.write(reinterpret_cast<const char*>(buffer->data()), static_cast<std::streamsize>(buffer->size()));
+        temp.close();
+        if (!temp || !FlushFileToDisk(temp_name))
+        {
+            std::error_code error;
+            std::filesystem::remove(temp_name, error);
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_name, catalog_file, error);
+    if (error)
+    {
+        std::filesystem::remove(temp_name, error);
+        return false;
+    }
+    return true;
+}
+
+auto CBglCatalog::Update() -> bool
+{
+    auto error = std::error_code{};
+    auto it = std::filesystem::recursive_directory_iterator(
+        m_root, std::filesystem::directory_options::skip_permission_denied, error);
+    if (error)
+    {
+        return false;
+    }
+
+    auto found = std::vector<SBglCatalogFile>{};
+    for (const auto end = std::filesystem::recursive_directory_iterator{}; it != end; it.increment(error))
+    {
+        if (error)
+        {
+            return false;
+        }
+        if (!it->is_regular_file(error) || !IsBglFile(it->path()))
+        {
+            continue;
+        }
+        auto entry = SBglCatalogFile{};
+        entry.FileSize = it->file_size(error);
+        const auto modified_time = it->last_write_time(error);
+        if (error)
+        {
+            // Removed while we were walking
+            error.clear();
+            continue;
+        }
+        entry.Path = it->path().lexically_relative(m_root);
+        entry.ModifiedTime = static_cast<int64_t>(modified_time.time_since_epoch().count());
+        found.emplace_back(std::move(entry));
+    }
+    std::sort(found.begin(), found.end(),
+        [](const SBglCatalogFile& lhs, const SBglCatalogFile& rhs) { return lhs.Path < rhs.Path; });
+
+    // Both lists are sorted by path, so the unchanged files are matched in one pass
+    m_indexed_count = 0;
+    auto previous = m_files.begin();
+    for (auto& entry : found)
+    {
+        while (previous != m_files.end() && previous->Path < entry.Path)
+        {
+            ++previous;
+        }
+        if (previous != m_files.end() && previous->Path == entry.Path && previous->FileSize == entry.FileSize &&
+            previous->ModifiedTime == entry.ModifiedTime)
+        {
+            entry = std::move(*previous);
+            continue;
+        }
+        entry.IsValid = IndexFile(m_root / entry.Path, entry);
+        ++m_indexed_count;
+    }
+
+    m_files = std::move(found);
+    BuildLookups();
+    return true;
+}
+
+auto CBglCatalog::FindQmid(CPackedQmid qmid, std::vector<SBglCatalogLocation>& locations) const -> int
+{
+    const auto key = qmid.Value();
+    auto count = 0;
+    for (auto i = 0; i < static_cast<int>(m_files.size()); ++i)
+    {
+        const auto& entry = m_files[i];
+        if (!entry.QmidFilter.MayContain(key))
+        {
+            continue;
+        }
+        for (const auto& layer : entry.Layers)
+        {
+            const auto tile = std::lower_bound(layer.Tiles.begin(), layer.Tiles.end(), key,
+                [](const SBglCatalogTile& lhs, uint64_t rhs) { return lhs.Qmid < rhs; });
+            if (tile != layer.Tiles.end() && tile->Qmid == key)
+            {
+                locations.push_back({ i, layer.Type, tile->StreamOffset, tile->SizeBytes });
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+auto CBglCatalog::FindIcao(uint32_t icao, std::vector<SBglCatalogLocation>& locations) const -> int
+{
+    const auto range = std::equal_range(m_icao_lookup.begin(), m_icao_lookup.end(),
+        std::make_pair(icao, SBglCatalogLocation{}),
+        [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        locations.push_back(it->second);
+    }
+    return static_cast<int>(range.second - range.first);
+}
+
+auto CBglCatalog::FindGuid(const _GUID& guid, std::vector<SBglCatalogLocation>& locations) const -> int
+{
+    const auto range = std::equal_range(m_guid_lookup.begin(), m_guid_lookup.end(),
+        std::make_pair(guid, SBglCatalogLocation{}),
+        [](const auto& lhs, const auto& rhs) { return GUIDComparer{}(lhs.first, rhs.first); });
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        locations.push_back(it->second);
+    }
+    return static_cast<int>(range.second - range.first);
+}
+
+auto CBglCatalog::IndexFile(const std::filesystem::path& file_name, SBglCatalogFile& entry) -> bool
+{
+    // Only the tables are read up front. Airport records are the one thing decoded, for
+    // their idents, and models are named by the GUID index alone
+    auto file = CBglFile(file_name.wstring());
+    file.SetReadFlags(EBglReadFlags::IndexOnly);
+    if (!file.Read())
+    {
+        return false;
+    }
+    entry.Header = file.GetHeader();
+
+    auto qmids = std::vector<CPackedQmid>{};
+    auto tile_count = 0;
+    for (const auto& layer : file.m_layers)
+    {
+        if (layer == nullptr)
+        {
+            continue;
+        }
+        auto catalog_layer = SBglCatalogLayer{};
+        catalog_layer.Type = layer->GetType();
+        const auto is_airport = CBglLayer::GetRecordType(catalog_layer.Type) == EBglLayerType::Airport;
+
+        qmids.clear();
+        layer->GetTileQmids(qmids);
+        if (auto* direct = layer->AsDirectQmidLayer(); direct != nullptr)
+        {
+            // Tile QMIDs and pointers are stored side by side
+            for (auto i = 0; i < static_cast<int>(qmids.size()); ++i)
+            {
+                const auto* pointer = direct->GetDataPointerAtIndex(i);
+                catalog_layer.Tiles.push_back({ qmids[i].Value(), pointer->StreamOffset, pointer->SizeBytes });
+                if (!is_airport)
+                {
+                    continue;
+                }
+                // Records of a direct layer are not addressable on their own, so they point at the tile.
+                // They are only read, through the const lookup, so a store shared with another layer
+                // stays shared
+                const auto& tiles = *direct;
+                const auto record_count = direct->GetDataCountAtQmid(qmids[i]);
+                for (auto j = 0; j < record_count; ++j)
+                {
+                    const auto* data = static_cast<const CBglData*>(tiles.GetDataAtQmid(qmids[i], j));
+                    if (data != nullptr && data->GetType() == EBglLayerType::Airport)
+                    {
+                        const auto* airport = static_cast<const CBglAirport*>(data->GetRecord());
+                        entry.Airports.push_back(
+                            { airport->GetIcaoIdent(), catalog_layer.Type, pointer->StreamOffset, pointer->SizeBytes });
+                    }
+                }
+            }
+        }
+        else if (auto* indirect = layer->AsIndirectQmidLayer(); indirect != nullptr)
+        {
+            for (const auto qmid : qmids)
+            {
+                const auto* pointer = indirect->GetDataPointerAtQmid(qmid);
+                catalog_layer.Tiles.push_back({ qmid.Value(), pointer->StreamOffset, pointer->SizeBytes });
+            }
+            if (is_airport)
+            {
+                // Pointers belong to tile entries, and a record listed under several tiles is indexed once
+                auto seen = std::vector<bool>(indirect->GetDataCount());
+                for (const auto qmid : qmids)
+                {
+                    const auto record_count = indirect->GetDataCountAtQmid(qmid);
+                    for (auto j = 0; j < record_count; ++j)
+                    {
+                        const auto index = indirect->GetDataIndexAtQmid(qmid, j);
+                        if (index < 0 || seen[index])
+                        {
+                            continue;
+                        }
+                        seen[index] = true;
+                        auto* data = indirect->GetDataAtIndex(index);
+                        auto* airport = data != nullptr ? data->AsAirport() : nullptr;
+                        if (airport != nullptr)
+                        {
+                            const auto* pointer = indirect->GetIndirectPointerAtQmid(qmid, j);
+                            entry.Airports.push_back({ airport->GetIcaoIdent(), catalog_layer.Type,
+                                pointer->StreamOffset, pointer->SizeBytes });
+                        }
+                    }
+                }
+            }
+        }
+        else if (auto* guids = layer->AsGuidLayer();
+                 guids != nullptr && CBglLayer::GetRecordType(catalog_layer.Type) == EBglLayerType::ModelData)
+        {
+            for (auto i = 0; i < guids->GetGuidCount(); ++i)
+            {
+                const auto* pointer = guids->GetGuidPointerAt(i);
+                entry.Models.push_back(
+                    { pointer->Name, catalog_layer.Type, pointer->StreamOffset, pointer->SizeBytes });
+            }
+        }
+
+        std::sort(catalog_layer.Tiles.begin(), catalog_layer.Tiles.end(),
+            [](const SBglCatalogTile& lhs, const SBglCatalogTile& rhs) { return lhs.Qmid < rhs.Qmid; });
+        tile_count += static_cast<int>(catalog_layer.Tiles.size());
+        entry.Layers.emplace_back(std::move(catalog_layer));
+    }
+
+    entry.QmidFilter = CBglBloomFilter(tile_count);
+    for (const auto& layer : entry.Layers)
+    {
+        for (const auto& tile : layer.Tiles)
+        {
+            entry.QmidFilter.Insert(tile.Qmid);
+        }
+    }
+    return true;
+}
+
+auto CBglCatalog::ReadEntry(BinaryFileStream& in, SBglCatalogFile& entry) -> bool
+{
+    uint32_t path_length = 0;
+    in >> path_length;
+    entry.Path = std::filesystem::u8path(in.ReadString(static_cast<int>(path_length)));
+    uint8_t is_valid = 0;
+    in >> entry.ModifiedTime >> entry.FileSize >> is_valid;
+    entry.IsValid = is_valid != 0;
+    entry.Header = SBglHeader::ReadBinary(in);
+
+    uint32_t layer_count = 0;
+    in >> layer_count;
+    for (auto i = 0u; i < layer_count && in; ++i)
+    {
+        auto layer = SBglCatalogLayer{};
+        uint32_t type = 0;
+        uint32_t tile_count = 0;
+        in >> type >> tile_count;
+        layer.Type = static_cast<EBglLayerType>(type);
+        for (auto j = 0u; j < tile_count && in; ++j)
+        {
+            auto tile = SBglCatalogTile{};
+            in >> tile.Qmid >> tile.StreamOffset >> tile.SizeBytes;
+            layer.Tiles.push_back(tile);
+        }
+        entry.Layers.emplace_back(std::move(layer));
+    }
+
+    uint32_t airport_count = 0;
+    in >> airport_count;
+    for (auto i = 0u; i < airport_count && in; ++i)
+    {
+        auto airport = SBglCatalogAirport{};
+        uint32_t type = 0;
+        in >> airport.Icao >> type >> airport.StreamOffset >> airport.SizeBytes;
+        airport.LayerType = static_cast<EBglLayerType>(type);
+        entry.Airports.push_back(airport);
+    }
+
+    uint32_t model_count = 0;
+    in >> model_count;
+    for (auto i = 0u; i < model_count && in; ++i)
+    {
+        auto model = SBglCatalogModel{};
+        uint32_t type = 0;
+        in >> model.Guid >> type >> model.StreamOffset >> model.SizeBytes;
+        model.LayerType = static_cast<EBglLayerType>(type);
+        entry.Models.push_back(model);
+    }
+
+    uint32_t word_count = 0;
+    in >> word_count;
+    auto words = std::vector<uint64_t>{};
+    for (auto i = 0u; i < word_count && in; ++i)
+    {
+        uint64_t word = 0;
+        in >> word;
+        words.push_back(word);
+    }
+    entry.QmidFilter.SetWords(std::move(words));
+
+    return static_cast<bool>(in);
+}
+
+auto CBglCatalog::WriteEntry(BinaryFileStream& out, const SBglCatalogFile& entry) -> void
+{
+    const auto path = entry.Path.generic_u8string();
+    out << static_cast<uint32_t>(path.size());
+    out.Write(path.data(), static_cast<int>(path.size()));
+    out << entry.ModifiedTime << entry.FileSize << static_cast<uint8_t>(entry.IsValid ? 1 : 0);
+    SBglHeader::WriteBinary(out, entry.Header);
+
+    out << static_cast<uint32_t>(entry.Layers.size());
+    for (const auto& layer : entry.Layers)
+    {
+        out << static_cast<uint32_t>(layer.Type) << static_cast<uint32_t>(layer.Tiles.size());
+        for (const auto& tile : layer.Tiles)
+        {
+            out << tile.Qmid << tile.StreamOffset << tile.SizeBytes;
+        }
+    }
+
+    out << static_cast<uint32_t>(entry.Airports.size());
+    for (const auto& airport : entry.Airports)
+    {
+        out << airport.Icao << static_cast<uint32_t>(airport.LayerType) << airport.StreamOffset << airport.SizeBytes;
+    }
+
+    out << static_cast<uint32_t>(entry.Models.size());
+    for (const auto& model : entry.Models)
+    {
+        out << model.Guid << static_cast<uint32_t>(model.LayerType) << model.StreamOffset << model.SizeBytes;
+    }
+
+    const auto& words = entry.QmidFilter.GetWords();
+    out << static_cast<uint32_t>(words.size());
+    for (const auto word : words)
+    {
+        out << word;
+    }
+}
+
+auto CBglCatalog::BuildLookups() -> void
+{
+    m_icao_lookup.clear();
+    m_guid_lookup.clear();
+    for (auto i = 0; i < static_cast<int>(m_files.size()); ++i)
+    {
+        for (const auto& airport : m_files[i].Airports)
+        {
+            m_icao_lookup.push_back(
+                { airport.Icao, { i, airport.LayerType, airport.StreamOffset, airport.SizeBytes } });
+        }
+        for (const auto& model : m_files[i].Models)
+        {
+            m_guid_lookup.push_back({ model.Guid, { i, model.LayerType, model.StreamOffset, model.SizeBytes } });
+        }
+    }
+    // Stable, so that matches come back in file order
+    std::stable_sort(m_icao_lookup.begin(), m_icao_lookup.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    std::stable_sort(m_guid_lookup.begin(), m_guid_lookup.end(),
+        [](const auto& lhs, const auto& rhs) { return GUIDComparer{}(lhs.first, rhs.first); });
+}
+
+
+}
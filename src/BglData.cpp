@@ -42,6 +42,7 @@
 #include "BglFile.h"
 #include "BinaryStream.h"
 
+#include <algorithm>
 #include <cstring>
 #include <type_traits>
 
@@ -53,12 +54,12 @@ template <typename T> constexpr auto to_integral(T e) -> typename std::underlyin
 
 template <typename T> T get_packed_bits(T src, int num_bits, int position)
 {
-    return (src >> position) & (1 << (num_bits - 1));
+    return static_cast<T>((src >> position) & ((1u << num_bits) - 1));
 }
 
 template <typename T> void set_packed_bits(T& dest, int value, int num_bits, int position)
 {
-    dest &= ~((1 << (num_bits - 1)) << position);
+    dest &= ~(((1u << num_bits) - 1) << position);
     dest |= static_cast<uint32_t>(value) << position;
 }
 
@@ -66,228 +67,249 @@ template <typename T> void set_packed_bits(T& dest, int value, int num_bits, int
 // CBglFuelAvailability
 //******************************************************************************
 
-template <typename T> flightsimlib::io::CBglFuelAvailability<T>::CBglFuelAvailability(T& data) : m_data(data) { }
-
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::Get73Octane() const -> EFuelAvailability
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::Get73Octane() const -> EFuelAvailability
 {
     return static_cast<EFuelAvailability>(
-        get_packed_bits(m_data->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Octane73)));
+        get_packed_bits(GetData()->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Octane73)));
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::Set73Octane(EFuelAvailability value) -> void
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::Set73Octane(EFuelAvailability value) -> void
 {
-    set_packed_bits(
-        m_data.write().FuelAvailability, to_integral(value), s_num_availability_bits, to_integral(EFuelBits::Octane73));
+    set_packed_bits(GetData().write().FuelAvailability, to_integral(value), s_num_availability_bits,
+        to_integral(EFuelBits::Octane73));
 
     UpdateAvgasAvailability(value);
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::Get87Octane() const -> EFuelAvailability
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::Get87Octane() const -> EFuelAvailability
 {
     return static_cast<EFuelAvailability>(
-        get_packed_bits(m_data->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Octane87)));
+        get_packed_bits(GetData()->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Octane87)));
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::Set87Octane(EFuelAvailability value) -> void
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::Set87Octane(EFuelAvailability value) -> void
 {
-    set_packed_bits(
-        m_data.write().FuelAvailability, to_integral(value), s_num_availability_bits, to_integral(EFuelBits::Octane87));
+    set_packed_bits(GetData().write().FuelAvailability, to_integral(value), s_num_availability_bits,
+        to_integral(EFuelBits::Octane87));
 
     UpdateAvgasAvailability(value);
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::Get100Octane() const -> EFuelAvailability
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::Get100Octane() const -> EFuelAvailability
 {
     return static_cast<EFuelAvailability>(
-        get_packed_bits(m_data->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Octane100)));
+        get_packed_bits(GetData()->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Octane100)));
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::Set100Octane(EFuelAvailability value) -> void
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::Set100Octane(EFuelAvailability value) -> void
 {
-    set_packed_bits(m_data.write().FuelAvailability, to_integral(value), s_num_availability_bits,
+    set_packed_bits(GetData().write().FuelAvailability, to_integral(value), s_num_availability_bits,
         to_integral(EFuelBits::Octane100));
 
     UpdateAvgasAvailability(value);
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::Get130Octane() const -> EFuelAvailability
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::Get130Octane() const -> EFuelAvailability
 {
     return static_cast<EFuelAvailability>(
-        get_packed_bits(m_data->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Octane130)));
+        get_packed_bits(GetData()->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Octane130)));
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::Set130Octane(EFuelAvailability value) -> void
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::Set130Octane(EFuelAvailability value) -> void
 {
-    set_packed_bits(m_data.write().FuelAvailability, to_integral(value), s_num_availability_bits,
+    set_packed_bits(GetData().write().FuelAvailability, to_integral(value), s_num_availability_bits,
         to_integral(EFuelBits::Octane130));
 
     UpdateAvgasAvailability(value);
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::Get145Octane() const -> EFuelAvailability
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::Get145Octane() const -> EFuelAvailability
 {
     return static_cast<EFuelAvailability>(
-        get_packed_bits(m_data->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Octane145)));
+        get_packed_bits(GetData()->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Octane145)));
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::Set145Octane(EFuelAvailability value) -> void
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::Set145Octane(EFuelAvailability value) -> void
 {
-    set_packed_bits(m_data.write().FuelAvailability, to_integral(value), s_num_availability_bits,
+    set_packed_bits(GetData().write().FuelAvailability, to_integral(value), s_num_availability_bits,
         to_integral(EFuelBits::Octane145));
 
     UpdateAvgasAvailability(value);
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::GetMogas() const -> EFuelAvailability
+template <typename TRecord> auto flightsimlib::io::CBglFuelAvailability<TRecord>::GetMogas() const -> EFuelAvailability
 {
     return static_cast<EFuelAvailability>(
-        get_packed_bits(m_data->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Mogas)));
+        get_packed_bits(GetData()->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Mogas)));
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::SetMogas(EFuelAvailability value) -> void
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::SetMogas(EFuelAvailability value) -> void
 {
-    set_packed_bits(
-        m_data.write().FuelAvailability, to_integral(value), s_num_availability_bits, to_integral(EFuelBits::Mogas));
+    set_packed_bits(GetData().write().FuelAvailability, to_integral(value), s_num_availability_bits,
+        to_integral(EFuelBits::Mogas));
 
     UpdateAvgasAvailability(value); // TODO - verify mogas counts as avgas?
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::GetJet() const -> EFuelAvailability
+template <typename TRecord> auto flightsimlib::io::CBglFuelAvailability<TRecord>::GetJet() const -> EFuelAvailability
 {
     return static_cast<EFuelAvailability>(
-        get_packed_bits(m_data->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Jet)));
+        get_packed_bits(GetData()->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Jet)));
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::SetJet(EFuelAvailability value) -> void
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::SetJet(EFuelAvailability value) -> void
 {
-    set_packed_bits(
-        m_data.write().FuelAvailability, to_integral(value), s_num_availability_bits, to_integral(EFuelBits::Jet));
+    set_packed_bits(GetData().write().FuelAvailability, to_integral(value), s_num_availability_bits,
+        to_integral(EFuelBits::Jet));
 
     UpdateJetFuelAvailability(value);
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::GetJetA() const -> EFuelAvailability
+template <typename TRecord> auto flightsimlib::io::CBglFuelAvailability<TRecord>::GetJetA() const -> EFuelAvailability
 {
     return static_cast<EFuelAvailability>(
-        get_packed_bits(m_data->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::JetA)));
+        get_packed_bits(GetData()->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::JetA)));
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::SetJetA(EFuelAvailability value) -> void
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::SetJetA(EFuelAvailability value) -> void
 {
-    set_packed_bits(
-        m_data.write().FuelAvailability, to_integral(value), s_num_availability_bits, to_integral(EFuelBits::JetA));
+    set_packed_bits(GetData().write().FuelAvailability, to_integral(value), s_num_availability_bits,
+        to_integral(EFuelBits::JetA));
 
     UpdateJetFuelAvailability(value);
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::GetJetA1() const -> EFuelAvailability
+template <typename TRecord> auto flightsimlib::io::CBglFuelAvailability<TRecord>::GetJetA1() const -> EFuelAvailability
 {
     return static_cast<EFuelAvailability>(
-        get_packed_bits(m_data->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::JetA1)));
+        get_packed_bits(GetData()->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::JetA1)));
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::SetJetA1(EFuelAvailability value) -> void
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::SetJetA1(EFuelAvailability value) -> void
 {
-    set_packed_bits(
-        m_data.write().FuelAvailability, to_integral(value), s_num_availability_bits, to_integral(EFuelBits::JetA1));
+    set_packed_bits(GetData().write().FuelAvailability, to_integral(value), s_num_availability_bits,
+        to_integral(EFuelBits::JetA1));
 
     UpdateJetFuelAvailability(value);
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::GetJetAP() const -> EFuelAvailability
+template <typename TRecord> auto flightsimlib::io::CBglFuelAvailability<TRecord>::GetJetAP() const -> EFuelAvailability
 {
     return static_cast<EFuelAvailability>(
-        get_packed_bits(m_data->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::JetAP)));
+        get_packed_bits(GetData()->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::JetAP)));
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::SetJetAP(EFuelAvailability value) -> void
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::SetJetAP(EFuelAvailability value) -> void
 {
-    set_packed_bits(
-        m_data.write().FuelAvailability, to_integral(value), s_num_availability_bits, to_integral(EFuelBits::JetAP));
+    set_packed_bits(GetData().write().FuelAvailability, to_integral(value), s_num_availability_bits,
+        to_integral(EFuelBits::JetAP));
 
     UpdateJetFuelAvailability(value);
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::GetJetB() const -> EFuelAvailability
+template <typename TRecord> auto flightsimlib::io::CBglFuelAvailability<TRecord>::GetJetB() const -> EFuelAvailability
 {
     return static_cast<EFuelAvailability>(
-        get_packed_bits(m_data->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::JetB)));
+        get_packed_bits(GetData()->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::JetB)));
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::SetJetB(EFuelAvailability value) -> void
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::SetJetB(EFuelAvailability value) -> void
 {
-    set_packed_bits(
-        m_data.write().FuelAvailability, to_integral(value), s_num_availability_bits, to_integral(EFuelBits::JetB));
+    set_packed_bits(GetData().write().FuelAvailability, to_integral(value), s_num_availability_bits,
+        to_integral(EFuelBits::JetB));
 
     UpdateJetFuelAvailability(value);
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::GetJet4() const -> EFuelAvailability
+template <typename TRecord> auto flightsimlib::io::CBglFuelAvailability<TRecord>::GetJet4() const -> EFuelAvailability
 {
     return static_cast<EFuelAvailability>(
-        get_packed_bits(m_data->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Jet4)));
+        get_packed_bits(GetData()->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Jet4)));
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::SetJet4(EFuelAvailability value) -> void
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::SetJet4(EFuelAvailability value) -> void
 {
-    set_packed_bits(
-        m_data.write().FuelAvailability, to_integral(value), s_num_availability_bits, to_integral(EFuelBits::Jet4));
+    set_packed_bits(GetData().write().FuelAvailability, to_integral(value), s_num_availability_bits,
+        to_integral(EFuelBits::Jet4));
 
     UpdateJetFuelAvailability(value);
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::GetJet5() const -> EFuelAvailability
+template <typename TRecord> auto flightsimlib::io::CBglFuelAvailability<TRecord>::GetJet5() const -> EFuelAvailability
 {
     return static_cast<EFuelAvailability>(
-        get_packed_bits(m_data->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Jet5)));
+        get_packed_bits(GetData()->FuelAvailability, s_num_availability_bits, to_integral(EFuelBits::Jet5)));
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::SetJet5(EFuelAvailability value) -> void
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::SetJet5(EFuelAvailability value) -> void
 {
-    set_packed_bits(
-        m_data.write().FuelAvailability, to_integral(value), s_num_availability_bits, to_integral(EFuelBits::Jet5));
+    set_packed_bits(GetData().write().FuelAvailability, to_integral(value), s_num_availability_bits,
+        to_integral(EFuelBits::Jet5));
 
     UpdateJetFuelAvailability(value);
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::HasAvgas() const -> bool
+template <typename TRecord> auto flightsimlib::io::CBglFuelAvailability<TRecord>::HasAvgas() const -> bool
 {
-    return static_cast<bool>(get_packed_bits(m_data->FuelAvailability, 1, to_integral(EFuelBits::Avgas)));
+    return static_cast<bool>(get_packed_bits(GetData()->FuelAvailability, 1, to_integral(EFuelBits::Avgas)));
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::HasJetFuel() const -> bool
+template <typename TRecord> auto flightsimlib::io::CBglFuelAvailability<TRecord>::HasJetFuel() const -> bool
 {
-    return static_cast<bool>(get_packed_bits(m_data->FuelAvailability, 1, to_integral(EFuelBits::JetFuel)));
+    return static_cast<bool>(get_packed_bits(GetData()->FuelAvailability, 1, to_integral(EFuelBits::JetFuel)));
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::UpdateAvgasAvailability(EFuelAvailability value)
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::UpdateAvgasAvailability(EFuelAvailability value)
 {
     if (value == EFuelAvailability::Yes && !HasAvgas())
     {
-        set_packed_bits(m_data.write().FuelAvailability, true, 1, to_integral(EFuelBits::Avgas));
+        set_packed_bits(GetData().write().FuelAvailability, true, 1, to_integral(EFuelBits::Avgas));
     }
     else if (value != EFuelAvailability::Yes && HasAvgas())
     {
-        if (get_packed_bits(m_data->FuelAvailability, to_integral(EFuelBits::Jet), to_integral(EFuelBits::Octane73)) ==
-            0)
+        // Avgas grades are the fields from Octane73 up to Jet
+        constexpr auto avgas_bits = to_integral(EFuelBits::Jet) - to_integral(EFuelBits::Octane73);
+        if (get_packed_bits(GetData()->FuelAvailability, avgas_bits, to_integral(EFuelBits::Octane73)) == 0)
         {
-            set_packed_bits(m_data.write().FuelAvailability, false, 1, to_integral(EFuelBits::Avgas));
+            set_packed_bits(GetData().write().FuelAvailability, false, 1, to_integral(EFuelBits::Avgas));
         }
     }
 }
 
-template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::UpdateJetFuelAvailability(EFuelAvailability value)
+template <typename TRecord>
+auto flightsimlib::io::CBglFuelAvailability<TRecord>::UpdateJetFuelAvailability(EFuelAvailability value)
 {
     if (value == EFuelAvailability::Yes && !HasJetFuel())
     {
-        set_packed_bits(m_data.write().FuelAvailability, true, 1, to_integral(EFuelBits::JetFuel));
+        set_packed_bits(GetData().write().FuelAvailability, true, 1, to_integral(EFuelBits::JetFuel));
     }
     else if (value != EFuelAvailability::Yes && HasJetFuel())
     {
-        if (get_packed_bits(m_data->FuelAvailability, to_integral(EFuelBits::Reserved1), to_integral(EFuelBits::Jet)) ==
-            0)
+        // Jet grades are the fields from Jet up to Reserved1. Wider, and the JetFuel flag itself
+        // would be counted, so it could never be cleared
+        constexpr auto jet_bits = to_integral(EFuelBits::Reserved1) - to_integral(EFuelBits::Jet);
+        if (get_packed_bits(GetData()->FuelAvailability, jet_bits, to_integral(EFuelBits::Jet)) == 0)
         {
-            set_packed_bits(m_data.write().FuelAvailability, false, 1, to_integral(EFuelBits::JetFuel));
+            set_packed_bits(GetData().write().FuelAvailability, false, 1, to_integral(EFuelBits::JetFuel));
         }
     }
 }
@@ -296,60 +318,65 @@ template <typename T> auto flightsimlib::io::CBglFuelAvailability<T>::UpdateJetF
 // CBglLLA
 //******************************************************************************
 
-template <typename T> flightsimlib::io::CBglLLA<T>::CBglLLA(T& data) : m_data(data) { }
-
-template <typename T> auto flightsimlib::io::CBglLLA<T>::GetLongitude() const -> double
+template <typename TRecord> auto flightsimlib::io::CBglLLA<TRecord>::GetLongitude() const -> double
 {
-    return Longitude::Value(m_data.get()->Longitude);
+    return Longitude::Value(GetData()->Longitude);
 }
 
-template <typename T> auto flightsimlib::io::CBglLLA<T>::SetLongitude(double value) -> void
+template <typename TRecord> auto flightsimlib::io::CBglLLA<TRecord>::SetLongitude(double value) -> void
 {
-    m_data.get().write().Longitude = Longitude::ToPacked(value);
+    GetData().write().Longitude = Longitude::ToPacked(value);
 }
 
-template <typename T> auto flightsimlib::io::CBglLLA<T>::GetLatitude() const -> double
+template <typename TRecord> auto flightsimlib::io::CBglLLA<TRecord>::GetLatitude() const -> double
 {
-    return Latitude::Value(m_data.get()->Latitude);
+    return Latitude::Value(GetData()->Latitude);
 }
 
-template <typename T> auto flightsimlib::io::CBglLLA<T>::SetLatitude(double value) -> void
+template <typename TRecord> auto flightsimlib::io::CBglLLA<TRecord>::SetLatitude(double value) -> void
 {
-    m_data.get().write().Latitude = Latitude::ToPacked(value);
+    GetData().write().Latitude = Latitude::ToPacked(value);
 }
 
-template <typename T> auto flightsimlib::io::CBglLLA<T>::GetAltitude() const -> double
+template <typename TRecord> auto flightsimlib::io::CBglLLA<TRecord>::GetAltitude() const -> double
 {
-    return PackedAltitude::Value(m_data.get()->Altitude);
+    return PackedAltitude::Value(GetData()->Altitude);
 }
 
-template <typename T> auto flightsimlib::io::CBglLLA<T>::SetAltitude(double value) -> void
+template <typename TRecord> auto flightsimlib::io::CBglLLA<TRecord>::SetAltitude(double value) -> void
 {
-    m_data.get().write().Altitude = PackedAltitude::FromDouble(value);
+    GetData().write().Altitude = PackedAltitude::FromDouble(value);
 }
 
 class CBglString
 {
 public:
-    template <typename T> static auto CalculatePadSize(T& m_data, const int remaining_size, int pad_to = 4) -> int
+    static auto CalculatePadSize(const flightsimlib::io::CPooledString& name, const int remaining_size,
+                                 int pad_to = 4) -> int
     {
-        const auto remainder = static_cast<int>(m_data->Name.size() + remaining_size) % pad_to;
+        const auto remainder = static_cast<int>(name.size() + remaining_size) % pad_to;
         return pad_to - (remainder == 0 ? pad_to : remainder);
     }
 
-    template <typename T>
-    static auto ReadBinary(T& m_data, const int remaining_size, flightsimlib::io::BinaryFileStream& in) -> void
+    static auto ReadBinary(uint32_t size, const int remaining_size, flightsimlib::io::BinaryFileStream& in)
+        -> flightsimlib::io::CPooledString
     {
-        m_data.write().Name = in.ReadString(static_cast<int>(m_data->Size) - remaining_size);
-        m_data.write().Name.erase(std::find(m_data->Name.begin(), m_data->Name.end(), '\0'), m_data->Name.end());
+        return ReadPadded(in, static_cast<int>(size) - remaining_size);
     }
 
-    template <typename T>
-    static auto WriteBinary(T& m_data, const int remaining_size, flightsimlib::io::BinaryFileStream& out) -> void
+    // Name fields are NUL padded to their record size
+    static auto ReadPadded(flightsimlib::io::BinaryFileStream& in, int size) -> flightsimlib::io::CPooledString
     {
-        out.Write(m_data->Name.c_str(), static_cast<int>(m_data->Name.size()));
+        const auto value = in.ReadStringView(size);
+        return flightsimlib::io::CPooledString(value.substr(0, value.find('\0')), in.GetStringPool());
+    }
 
-        const auto num_pad = CalculatePadSize(m_data, remaining_size);
+    static auto WriteBinary(const flightsimlib::io::CPooledString& name, const int remaining_size,
+                            flightsimlib::io::BinaryFileStream& out) -> void
+    {
+        out.Write(name.c_str(), static_cast<int>(name.size()));
+
+        const auto num_pad = CalculatePadSize(name, remaining_size);
         const auto pad = uint8_t{0};
         for (auto i = 0; i < num_pad; ++i)
         {
@@ -366,31 +393,31 @@ auto flightsimlib::io::CBglName::ReadBinary(BinaryFileStream& in) -> void
 {
     in >> m_data.write().Type >> m_data.write().Size;
 
-    CBglString::ReadBinary(m_data, CalculateRemainingSize(), in);
+    m_name = CBglString::ReadBinary(m_data->Size, CalculateRemainingSize(), in);
 }
 
 auto flightsimlib::io::CBglName::WriteBinary(BinaryFileStream& out) -> void
 {
     out << m_data->Type << m_data->Size;
 
-    CBglString::WriteBinary(m_data, CalculateRemainingSize(), out);
+    CBglString::WriteBinary(m_name, CalculateRemainingSize(), out);
 }
 
 auto flightsimlib::io::CBglName::Validate() -> bool { return true; }
 
 auto flightsimlib::io::CBglName::CalculateSize() const -> int
 {
-    return static_cast<int>(CalculateRemainingSize() + m_data->Name.size() +
-                            CBglString::CalculatePadSize(m_data, CalculateRemainingSize()));
+    return static_cast<int>(CalculateRemainingSize() + m_name.size() +
+                            CBglString::CalculatePadSize(m_name, CalculateRemainingSize()));
 }
 
-auto flightsimlib::io::CBglName::GetName() const -> const char* { return m_data->Name.c_str(); }
+auto flightsimlib::io::CBglName::GetName() const -> const char* { return m_name.c_str(); }
 
-auto flightsimlib::io::CBglName::SetName(const char* value) -> void { m_data.write().Name = value; }
+auto flightsimlib::io::CBglName::SetName(const char* value) -> void { m_name = value; }
 
 auto flightsimlib::io::CBglName::IsEmpty() const -> bool
 {
-    if (m_data->Type == 0 || m_data->Name.empty())
+    if (m_data->Type == 0 || m_name.empty())
     {
         return true;
     }
@@ -408,9 +435,7 @@ auto flightsimlib::io::CBglName::CalculateRemainingSize() const -> int
 
 auto flightsimlib::io::CBglNdb::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.NdbType >> data.Frequency >> data.Longitude >> data.Latitude >>
-        data.Altitude >> data.Range >> data.MagVar >> data.Icao >> data.Region;
+    m_data.write() = in.ReadPacked<SBglNdbData>();
 
     CBglName::ReadBinary(in);
 }
@@ -460,8 +485,7 @@ auto flightsimlib::io::CBglNdb::SetRegion(uint32_t value) -> void { m_data.write
 
 void flightsimlib::io::CBglRunway::CBglRunwayEnd::ReadBinary(BinaryFileStream& in)
 {
-    auto& data = m_data.write();
-    in >> data.Position >> data.Size >> data.SurfaceType >> data.Length >> data.Width;
+    m_data.write() = in.ReadPacked<SBglRunwayEndData>();
 }
 
 void flightsimlib::io::CBglRunway::CBglRunwayEnd::WriteBinary(BinaryFileStream& out)
@@ -519,8 +543,7 @@ auto flightsimlib::io::CBglRunway::CBglRunwayEnd::SetPosition(EPosition value) -
 
 auto flightsimlib::io::CBglRunway::CBglRunwayVasi::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Position >> data.Size >> data.Type >> data.BiasX >> data.BiasZ >> data.Spacing >> data.Pitch;
+    m_data.write() = in.ReadPacked<SBglRunwayVasiData>();
 }
 
 auto flightsimlib::io::CBglRunway::CBglRunwayVasi::WriteBinary(BinaryFileStream& out) -> void
@@ -584,8 +607,7 @@ auto flightsimlib::io::CBglRunway::CBglRunwayVasi::SetPosition(EPosition value)
 
 auto flightsimlib::io::CBglRunway::CBglRunwayApproachLights::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Position >> data.Size >> data.Type >> data.Strobes;
+    m_data.write() = in.ReadPacked<SBglRunwayApproachLightsData>();
 }
 
 auto flightsimlib::io::CBglRunway::CBglRunwayApproachLights::WriteBinary(BinaryFileStream& out) -> void
@@ -1424,9 +1446,7 @@ auto flightsimlib::io::CBglRunway::SetSecondaryApproachLights(IBglRunwayApproach
 
 auto flightsimlib::io::CBglStart::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.Number >> data.Designator >> data.Longitude >> data.Latitude >>
-        data.Altitude >> data.Heading;
+    m_data.write() = in.ReadPacked<SBglStartData>();
 }
 
 auto flightsimlib::io::CBglStart::WriteBinary(BinaryFileStream& out) -> void
@@ -1485,7 +1505,7 @@ auto flightsimlib::io::CBglCom::ReadBinary(BinaryFileStream& in) -> void
     const auto size = CalculateRemainingSize();
     if (static_cast<int>(m_data->Size) != size)
     {
-        CBglString::ReadBinary(m_data, size, in);
+        m_name = CBglString::ReadBinary(m_data->Size, size, in);
     }
 }
 
@@ -1496,7 +1516,7 @@ auto flightsimlib::io::CBglCom::WriteBinary(BinaryFileStream& out) -> void
     const auto size = CalculateRemainingSize();
     if (static_cast<int>(m_data->Size) != size)
     {
-        CBglString::WriteBinary(m_data, size, out);
+        CBglString::WriteBinary(m_name, size, out);
     }
 }
 
@@ -1504,8 +1524,8 @@ auto flightsimlib::io::CBglCom::Validate() -> bool { return true; }
 
 auto flightsimlib::io::CBglCom::CalculateSize() const -> int
 {
-    return static_cast<int>(CalculateRemainingSize() + m_data->Name.size() +
-                            CBglString::CalculatePadSize(m_data, CalculateRemainingSize()));
+    return static_cast<int>(CalculateRemainingSize() + m_name.size() +
+                            CBglString::CalculatePadSize(m_name, CalculateRemainingSize()));
 }
 
 auto flightsimlib::io::CBglCom::GetType() const -> EType { return static_cast<EType>(m_data->Type); }
@@ -1516,9 +1536,9 @@ auto flightsimlib::io::CBglCom::GetFrequency() const -> uint32_t { return m_data
 
 auto flightsimlib::io::CBglCom::SetFrequency(uint32_t value) -> void { m_data.write().Frequency = value; }
 
-auto flightsimlib::io::CBglCom::GetName() const -> const char* { return m_data->Name.c_str(); }
+auto flightsimlib::io::CBglCom::GetName() const -> const char* { return m_name.c_str(); }
 
-auto flightsimlib::io::CBglCom::SetName(const char* value) -> void { m_data.write().Name = value; }
+auto flightsimlib::io::CBglCom::SetName(const char* value) -> void { m_name = value; }
 
 auto flightsimlib::io::CBglCom::IsEmpty() const -> bool
 {
@@ -1541,9 +1561,7 @@ auto flightsimlib::io::CBglCom::CalculateRemainingSize() const -> int
 
 auto flightsimlib::io::CBglHelipad::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.SurfaceType >> data.HelipadType >> data.Color >> data.Longitude >>
-        data.Latitude >> data.Altitude >> data.Length >> data.Width >> data.Heading;
+    m_data.write() = in.ReadPacked<SBglHelipadData>();
 }
 
 auto flightsimlib::io::CBglHelipad::WriteBinary(BinaryFileStream& out) -> void
@@ -1619,8 +1637,7 @@ auto flightsimlib::io::CBglHelipad::SetHeading(float value) -> void { m_data.wri
 
 auto flightsimlib::io::CBglRunwayDelete::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.SurfaceType >> data.NumberPrimary >> data.NumberSecondary >> data.Designator;
+    m_data.write() = in.ReadPacked<SBglRunwayDeleteData>();
 }
 
 auto flightsimlib::io::CBglRunwayDelete::WriteBinary(BinaryFileStream& out) -> void
@@ -1691,8 +1708,7 @@ auto flightsimlib::io::CBglRunwayDelete::SetSecondaryRunwayDesignator(IBglRunway
 
 auto flightsimlib::io::CBglStartDelete::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Number >> data.Designator >> data.Type >> data.Pad;
+    m_data.write() = in.ReadPacked<SBglStartDeleteData>();
 }
 
 auto flightsimlib::io::CBglStartDelete::WriteBinary(BinaryFileStream& out) -> void
@@ -1779,7 +1795,7 @@ auto flightsimlib::io::CBglComDelete::SetFrequency(uint32_t value) -> void
 auto flightsimlib::io::CBglAirportDelete::ReadBinary(BinaryFileStream& in) -> void
 {
     auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.Flags >> data.RunwayCount >> data.StartCount >> data.ComCount >> data.Pad;
+    data = in.ReadPacked<SBglAirportDeleteData>();
 
     m_runway_deletes.write().reserve(data.RunwayCount);
     m_start_deletes.write().reserve(data.StartCount);
@@ -1946,6 +1962,11 @@ auto flightsimlib::io::CBglAirportDelete::GetRunwayDeleteAt(int index) -> IBglRu
     return &(m_runway_deletes.write()[index]);
 }
 
+auto flightsimlib::io::CBglAirportDelete::GetRunwayDeleteAt(int index) const -> const IBglRunwayDelete*
+{
+    return &(m_runway_deletes.read()[index]);
+}
+
 auto flightsimlib::io::CBglAirportDelete::AddRunwayDelete(const IBglRunwayDelete* runway) -> void
 {
     m_runway_deletes.write().emplace_back(*static_cast<const CBglRunwayDelete*>(runway));
@@ -1963,6 +1984,11 @@ auto flightsimlib::io::CBglAirportDelete::GetStartDeleteAt(int index) -> IBglSta
     return &(m_start_deletes.write()[index]);
 }
 
+auto flightsimlib::io::CBglAirportDelete::GetStartDeleteAt(int index) const -> const IBglStartDelete*
+{
+    return &(m_start_deletes.read()[index]);
+}
+
 auto flightsimlib::io::CBglAirportDelete::AddStartDelete(const IBglStartDelete* start) -> void
 {
     m_start_deletes.write().emplace_back(*static_cast<const CBglStartDelete*>(start));
@@ -1980,6 +2006,11 @@ auto flightsimlib::io::CBglAirportDelete::GetComDeleteAt(int index) -> IBglComDe
     return &(m_com_deletes.write()[index]);
 }
 
+auto flightsimlib::io::CBglAirportDelete::GetComDeleteAt(int index) const -> const IBglComDelete*
+{
+    return &(m_com_deletes.read()[index]);
+}
+
 auto flightsimlib::io::CBglAirportDelete::AddComDelete(const IBglComDelete* com) -> void
 {
     m_com_deletes.write().emplace_back(*static_cast<const CBglComDelete*>(com));
@@ -2007,9 +2038,7 @@ auto flightsimlib::io::CBglAirportDelete::IsEmpty() const -> bool
 
 auto flightsimlib::io::CBglApronEdgeLights::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.Flags >> data.VertexCount >> data.EdgeCount >> data.Color >> data.Brightness >>
-        data.MaxAltitude;
+    m_data.write() = in.ReadPacked<SBglApronEdgeLightsData>();
 
     m_vertices.write().resize(m_data->VertexCount);
     m_edges.write().resize(m_data->EdgeCount);
@@ -2070,6 +2099,11 @@ auto flightsimlib::io::CBglApronEdgeLights::GetVertexAt(int index) -> SBglVertex
     return &(m_vertices.write()[index]);
 }
 
+auto flightsimlib::io::CBglApronEdgeLights::GetVertexAt(int index) const -> const SBglVertexLL*
+{
+    return &(m_vertices.read()[index]);
+}
+
 auto flightsimlib::io::CBglApronEdgeLights::AddVertex(const SBglVertexLL* vertex) -> void
 {
     // TODO Need validation, self check, update count
@@ -2084,6 +2118,11 @@ auto flightsimlib::io::CBglApronEdgeLights::RemoveVertex(const SBglVertexLL* ver
 
 auto flightsimlib::io::CBglApronEdgeLights::GetEdgeAt(int index) -> SBglEdge* { return &(m_edges.write()[index]); }
 
+auto flightsimlib::io::CBglApronEdgeLights::GetEdgeAt(int index) const -> const SBglEdge*
+{
+    return &(m_edges.read()[index]);
+}
+
 auto flightsimlib::io::CBglApronEdgeLights::AddEdge(const SBglEdge* edge) -> void
 {
     // TODO Need validation, self check, update count
@@ -2104,8 +2143,7 @@ auto flightsimlib::io::CBglApronEdgeLights::IsEmpty() const -> bool { return m_d
 
 auto flightsimlib::io::CBglApron::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.Surface >> data.VertexCount;
+    m_data.write() = in.ReadPacked<SBglApronData>();
 
     m_vertices.write().resize(m_data->VertexCount);
 
@@ -2160,6 +2198,11 @@ auto flightsimlib::io::CBglApron::GetVertexCount() const -> int { return m_data-
 
 auto flightsimlib::io::CBglApron::GetVertexAt(int index) -> SBglVertexLL* { return &(m_vertices.write()[index]); }
 
+auto flightsimlib::io::CBglApron::GetVertexAt(int index) const -> const SBglVertexLL*
+{
+    return &(m_vertices.read()[index]);
+}
+
 auto flightsimlib::io::CBglApron::AddVertex(const SBglVertexLL* vertex) -> void
 {
     // TODO Need validation, self check, update count
@@ -2178,8 +2221,7 @@ auto flightsimlib::io::CBglApron::RemoveVertex(const SBglVertexLL* vertex) -> vo
 
 auto flightsimlib::io::CBglApronPolygons::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.Surface >> data.Flags >> data.VertexCount >> data.IndexCount;
+    m_data.write() = in.ReadPacked<SBglApronPolygonsData>();
 
     m_vertices.write().resize(m_data->VertexCount);
     m_indices.write().resize(m_data->IndexCount);
@@ -2273,6 +2315,11 @@ auto flightsimlib::io::CBglApronPolygons::GetVertexAt(int index) -> SBglVertexLL
     return &(m_vertices.write()[index]);
 }
 
+auto flightsimlib::io::CBglApronPolygons::GetVertexAt(int index) const -> const SBglVertexLL*
+{
+    return &(m_vertices.read()[index]);
+}
+
 auto flightsimlib::io::CBglApronPolygons::AddVertex(const SBglVertexLL* vertex) -> void
 {
     // TODO Need validation, self check, update count
@@ -2287,6 +2334,11 @@ auto flightsimlib::io::CBglApronPolygons::RemoveVertex(const SBglVertexLL* verte
 
 auto flightsimlib::io::CBglApronPolygons::GetIndexAt(int index) -> SBglIndex* { return &(m_indices.write()[index]); }
 
+auto flightsimlib::io::CBglApronPolygons::GetIndexAt(int index) const -> const SBglIndex*
+{
+    return &(m_indices.read()[index]);
+}
+
 auto flightsimlib::io::CBglApronPolygons::AddIndex(const SBglIndex* index) -> void
 {
     // TODO Need validation, self check, update count
@@ -2337,9 +2389,11 @@ auto flightsimlib::io::CBglTaxiwayPoint::SetOrientation(EOrientation value) -> v
 
 auto flightsimlib::io::CBglTaxiwayPoint::GetVertex() -> SBglVertexLL*
 {
-    return &(m_data.write().Vertex); // TODO - do we want a const form for readers?
+    return &(m_data.write().Vertex);
 }
 
+auto flightsimlib::io::CBglTaxiwayPoint::GetVertex() const -> const SBglVertexLL* { return &(m_data.read().Vertex); }
+
 auto flightsimlib::io::CBglTaxiwayPoint::SetVertex(SBglVertexLL* vertex) -> void { m_data.write().Vertex = *vertex; }
 
 //******************************************************************************
@@ -2348,8 +2402,7 @@ auto flightsimlib::io::CBglTaxiwayPoint::SetVertex(SBglVertexLL* vertex) -> void
 
 auto flightsimlib::io::CBglTaxiwayPoints::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.PointCount;
+    m_data.write() = in.ReadPacked<SBglTaxiwayPointsData>();
 
     m_points.write().resize(m_data->PointCount);
 
@@ -2385,6 +2438,11 @@ auto flightsimlib::io::CBglTaxiwayPoints::GetPointAt(int index) -> IBglTaxiwayPo
     return &(m_points.write()[index]);
 }
 
+auto flightsimlib::io::CBglTaxiwayPoints::GetPointAt(int index) const -> const IBglTaxiwayPoint*
+{
+    return &(m_points.read()[index]);
+}
+
 auto flightsimlib::io::CBglTaxiwayPoints::AddPoint(const IBglTaxiwayPoint* point) -> void
 {
     m_points.write().emplace_back(*static_cast<const CBglTaxiwayPoint*>(point));
@@ -2413,8 +2471,7 @@ auto flightsimlib::io::CBglTaxiwayParking::ReadBinary(BinaryFileStream& in) -> v
 
     for (auto& code : m_codes.write())
     {
-        code.assign(in.ReadString(static_cast<int>(sizeof(uint32_t))));
-        code.erase(std::find(code.begin(), code.end(), '\0'), code.end());
+        code = CBglString::ReadPadded(in, static_cast<int>(sizeof(uint32_t)));
     }
 }
 
@@ -2553,8 +2610,7 @@ auto flightsimlib::io::CBglTaxiwayParking::SetAirlineCodeCount(int value) -> voi
 
 auto flightsimlib::io::CBglTaxiwayParkings::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.ParkingCount;
+    m_data.write() = in.ReadPacked<SBglTaxiwayParkingsData>();
 
     m_parkings.write().resize(m_data->ParkingCount);
 
@@ -2598,6 +2654,11 @@ auto flightsimlib::io::CBglTaxiwayParkings::GetParkingAt(int index) -> IBglTaxiw
     return &(m_parkings.write()[index]);
 }
 
+auto flightsimlib::io::CBglTaxiwayParkings::GetParkingAt(int index) const -> const IBglTaxiwayParking*
+{
+    return &(m_parkings.read()[index]);
+}
+
 auto flightsimlib::io::CBglTaxiwayParkings::AddParking(const IBglTaxiwayParking* parking) -> void
 {
     m_parkings.write().emplace_back(*static_cast<const CBglTaxiwayParking*>(parking));
@@ -2618,10 +2679,7 @@ auto flightsimlib::io::CBglTaxiwayParkings::IsEmpty() const -> bool { return m_d
 
 auto flightsimlib::io::CBglTaxiwayPath::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-
-    in >> data.StartIndex >> data.EndIndex >> data.TypeFlags >> data.NameIndex >> data.MarkingFlags >> data.Surface >>
-        data.Width >> data.WeightLimit >> data.Unknown;
+    m_data.write() = in.ReadPacked<SBglTaxiwayPathData>();
 }
 
 auto flightsimlib::io::CBglTaxiwayPath::WriteBinary(BinaryFileStream& out) -> void
@@ -2795,8 +2853,7 @@ auto flightsimlib::io::CBglTaxiwayPath::SetWeightLimit(float value) -> void { m_
 
 auto flightsimlib::io::CBglTaxiwayPaths::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.PathCount;
+    m_data.write() = in.ReadPacked<SBglTaxiwayPathsData>();
 
     m_paths.write().resize(m_data->PathCount);
 
@@ -2828,6 +2885,11 @@ auto flightsimlib::io::CBglTaxiwayPaths::GetPathCount() const -> int { return st
 
 auto flightsimlib::io::CBglTaxiwayPaths::GetPathAt(int index) -> IBglTaxiwayPath* { return &(m_paths.write()[index]); }
 
+auto flightsimlib::io::CBglTaxiwayPaths::GetPathAt(int index) const -> const IBglTaxiwayPath*
+{
+    return &(m_paths.read()[index]);
+}
+
 auto flightsimlib::io::CBglTaxiwayPaths::AddPath(const IBglTaxiwayPath* path) -> void
 {
     m_paths.write().emplace_back(*static_cast<const CBglTaxiwayPath*>(path));
@@ -2848,15 +2910,13 @@ auto flightsimlib::io::CBglTaxiwayPaths::IsEmpty() const -> bool { return m_data
 
 auto flightsimlib::io::CBglTaxiwayNames::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.NameCount;
+    m_data.write() = in.ReadPacked<SBglTaxiwayNamesData>();
 
     m_names.write().resize(m_data->NameCount);
 
     for (auto& name : m_names.write())
     {
-        name.assign(in.ReadString(static_cast<int>(sizeof(uint64_t))));
-        name.erase(std::find(name.begin(), name.end(), '\0'), name.end());
+        name = CBglString::ReadPadded(in, static_cast<int>(sizeof(uint64_t)));
     }
 }
 
@@ -2931,9 +2991,7 @@ flightsimlib::io::CBglJetway& flightsimlib::io::CBglJetway::operator=(CBglJetway
 
 auto flightsimlib::io::CBglJetway::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-
-    in >> data.Type >> data.Size >> data.Number >> data.Name >> data.SceneryObjectSize;
+    m_data.write() = in.ReadPacked<SBglJetwayData>();
 
     const auto pos = in.GetPosition();
     auto child_type = uint16_t{};
@@ -3058,11 +3116,7 @@ auto flightsimlib::io::CBglJetway::CalculatePadSize() const -> int
 
 auto flightsimlib::io::CBglLeg::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-
-    in >> data.LegType >> data.AltitudeDescriptor >> data.TurnDirection >> data.Flags >> data.IcaoIdent >>
-        data.RegionIdent >> data.RecommendedIcaoIdent >> data.RecommendedRegionIdent >> data.Theta >> data.Rho >>
-        data.Course >> data.DistanceTime >> data.Altitude1 >> data.Altitude2;
+    m_data.write() = in.ReadPacked<SBglLegData>();
 }
 
 auto flightsimlib::io::CBglLeg::WriteBinary(BinaryFileStream& out) -> void
@@ -3282,8 +3336,7 @@ auto flightsimlib::io::CBglLeg::SetAltitude2(float value) -> void { m_data.write
 
 auto flightsimlib::io::CBglLegs::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.LegCount;
+    m_data.write() = in.ReadPacked<SBglLegsData>();
 
     m_legs.write().resize(m_data->LegCount);
 
@@ -3318,6 +3371,8 @@ auto flightsimlib::io::CBglLegs::GetLegCount() const -> int { return static_cast
 
 auto flightsimlib::io::CBglLegs::GetLegAt(int index) -> IBglLeg* { return &(m_legs.write()[index]); }
 
+auto flightsimlib::io::CBglLegs::GetLegAt(int index) const -> const IBglLeg* { return &(m_legs.read()[index]); }
+
 auto flightsimlib::io::CBglLegs::AddLeg(const IBglLeg* leg) -> void
 {
     m_legs.write().emplace_back(*static_cast<const CBglLeg*>(leg));
@@ -3344,8 +3399,7 @@ auto flightsimlib::io::CBglLegs::IsEmpty() const -> bool
 
 auto flightsimlib::io::CBglDmeArc::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.IcaoIdent >> data.RegionIdent >> data.Radial >> data.Distance;
+    m_data.write() = in.ReadPacked<SBglDmeArcData>();
 }
 
 auto flightsimlib::io::CBglDmeArc::WriteBinary(BinaryFileStream& out) -> void
@@ -3411,10 +3465,7 @@ auto flightsimlib::io::CBglDmeArc::IsEmpty() const -> bool
 
 auto flightsimlib::io::CBglTransition::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-
-    in >> data.Type >> data.Size >> data.TransitionType >> data.LegCount >> data.IcaoIdent >> data.RegionIdent >>
-        data.Altitude;
+    m_data.write() = in.ReadPacked<SBglTransitionData>();
 
     if (GetType() == EType::Dme)
     {
@@ -3536,6 +3587,15 @@ auto flightsimlib::io::CBglTransition::GetDmeArc() -> IBglDmeArc*
     return &m_dme_arc.write();
 }
 
+auto flightsimlib::io::CBglTransition::GetDmeArc() const -> const IBglDmeArc*
+{
+    if (m_dme_arc->IsEmpty())
+    {
+        return nullptr;
+    }
+    return &m_dme_arc.read();
+}
+
 auto flightsimlib::io::CBglTransition::SetDmeArc(IBglDmeArc* value) -> void
 {
     // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -3551,6 +3611,15 @@ auto flightsimlib::io::CBglTransition::GetTransitionLegs() -> IBglLegs*
     return &m_legs.write();
 }
 
+auto flightsimlib::io::CBglTransition::GetTransitionLegs() const -> const IBglLegs*
+{
+    if (m_legs->IsEmpty())
+    {
+        return nullptr;
+    }
+    return &m_legs.read();
+}
+
 auto flightsimlib::io::CBglTransition::SetTransitionLegs(IBglLegs* value) -> void
 {
     // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -3565,11 +3634,7 @@ auto flightsimlib::io::CBglApproach::ReadBinary(BinaryFileStream& in) -> void
 {
     const auto initial_pos = in.GetPosition();
 
-    auto& data = m_data.write();
-
-    in >> data.Type >> data.Size >> data.Suffix >> data.Number >> data.TypeDesignator >> data.TransitionCount >>
-        data.ApproachLegCount >> data.MissedApproachLegCount >> data.IcaoIdent >> data.RegionIdent >> data.Altitude >>
-        data.Heading >> data.MissedAltitude;
+    m_data.write() = in.ReadPacked<SBglApproachData>();
 
     m_transitions.write().resize(m_data->TransitionCount);
     auto transition_index = 0;
@@ -3779,6 +3844,15 @@ auto flightsimlib::io::CBglApproach::GetApproachLegs() -> IBglLegs*
     return &m_approach_legs.write();
 }
 
+auto flightsimlib::io::CBglApproach::GetApproachLegs() const -> const IBglLegs*
+{
+    if (m_approach_legs->IsEmpty())
+    {
+        return nullptr;
+    }
+    return &m_approach_legs.read();
+}
+
 auto flightsimlib::io::CBglApproach::SetApproachLegs(IBglLegs* value) -> void
 {
     // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -3794,6 +3868,15 @@ auto flightsimlib::io::CBglApproach::GetMissedApproachLegs() -> IBglLegs*
     return &m_missed_approach_legs.write();
 }
 
+auto flightsimlib::io::CBglApproach::GetMissedApproachLegs() const -> const IBglLegs*
+{
+    if (m_missed_approach_legs->IsEmpty())
+    {
+        return nullptr;
+    }
+    return &m_missed_approach_legs.read();
+}
+
 auto flightsimlib::io::CBglApproach::SetMissedApproachLegs(IBglLegs* value) -> void
 {
     // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -3805,6 +3888,11 @@ auto flightsimlib::io::CBglApproach::GetTransitionAt(int index) -> IBglTransitio
     return &(m_transitions.write()[index]);
 }
 
+auto flightsimlib::io::CBglApproach::GetTransitionAt(int index) const -> const IBglTransition*
+{
+    return &(m_transitions.read()[index]);
+}
+
 auto flightsimlib::io::CBglApproach::AddTransition(const IBglTransition* transition) -> void
 {
     m_transitions.write().emplace_back(*static_cast<const CBglTransition*>(transition));
@@ -3825,8 +3913,7 @@ auto flightsimlib::io::CBglFence::ReadBinary(BinaryFileStream& in) -> void
 {
     assert(m_vertices->empty());
 
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.VertexCount >> data.InstanceId >> data.Profile;
+    m_data.write() = in.ReadPacked<SBglFenceData>();
 
     const auto count = GetVertexCount();
     m_vertices.write().resize(count);
@@ -3870,6 +3957,11 @@ auto flightsimlib::io::CBglFence::SetProfile(_GUID value) -> void { m_data.write
 
 auto flightsimlib::io::CBglFence::GetVertexAt(int index) -> SBglVertexLL* { return &(m_vertices.write()[index]); }
 
+auto flightsimlib::io::CBglFence::GetVertexAt(int index) const -> const SBglVertexLL*
+{
+    return &(m_vertices.read()[index]);
+}
+
 auto flightsimlib::io::CBglFence::AddVertex(const SBglVertexLL* vertex) -> void
 {
     m_vertices.write().emplace_back(*vertex);
@@ -3891,11 +3983,7 @@ auto flightsimlib::io::CBglAirport::ReadBinary(BinaryFileStream& in) -> void
 {
     const auto initial_pos = in.GetPosition();
 
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.RunwayCount >> data.FrequencyCount >> data.StartCount >> data.ApproachCount >>
-        data.ApronCount >> data.HelipadCount >> data.Longitude >> data.Latitude >> data.Altitude >>
-        data.TowerLongitude >> data.TowerLatitude >> data.TowerAltitude >> data.MagVar >> data.IcaoIdent >>
-        data.RegionIdent >> data.FuelAvailability >> data.TrafficScalar >> data.Pad;
+    m_data.write() = in.ReadPacked<SBglAirportData>();
 
     m_runways.write().reserve(m_data->RunwayCount);
     m_starts.write().reserve(m_data->StartCount);
@@ -4335,6 +4423,11 @@ auto flightsimlib::io::CBglAirport::SetTrafficScalar(float value) -> void
 
 auto flightsimlib::io::CBglAirport::GetRunwayAt(int index) -> IBglRunway* { return &(m_runways.write()[index]); }
 
+auto flightsimlib::io::CBglAirport::GetRunwayAt(int index) const -> const IBglRunway*
+{
+    return &(m_runways.read()[index]);
+}
+
 auto flightsimlib::io::CBglAirport::AddRunway(const IBglRunway* runway) -> void
 {
     // TODO Need validation, self check
@@ -4350,6 +4443,11 @@ auto flightsimlib::io::CBglAirport::RemoveRunway(const IBglRunway* runway) -> vo
 
 auto flightsimlib::io::CBglAirport::GetStartAt(int index) -> IBglStart* { return &(m_starts.write()[index]); }
 
+auto flightsimlib::io::CBglAirport::GetStartAt(int index) const -> const IBglStart*
+{
+    return &(m_starts.read()[index]);
+}
+
 auto flightsimlib::io::CBglAirport::AddStart(const IBglStart* start) -> void
 {
     m_starts.write().emplace_back(*static_cast<const CBglStart*>(start));
@@ -4364,6 +4462,8 @@ auto flightsimlib::io::CBglAirport::RemoveStart(const IBglStart* start) -> void
 
 auto flightsimlib::io::CBglAirport::GetComAt(int index) -> IBglCom* { return &(m_coms.write()[index]); }
 
+auto flightsimlib::io::CBglAirport::GetComAt(int index) const -> const IBglCom* { return &(m_coms.read()[index]); }
+
 auto flightsimlib::io::CBglAirport::AddCom(const IBglCom* com) -> void
 {
     m_coms.write().emplace_back(*static_cast<const CBglCom*>(com));
@@ -4377,6 +4477,11 @@ auto flightsimlib::io::CBglAirport::RemoveCom(const IBglCom* com) -> void
 
 auto flightsimlib::io::CBglAirport::GetHelipadAt(int index) -> IBglHelipad* { return &(m_helipads.write()[index]); }
 
+auto flightsimlib::io::CBglAirport::GetHelipadAt(int index) const -> const IBglHelipad*
+{
+    return &(m_helipads.read()[index]);
+}
+
 auto flightsimlib::io::CBglAirport::AddHelipad(const IBglHelipad* helipad) -> void
 {
     m_helipads.write().emplace_back(*static_cast<const CBglHelipad*>(helipad));
@@ -4398,6 +4503,15 @@ auto flightsimlib::io::CBglAirport::GetDelete() -> IBglAirportDelete*
     return &m_delete.write();
 }
 
+auto flightsimlib::io::CBglAirport::GetDelete() const -> const IBglAirportDelete*
+{
+    if (m_delete->IsEmpty())
+    {
+        return nullptr;
+    }
+    return &m_delete.read();
+}
+
 auto flightsimlib::io::CBglAirport::SetDelete(IBglAirportDelete* value) -> void
 {
     // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -4413,6 +4527,15 @@ auto flightsimlib::io::CBglAirport::GetApronEdgeLights() -> IBglApronEdgeLights*
     return &m_apron_edge_lights.write();
 }
 
+auto flightsimlib::io::CBglAirport::GetApronEdgeLights() const -> const IBglApronEdgeLights*
+{
+    if (m_apron_edge_lights->IsEmpty())
+    {
+        return nullptr;
+    }
+    return &m_apron_edge_lights.read();
+}
+
 auto flightsimlib::io::CBglAirport::SetApronEdgeLights(IBglApronEdgeLights* value) -> void
 {
     // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -4421,6 +4544,11 @@ auto flightsimlib::io::CBglAirport::SetApronEdgeLights(IBglApronEdgeLights* valu
 
 auto flightsimlib::io::CBglAirport::GetApronAt(int index) -> IBglApron* { return &(m_aprons.write()[index]); }
 
+auto flightsimlib::io::CBglAirport::GetApronAt(int index) const -> const IBglApron*
+{
+    return &(m_aprons.read()[index]);
+}
+
 auto flightsimlib::io::CBglAirport::AddApron(const IBglApron* apron) -> void
 {
     m_aprons.write().emplace_back(*static_cast<const CBglApron*>(apron));
@@ -4438,6 +4566,11 @@ auto flightsimlib::io::CBglAirport::GetApronPolygonsAt(int index) -> IBglApronPo
     return &(m_apron_polygons.write()[index]);
 }
 
+auto flightsimlib::io::CBglAirport::GetApronPolygonsAt(int index) const -> const IBglApronPolygons*
+{
+    return &(m_apron_polygons.read()[index]);
+}
+
 auto flightsimlib::io::CBglAirport::AddApronPolygons(const IBglApronPolygons* polygons) -> void
 {
     m_apron_polygons.write().emplace_back(*static_cast<const CBglApronPolygons*>(polygons));
@@ -4459,6 +4592,15 @@ auto flightsimlib::io::CBglAirport::GetTaxiwayPoints() -> IBglTaxiwayPoints*
     return &m_taxiway_points.write();
 }
 
+auto flightsimlib::io::CBglAirport::GetTaxiwayPoints() const -> const IBglTaxiwayPoints*
+{
+    if (m_taxiway_points->IsEmpty())
+    {
+        return nullptr;
+    }
+    return &m_taxiway_points.read();
+}
+
 auto flightsimlib::io::CBglAirport::SetTaxiwayPoints(IBglTaxiwayPoints* value) -> void
 {
     // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -4474,6 +4616,15 @@ auto flightsimlib::io::CBglAirport::GetTaxiwayParkings() -> IBglTaxiwayParkings*
     return &m_taxiway_parkings.write();
 }
 
+auto flightsimlib::io::CBglAirport::GetTaxiwayParkings() const -> const IBglTaxiwayParkings*
+{
+    if (m_taxiway_parkings->IsEmpty())
+    {
+        return nullptr;
+    }
+    return &m_taxiway_parkings.read();
+}
+
 auto flightsimlib::io::CBglAirport::SetTaxiwayParkings(IBglTaxiwayParkings* value) -> void
 {
     // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -4489,6 +4640,15 @@ auto flightsimlib::io::CBglAirport::GetTaxiwayPaths() -> IBglTaxiwayPaths*
     return &m_taxiway_paths.write();
 }
 
+auto flightsimlib::io::CBglAirport::GetTaxiwayPaths() const -> const IBglTaxiwayPaths*
+{
+    if (m_taxiway_paths->IsEmpty())
+    {
+        return nullptr;
+    }
+    return &m_taxiway_paths.read();
+}
+
 auto flightsimlib::io::CBglAirport::SetTaxiwayPaths(IBglTaxiwayPaths* value) -> void
 {
     // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -4504,6 +4664,15 @@ auto flightsimlib::io::CBglAirport::GetTaxiwayNames() -> IBglTaxiwayNames*
     return &m_taxiway_names.write();
 }
 
+auto flightsimlib::io::CBglAirport::GetTaxiwayNames() const -> const IBglTaxiwayNames*
+{
+    if (m_taxiway_names->IsEmpty())
+    {
+        return nullptr;
+    }
+    return &m_taxiway_names.read();
+}
+
 auto flightsimlib::io::CBglAirport::SetTaxiwayNames(IBglTaxiwayNames* value) -> void
 {
     // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -4514,6 +4683,11 @@ auto flightsimlib::io::CBglAirport::GetJetwayCount() const -> int { return stati
 
 auto flightsimlib::io::CBglAirport::GetJetwayAt(int index) -> IBglJetway* { return &(m_jetways.write()[index]); }
 
+auto flightsimlib::io::CBglAirport::GetJetwayAt(int index) const -> const IBglJetway*
+{
+    return &(m_jetways.read()[index]);
+}
+
 auto flightsimlib::io::CBglAirport::AddJetway(const IBglJetway* jetway) -> void
 {
     m_jetways.write().emplace_back(*static_cast<const CBglJetway*>(jetway));
@@ -4528,6 +4702,11 @@ auto flightsimlib::io::CBglAirport::RemoveJetway(const IBglJetway* jetway) -> vo
 
 auto flightsimlib::io::CBglAirport::GetApproachAt(int index) -> IBglApproach* { return &(m_approaches.write()[index]); }
 
+auto flightsimlib::io::CBglAirport::GetApproachAt(int index) const -> const IBglApproach*
+{
+    return &(m_approaches.read()[index]);
+}
+
 auto flightsimlib::io::CBglAirport::AddApproach(const IBglApproach* approach) -> void
 {
     m_approaches.write().emplace_back(*static_cast<const CBglApproach*>(approach));
@@ -4550,6 +4729,11 @@ auto flightsimlib::io::CBglAirport::GetBlastFenceAt(int index) -> IBglFence*
     return &(m_blast_fences.write()[index]);
 }
 
+auto flightsimlib::io::CBglAirport::GetBlastFenceAt(int index) const -> const IBglFence*
+{
+    return &(m_blast_fences.read()[index]);
+}
+
 auto flightsimlib::io::CBglAirport::AddBlastFence(const IBglFence* fence) -> void
 {
     m_blast_fences.write().emplace_back(*static_cast<const CBglFence*>(fence));
@@ -4572,6 +4756,11 @@ auto flightsimlib::io::CBglAirport::GetBoundaryFenceAt(int index) -> IBglFence*
     return &(m_boundary_fences.write()[index]);
 }
 
+auto flightsimlib::io::CBglAirport::GetBoundaryFenceAt(int index) const -> const IBglFence*
+{
+    return &(m_boundary_fences.read()[index]);
+}
+
 auto flightsimlib::io::CBglAirport::AddBoundaryFence(const IBglFence* fence) -> void
 {
     m_boundary_fences.write().emplace_back(*static_cast<const CBglFence*>(fence));
@@ -4590,10 +4779,7 @@ auto flightsimlib::io::CBglAirport::RemoveBoundaryFence(const IBglFence* fence)
 
 auto flightsimlib::io::CBglAirportSummary::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.ApproachAvailability >> data.Longitude >> data.Latitude >> data.Altitude >>
-        data.IcaoIdent >> data.RegionIdent >> data.MagVar >> data.LongestRunwayLength >> data.LongestRunwayHeading >>
-        data.FuelAvailability;
+    m_data.write() = in.ReadPacked<SBglAirportSummaryData>();
 }
 
 auto flightsimlib::io::CBglAirportSummary::WriteBinary(BinaryFileStream& out) -> void
@@ -4794,8 +4980,7 @@ auto flightsimlib::io::CBglRoute::ReadBinary(BinaryFileStream& in) -> void
     auto& data = m_data.write();
     in >> data.RouteType;
 
-    data.Name.assign(in.ReadString(static_cast<int>(sizeof(uint64_t))));
-    data.Name.erase(std::find(data.Name.begin(), data.Name.end(), '\0'), data.Name.end());
+    m_name = CBglString::ReadPadded(in, static_cast<int>(sizeof(uint64_t)));
 
     in >> data.Previous.IcaoIdent >> data.Previous.RegionIdent >> data.Previous.AltitudeMinimum >>
         data.Next.IcaoIdent >> data.Next.RegionIdent >> data.Next.AltitudeMinimum;
@@ -4806,8 +4991,8 @@ auto flightsimlib::io::CBglRoute::WriteBinary(BinaryFileStream& out) -> void
     out << m_data->RouteType;
 
     // TODO Pad Util
-    const auto size = static_cast<int>(m_data->Name.size());
-    out.Write(m_data->Name.c_str(), size);
+    const auto size = static_cast<int>(m_name.size());
+    out.Write(m_name.c_str(), size);
 
     auto pad_size = 8 - size % 8;
     if (pad_size == 8 && size != 0)
@@ -4836,9 +5021,9 @@ auto flightsimlib::io::CBglRoute::GetType() const -> EType { return static_cast<
 
 auto flightsimlib::io::CBglRoute::SetType(EType value) -> void { m_data.write().RouteType = to_integral(value); }
 
-auto flightsimlib::io::CBglRoute::GetName() const -> const char* { return m_data->Name.c_str(); }
+auto flightsimlib::io::CBglRoute::GetName() const -> const char* { return m_name.c_str(); }
 
-auto flightsimlib::io::CBglRoute::SetName(const char* value) -> void { m_data.write().Name = value; }
+auto flightsimlib::io::CBglRoute::SetName(const char* value) -> void { m_name = value; }
 
 auto flightsimlib::io::CBglRoute::GetPreviousType() const -> EConnectionType
 {
@@ -4943,10 +5128,7 @@ auto flightsimlib::io::CBglRoute::SetNextAltitudeMinimum(float value) -> void
 
 auto flightsimlib::io::CBglWaypoint::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-
-    in >> data.Type >> data.Size >> data.WaypointType >> data.RouteCount >> data.Longitude >> data.Latitude >>
-        data.Magvar >> data.IcaoIdent >> data.RegionIdent;
+    m_data.write() = in.ReadPacked<SBglWaypointData>();
 
     m_routes.write().resize(m_data->RouteCount);
 
@@ -5044,6 +5226,11 @@ auto flightsimlib::io::CBglWaypoint::SetIcaoAirport(uint32_t value) -> void
 
 auto flightsimlib::io::CBglWaypoint::GetRouteAt(int index) -> IBglRoute* { return &(m_routes.write()[index]); }
 
+auto flightsimlib::io::CBglWaypoint::GetRouteAt(int index) const -> const IBglRoute*
+{
+    return &(m_routes.read()[index]);
+}
+
 auto flightsimlib::io::CBglWaypoint::AddRoute(const IBglRoute* route) -> void
 {
     m_routes.write().emplace_back(*static_cast<const CBglRoute*>(route));
@@ -5074,8 +5261,7 @@ auto flightsimlib::io::CBglWaypoint::CalculatePadSize() const -> int
 
 auto flightsimlib::io::CBglLocalizer::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.RunwayNumber >> data.RunwayDesignator >> data.Heading >> data.Width;
+    m_data.write() = in.ReadPacked<SBglLocalizerData>();
 }
 
 auto flightsimlib::io::CBglLocalizer::WriteBinary(BinaryFileStream& out) -> void
@@ -5134,9 +5320,7 @@ auto flightsimlib::io::CBglLocalizer::IsEmpty() const -> bool
 
 auto flightsimlib::io::CBglGlideSlope::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.Pad >> data.Longitude >> data.Latitude >> data.Altitude >> data.Range >>
-        data.Pitch;
+    m_data.write() = in.ReadPacked<SBglGlideSlopeData>();
 }
 
 auto flightsimlib::io::CBglGlideSlope::WriteBinary(BinaryFileStream& out) -> void
@@ -5175,8 +5359,7 @@ auto flightsimlib::io::CBglGlideSlope::IsEmpty() const -> bool
 
 auto flightsimlib::io::CBglDme::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.Pad >> data.Longitude >> data.Latitude >> data.Altitude >> data.Range;
+    m_data.write() = in.ReadPacked<SBglDmeData>();
 }
 
 auto flightsimlib::io::CBglDme::WriteBinary(BinaryFileStream& out) -> void
@@ -5212,8 +5395,7 @@ auto flightsimlib::io::CBglNav::ReadBinary(BinaryFileStream& in) -> void
 
     const auto initial_pos = in.GetPosition();
 
-    in >> data.Type >> data.Size >> data.NavType >> data.Flags >> data.Longitude >> data.Latitude >> data.Altitude >>
-        data.Frequency >> data.Range >> data.MagVar >> data.IcaoIdent >> data.RegionIdent;
+    data = in.ReadPacked<SBglNavData>();
 
     const auto final_position = initial_pos + static_cast<int>(m_data->Size);
     while (in.GetPosition() < final_position)
@@ -5417,6 +5599,15 @@ auto flightsimlib::io::CBglNav::GetLocalizer() -> IBglLocalizer*
     return &m_localizer.write();
 }
 
+auto flightsimlib::io::CBglNav::GetLocalizer() const -> const IBglLocalizer*
+{
+    if (m_localizer->IsEmpty())
+    {
+        return nullptr;
+    }
+    return &m_localizer.read();
+}
+
 auto flightsimlib::io::CBglNav::SetLocalizer(IBglLocalizer* value) -> void
 {
     // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -5432,6 +5623,15 @@ auto flightsimlib::io::CBglNav::GetGlideSlope() -> IBglGlideSlope*
     return &m_glide_slope.write();
 }
 
+auto flightsimlib::io::CBglNav::GetGlideSlope() const -> const IBglGlideSlope*
+{
+    if (m_glide_slope->IsEmpty())
+    {
+        return nullptr;
+    }
+    return &m_glide_slope.read();
+}
+
 auto flightsimlib::io::CBglNav::SetGlideSlope(IBglGlideSlope* value) -> void
 {
     // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -5447,6 +5647,15 @@ auto flightsimlib::io::CBglNav::GetDmeRecord() -> IBglDme*
     return &m_dme.write();
 }
 
+auto flightsimlib::io::CBglNav::GetDmeRecord() const -> const IBglDme*
+{
+    if (m_dme->IsEmpty())
+    {
+        return nullptr;
+    }
+    return &m_dme.read();
+}
+
 auto flightsimlib::io::CBglNav::SetDmeRecord(IBglDme* value) -> void
 {
     // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -5463,8 +5672,7 @@ auto flightsimlib::io::CBglTacan::ReadBinary(BinaryFileStream& in) -> void
 
     const auto initial_pos = in.GetPosition();
 
-    in >> data.Type >> data.Size >> data.Longitude >> data.Latitude >> data.Altitude >> data.Channel >> data.Flags >>
-        data.Range >> data.MagVar >> data.IcaoIdent >> data.RegionIdent;
+    data = in.ReadPacked<SBglTacanData>();
 
     const auto final_position = initial_pos + static_cast<int>(m_data->Size);
     while (in.GetPosition() < final_position)
@@ -5588,6 +5796,15 @@ auto flightsimlib::io::CBglTacan::GetDmeRecord() -> IBglDme*
     return &m_dme.write();
 }
 
+auto flightsimlib::io::CBglTacan::GetDmeRecord() const -> const IBglDme*
+{
+    if (m_dme->IsEmpty())
+    {
+        return nullptr;
+    }
+    return &m_dme.read();
+}
+
 auto flightsimlib::io::CBglTacan::SetDmeRecord(IBglDme* value) -> void
 {
     // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -5600,9 +5817,7 @@ auto flightsimlib::io::CBglTacan::SetDmeRecord(IBglDme* value) -> void
 
 auto flightsimlib::io::CBglBoundaryEdge::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-
-    in >> data.Type >> data.Longitude >> data.Latitude;
+    m_data.write() = in.ReadPacked<SBglBoundaryEdgeData>();
 }
 
 auto flightsimlib::io::CBglBoundaryEdge::WriteBinary(BinaryFileStream& out) -> void
@@ -5661,9 +5876,7 @@ auto flightsimlib::io::CBglBoundaryEdge::SetRadius(float value) -> void
 
 auto flightsimlib::io::CBglBoundaryEdges::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-
-    in >> data.Type >> data.Size >> data.EdgeCount;
+    m_data.write() = in.ReadPacked<SBglBoundaryEdgesData>();
 
     m_edges.write().resize(m_data->EdgeCount);
 
@@ -5702,6 +5915,11 @@ auto flightsimlib::io::CBglBoundaryEdges::GetEdgeAt(int index) -> IBglBoundaryEd
     return &(m_edges.write()[index]);
 }
 
+auto flightsimlib::io::CBglBoundaryEdges::GetEdgeAt(int index) const -> const IBglBoundaryEdge*
+{
+    return &(m_edges.read()[index]);
+}
+
 auto flightsimlib::io::CBglBoundaryEdges::AddEdge(const IBglBoundaryEdge* edge) -> void
 {
     m_edges.write().emplace_back(*static_cast<const CBglBoundaryEdge*>(edge));
@@ -5735,8 +5953,7 @@ auto flightsimlib::io::CBglBoundary::ReadBinary(BinaryFileStream& in) -> void
 
     const auto initial_pos = in.GetPosition();
 
-    in >> data.Type >> data.Size >> data.BoundaryType >> data.AltitudeType >> data.MinLongitude >> data.MinLatitude >>
-        data.MinAltitude >> data.MaxLongitude >> data.MaxLatitude >> data.MaxAltitude;
+    data = in.ReadPacked<SBglBoundaryData>();
 
     const auto final_position = initial_pos + static_cast<int>(m_data->Size);
     while (in.GetPosition() < final_position)
@@ -5924,6 +6141,15 @@ auto flightsimlib::io::CBglBoundary::GetCom() -> IBglCom*
     return &m_com.write();
 }
 
+auto flightsimlib::io::CBglBoundary::GetCom() const -> const IBglCom*
+{
+    if (m_com->IsEmpty())
+    {
+        return nullptr;
+    }
+    return &m_com.read();
+}
+
 auto flightsimlib::io::CBglBoundary::SetCom(IBglCom* value) -> void
 {
     // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -5939,6 +6165,15 @@ auto flightsimlib::io::CBglBoundary::GetEdges() -> IBglBoundaryEdges*
     return &m_edges.write();
 }
 
+auto flightsimlib::io::CBglBoundary::GetEdges() const -> const IBglBoundaryEdges*
+{
+    if (m_edges->IsEmpty())
+    {
+        return nullptr;
+    }
+    return &m_edges.read();
+}
+
 auto flightsimlib::io::CBglBoundary::SetEdges(IBglBoundaryEdges* value) -> void
 {
     // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
@@ -5967,8 +6202,7 @@ auto flightsimlib::io::CBglBoundary::CalculatePadSize() const -> int
 
 auto flightsimlib::io::CBglExclusion::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.Type >> data.Size >> data.MinLongitude >> data.MinLatitude >> data.MaxLongitude >> data.MaxLatitude;
+    m_data.write() = in.ReadPacked<SBglExclusionData>();
 }
 
 auto flightsimlib::io::CBglExclusion::WriteBinary(BinaryFileStream& out) -> void
@@ -6111,9 +6345,7 @@ auto flightsimlib::io::CBglExclusion::SetExtrusionBridge(bool value) -> void
 
 auto flightsimlib::io::CBglMarker::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-    in >> data.SectionType >> data.Size >> data.UnusedType >> data.Heading >> data.MarkerType >> data.Longitude >>
-        data.Latitude >> data.Altitude >> data.Icao >> data.Region;
+    m_data.write() = in.ReadPacked<SBglMarkerData>();
 }
 
 auto flightsimlib::io::CBglMarker::WriteBinary(BinaryFileStream& out) -> void
@@ -6177,9 +6409,7 @@ auto flightsimlib::io::CBglGeopol::ReadBinary(BinaryFileStream& in) -> void
 {
     assert(m_vertices->empty());
 
-    auto& data = m_data.write();
-    in >> data.SectionType >> data.Size >> data.GeopolType >> data.MinLongitude >> data.MinLatitude >>
-        data.MaxLongitude >> data.MaxLatitude;
+    m_data.write() = in.ReadPacked<SBglGeopolData>();
 
     const auto count = GetVertexCount();
     m_vertices.write().resize(count);
@@ -6250,6 +6480,11 @@ auto flightsimlib::io::CBglGeopol::GetVertexCount() const -> int { return m_data
 
 auto flightsimlib::io::CBglGeopol::GetVertexAt(int index) -> SBglVertexLL* { return &(m_vertices.write()[index]); }
 
+auto flightsimlib::io::CBglGeopol::GetVertexAt(int index) const -> const SBglVertexLL*
+{
+    return &(m_vertices.read()[index]);
+}
+
 auto flightsimlib::io::CBglGeopol::AddVertex(const SBglVertexLL* vertex) -> void
 {
     // TODO Need validation, self check
@@ -6974,8 +7209,7 @@ void flightsimlib::io::CBglLibraryObject::ReadBinary(BinaryFileStream& in)
     CBglSceneryObject::ReadBinary(in);
     if (in)
     {
-        auto& data = m_data.write();
-        in >> data.Name >> data.Scale;
+        m_data.write() = in.ReadPacked<SBglLibraryObjectData>();
     }
 }
 
@@ -7012,8 +7246,7 @@ void flightsimlib::io::CBglWindsock::ReadBinary(BinaryFileStream& in)
     CBglSceneryObject::ReadBinary(in);
     if (in)
     {
-        auto& data = m_data.write();
-        in >> data.PoleHeight >> data.WindsockLength >> data.PoleColor >> data.SockColor >> data.Lighted;
+        m_data.write() = in.ReadPacked<SBglWindsockData>();
     }
 }
 
@@ -7063,15 +7296,10 @@ void flightsimlib::io::CBglEffect::ReadBinary(BinaryFileStream& in)
     CBglSceneryObject::ReadBinary(in);
     if (in)
     {
-        auto& data = m_data.write();
-
-        data.Name.resize(s_name_size);
-        char input[s_name_size];
-        in.Read(&input, s_name_size);
-        data.Name.assign(input, s_name_size);
+        m_name = in.ReadPooledString(s_name_size);
 
         const auto param_size = RecordSize() - CBglSceneryObject::CalculateSize() - s_name_size;
-        data.Params = in.ReadString(param_size);
+        m_params = in.ReadPooledString(param_size);
     }
 }
 
@@ -7080,13 +7308,15 @@ void flightsimlib::io::CBglEffect::WriteBinary(BinaryFileStream& out)
     CBglSceneryObject::WriteBinary(out);
     if (out)
     {
-        if (m_data->Name.size() != s_name_size)
+        const auto name_size = std::min(static_cast<int>(m_name.size()), s_name_size);
+        out.Write(m_name.data(), name_size);
+        const auto pad = uint8_t{0};
+        for (auto i = name_size; i < s_name_size; ++i)
         {
-            m_data.write().Name.resize(s_name_size);
+            out << pad;
         }
-        out.Write(m_data->Name.data(), s_name_size);
 
-        const auto* const params = m_data->Params.c_str();
+        const auto* const params = m_params.c_str();
         out.Write(params, static_cast<int>(strlen(params)));
     }
 }
@@ -7095,16 +7325,16 @@ bool flightsimlib::io::CBglEffect::Validate() { return true; }
 
 int flightsimlib::io::CBglEffect::CalculateSize() const
 {
-    return CBglSceneryObject::CalculateSize() + s_name_size + static_cast<int>(strlen(m_data->Params.c_str()));
+    return CBglSceneryObject::CalculateSize() + s_name_size + static_cast<int>(strlen(m_params.c_str()));
 }
 
-const char* flightsimlib::io::CBglEffect::GetName() const { return m_data->Name.c_str(); }
+const char* flightsimlib::io::CBglEffect::GetName() const { return m_name.c_str(); }
 
-void flightsimlib::io::CBglEffect::SetName(const char* value) { m_data.write().Name = value; }
+void flightsimlib::io::CBglEffect::SetName(const char* value) { m_name = value; }
 
-const char* flightsimlib::io::CBglEffect::GetParams() const { return m_data->Params.c_str(); }
+const char* flightsimlib::io::CBglEffect::GetParams() const { return m_params.c_str(); }
 
-void flightsimlib::io::CBglEffect::SetParams(const char* value) { m_data.write().Params = value; }
+void flightsimlib::io::CBglEffect::SetParams(const char* value) { m_params = value; }
 
 //******************************************************************************
 // CBglTaxiwaySign
@@ -7115,9 +7345,9 @@ auto flightsimlib::io::CBglTaxiwaySign::ReadBinary(BinaryFileStream& in) -> void
     auto& data = m_data.write();
     in >> data.LongitudeBias >> data.LatitudeBias >> data.Heading >> data.Size >> data.Justification;
 
-    data.Label = in.ReadCString();
+    m_label = in.ReadPooledCString();
     auto pad = uint8_t{0};
-    if (data.Label.size() % 2 == 0) // if it's even, we pad, as the c_str() is odd
+    if (m_label.size() % 2 == 0) // if it's even, we pad, as the c_str() is odd
     {
         in >> pad;
     }
@@ -7127,7 +7357,7 @@ auto flightsimlib::io::CBglTaxiwaySign::WriteBinary(BinaryFileStream& out) -> vo
 {
     out << m_data->LongitudeBias << m_data->LatitudeBias << m_data->Heading << m_data->Size << m_data->Justification;
 
-    const auto* const label = m_data->Label.c_str();
+    const auto* const label = m_label.c_str();
     const auto length = static_cast<int>(strlen(label)) + 1;
     out.Write(label, length);
 
@@ -7149,7 +7379,7 @@ auto flightsimlib::io::CBglTaxiwaySign::Validate() -> bool { return true; }
 
 auto flightsimlib::io::CBglTaxiwaySign::CalculateSize() const -> int
 {
-    const auto label_length = static_cast<int>(m_data->Label.size());
+    const auto label_length = static_cast<int>(m_label.size());
     return s_record_size + label_length + 1 + (label_length % 2 ? 0 : 1);
 }
 
@@ -7185,9 +7415,9 @@ auto flightsimlib::io::CBglTaxiwaySign::SetJustification(EJustification value) -
     m_data.write().Justification = to_integral(value);
 }
 
-auto flightsimlib::io::CBglTaxiwaySign::GetLabel() const -> const char* { return m_data->Label.c_str(); }
+auto flightsimlib::io::CBglTaxiwaySign::GetLabel() const -> const char* { return m_label.c_str(); }
 
-auto flightsimlib::io::CBglTaxiwaySign::SetLabel(const char* value) -> void { m_data.write().Label = value; }
+auto flightsimlib::io::CBglTaxiwaySign::SetLabel(const char* value) -> void { m_label = value; }
 
 //******************************************************************************
 // CBglTaxiwaySigns
@@ -7252,6 +7482,11 @@ auto flightsimlib::io::CBglTaxiwaySigns::GetSignCount() const -> int { return st
 
 auto flightsimlib::io::CBglTaxiwaySigns::GetSignAt(int index) -> IBglTaxiwaySign* { return &(m_signs.write()[index]); }
 
+auto flightsimlib::io::CBglTaxiwaySigns::GetSignAt(int index) const -> const IBglTaxiwaySign*
+{
+    return &(m_signs.read()[index]);
+}
+
 auto flightsimlib::io::CBglTaxiwaySigns::AddSign(const IBglTaxiwaySign* sign) -> void
 {
     // TODO Need validation, self check
@@ -7272,7 +7507,7 @@ auto flightsimlib::io::CBglTaxiwaySigns::RemoveSign(const IBglTaxiwaySign* sign)
 auto flightsimlib::io::CBglTriggerRefuelRepair::ReadBinary(BinaryFileStream& in) -> void
 {
     auto& data = m_data.write();
-    in >> data.FuelAvailability >> data.PointCount;
+    data = in.ReadPacked<SBglTriggerRefuelRepairData>();
 
     m_vertices.write().resize(data.PointCount);
 
@@ -7306,6 +7541,11 @@ auto flightsimlib::io::CBglTriggerRefuelRepair::GetVertexAt(int index) -> SBglVe
     return &(m_vertices.write()[index]);
 }
 
+auto flightsimlib::io::CBglTriggerRefuelRepair::GetVertexAt(int index) const -> const SBglVertexBias*
+{
+    return &(m_vertices.read()[index]);
+}
+
 auto flightsimlib::io::CBglTriggerRefuelRepair::AddVertex(const SBglVertexBias* point) -> void
 {
     m_vertices.write().emplace_back(*point);
@@ -7326,7 +7566,7 @@ auto flightsimlib::io::CBglTriggerRefuelRepair::RemoveVertex(const SBglVertexBia
 auto flightsimlib::io::CBglTriggerWeather::ReadBinary(BinaryFileStream& in) -> void
 {
     auto& data = m_data.write();
-    in >> data.Type >> data.Heading >> data.Scalar >> data.PointCount;
+    data = in.ReadPacked<SBglTriggerWeatherData>();
 
     m_vertices.write().resize(data.PointCount);
 
@@ -7368,6 +7608,11 @@ auto flightsimlib::io::CBglTriggerWeather::GetVertexAt(int index) -> SBglVertexB
     return &(m_vertices.write()[index]);
 }
 
+auto flightsimlib::io::CBglTriggerWeather::GetVertexAt(int index) const -> const SBglVertexBias*
+{
+    return &(m_vertices.read()[index]);
+}
+
 auto flightsimlib::io::CBglTriggerWeather::AddVertex(const SBglVertexBias* point) -> void
 {
     m_vertices.write().emplace_back(*point);
@@ -7390,8 +7635,7 @@ auto flightsimlib::io::CBglTrigger::ReadBinary(BinaryFileStream& in) -> void
     CBglSceneryObject::ReadBinary(in);
     if (in)
     {
-        auto& data = m_data.write();
-        in >> data.Type >> data.Height;
+        m_data.write() = in.ReadPacked<SBglTriggerData>();
 
         if (GetType() == EType::RefuelRepair)
         {
@@ -7566,9 +7810,7 @@ auto flightsimlib::io::CBglExtrusionBridge::ReadBinary(BinaryFileStream& in) ->
     if (in)
     {
         auto& data = m_data.write();
-        in >> data.ExtrusionProfile >> data.MaterialSet >> data.LongitudeSample1 >> data.LatitudeSample1 >>
-            data.AltitudeSample1 >> data.LongitudeSample2 >> data.LatitudeSample2 >> data.AltitudeSample2 >>
-            data.RoadWidth >> data.Probability >> data.SuppressPlatform >> data.PlacementCount >> data.PointCount;
+        data = in.ReadPacked<SBglExtrusionBridgeData>();
 
         m_placements.write().resize(data.PlacementCount);
 
@@ -7720,6 +7962,11 @@ auto flightsimlib::io::CBglExtrusionBridge::GetPlacementAt(int index) -> _GUID*
     return &(m_placements.write()[index]);
 }
 
+auto flightsimlib::io::CBglExtrusionBridge::GetPlacementAt(int index) const -> const _GUID*
+{
+    return &(m_placements.read()[index]);
+}
+
 auto flightsimlib::io::CBglExtrusionBridge::AddPlacement(const _GUID* placement) -> void
 {
     // TODO Need validation, self check
@@ -7739,6 +7986,11 @@ auto flightsimlib::io::CBglExtrusionBridge::GetPointAt(int index) -> SBglVertexL
     return &(m_points.write()[index]);
 }
 
+auto flightsimlib::io::CBglExtrusionBridge::GetPointAt(int index) const -> const SBglVertexLLA*
+{
+    return &(m_points.read()[index]);
+}
+
 auto flightsimlib::io::CBglExtrusionBridge::AddPoint(const SBglVertexLLA* point) -> void
 {
     m_points.write().emplace_back(*point);
@@ -7796,19 +8048,143 @@ auto flightsimlib::io::CBglModelData::SetData(const uint8_t* value, int length)
 auto flightsimlib::io::CBglModelData::GetLength() const -> int { return static_cast<int>(m_model->size()); }
 
 //******************************************************************************
-// CTerrainRasterQuad1
+// CRasterBlockCache
 //******************************************************************************
 
-std::shared_ptr<uint8_t[]> flightsimlib::io::CRasterBlock::GetCompressedData() { return nullptr; }
+flightsimlib::io::CRasterBlockCache::CRasterBlockCache(size_t budget_bytes) : m_budget(budget_bytes), m_resident(0) { }
+
+auto flightsimlib::io::CRasterBlockCache::GetDefault() -> CRasterBlockCache&
+{
+    static CRasterBlockCache s_cache;
+    return s_cache;
+}
+
+void flightsimlib::io::CRasterBlockCache::SetBudget(size_t budget_bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budget = budget_bytes;
+    EvictToBudget();
+}
+
+auto flightsimlib::io::CRasterBlockCache::GetBudget() const -> size_t
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_budget;
+}
+
+auto flightsimlib::io::CRasterBlockCache::GetResidentBytes() const -> size_t
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_resident;
+}
+
+auto flightsimlib::io::CRasterBlockCache::Load(
+    const std::shared_ptr<const IPositionalStream>& source, int offset, int length) -> std::shared_ptr<uint8_t[]>
+{
+    if (source == nullptr || length <= 0)
+    {
+        return nullptr;
+    }
+
+    const auto key = SEntryKey{ source.get(), offset };
+    const auto is_same_source = [&source](const SEntry& entry)
+    { return !entry.Source.owner_before(source) && !source.owner_before(entry.Source); };
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto it = m_index.find(key);
+        if (it != m_index.end())
+        {
+            const auto entry = it->second;
+            // The address may belong to a newer stream once the old one is destroyed
+            if (is_same_source(*entry) && entry->Length == length)
+            {
+                m_entries.splice(m_entries.begin(), m_entries, entry);
+                return entry->Data;
+            }
+            m_resident -= static_cast<size_t>(entry->Length);
+            m_entries.erase(entry);
+            m_index.erase(it);
+        }
+    }
+
+    // Read without holding the lock so other blocks can be served meanwhile
+    auto data = std::shared_ptr<uint8_t[]>(new uint8_t[length]);
+    if (!source->ReadAt(offset, data.get(), length))
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_index.find(key);
+    if (it != m_index.end() && is_same_source(*it->second) && it->second->Length == length)
+    {
+        // Another thread loaded the same block first
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->Data;
+    }
+    if (it != m_index.end())
+    {
+        m_resident -= static_cast<size_t>(it->second->Length);
+        m_entries.erase(it->second);
+        m_index.erase(it);
+    }
+
+    if (static_cast<size_t>(length) > m_budget)
+    {
+        return data;
+    }
+
+    m_entries.push_front({ key, source, length, data });
+    m_index.emplace(key, m_entries.begin());
+    m_resident += static_cast<size_t>(length);
+    EvictToBudget();
+    return data;
+}
+
+void flightsimlib::io::CRasterBlockCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_index.clear();
+    m_resident = 0;
+}
+
+void flightsimlib::io::CRasterBlockCache::EvictToBudget()
+{
+    while (m_resident > m_budget && !m_entries.empty())
+    {
+        const auto& entry = m_entries.back();
+        m_resident -= static_cast<size_t>(entry.Length);
+        m_index.erase(entry.Key);
+        m_entries.pop_back();
+    }
+}
+
+//******************************************************************************
+// CRasterBlock
+//******************************************************************************
+
+std::shared_ptr<uint8_t[]> flightsimlib::io::CRasterBlock::GetCompressedData() const
+{
+    return GetCompressedData(CRasterBlockCache::GetDefault());
+}
+
+std::shared_ptr<uint8_t[]> flightsimlib::io::CRasterBlock::GetCompressedData(CRasterBlockCache& cache) const
+{
+    return cache.Load(Source, DataOffset, DataLength);
+}
+
+//******************************************************************************
+// CTerrainRasterQuad1
+//******************************************************************************
 
 void flightsimlib::io::CTerrainRasterQuad1::ReadBinary(BinaryFileStream& in)
 {
     auto& header = m_header.write();
     // On-disk order: Cols (u16) + padding (u16), then Rows (u16) + padding
     // (u16). See SBglTerrainRasterQuad1Data comment in BglData.h.
-    in >> header.Version >> header.Size >> header.DataType >> header.CompressionTypeData >>
-        header.CompressionTypeMask >> header.QmidLow >> header.QmidHigh >> header.Variations >> header.Cols >>
-        header.ColsPadding >> header.Rows >> header.RowsPadding >> header.SizeData >> header.SizeMask;
+    header = in.ReadPacked<SBglTerrainRasterQuad1Data>();
 
     if (in)
     {
@@ -7819,6 +8195,7 @@ void flightsimlib::io::CTerrainRasterQuad1::ReadBinary(BinaryFileStream& in)
             m_data.write().MaskOffset = m_data->DataOffset + m_data->DataLength;
             m_data.write().MaskLength = m_header->SizeMask;
         }
+        m_data.write().Source = in.GetPayloadSource();
     }
 }
 
@@ -7832,6 +8209,8 @@ void flightsimlib::io::CTerrainRasterQuad1::WriteBinary(BinaryFileStream& out)
         << m_header->Cols << m_header->ColsPadding << m_header->Rows << m_header->RowsPadding << m_header->SizeData
         << m_header->SizeMask;
 
+    // The offsets now describe the output, which the old source can't serve
+    m_data.write().Source = nullptr;
     m_data.write().DataOffset = out.GetPosition();
     if (m_data->MaskLength)
     {
@@ -7975,6 +8354,17 @@ bool flightsimlib::io::CTerrainRasterQuad1::ReadCompressedMask(BinaryFileStream&
         return true;
     }
 
+    if (in.IsMapped())
+    {
+        auto view = SByteSpan{};
+        if (!ReadCompressedMask(static_cast<const BinaryFileStream&>(in), view))
+        {
+            return false;
+        }
+        out_mask.assign(view.Data, view.Data + view.Length);
+        return true;
+    }
+
     in.SetPosition(m_data->MaskOffset);
     if (!in)
     {
@@ -7995,17 +8385,43 @@ bool flightsimlib::io::CTerrainRasterQuad1::DecompressMask(BinaryFileStream& in,
         return true;
     }
 
-    if (header.Rows == 0 || header.Cols == 0)
+    std::vector<uint8_t> compressed;
+    if (!ReadCompressedMask(in, compressed))
     {
         return false;
     }
 
+    return DecompressMaskData(compressed, out_mask);
+}
+
+bool flightsimlib::io::CTerrainRasterQuad1::DecompressMask(
+    const IPositionalStream& in, std::vector<uint8_t>& out_mask) const
+{
+    out_mask.clear();
+    const auto& header = GetHeader();
+    if (header.SizeMask == 0 || m_data->MaskLength <= 0)
+    {
+        return true;
+    }
+
     std::vector<uint8_t> compressed;
     if (!ReadCompressedMask(in, compressed))
     {
         return false;
     }
 
+    return DecompressMaskData(compressed, out_mask);
+}
+
+bool flightsimlib::io::CTerrainRasterQuad1::DecompressMaskData(
+    const std::vector<uint8_t>& compressed, std::vector<uint8_t>& out_mask) const
+{
+    const auto& header = GetHeader();
+    if (header.Rows == 0 || header.Cols == 0)
+    {
+        return false;
+    }
+
     const int rows = header.Rows;
     const int cols = header.Cols;
     constexpr int mask_bpp = 1;
@@ -8024,6 +8440,34 @@ bool flightsimlib::io::CTerrainRasterQuad1::DecompressMask(BinaryFileStream& in,
     return true;
 }
 
+namespace
+{
+// Returns the size of the RCS1 scale/base prefix on an elevation payload, or 0 if not present
+auto ParseRcs1Header(const uint8_t* data, int length,
+    std::optional<flightsimlib::io::ITerrainRasterQuad1::SRcs1Data>& out_rcs1) -> int
+{
+    out_rcs1.reset();
+    if (length < 12)
+    {
+        return 0;
+    }
+
+    uint32_t signature = 0;
+    std::memcpy(&signature, data, sizeof(signature));
+    if (signature != 0x31534352) // "RCS1"
+    {
+        return 0;
+    }
+
+    flightsimlib::io::ITerrainRasterQuad1::SRcs1Data rcs1{};
+    rcs1.Signature = signature;
+    std::memcpy(&rcs1.Scale, data + 4, sizeof(rcs1.Scale));
+    std::memcpy(&rcs1.Base, data + 8, sizeof(rcs1.Base));
+    out_rcs1 = rcs1;
+    return 12;
+}
+} // namespace
+
 bool flightsimlib::io::CTerrainRasterQuad1::ReadCompressedRaster(
     BinaryFileStream& in, std::vector<uint8_t>& out_data, std::optional<SRcs1Data>& out_rcs1) const
 {
@@ -8033,6 +8477,17 @@ bool flightsimlib::io::CTerrainRasterQuad1::ReadCompressedRaster(
         return false;
     }
 
+    if (in.IsMapped())
+    {
+        auto view = SByteSpan{};
+        if (!ReadCompressedRaster(static_cast<const BinaryFileStream&>(in), view, out_rcs1))
+        {
+            return false;
+        }
+        out_data.assign(view.Data, view.Data + view.Length);
+        return true;
+    }
+
     in.SetPosition(m_data->DataOffset);
     if (!in)
     {
@@ -8046,28 +8501,98 @@ bool flightsimlib::io::CTerrainRasterQuad1::ReadCompressedRaster(
         return false;
     }
 
-    out_rcs1.reset();
-    if (buffer.size() >= 12)
+    const auto header_size = ParseRcs1Header(buffer.data(), data_length, out_rcs1);
+    if (header_size > 0)
     {
-        uint32_t signature = 0;
-        std::memcpy(&signature, buffer.data(), sizeof(signature));
-        if (signature == 0x31534352) // "RCS1"
-        {
-            SRcs1Data rcs1{};
-            rcs1.Signature = signature;
-            std::memcpy(&rcs1.Scale, buffer.data() + 4, sizeof(rcs1.Scale));
-            std::memcpy(&rcs1.Base, buffer.data() + 8, sizeof(rcs1.Base));
-            out_rcs1 = rcs1;
-
-            out_data.assign(buffer.begin() + 12, buffer.end());
-            return true;
-        }
+        out_data.assign(buffer.begin() + header_size, buffer.end());
+        return true;
     }
 
     out_data = std::move(buffer);
     return true;
 }
 
+bool flightsimlib::io::CTerrainRasterQuad1::ReadCompressedRaster(
+    const BinaryFileStream& in, SByteSpan& out_data, std::optional<SRcs1Data>& out_rcs1) const
+{
+    out_data = {};
+    const auto data_length = m_data->DataLength;
+    if (data_length <= 0)
+    {
+        return false;
+    }
+
+    const auto view = in.GetMappedView(m_data->DataOffset, data_length);
+    if (view.Empty())
+    {
+        return false;
+    }
+
+    const auto header_size = ParseRcs1Header(view.Data, view.Length, out_rcs1);
+    out_data = { view.Data + header_size, view.Length - header_size };
+    return true;
+}
+
+bool flightsimlib::io::CTerrainRasterQuad1::ReadCompressedMask(const BinaryFileStream& in, SByteSpan& out_mask) const
+{
+    out_mask = {};
+    const auto& header = GetHeader();
+    if (header.SizeMask == 0 || m_data->MaskLength <= 0)
+    {
+        return true;
+    }
+
+    out_mask = in.GetMappedView(m_data->MaskOffset, m_data->MaskLength);
+    return !out_mask.Empty();
+}
+
+bool flightsimlib::io::CTerrainRasterQuad1::ReadCompressedRaster(
+    const IPositionalStream& in, std::vector<uint8_t>& out_data, std::optional<SRcs1Data>& out_rcs1) const
+{
+    const auto data_length = m_data->DataLength;
+    if (data_length <= 0)
+    {
+        return false;
+    }
+
+    const auto view = in.GetView(m_data->DataOffset, data_length);
+    if (!view.Empty())
+    {
+        const auto header_size = ParseRcs1Header(view.Data, view.Length, out_rcs1);
+        out_data.assign(view.Data + header_size, view.Data + view.Length);
+        return true;
+    }
+
+    std::vector<uint8_t> buffer(static_cast<size_t>(data_length));
+    if (!in.ReadAt(m_data->DataOffset, buffer.data(), data_length))
+    {
+        return false;
+    }
+
+    const auto header_size = ParseRcs1Header(buffer.data(), data_length, out_rcs1);
+    if (header_size > 0)
+    {
+        buffer.erase(buffer.begin(), buffer.begin() + header_size);
+    }
+
+    out_data = std::move(buffer);
+    return true;
+}
+
+bool flightsimlib::io::CTerrainRasterQuad1::ReadCompressedMask(
+    const IPositionalStream& in, std::vector<uint8_t>& out_mask) const
+{
+    out_mask.clear();
+    const auto& header = GetHeader();
+    if (header.SizeMask == 0 || m_data->MaskLength <= 0)
+    {
+        return true;
+    }
+
+    out_mask.resize(static_cast<size_t>(m_data->MaskLength));
+    return in.ReadAt(m_data->MaskOffset, out_mask.data(), m_data->MaskLength);
+}
+
 bool flightsimlib::io::CTerrainRasterQuad1::GetImageFormatForType(
     ERasterDataType data_type, int& bit_depth, int& num_channels)
 {
@@ -8286,10 +8811,7 @@ auto flightsimlib::io::ConvertRasterToRgba(const SRasterImage& image, std::vecto
 
 auto flightsimlib::io::CBglTimeZone::ReadBinary(BinaryFileStream& in) -> void
 {
-    auto& data = m_data.write();
-
-    in >> data.MinLongitude >> data.MaxLatitude >> data.MaxLongitude >> data.MinLatitude >> data.TimeDeviation >>
-        data.Priority >> data.DstTimeShift >> data.DstPacked;
+    m_data.write() = in.ReadPacked<SBglTimezoneData>();
 }
 
 auto flightsimlib::io::CBglTimeZone::WriteBinary(BinaryFileStream& out) -> void
@@ -8398,18 +8920,17 @@ auto flightsimlib::io::CBglTimeZone::SetDaylightSavingsEndDayOfWeek(EStartDayOfW
     set_packed_bits(m_data.write().DstPacked, to_integral(value), 3, 9);
 }
 
-template class flightsimlib::io::CBglFuelAvailability<
-    stlab::copy_on_write<flightsimlib::io::SBglTriggerRefuelRepairData>>;
-template class flightsimlib::io::CBglFuelAvailability<stlab::copy_on_write<flightsimlib::io::SBglAirportData>>;
-template class flightsimlib::io::CBglFuelAvailability<stlab::copy_on_write<flightsimlib::io::SBglAirportSummaryData>>;
-
-template class flightsimlib::io::CBglLLA<stlab::copy_on_write<flightsimlib::io::SBglNdbData>>;
-template class flightsimlib::io::CBglLLA<stlab::copy_on_write<flightsimlib::io::SBglRunwayData>>;
-template class flightsimlib::io::CBglLLA<stlab::copy_on_write<flightsimlib::io::SBglStartData>>;
-template class flightsimlib::io::CBglLLA<stlab::copy_on_write<flightsimlib::io::SBglHelipadData>>;
-template class flightsimlib::io::CBglLLA<stlab::copy_on_write<flightsimlib::io::SBglAirportData>>;
-template class flightsimlib::io::CBglLLA<stlab::copy_on_write<flightsimlib::io::SBglAirportSummaryData>>;
-template class flightsimlib::io::CBglLLA<stlab::copy_on_write<flightsimlib::io::SBglGlideSlopeData>>;
-template class flightsimlib::io::CBglLLA<stlab::copy_on_write<flightsimlib::io::SBglDmeData>>;
-template class flightsimlib::io::CBglLLA<stlab::copy_on_write<flightsimlib::io::SBglNavData>>;
-template class flightsimlib::io::CBglLLA<stlab::copy_on_write<flightsimlib::io::SBglTacanData>>;
\ No newline at end of file
+template class flightsimlib::io::CBglFuelAvailability<flightsimlib::io::CBglTriggerRefuelRepair>;
+template class flightsimlib::io::CBglFuelAvailability<flightsimlib::io::CBglAirport>;
+template class flightsimlib::io::CBglFuelAvailability<flightsimlib::io::CBglAirportSummary>;
+
+template class flightsimlib::io::CBglLLA<flightsimlib::io::CBglNdb>;
+template class flightsimlib::io::CBglLLA<flightsimlib::io::CBglRunway>;
+template class flightsimlib::io::CBglLLA<flightsimlib::io::CBglStart>;
+template class flightsimlib::io::CBglLLA<flightsimlib::io::CBglHelipad>;
+template class flightsimlib::io::CBglLLA<flightsimlib::io::CBglAirport>;
+template class flightsimlib::io::CBglLLA<flightsimlib::io::CBglAirportSummary>;
+template class flightsimlib::io::CBglLLA<flightsimlib::io::CBglGlideSlope>;
+template class flightsimlib::io::CBglLLA<flightsimlib::io::CBglDme>;
+template class flightsimlib::io::CBglLLA<flightsimlib::io::CBglNav>;
+template class flightsimlib::io::CBglLLA<flightsimlib::io::CBglTacan>;
\ No newline at end of file
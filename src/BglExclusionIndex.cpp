@@ -0,0 +1,343 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     BglExclusionIndex.cpp
+//
+// Summary:  Grid of packed exclusion rectangles for testing scenery object
+//           positions in bulk
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "BglExclusionIndex.h"
+
+#include "CpuFeatures.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#ifdef FLIGHTSIMLIB_X64
+#include <immintrin.h>
+#endif
+
+
+namespace flightsimlib::io
+{
+
+
+static constexpr auto s_longitude_units = 0x30000000;
+static constexpr auto s_latitude_units = 0x20000000;
+
+// Both map degrees to non-negative units the way the record does, except that latitude
+// grows northwards. Points and edges go through the same mapping, so containment holds
+// as it does in degrees
+static auto PackLongitude(double value) -> int32_t
+{
+    const auto units = std::floor((std::clamp(value, -180.0, 180.0) + 180.0) * (s_longitude_units / 360.0));
+    return static_cast<int32_t>(units);
+}
+
+static auto PackLatitude(double value) -> int32_t
+{
+    const auto units = std::floor((std::clamp(value, -90.0, 90.0) + 90.0) * (s_latitude_units / 180.0));
+    return static_cast<int32_t>(units);
+}
+
+// Edges of a run of rectangles, padded to whole blocks
+struct SRectColumns
+{
+    const int32_t* MinLongitude;
+    const int32_t* MaxLongitude;
+    const int32_t* MinLatitude;
+    const int32_t* MaxLatitude;
+    const uint32_t* Types;
+    int Count;
+};
+
+static auto ContainsScalar(const SRectColumns& rects, int32_t longitude, int32_t latitude, uint32_t type) -> bool
+{
+    for (auto i = 0; i < rects.Count; ++i)
+    {
+        if (longitude >= rects.MinLongitude[i] && longitude <= rects.MaxLongitude[i] &&
+            latitude >= rects.MinLatitude[i] && latitude <= rects.MaxLatitude[i] && (rects.Types[i] & type) != 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifdef FLIGHTSIMLIB_X64
+
+// As ContainsScalar, eight rectangles at a time
+FLIGHTSIMLIB_TARGET_AVX2 static auto ContainsAvx2(const SRectColumns& rects, int32_t longitude, int32_t latitude,
+    uint32_t type) -> bool
+{
+    const auto x = _mm256_set1_epi32(longitude);
+    const auto y = _mm256_set1_epi32(latitude);
+    const auto types = _mm256_set1_epi32(static_cast<int>(type));
+    const auto zero = _mm256_setzero_si256();
+    for (auto i = 0; i < rects.Count; i += 8)
+    {
+        const auto min_x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rects.MinLongitude + i));
+        const auto max_x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rects.MaxLongitude + i));
+        const auto min_y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rects.MinLatitude + i));
+        const auto max_y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rects.MaxLatitude + i));
+        const auto mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rects.Types + i));
+        auto outside = _mm256_or_si256(_mm256_cmpgt_epi32(min_x, x), _mm256_cmpgt_epi32(x, max_x));
+        outside = _mm256_or_si256(outside, _mm256_cmpgt_epi32(min_y, y));
+        outside = _mm256_or_si256(outside, _mm256_cmpgt_epi32(y, max_y));
+        outside = _mm256_or_si256(outside, _mm256_cmpeq_epi32(_mm256_and_si256(mask, types), zero));
+        if (_mm256_movemask_ps(_mm256_castsi256_ps(outside)) != 0xFF)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
+
+
+//******************************************************************************
+// CBglExclusionIndex
+//******************************************************************************
+
+
+// The bit of each type is its bit in the type field of the exclusion record. Types an
+// exclusion cannot name use the bit of exclude all, which only exclude all rectangles have
+auto CBglExclusionIndex::TypeMask(ESceneryObjectType type) -> uint32_t
+{
+    switch (type)
+    {
+    case ESceneryObjectType::Beacon:
+        return 1u << 4;
+    case ESceneryObjectType::Effect:
+        return 1u << 5;
+    case ESceneryObjectType::GenericBuilding:
+        return 1u << 6;
+    case ESceneryObjectType::LibraryObject:
+        return 1u << 7;
+    case ESceneryObjectType::TaxiwaySigns:
+        return 1u << 8;
+    case ESceneryObjectType::Trigger:
+        return 1u << 9;
+    case ESceneryObjectType::Windsock:
+        return 1u << 10;
+    case ESceneryObjectType::ExtrusionBridge:
+        return 1u << 11;
+    default:
+        return 1u << 3;
+    }
+}
+
+auto CBglExclusionIndex::CellOf(int32_t longitude, int32_t latitude) -> int
+{
+    const auto column = std::min(static_cast<int>(static_cast<int64_t>(longitude) * s_columns / s_longitude_units),
+        s_columns - 1);
+    const auto row = std::min(static_cast<int>(static_cast<int64_t>(latitude) * s_rows / s_latitude_units), s_rows - 1);
+    return row * s_columns + column;
+}
+
+auto CBglExclusionIndex::Add(const IBglExclusion& exclusion) -> void
+{
+    auto types = ~0u;
+    if (!exclusion.IsExcludeAll())
+    {
+        const std::pair<bool, ESceneryObjectType> flags[] = {
+            { exclusion.IsBeacon(), ESceneryObjectType::Beacon },
+            { exclusion.IsEffect(), ESceneryObjectType::Effect },
+            { exclusion.IsGenericBuilding(), ESceneryObjectType::GenericBuilding },
+            { exclusion.IsLibraryObject(), ESceneryObjectType::LibraryObject },
+            { exclusion.IsTaxiwaySigns(), ESceneryObjectType::TaxiwaySigns },
+            { exclusion.IsTrigger(), ESceneryObjectType::Trigger },
+            { exclusion.IsWindsock(), ESceneryObjectType::Windsock },
+            { exclusion.IsExtrusionBridge(), ESceneryObjectType::ExtrusionBridge },
+        };
+        types = 0;
+        for (const auto& [set, type] : flags)
+        {
+            types |= set ? TypeMask(type) : 0;
+        }
+    }
+
+    const auto min_latitude = std::min(exclusion.GetMinLatitude(), exclusion.GetMaxLatitude());
+    const auto max_latitude = std::max(exclusion.GetMinLatitude(), exclusion.GetMaxLatitude());
+    auto rect = SRect{};
+    rect.MinLongitude = PackLongitude(exclusion.GetMinLongitude());
+    rect.MaxLongitude = PackLongitude(exclusion.GetMaxLongitude());
+    rect.MinLatitude = PackLatitude(min_latitude);
+    rect.MaxLatitude = PackLatitude(max_latitude);
+    rect.Types = types;
+    ++m_count;
+    if (types == 0 || !std::isfinite(min_latitude) || !std::isfinite(max_latitude) ||
+        !std::isfinite(exclusion.GetMinLongitude()) || !std::isfinite(exclusion.GetMaxLongitude()))
+    {
+        return;
+    }
+
+    // Across the antimeridian, as two rectangles
+    if (rect.MinLongitude > rect.MaxLongitude)
+    {
+        auto east = rect;
+        east.MinLongitude = 0;
+        rect.MaxLongitude = s_longitude_units;
+        m_staged.push_back(east);
+    }
+    m_staged.push_back(rect);
+}
+
+auto CBglExclusionIndex::Add(const IBglExclusionLayer& layer) -> void
+{
+    for (auto i = 0; i < layer.GetExclusionCount(); ++i)
+    {
+        Add(*layer.GetExclusionAt(i));
+    }
+}
+
+auto CBglExclusionIndex::Build() -> void
+{
+    constexpr auto cell_count = s_columns * s_rows;
+    // Passes each cell the rectangle is filed under to the action, where cell_count stands
+    // for the list tested for every position
+    const auto for_each_cell = [](const SRect& rect, auto&& action)
+    {
+        const auto first = CellOf(rect.MinLongitude, rect.MinLatitude);
+        const auto last = CellOf(rect.MaxLongitude, rect.MaxLatitude);
+        const auto first_row = first / s_columns;
+        const auto last_row = last / s_columns;
+        const auto first_column = first % s_columns;
+        const auto last_column = last % s_columns;
+        if ((last_row - first_row + 1) * (last_column - first_column + 1) > s_max_cells)
+        {
+            action(cell_count);
+            return;
+        }
+        for (auto row = first_row; row <= last_row; ++row)
+        {
+            for (auto column = first_column; column <= last_column; ++column)
+            {
+                action(row * s_columns + column);
+            }
+        }
+    };
+
+    auto counts = std::vector<int>(cell_count + 1, 0);
+    for (const auto& rect : m_staged)
+    {
+        for_each_cell(rect, [&counts](int cell) { ++counts[cell]; });
+    }
+    m_cell_start.assign(cell_count + 2, 0);
+    for (auto cell = 0; cell <= cell_count; ++cell)
+    {
+        const auto padded = (counts[cell] + s_block_size - 1) / s_block_size * s_block_size;
+        m_cell_start[cell + 1] = m_cell_start[cell] + padded;
+    }
+
+    // Padding is left as rectangles whose minimum lies past their maximum
+    const auto total = m_cell_start.back();
+    m_min_longitude.assign(total, 1);
+    m_max_longitude.assign(total, 0);
+    m_min_latitude.assign(total, 1);
+    m_max_latitude.assign(total, 0);
+    m_types.assign(total, 0);
+    auto next = std::vector<int>(m_cell_start.begin(), m_cell_start.end() - 1);
+    for (const auto& rect : m_staged)
+    {
+        for_each_cell(rect,
+            [&](int cell)
+            {
+                const auto i = next[cell]++;
+                m_min_longitude[i] = rect.MinLongitude;
+                m_max_longitude[i] = rect.MaxLongitude;
+                m_min_latitude[i] = rect.MinLatitude;
+                m_max_latitude[i] = rect.MaxLatitude;
+                m_types[i] = rect.Types;
+            });
+    }
+}
+
+auto CBglExclusionIndex::Contains(int first, int end, int32_t longitude, int32_t latitude, uint32_t type) const
+    -> bool
+{
+    auto rects = SRectColumns{};
+    rects.MinLongitude = m_min_longitude.data() + first;
+    rects.MaxLongitude = m_max_longitude.data() + first;
+    rects.MinLatitude = m_min_latitude.data() + first;
+    rects.MaxLatitude = m_max_latitude.data() + first;
+    rects.Types = m_types.data() + first;
+    rects.Count = end - first;
+#ifdef FLIGHTSIMLIB_X64
+    static_assert(s_block_size % 8 == 0, "The AVX2 test reads whole blocks of eight rectangles");
+    if (CCpuFeatures::HasAvx2())
+    {
+        return ContainsAvx2(rects, longitude, latitude, type);
+    }
+#endif
+    return ContainsScalar(rects, longitude, latitude, type);
+}
+
+auto CBglExclusionIndex::IsExcluded(double latitude, double longitude, ESceneryObjectType type) const -> bool
+{
+    if (m_cell_start.empty() || !(latitude >= -90.0 && latitude <= 90.0) ||
+        !(longitude >= -180.0 && longitude <= 180.0))
+    {
+        return false;
+    }
+    constexpr auto shared = s_columns * s_rows;
+    const auto x = PackLongitude(longitude);
+    const auto y = PackLatitude(latitude);
+    const auto cell = CellOf(x, y);
+    const auto mask = TypeMask(type);
+    return Contains(m_cell_start[cell], m_cell_start[cell + 1], x, y, mask) ||
+        Contains(m_cell_start[shared], m_cell_start[shared + 1], x, y, mask);
+}
+
+auto CBglExclusionIndex::FilterExcluded(const double* latitudes, const double* longitudes, int count,
+    ESceneryObjectType type, std::vector<uint64_t>& excluded) const -> int
+{
+    excluded.assign((std::max(count, 0) + 63) / 64, 0);
+    auto total = 0;
+    for (auto i = 0; i < count; ++i)
+    {
+        if (IsExcluded(latitudes[i], longitudes[i], type))
+        {
+            excluded[i / 64] |= 1ull << (i % 64);
+            ++total;
+        }
+    }
+    return total;
+}
+
+
+}
@@ -44,12 +44,43 @@
 #include "BglFile.h"
 // #include "BglData.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
 namespace flightsimlib
 {
 
     namespace io
     {
 
+        // Puts a stream shared by the layers that decode records on demand back where it was,
+        // also after a failed read, so the next record decoded from it is read from the right place
+        class CStreamPositionGuard
+        {
+          public:
+            explicit CStreamPositionGuard(BinaryFileStream& stream) : m_stream(stream)
+            {
+                m_stream.ClearFail();
+                m_position = m_stream.GetPosition();
+            }
+            ~CStreamPositionGuard()
+            {
+                m_stream.ClearFail();
+                m_stream.SetPosition(m_position);
+            }
+            CStreamPositionGuard(const CStreamPositionGuard&) = delete;
+            CStreamPositionGuard& operator=(const CStreamPositionGuard&) = delete;
+            CStreamPositionGuard(CStreamPositionGuard&&) = delete;
+            CStreamPositionGuard& operator=(CStreamPositionGuard&&) = delete;
+
+          private:
+            BinaryFileStream& m_stream;
+            int m_position = 0;
+        };
+
         //******************************************************************************
         // CBglData
         //******************************************************************************
@@ -60,7 +91,7 @@ namespace flightsimlib
         {
             std::unique_ptr<IBglSerializable> data = nullptr;
 
-            constexpr auto no_copy = sizeof...(Args) != 0;
+            constexpr auto no_copy = sizeof...(Args) == 0;
 
             using TLayer = std::underlying_type<EBglLayerType>::type;
             const auto layer_value = static_cast<TLayer>(type);
@@ -244,8 +275,6 @@ namespace flightsimlib
             return FactoryImpl(GetType(), child_type, m_data.get());
         }
 
-        auto CBglData::GetType() const -> EBglLayerType { return m_type; }
-
         auto CBglData::SetType(EBglLayerType value) -> void { m_type = value; }
 
         auto CBglData::AsRasterQuad1() -> ITerrainRasterQuad1*
@@ -550,6 +579,30 @@ namespace flightsimlib
             return true;
         }
 
+        auto CBglData::ReadBinary(const IPositionalStream& in, int offset, int size) -> bool
+        {
+            if (m_data == nullptr)
+            {
+                return false;
+            }
+
+            auto view = in.GetView(offset, size);
+            std::vector<uint8_t> buffer;
+            if (view.Empty())
+            {
+                buffer.resize(static_cast<size_t>(size));
+                if (!in.ReadAt(offset, buffer.data(), size))
+                {
+                    return false;
+                }
+                view = SByteSpan{buffer.data(), size};
+            }
+
+            auto window = BinaryFileStream{};
+            window.OpenView(view.Data, view.Length, offset);
+            return ReadBinary(window);
+        }
+
         auto CBglData::WriteBinary(BinaryFileStream& out) -> bool
         {
             if (m_data == nullptr)
@@ -703,779 +756,1784 @@ namespace flightsimlib
             return false;
         }
 
+        auto CBglLayer::GetRecordType(EBglLayerType layer_type) -> EBglLayerType
+        {
+            // TODO - This needs to become a factory method
+            switch (layer_type) // NOLINT(clang-diagnostic-switch-enum)
+            {
+            case EBglLayerType::TerrainPhoto32Jan:
+                return EBglLayerType::Tacan;
+            case EBglLayerType::TerrainPhoto32Feb:
+                return EBglLayerType::TacanIndex;
+            default:
+                return layer_type;
+            }
+        }
+
         //******************************************************************************
         // CBglDirectQmidLayer
         //******************************************************************************
 
-        CBglDirectQmidLayer::CBglDirectQmidLayer(const SBglLayerPointer& pointer, EBglLayerType type) :
-            CBglLayer(type, EBglLayerClass::DirectQmid, pointer)
-        {
-        }
-
-        CBglDirectQmidLayer::CBglDirectQmidLayer(const CBglDirectQmidLayer& other) :
-            CBglLayer(other.GetType(), other.GetClass(), *other.GetLayerPointer()), m_pointers(other.m_pointers.size())
+        CBglDirectQmidLayer::STileStore::STileStore(const STileStore& other)
         {
-            for (const auto& tile : other.m_tiles)
-            {
-                auto& it = m_tiles[tile.first] = std::vector<std::unique_ptr<CBglData>>(tile.second.size());
-
-                for (const auto& data : tile.second)
-                {
-                    it.emplace_back(data->Clone());
-                }
-            }
-
-            for (auto i = 0u; i < other.m_pointers.size(); ++i)
+            // The other store may still be filling pending tiles on worker threads
+            std::lock_guard<std::mutex> lock(other.PendingMutex);
+            Keys = other.Keys;
+            Pointers = other.Pointers;
+            RepeatedEntries = other.RepeatedEntries;
+            Ranges = other.Ranges;
+            Pending = other.Pending;
+            PendingCount = other.PendingCount;
+            Stream = other.Stream;
+            Records.reserve(other.Records.size());
+            for (const auto& data : other.Records)
             {
-                m_pointers[i] = std::make_unique<SBglTilePointer>(*other.m_pointers[i]);
+                Records.emplace_back(data->Clone());
             }
         }
 
-        auto CBglDirectQmidLayer::ReadBinary(BinaryFileStream& in) -> bool
+        // Branchless lower bound: the loop runs log2(n) times whatever the key, and the
+        // comparison feeds an add instead of a jump the predictor would miss half the time
+        auto CBglDirectQmidLayer::STileStore::FindTile(CPackedQmid qmid) const -> int
         {
-            const auto* layer_pointer = CBglLayer::GetLayerPointer();
-            if (!in)
+            const auto key = qmid.Value();
+            const auto* keys = Keys.data();
+            auto length = Keys.size();
+            if (length == 0)
             {
-                return false;
+                return -1;
             }
-            const auto next_position = in.GetPosition();
-            in.SetPosition(layer_pointer->StreamOffset);
-            if (!in)
+            const auto* base = keys;
+            while (length > 1)
             {
-                return false;
+                const auto half = length / 2;
+                base += static_cast<size_t>(base[half - 1] < key) * half;
+                length -= half;
             }
-
-            // TODO - This needs to become a factory method
-            // ReSharper disable once CppInitializedValueIsAlwaysRewritten
-            auto layer_type = EBglLayerType::None;
-            switch (layer_pointer->Type)
+            base += static_cast<size_t>(*base < key);
+            if (base == keys + Keys.size() || *base != key)
             {
-            case EBglLayerType::TerrainPhoto32Jan:
-                layer_type = EBglLayerType::Tacan;
-                break;
-            case EBglLayerType::TerrainPhoto32Feb:
-                layer_type = EBglLayerType::TacanIndex;
-                break;
-            default:
-                layer_type = layer_pointer->Type;
-                break;
+                return -1;
             }
-            const auto qmid_count = static_cast<int>(layer_pointer->TileCount);
+            return static_cast<int>(base - keys);
+        }
 
-            auto existing = false;
-            // TODO - merge layers when pointer match - maybe handle outside of layer code?
-            /*
-            for (const auto& other_layer : layers)
+        // Records of a tile are one contiguous run of Records. Runs are filled in tile order
+        // when a layer is read, so this is normally an append to the end
+        auto CBglDirectQmidLayer::STileStore::InsertRecords(int tile, std::vector<std::unique_ptr<CBglData>>& records)
+            -> void
+        {
+            auto& range = Ranges[tile];
+            if (range.Count == 0)
             {
-                if (other_layer.second->m_data->StreamOffset == layer_pointer->StreamOffset)
-                {
-                    existing = true;
-                    for (const auto& tile : other_layer.second->Tiles())
-                    {
-                        const auto tile_pointer(tile.second);
-                        layer->AddTile(tile.first, tile_pointer);
-                    }
-                    break;
-                }
+                range.First = static_cast<int>(Records.size());
             }
-            */
-            if (existing == false)
+            const auto position = range.First + range.Count;
+            const auto count = static_cast<int>(records.size());
+            if (position != static_cast<int>(Records.size()))
             {
-                m_pointers.resize(qmid_count);
-                const bool is_terrain_layer =
-                    CBglLayer::IsTrq1BglLayer(layer_pointer->Type) || CBglLayer::IsRcs1BglLayer(layer_pointer->Type);
-                const auto entry_size =
-                    (layer_pointer->TileCount > 0) ? (layer_pointer->SizeBytes / layer_pointer->TileCount) : 0u;
-                for (auto i = 0; i < qmid_count; ++i)
+                for (auto i = 0; i < static_cast<int>(Ranges.size()); ++i)
                 {
-                    m_pointers[i] = std::make_unique<SBglTilePointer>();
-                    if (is_terrain_layer && (entry_size == 16 || entry_size == 20))
-                    {
-                        in >> m_pointers[i]->QmidLow >> m_pointers[i]->QmidHigh;
-                        if (entry_size == 20)
-                        {
-                            in >> m_pointers[i]->RecordCount;
-                        }
-                        else
-                        {
-                            m_pointers[i]->RecordCount = 1;
-                        }
-                        in >> m_pointers[i]->StreamOffset >> m_pointers[i]->SizeBytes;
-                    }
-                    else
-                    {
-                        m_pointers[i]->ReadBinary(in, layer_pointer->HasQmidHigh != 0);
-                    }
-                    if (!in)
+                    if (i != tile && Ranges[i].First >= position)
                     {
-                        return false;
+                        Ranges[i].First += count;
                     }
                 }
-                if (in.GetPosition() != static_cast<int>(layer_pointer->StreamOffset + layer_pointer->SizeBytes))
+            }
+            Records.insert(Records.begin() + position, std::make_move_iterator(records.begin()),
+                std::make_move_iterator(records.end()));
+            range.Count += count;
+        }
+
+        auto CBglDirectQmidLayer::STileStore::EraseRecords(int tile, int index, int count) -> void
+        {
+            auto& range = Ranges[tile];
+            const auto position = range.First + index;
+            Records.erase(Records.begin() + position, Records.begin() + position + count);
+            range.Count -= count;
+            for (auto i = 0; i < static_cast<int>(Ranges.size()); ++i)
+            {
+                if (i != tile && Ranges[i].First > position)
                 {
-                    return false;
+                    Ranges[i].First -= count;
                 }
-                for (const auto& tile_pointer : m_pointers)
-                {
-                    const auto data_count = static_cast<int>(tile_pointer->RecordCount);
-                    if (data_count <= 0)
-                    {
-                        return false;
-                    }
+            }
+        }
 
-                    in.SetPosition(tile_pointer->StreamOffset);
-                    if (!in)
-                    {
-                        return false;
-                    }
+        auto CBglDirectQmidLayer::STileStore::FindRepeatedEntries(uint64_t key) const
+            -> std::pair<std::vector<SBglTilePointer>::const_iterator, std::vector<SBglTilePointer>::const_iterator>
+        {
+            const auto key_of = [](const SBglTilePointer& entry)
+            { return CPackedQmid{entry.QmidLow, entry.QmidHigh}.Value(); };
+            const auto first = std::lower_bound(RepeatedEntries.begin(), RepeatedEntries.end(), key,
+                [&key_of](const SBglTilePointer& entry, uint64_t value) { return key_of(entry) < value; });
+            const auto last = std::upper_bound(first, RepeatedEntries.end(), key,
+                [&key_of](uint64_t value, const SBglTilePointer& entry) { return value < key_of(entry); });
+            return {first, last};
+        }
+
+        CBglDirectQmidLayer::CBglDirectQmidLayer(const SBglLayerPointer& pointer, EBglLayerType type) :
+            CBglLayer(type, EBglLayerClass::DirectQmid, pointer), m_store(std::make_shared<STileStore>())
+        {
+        }
 
-                    auto tile =
-                        m_tiles.emplace(std::make_pair(CPackedQmid{tile_pointer->QmidLow, tile_pointer->QmidHigh},
-                            std::vector<std::unique_ptr<CBglData>>{}));
-                    auto& data_list = tile.first->second;
+        // Shares the tiles, the first edit to either layer copies them
+        CBglDirectQmidLayer::CBglDirectQmidLayer(const CBglDirectQmidLayer& other) :
+            CBglLayer(other.GetType(), other.GetClass(), *other.GetLayerPointer()), m_store(other.m_store)
+        {
+        }
 
-                    data_list.reserve(data_count);
+        auto CBglDirectQmidLayer::ShareTiles(const CBglDirectQmidLayer& other) -> void { m_store = other.m_store; }
 
-                    for (auto i = 0; i < data_count; ++i)
-                    {
-                        const auto pos = in.GetPosition();
-                        const auto type = GetType();
-                        auto child_type = IBglSceneryObject::ESceneryObjectType::Unknown;
-                        if (type == EBglLayerType::SceneryObject)
-                        {
-                            child_type = GetSceneryObjectType(in);
-                        }
-                        auto data = CBglData::Factory(layer_type, child_type);
-                        if (data == nullptr)
-                        {
-                            in.SetPosition(pos + static_cast<int>(tile_pointer->SizeBytes));
-                            continue;
-                        }
-                        if (!data->ReadBinary(in))
-                        {
-                            return false;
-                        }
-                        const auto size = data->CalculateSize();
-                        if (!data->Validate())
-                        {
-                            return false;
-                        }
-                        data_list.emplace_back(std::move(data));
-                        if (is_terrain_layer)
-                        {
-                            in.SetPosition(pos + static_cast<int>(tile_pointer->SizeBytes));
-                        }
-                        else
-                        {
-                            in.SetPosition(pos + static_cast<int>(size));
-                        }
-                        if (!in)
-                        {
-                            return false;
-                        }
-                    }
-                }
+        auto CBglDirectQmidLayer::IsSharingTiles(const CBglDirectQmidLayer& other) const -> bool
+        {
+            return m_store == other.m_store;
+        }
+
+        auto CBglDirectQmidLayer::Detach() -> STileStore&
+        {
+            if (m_store.use_count() > 1)
+            {
+                m_store = std::make_shared<STileStore>(*m_store);
             }
+            return *m_store;
+        }
 
-            in.SetPosition(next_position);
+        auto CBglDirectQmidLayer::ReadBinary(BinaryFileStream& in) -> bool
+        {
             if (!in)
             {
                 return false;
             }
-            return true;
-        }
+            const auto next_position = in.GetPosition();
 
-        auto CBglDirectQmidLayer::CalculateSize() const -> int
-        {
-            auto data_size = 0;
-            for (const auto& tile : m_tiles)
+            std::vector<SBglTilePointer> pointers;
+            if (!ReadTilePointers(in, pointers))
             {
-                for (const auto& data : tile.second)
-                {
-                    data_size += data->CalculateSize();
-                }
+                return false;
             }
-            return data_size;
-        }
+            auto& store = ResetTiles(pointers, false);
 
-        auto CBglDirectQmidLayer::CalculateDataPointersSize() const -> int
-        {
-            auto tile_pointer_size = 16;
-            for (const auto& pointer : m_pointers)
+            // Duplicate QMIDs in the table are sorted next to each other and share one tile
+            auto data_list = std::vector<std::unique_ptr<CBglData>>{};
+            for (const auto& tile_pointer : pointers)
             {
-                if (pointer->QmidHigh > 0)
+                data_list.clear();
+                if (!ReadTile(in, tile_pointer, data_list))
                 {
-                    tile_pointer_size = 20;
-                    break;
+                    return false;
                 }
+                const auto tile = store.FindTile(CPackedQmid{tile_pointer.QmidLow, tile_pointer.QmidHigh});
+                store.InsertRecords(tile, data_list);
             }
-            return static_cast<int>(m_layer_pointer->TileCount) * tile_pointer_size;
+
+            in.SetPosition(next_position);
+            if (!in)
+            {
+                return false;
+            }
+            return true;
         }
 
-        auto CBglDirectQmidLayer::WriteBinaryPointer(BinaryFileStream& out, int offset_to_tile, int offset_to_layer)
-            -> bool
+        auto CBglDirectQmidLayer::ReadBinaryIndex(const std::shared_ptr<BinaryFileStream>& in) -> bool
         {
-            const auto tile_pointers_size = CalculateDataPointersSize();
-
-            auto type = CBglLayer::GetType();
-            switch (type) // NOLINT(clang-diagnostic-switch-enum)
+            if (!*in)
             {
-            case EBglLayerType::Tacan:
-                type = EBglLayerType::TerrainPhoto32Jan;
-                break;
-            case EBglLayerType::TacanIndex:
-                type = EBglLayerType::TerrainPhoto32Feb;
-                break;
-            default:
-                break;
+                return false;
             }
+            const auto next_position = in->GetPosition();
 
-            auto& data = m_layer_pointer.write();
-            data.Type = type;
-
-            data.TileCount = static_cast<uint32_t>(m_tiles.size());
-            data.DataClass = 1;
-            if (m_layer_pointer->TileCount && tile_pointers_size / static_cast<int>(m_layer_pointer->TileCount) == 20)
+            std::vector<SBglTilePointer> pointers;
+            if (!ReadTilePointers(*in, pointers))
             {
-                data.HasQmidHigh = 1;
+                return false;
             }
-            else
+            for (const auto& tile_pointer : pointers)
             {
-                data.HasQmidHigh = 0;
+                if (tile_pointer.RecordCount == 0)
+                {
+                    return false;
+                }
             }
-            data.SizeBytes = tile_pointers_size;
-            data.StreamOffset = offset_to_tile;
+            // Empty ranges keep the QMID queries working until each tile is decoded
+            auto& store = ResetTiles(pointers, true);
+            store.Stream = in;
 
-            m_layer_pointer->WriteBinary(out);
-            return true;
+            in->SetPosition(next_position);
+            return static_cast<bool>(*in);
         }
 
-        auto CBglDirectQmidLayer::WriteBinaryData(BinaryFileStream& out) -> bool
+        auto CBglDirectQmidLayer::Materialize() -> bool
         {
-            for (const auto& pointer : m_pointers)
+            auto& store = *m_store;
+            for (auto i = 0; i < static_cast<int>(store.Keys.size()); ++i)
             {
-                const auto& tile = m_tiles[CPackedQmid{pointer->QmidLow, pointer->QmidHigh}];
-
-                pointer->StreamOffset = out.GetPosition();
-                pointer->RecordCount = static_cast<int>(tile.size());
-
-                auto data_size = 0;
-
-                for (const auto& data : tile)
+                if (!LoadTileAt(i))
                 {
-                    if (!data->WriteBinary(out))
-                    {
-                        return false;
-                    }
-                    data_size += data->CalculateSize();
+                    return false;
                 }
-
-                pointer->SizeBytes = data_size;
             }
+            std::lock_guard<std::mutex> lock(store.PendingMutex);
+            store.Stream.reset();
             return true;
         }
 
-        auto CBglDirectQmidLayer::WriteBinaryDataPointers(BinaryFileStream& out) -> bool
+        auto CBglDirectQmidLayer::GetPendingExtents(std::vector<SBglReadExtent>& extents) const -> void
         {
-            for (const auto& pointer : m_pointers)
+            const auto& store = *m_store;
+            for (auto i = 0; i < static_cast<int>(store.Pointers.size()); ++i)
             {
-                pointer->WriteBinary(out, m_layer_pointer->HasQmidHigh);
-                if (!out)
+                // A QMID repeated in the table spans several extents, and is left to Materialize
+                const auto repeated = store.FindRepeatedEntries(store.Keys[i]);
+                if (store.Pending[i] && repeated.first == repeated.second)
                 {
-                    return false;
+                    const auto& pointer = store.Pointers[i];
+                    extents.push_back({static_cast<int>(pointer.StreamOffset), static_cast<int>(pointer.SizeBytes), i});
                 }
             }
-            return true;
         }
 
-        auto CBglDirectQmidLayer::GetQmidCount() const -> int
+        auto CBglDirectQmidLayer::MaterializeExtent(BinaryFileStream& window, int item) -> bool
         {
-            assert(m_pointers.size() == m_tiles.size());
-            return static_cast<int>(m_pointers.size());
-        }
+            auto& store = *m_store;
+            auto tile_pointer = SBglTilePointer{};
+            {
+                std::lock_guard<std::mutex> lock(store.PendingMutex);
+                if (!store.Pending[item])
+                {
+                    return true;
+                }
+                tile_pointer = store.Pointers[item];
+            }
 
-        auto CBglDirectQmidLayer::HasQmid(CPackedQmid qmid) const -> bool
-        {
-            const auto& it = m_tiles.find(qmid);
-            if (it == m_tiles.end())
+            // Decode outside the lock, other threads are busy with their own tiles
+            auto data_list = std::vector<std::unique_ptr<CBglData>>{};
+            if (!ReadTile(window, tile_pointer, data_list))
             {
                 return false;
             }
-            return true;
-        }
 
-        auto CBglDirectQmidLayer::GetDataPointerAtIndex(int index) const -> const SBglTilePointer*
-        {
-            return m_pointers[index].get();
-        }
-
-        auto CBglDirectQmidLayer::GetDataCountAtQmid(CPackedQmid qmid) -> int
-        {
-            const auto& it = m_tiles.find(qmid);
-            if (it == m_tiles.end())
+            std::lock_guard<std::mutex> lock(store.PendingMutex);
+            if (store.Pending[item])
             {
-                return 0;
+                store.InsertRecords(item, data_list);
+                store.Pending[item] = false;
+                --store.PendingCount;
             }
-            return static_cast<int>(it->second.size());
+            return true;
         }
 
-        auto CBglDirectQmidLayer::GetDataAtQmid(CPackedQmid qmid, int index) -> IBglData*
+        auto CBglDirectQmidLayer::ReadTilePointers(BinaryFileStream& in, std::vector<SBglTilePointer>& pointers) -> bool
         {
-            const auto& it = m_tiles.find(qmid);
-            if (it == m_tiles.end())
+            const auto* layer_pointer = CBglLayer::GetLayerPointer();
+            in.SetPosition(layer_pointer->StreamOffset);
+            if (!in)
             {
-                return nullptr;
+                return false;
             }
-            return it->second[index].get();
-        }
 
-        auto CBglDirectQmidLayer::AddDataAtQmid(CPackedQmid qmid, const IBglData* data) -> void
-        {
-            auto& record = m_tiles[qmid];
-            if (record.empty())
+            const auto qmid_count = static_cast<int>(layer_pointer->TileCount);
+            pointers.resize(qmid_count);
+            const bool is_terrain_layer =
+                CBglLayer::IsTrq1BglLayer(layer_pointer->Type) || CBglLayer::IsRcs1BglLayer(layer_pointer->Type);
+            const auto entry_size =
+                (layer_pointer->TileCount > 0) ? (layer_pointer->SizeBytes / layer_pointer->TileCount) : 0u;
+            for (auto& pointer : pointers)
             {
-                auto pointer = std::make_unique<SBglTilePointer>();
-                pointer->QmidLow = qmid.Low();
-                pointer->QmidHigh = qmid.High();
-                pointer->RecordCount = 1u;
-
-                auto it = m_pointers.begin();
-                for (; it != m_pointers.end(); ++it)
+                pointer = SBglTilePointer{};
+                if (is_terrain_layer && (entry_size == 16 || entry_size == 20))
                 {
-                    auto record_qmid = CPackedQmid{it->get()->QmidLow, it->get()->QmidHigh};
-                    if (record_qmid > qmid) // map is ordered, so only check one direction
+                    in >> pointer.QmidLow >> pointer.QmidHigh;
+                    if (entry_size == 20)
                     {
-                        break;
+                        in >> pointer.RecordCount;
+                    }
+                    else
+                    {
+                        pointer.RecordCount = 1;
                     }
+                    in >> pointer.StreamOffset >> pointer.SizeBytes;
                 }
-
-                m_pointers.emplace(it, std::move(pointer));
+                else
+                {
+                    pointer.ReadBinary(in, layer_pointer->HasQmidHigh != 0);
+                }
+                if (!in)
+                {
+                    return false;
+                }
+            }
+            if (in.GetPosition() != static_cast<int>(layer_pointer->StreamOffset + layer_pointer->SizeBytes))
+            {
+                return false;
             }
-            record.emplace_back(static_cast<const CBglData*>(data)->Clone());
+            SortTilePointers(pointers);
+            return true;
         }
 
-        auto CBglDirectQmidLayer::RemoveQmid(CPackedQmid qmid) -> void
+        // Tables are normally written in QMID order already, so the radix passes rarely run
+        auto CBglDirectQmidLayer::SortTilePointers(std::vector<SBglTilePointer>& pointers) -> void
         {
-            const auto it_tile = m_tiles.find(qmid);
-            if (it_tile != m_tiles.end())
+            const auto key = [](const SBglTilePointer& pointer)
+            { return CPackedQmid{pointer.QmidLow, pointer.QmidHigh}.Value(); };
+            if (std::is_sorted(pointers.begin(), pointers.end(),
+                    [&key](const SBglTilePointer& lhs, const SBglTilePointer& rhs) { return key(lhs) < key(rhs); }))
             {
-                m_tiles.erase(it_tile);
+                return;
+            }
 
-                for (auto it = m_pointers.begin(); it != m_pointers.end(); ++it)
+            // Stable LSD passes over 8 bit digits, skipping digits every key has in common
+            const auto count = static_cast<int>(pointers.size());
+            std::vector<SBglTilePointer> scratch(pointers.size());
+            for (auto shift = 0; shift < 64; shift += 8)
+            {
+                std::array<int, 257> offsets{};
+                for (const auto& pointer : pointers)
                 {
-                    if (it->get()->QmidLow == qmid.Low() && it->get()->QmidHigh == qmid.High())
-                    {
-                        m_pointers.erase(it);
-                        break;
-                    }
+                    ++offsets[((key(pointer) >> shift) & 0xFF) + 1];
+                }
+                if (std::find(offsets.begin(), offsets.end(), count) != offsets.end())
+                {
+                    continue;
+                }
+                for (auto digit = 1; digit < 257; ++digit)
+                {
+                    offsets[digit] += offsets[digit - 1];
+                }
+                for (const auto& pointer : pointers)
+                {
+                    scratch[offsets[(key(pointer) >> shift) & 0xFF]++] = pointer;
                 }
+                pointers.swap(scratch);
             }
         }
 
-        auto CBglDirectQmidLayer::RemoveDataAtQmid(CPackedQmid qmid, int index) -> void
+        // The old tiles are dropped, so a store still shared is left to the other layers
+        auto CBglDirectQmidLayer::ResetTiles(const std::vector<SBglTilePointer>& sorted_pointers, bool pending)
+            -> STileStore&
         {
-            const auto it = m_tiles.find(qmid);
-            if (it != m_tiles.end())
+            if (m_store.use_count() > 1)
+            {
+                auto arena = m_store->Arena;
+                m_store = std::make_shared<STileStore>();
+                m_store->Arena = std::move(arena);
+            }
+            auto& store = *m_store;
+            store.Keys.clear();
+            store.Pointers.clear();
+            store.RepeatedEntries.clear();
+            store.Keys.reserve(sorted_pointers.size());
+            store.Pointers.reserve(sorted_pointers.size());
+            for (const auto& pointer : sorted_pointers)
             {
-                it->second.erase(it->second.begin() + index);
-                if (it->second.empty())
+                const auto key = CPackedQmid{pointer.QmidLow, pointer.QmidHigh}.Value();
+                if (store.Keys.empty() || store.Keys.back() != key)
                 {
-                    RemoveQmid(qmid);
+                    store.Keys.emplace_back(key);
+                    store.Pointers.emplace_back(pointer);
+                    continue;
                 }
-            }
-        }
-
-        //******************************************************************************
-        // CBglIndirectQmidLayer
-        //******************************************************************************
-
-        CBglIndirectQmidLayer::CBglIndirectQmidLayer(const SBglLayerPointer& pointer, EBglLayerType type) :
-            CBglLayer(type, EBglLayerClass::GuidIndex, pointer)
-        {
-        }
 
-        CBglIndirectQmidLayer::CBglIndirectQmidLayer(const CBglIndirectQmidLayer& other) :
-            CBglLayer(other.GetType(), other.GetClass(), *other.GetLayerPointer()), m_tiles(other.m_tiles),
-            m_pointers(other.m_pointers), m_offsets(other.m_offsets)
-        {
-            for (const auto& data : other.m_data)
-            {
-                m_data.emplace_back(data->Clone());
+                // The first entry of the QMID is kept as read before its tile pointer counts both
+                const auto& entries = store.RepeatedEntries;
+                if (entries.empty() || CPackedQmid{entries.back().QmidLow, entries.back().QmidHigh}.Value() != key)
+                {
+                    store.RepeatedEntries.emplace_back(store.Pointers.back());
+                }
+                store.RepeatedEntries.emplace_back(pointer);
+                auto& merged = store.Pointers.back();
+                merged.RecordCount += pointer.RecordCount;
+                merged.SizeBytes += pointer.SizeBytes;
             }
+            store.Ranges.assign(store.Keys.size(), STileRange{});
+            store.Records.clear();
+            store.Pending.assign(store.Keys.size(), pending);
+            store.PendingCount = pending ? static_cast<int>(store.Keys.size()) : 0;
+            return store;
         }
 
-        auto CBglIndirectQmidLayer::ReadBinary(BinaryFileStream& in) -> bool
+        auto CBglDirectQmidLayer::ReadTile(BinaryFileStream& in, const SBglTilePointer& tile_pointer,
+            std::vector<std::unique_ptr<CBglData>>& data_list) const -> bool
         {
             const auto* layer_pointer = CBglLayer::GetLayerPointer();
-            in.SetPosition(layer_pointer->StreamOffset);
 
-            const auto qmid_count = static_cast<int>(layer_pointer->TileCount);
-            const auto base_position = in.GetPosition();
+            const auto layer_type = CBglLayer::GetRecordType(layer_pointer->Type);
+            const bool is_terrain_layer =
+                CBglLayer::IsTrq1BglLayer(layer_pointer->Type) || CBglLayer::IsRcs1BglLayer(layer_pointer->Type);
 
-            auto& tiles = m_tiles.write();
-            auto max_index = 0;
-            for (auto i = 0; i < qmid_count; ++i)
+            const auto data_count = static_cast<int>(tile_pointer.RecordCount);
+            if (data_count <= 0)
             {
-                SBglTilePointer pointer{};
-                pointer.ReadBinary(in, false);
-                if (!in)
-                {
-                    return false;
-                }
-                const auto new_index = static_cast<int>(pointer.StreamOffset + pointer.RecordCount);
-                if (new_index > max_index)
-                {
-                    max_index = new_index;
-                }
-                tiles[CPackedQmid{pointer.QmidLow, 0}] = pointer;
+                return false;
             }
 
-            if (max_index < 0)
+            in.SetPosition(tile_pointer.StreamOffset);
+            if (!in)
             {
                 return false;
             }
 
-            auto& pointers = m_pointers.write();
-            pointers.resize(max_index);
-            std::map<int, int> offsets_and_sizes;
+            data_list.reserve(data_count);
 
-            for (auto& pointer : pointers)
+            for (auto i = 0; i < data_count; ++i)
             {
-                pointer.ReadBinary(in);
+                const auto pos = in.GetPosition();
+                const auto type = GetType();
+                auto child_type = IBglSceneryObject::ESceneryObjectType::Unknown;
+                if (type == EBglLayerType::SceneryObject)
+                {
+                    child_type = GetSceneryObjectType(in);
+                }
+                auto data = CBglData::Factory(layer_type, child_type);
+                if (data == nullptr)
+                {
+                    in.SetPosition(pos + static_cast<int>(tile_pointer.SizeBytes));
+                    continue;
+                }
+                if (!data->ReadBinary(in))
+                {
+                    return false;
+                }
+                const auto size = data->CalculateSize();
+                if (!data->Validate())
+                {
+                    return false;
+                }
+                data_list.emplace_back(std::move(data));
+                if (is_terrain_layer)
+                {
+                    in.SetPosition(pos + static_cast<int>(tile_pointer.SizeBytes));
+                }
+                else
+                {
+                    in.SetPosition(pos + static_cast<int>(size));
+                }
                 if (!in)
                 {
                     return false;
                 }
-                offsets_and_sizes[static_cast<int>(pointer.StreamOffset)] = static_cast<int>(pointer.SizeBytes);
             }
+            return true;
+        }
 
-            auto pos = in.GetPosition();
-            if (pos != base_position + static_cast<int>(layer_pointer->SizeBytes))
+        // Decoding a pending tile leaves the content of the store as it was, so it is done in
+        // place even when the store is shared
+        auto CBglDirectQmidLayer::LoadTile(CPackedQmid qmid) const -> bool
+        {
+            const auto tile = m_store->FindTile(qmid);
+            return tile < 0 || LoadTileAt(tile);
+        }
+
+        // Layers sharing a store may be read from several threads, so the pending flags, the records
+        // and the shared stream are only touched under the lock of the store
+        auto CBglDirectQmidLayer::LoadTileAt(int tile) const -> bool
+        {
+            auto& store = *m_store;
+            std::lock_guard<std::mutex> lock(store.PendingMutex);
+            if (!store.Pending[tile])
+            {
+                return true;
+            }
+            if (store.Stream == nullptr || !store.Stream->IsOpen())
             {
                 return false;
             }
 
-            // Now read data
-            m_data.resize(offsets_and_sizes.size());
-            in.SetPosition(offsets_and_sizes.begin()->first);
-
-            auto i = 0;
-            for (auto it = offsets_and_sizes.begin(); it != offsets_and_sizes.end(); ++it)
+            // A tile that fails to decode stays pending, and the stream is put back either way
+            auto data_list = std::vector<std::unique_ptr<CBglData>>{};
             {
-                pos = in.GetPosition();
-                if (pos != it->first)
+                const CStreamPositionGuard restore(*store.Stream);
+                const auto repeated = store.FindRepeatedEntries(store.Keys[tile]);
+                if (repeated.first == repeated.second)
                 {
-                    return false;
-                }
-
-                auto& data = m_data[i++];
-                data = CBglData::Factory(GetType(), IBglSceneryObject::ESceneryObjectType::Unknown);
-                if (data == nullptr)
-                {
-                    continue;
+                    if (!ReadTile(*store.Stream, store.Pointers[tile], data_list))
+                    {
+                        return false;
+                    }
                 }
-
-                data->ReadBinary(in);
-
-                if (!data->Validate() || data->CalculateSize() != it->second)
+                for (auto it = repeated.first; it != repeated.second; ++it)
                 {
-                    return false;
+                    if (!ReadTile(*store.Stream, *it, data_list))
+                    {
+                        return false;
+                    }
                 }
             }
-
+            store.InsertRecords(tile, data_list);
+            store.Pending[tile] = false;
+            --store.PendingCount;
             return true;
         }
 
-        auto CBglIndirectQmidLayer::CalculateSize() const -> int
+        auto CBglDirectQmidLayer::CalculateSize() const -> int
         {
             auto data_size = 0;
-            for (const auto& data : m_data)
+            for (const auto& data : m_store->Records)
             {
                 data_size += data->CalculateSize();
             }
-
             return data_size;
         }
 
-        auto CBglIndirectQmidLayer::CalculateDataPointersSize() const -> int
+        auto CBglDirectQmidLayer::CalculateDataPointersSize() const -> int
         {
-            return static_cast<int>(sizeof(SBglIndirectPointer) * m_pointers->size()) +
-                   static_cast<int>(16 * m_tiles->size()); // TODO Constant
+            auto tile_pointer_size = 16;
+            for (const auto& pointer : m_store->Pointers)
+            {
+                if (pointer.QmidHigh > 0)
+                {
+                    tile_pointer_size = 20;
+                    break;
+                }
+            }
+            return static_cast<int>(m_layer_pointer->TileCount) * tile_pointer_size;
         }
 
-        auto CBglIndirectQmidLayer::WriteBinaryPointer(BinaryFileStream& out, int offset_to_tile, int offset_to_layer)
+        auto CBglDirectQmidLayer::WriteBinaryPointer(BinaryFileStream& out, int offset_to_tile, int offset_to_layer)
             -> bool
         {
-            auto& data = m_layer_pointer.write();
-            data.Type = GetType();
-            data.TileCount = GetQmidCount();
-            data.DataClass = static_cast<std::underlying_type<EBglLayerType>::type>(EBglLayerClass::IndirectQmid);
-            data.HasQmidHigh = 0;
-            data.SizeBytes = CalculateDataPointersSize();
-            data.StreamOffset = offset_to_tile;
-
-            m_layer_pointer->WriteBinary(out);
-            return true;
-        }
-
-        auto CBglIndirectQmidLayer::WriteBinaryData(BinaryFileStream& out) -> bool
-        {
-            auto position = out.GetPosition();
-            position += static_cast<int>(sizeof(SBglIndirectPointer) * m_pointers->size());
-
-            // First recalculate indirect pointers to data
-            std::vector<std::pair<int, int>> indirect_pointers;
-            indirect_pointers.reserve(m_data.size());
+            const auto tile_pointers_size = CalculateDataPointersSize();
 
-            for (const auto& data : m_data)
+            auto type = CBglLayer::GetType();
+            switch (type) // NOLINT(clang-diagnostic-switch-enum)
             {
-                const auto data_size = data->CalculateSize();
-                indirect_pointers.emplace_back(position, data_size);
-                position += data_size;
+            case EBglLayerType::Tacan:
+                type = EBglLayerType::TerrainPhoto32Jan;
+                break;
+            case EBglLayerType::TacanIndex:
+                type = EBglLayerType::TerrainPhoto32Feb;
+                break;
+            default:
+                break;
             }
 
-            for (auto i = 0; i < static_cast<int>(m_offsets->size()); ++i)
+            auto& data = m_layer_pointer.write();
+            data.Type = type;
+
+            data.TileCount = static_cast<uint32_t>(m_store->Keys.size());
+            data.DataClass = 1;
+            if (m_layer_pointer->TileCount && tile_pointers_size / static_cast<int>(m_layer_pointer->TileCount) == 20)
             {
-                const auto index = m_offsets.read()[i];
-                const auto& indirect_pointer = indirect_pointers[index];
-                auto& existing_pointer = m_pointers.write()[i];
-                existing_pointer.StreamOffset = static_cast<uint32_t>(indirect_pointer.first);
-                existing_pointer.SizeBytes = static_cast<uint32_t>(indirect_pointer.second);
+                data.HasQmidHigh = 1;
             }
-
-            // Then write the data
-            for (const auto& data : m_data)
+            else
             {
-                if (!data->WriteBinary(out))
-                {
-                    return false;
-                }
+                data.HasQmidHigh = 0;
             }
+            data.SizeBytes = tile_pointers_size;
+            data.StreamOffset = offset_to_tile;
 
+            m_layer_pointer->WriteBinary(out);
             return true;
         }
 
-        auto CBglIndirectQmidLayer::WriteBinaryDataPointers(BinaryFileStream& out) -> bool
+        // The tile pointers of the file being written are kept by the layer rather than the store,
+        // so writing a layer that shares its store with others neither copies nor changes it
+        auto CBglDirectQmidLayer::WriteBinaryData(BinaryFileStream& out) -> bool
         {
-            // First write tile pointers (which use relative offsets, so must be at front)
-            for (const auto& tile : m_tiles.write())
+            const auto& store = *m_store;
+            m_written_pointers = store.Pointers;
+            for (auto i = 0; i < static_cast<int>(m_written_pointers.size()); ++i)
             {
-                tile.second.WriteBinary(out, false);
-                if (!out)
+                auto& pointer = m_written_pointers[i];
+                const auto& range = store.Ranges[i];
+
+                pointer.StreamOffset = out.GetPosition();
+                pointer.RecordCount = range.Count;
+
+                auto data_size = 0;
+
+                for (auto j = range.First; j < range.First + range.Count; ++j)
                 {
-                    return false;
+                    const auto& data = store.Records[j];
+                    if (!data->WriteBinary(out))
+                    {
+                        return false;
+                    }
+                    data_size += data->CalculateSize();
                 }
+
+                pointer.SizeBytes = data_size;
             }
+            return true;
+        }
 
-            // Then write the indirect pointers
-            for (auto& pointer : m_pointers.write())
+        auto CBglDirectQmidLayer::WriteBinaryDataPointers(BinaryFileStream& out) -> bool
+        {
+            for (const auto& pointer : m_written_pointers)
             {
-                pointer.WriteBinary(out);
+                pointer.WriteBinary(out, m_layer_pointer->HasQmidHigh);
                 if (!out)
                 {
                     return false;
                 }
             }
+            return true;
+        }
 
-            if (!out)
+        auto CBglDirectQmidLayer::GetTileQmids(std::vector<CPackedQmid>& qmids) const -> void
+        {
+            for (const auto key : m_store->Keys)
             {
-                return false;
+                qmids.emplace_back(key);
             }
-            return true;
         }
 
-        auto CBglIndirectQmidLayer::GetQmidCount() const -> int { return static_cast<int>(m_tiles->size()); }
+        auto CBglDirectQmidLayer::GetQmidCount() const -> int { return static_cast<int>(m_store->Keys.size()); }
 
-        auto CBglIndirectQmidLayer::HasQmid(CPackedQmid qmid) const -> bool
+        auto CBglDirectQmidLayer::HasQmid(CPackedQmid qmid) const -> bool { return m_store->FindTile(qmid) >= 0; }
+
+        auto CBglDirectQmidLayer::QueryRegion(const CQmidQuery& query, int min_level, int max_level,
+            std::vector<CPackedQmid>& qmids) const -> void
         {
-            const auto it = m_tiles->find(qmid);
-            if (it != m_tiles->end())
+            const auto& keys = m_store->Keys;
+            auto tiles = std::vector<int>{};
+            query.Select(keys, min_level, max_level, tiles);
+            for (const auto tile : tiles)
             {
-                return true;
+                qmids.emplace_back(keys[tile]);
             }
-            return false;
         }
 
-        auto CBglIndirectQmidLayer::GetDataPointerAtQmid(CPackedQmid qmid) const -> const SBglTilePointer*
+        auto CBglDirectQmidLayer::GetDataPointerAtIndex(int index) const -> const SBglTilePointer*
         {
-            const auto it = m_tiles->find(qmid);
-            if (it != m_tiles->end())
-            {
-                return &it->second;
-            }
-            return nullptr;
+            return &m_store->Pointers[index];
         }
 
-        auto CBglIndirectQmidLayer::GetDataCountAtQmid(CPackedQmid qmid) const -> int
+        auto CBglDirectQmidLayer::GetDataCountAtQmid(CPackedQmid qmid) -> int
         {
-            const auto it = m_tiles->find(qmid);
-            if (it != m_tiles->end())
+            LoadTile(qmid);
+            const auto tile = m_store->FindTile(qmid);
+            if (tile < 0)
             {
-                return static_cast<int>(it->second.RecordCount);
+                return 0;
             }
-            return 0;
+            return m_store->Ranges[tile].Count;
         }
 
-        auto CBglIndirectQmidLayer::GetIndirectPointerCount() const -> int
+        auto CBglDirectQmidLayer::GetDataAtQmid(CPackedQmid qmid, int index) -> IBglData*
         {
-            return static_cast<int>(m_pointers->size());
+            LoadTile(qmid);
+            // The record may be edited through the pointer
+            auto& store = Detach();
+            const auto tile = store.FindTile(qmid);
+            if (tile < 0 || index < 0 || index >= store.Ranges[tile].Count)
+            {
+                return nullptr;
+            }
+            return store.Records[store.Ranges[tile].First + index].get();
         }
 
-        auto CBglIndirectQmidLayer::GetIndirectPointerAtIndex(int index) const -> const SBglIndirectPointer*
+        auto CBglDirectQmidLayer::GetDataAtQmid(CPackedQmid qmid, int index) const -> const IBglData*
         {
-            return &m_pointers.read()[index];
+            LoadTile(qmid);
+            const auto& store = *m_store;
+            // Another reader of the store may be decoding a tile into the records
+            std::lock_guard<std::mutex> lock(store.PendingMutex);
+            const auto tile = store.FindTile(qmid);
+            if (tile < 0 || index < 0 || index >= store.Ranges[tile].Count)
+            {
+                return nullptr;
+            }
+            return store.Records[store.Ranges[tile].First + index].get();
         }
 
-        auto CBglIndirectQmidLayer::GetIndirectPointerAtQmid(CPackedQmid qmid, int index) const
-            -> const SBglIndirectPointer*
+        auto CBglDirectQmidLayer::AddDataAtQmid(CPackedQmid qmid, const IBglData* data) -> void
         {
-            const auto it = m_tiles->find(qmid);
-            if (it != m_tiles->end())
+            LoadTile(qmid);
+            auto& store = Detach();
+            auto tile = store.FindTile(qmid);
+            if (tile < 0)
             {
-                return &m_pointers.read()[static_cast<int>(it->second.StreamOffset) + index];
+                auto pointer = SBglTilePointer{};
+                pointer.QmidLow = qmid.Low();
+                pointer.QmidHigh = qmid.High();
+                pointer.RecordCount = 1u;
+
+                // Keys stay sorted, so the new tile goes where the search would look for it
+                tile = static_cast<int>(std::distance(
+                    store.Keys.begin(), std::lower_bound(store.Keys.begin(), store.Keys.end(), qmid.Value())));
+                store.Keys.insert(store.Keys.begin() + tile, qmid.Value());
+                store.Pointers.insert(store.Pointers.begin() + tile, pointer);
+                store.Ranges.insert(store.Ranges.begin() + tile, STileRange{static_cast<int>(store.Records.size()), 0});
+                store.Pending.insert(store.Pending.begin() + tile, false);
             }
-            return nullptr;
+            auto records = std::vector<std::unique_ptr<CBglData>>{};
+            records.emplace_back(static_cast<const CBglData*>(data)->Clone());
+            store.InsertRecords(tile, records);
         }
 
-        auto CBglIndirectQmidLayer::GetDataIndexAtQmid(CPackedQmid qmid, int index) const -> int
+        auto CBglDirectQmidLayer::AddDataAtQmids(const SBglQmidData* data, int count) -> bool
         {
-            const auto it = m_tiles->find(qmid);
-            if (it == m_tiles->end())
+            auto records = BglQmidRecords{};
+            records.reserve(count);
+            for (auto i = 0; i < count; ++i)
             {
-                return 0;
+                records.emplace_back(data[i].Qmid, static_cast<const CBglData*>(data[i].Data)->Clone());
             }
-
-            const auto offset = static_cast<int>(it->second.StreamOffset) + index;
-            return m_offsets.read()[offset];
+            return AddDataAtQmids(std::move(records));
         }
 
-        auto CBglIndirectQmidLayer::GetDataCount() const -> int { return static_cast<int>(m_data.size()); }
-
-        auto CBglIndirectQmidLayer::GetDataAtIndex(int index) -> IBglData* { return m_data[index].get(); }
-
-        auto CBglIndirectQmidLayer::AddDataAtQmids(CPackedQmid* qmids, int count, const IBglData* data) -> void
+        // Sorts the new records once and merges them with the tiles in a single pass, where each
+        // AddDataAtQmid shifts the tile arrays and the record runs after it
+        auto CBglDirectQmidLayer::AddDataAtQmids(BglQmidRecords records) -> bool
         {
-            auto offset = static_cast<int>(m_offsets->size());
-            m_data.emplace_back(static_cast<const CBglData*>(data)->Clone());
+            if (records.empty())
+            {
+                return true;
+            }
+            std::stable_sort(records.begin(), records.end(),
+                [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
 
-            for (auto i = 0; i < count; ++i)
+            // Tiles gaining records are decoded first so that their own records stay in front. If one
+            // fails to decode nothing is added, since its records would land behind the new ones
+            for (auto i = 0; i < static_cast<int>(records.size()); ++i)
             {
-                auto& qmid = qmids[i];
-                auto it = m_tiles.write().find(qmid);
-                if (it == m_tiles->end())
+                if ((i == 0 || records[i - 1].first < records[i].first) && !LoadTile(records[i].first))
                 {
-                    m_tiles.write().emplace(qmid, SBglTilePointer{
-                                                      qmid.Low(),
-                                                      0,
-                                                      1,
-                                                      static_cast<uint32_t>(m_pointers->size()),
-                                                      0,
-
-                                                  });
-
-                    const auto size = static_cast<const CBglData*>(data)->CalculateSize();
-                    m_pointers.write().emplace_back(SBglIndirectPointer{0, static_cast<uint32_t>(size)});
-
-                    m_offsets.write().emplace_back(offset);
+                    return false;
+                }
+            }
+            auto& store = Detach();
+
+            auto keys = std::vector<uint64_t>{};
+            auto pointers = std::vector<SBglTilePointer>{};
+            auto ranges = std::vector<STileRange>{};
+            auto pending = std::vector<bool>{};
+            auto tile_records = std::vector<std::unique_ptr<CBglData>>{};
+            const auto capacity = store.Keys.size() + records.size();
+            keys.reserve(capacity);
+            pointers.reserve(capacity);
+            ranges.reserve(capacity);
+            pending.reserve(capacity);
+            tile_records.reserve(store.Records.size() + records.size());
+
+            // Runs are laid out again in tile order, whatever order the edits left them in
+            const auto move_tile = [&store, &tile_records](int tile, STileRange& range)
+            {
+                const auto& old_range = store.Ranges[tile];
+                for (auto i = old_range.First; i < old_range.First + old_range.Count; ++i)
+                {
+                    tile_records.emplace_back(std::move(store.Records[i]));
+                }
+                range.Count += old_range.Count;
+            };
 
+            auto tile = 0;
+            auto next = 0;
+            const auto tile_count = static_cast<int>(store.Keys.size());
+            const auto record_count = static_cast<int>(records.size());
+            while (tile < tile_count || next < record_count)
+            {
+                auto range = STileRange{static_cast<int>(tile_records.size()), 0};
+                if (next == record_count || (tile < tile_count && store.Keys[tile] < records[next].first.Value()))
+                {
+                    move_tile(tile, range);
+                    keys.emplace_back(store.Keys[tile]);
+                    pointers.emplace_back(store.Pointers[tile]);
+                    ranges.emplace_back(range);
+                    pending.emplace_back(store.Pending[tile]);
+                    ++tile;
                     continue;
                 }
 
-                auto& tile_pointer = it->second;
-                const auto index = tile_pointer.StreamOffset + tile_pointer.RecordCount++;
-
-                while (++it != m_tiles->end())
+                const auto qmid = records[next].first;
+                auto pointer = SBglTilePointer{};
+                if (tile < tile_count && store.Keys[tile] == qmid.Value())
                 {
-                    ++it->second.StreamOffset;
+                    pointer = store.Pointers[tile];
+                    move_tile(tile, range);
+                    ++tile;
                 }
+                else
+                {
+                    pointer.QmidLow = qmid.Low();
+                    pointer.QmidHigh = qmid.High();
+                }
+                for (; next < record_count && records[next].first.Value() == qmid.Value(); ++next)
+                {
+                    tile_records.emplace_back(std::move(records[next].second));
+                    ++range.Count;
+                }
+                pointer.RecordCount = static_cast<uint32_t>(range.Count);
 
-                const auto size = static_cast<const CBglData*>(data)->CalculateSize();
-                m_pointers.write().emplace(
-                    m_pointers.write().begin() + index, SBglIndirectPointer{0, static_cast<uint32_t>(size)});
-
-                m_offsets.write().emplace(m_offsets.write().begin() + index, offset);
+                keys.emplace_back(qmid.Value());
+                pointers.emplace_back(pointer);
+                ranges.emplace_back(range);
+                pending.emplace_back(false);
             }
+
+            store.Keys = std::move(keys);
+            store.Pointers = std::move(pointers);
+            store.Ranges = std::move(ranges);
+            store.Pending = std::move(pending);
+            store.Records = std::move(tile_records);
+            return true;
         }
 
-        auto CBglIndirectQmidLayer::RemoveDataAtIndex(int index) -> void
+        auto CBglDirectQmidLayer::RemoveQmid(CPackedQmid qmid) -> void
         {
-            m_data.erase(m_data.begin() + index);
-
-            std::vector<int> offsets;
-
-            for (auto i = 0; i < static_cast<int>(m_offsets->size()); ++i)
+            if (!HasQmid(qmid))
             {
-                if (m_offsets.read()[i] == index)
-                {
-                    offsets.emplace_back(i);
-                }
+                return;
             }
-
-            for (auto offset : offsets)
+            auto& store = Detach();
+            const auto tile = store.FindTile(qmid);
+            store.EraseRecords(tile, 0, store.Ranges[tile].Count);
+            if (store.Pending[tile])
             {
-                m_pointers.write().erase(m_pointers.write().begin() + offset);
-                m_offsets.write().erase(m_offsets.write().begin() + offset);
+                --store.PendingCount;
+            }
+            store.Keys.erase(store.Keys.begin() + tile);
+            store.Pointers.erase(store.Pointers.begin() + tile);
+            store.Ranges.erase(store.Ranges.begin() + tile);
+            store.Pending.erase(store.Pending.begin() + tile);
+        }
 
-                // This is super duper inefficient, but we wouldn't do this often??
-                auto found = false;
-                for (auto it = m_tiles.write().begin(); it != m_tiles.write().end(); /* no increment */)
-                {
-                    if (!found)
+        auto CBglDirectQmidLayer::RemoveDataAtQmid(CPackedQmid qmid, int index) -> void
+        {
+            LoadTile(qmid);
+            if (!HasQmid(qmid))
+            {
+                return;
+            }
+            auto& store = Detach();
+            const auto tile = store.FindTile(qmid);
+            store.EraseRecords(tile, index, 1);
+            if (store.Ranges[tile].Count == 0)
+            {
+                RemoveQmid(qmid);
+            }
+        }
+
+        //******************************************************************************
+        // CBglIndirectQmidLayer
+        //******************************************************************************
+
+        CBglIndirectQmidLayer::CBglIndirectQmidLayer(const SBglLayerPointer& pointer, EBglLayerType type) :
+            CBglLayer(type, EBglLayerClass::IndirectQmid, pointer)
+        {
+        }
+
+        CBglIndirectQmidLayer::CBglIndirectQmidLayer(const CBglIndirectQmidLayer& other) :
+            CBglLayer(other.GetType(), other.GetClass(), *other.GetLayerPointer()), m_keys(other.m_keys),
+            m_tiles(other.m_tiles), m_entries(other.m_entries), m_pointers(other.m_pointers),
+            m_removed(other.m_removed), m_removed_count(other.m_removed_count),
+            m_live_tile_count(other.m_live_tile_count), m_record_rows(other.m_record_rows),
+            m_record_tiles(other.m_record_tiles), m_pending_offsets(other.m_pending_offsets),
+            m_pending_sizes(other.m_pending_sizes), m_stream(other.m_stream)
+        {
+            for (const auto& data : other.m_data)
+            {
+                m_data.emplace_back(data != nullptr ? data->Clone() : nullptr);
+            }
+        }
+
+        auto CBglIndirectQmidLayer::ReadBinary(BinaryFileStream& in) -> bool
+        {
+            std::map<int, int> offsets_and_sizes;
+            if (!ReadIndex(in, offsets_and_sizes))
+            {
+                return false;
+            }
+
+            if (offsets_and_sizes.empty())
+            {
+                return true;
+            }
+
+            // Now read data
+            m_data.resize(offsets_and_sizes.size());
+            in.SetPosition(offsets_and_sizes.begin()->first);
+
+            auto i = 0;
+            for (auto it = offsets_and_sizes.begin(); it != offsets_and_sizes.end(); ++it)
+            {
+                const auto pos = in.GetPosition();
+                if (pos != it->first)
+                {
+                    return false;
+                }
+
+                auto& data = m_data[i++];
+                data = CBglData::Factory(GetType(), IBglSceneryObject::ESceneryObjectType::Unknown);
+                if (data == nullptr)
+                {
+                    continue;
+                }
+
+                data->ReadBinary(in);
+
+                if (!data->Validate() || data->CalculateSize() != it->second)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        auto CBglIndirectQmidLayer::ReadBinaryIndex(const std::shared_ptr<BinaryFileStream>& in) -> bool
+        {
+            std::map<int, int> offsets_and_sizes;
+            if (!ReadIndex(*in, offsets_and_sizes))
+            {
+                return false;
+            }
+
+            m_data.resize(offsets_and_sizes.size());
+            m_pending_offsets.clear();
+            m_pending_offsets.reserve(offsets_and_sizes.size());
+            m_pending_sizes.clear();
+            m_pending_sizes.reserve(offsets_and_sizes.size());
+            for (const auto& offset_and_size : offsets_and_sizes)
+            {
+                m_pending_offsets.emplace_back(offset_and_size.first);
+                m_pending_sizes.emplace_back(offset_and_size.second);
+            }
+            m_stream = in;
+            return true;
+        }
+
+        auto CBglIndirectQmidLayer::Materialize() -> bool
+        {
+            for (auto i = 0; i < static_cast<int>(m_pending_offsets.size()); ++i)
+            {
+                if (!LoadData(i))
+                {
+                    return false;
+                }
+            }
+            m_pending_offsets.clear();
+            m_pending_sizes.clear();
+            m_stream.reset();
+            return true;
+        }
+
+        auto CBglIndirectQmidLayer::GetPendingExtents(std::vector<SBglReadExtent>& extents) const -> void
+        {
+            for (auto i = 0; i < static_cast<int>(m_pending_offsets.size()); ++i)
+            {
+                if (m_pending_offsets[i] >= 0)
+                {
+                    extents.push_back({m_pending_offsets[i], m_pending_sizes[i], i});
+                }
+            }
+        }
+
+        auto CBglIndirectQmidLayer::MaterializeExtent(BinaryFileStream& window, int item) -> bool
+        {
+            const auto offset = m_pending_offsets[item];
+            if (offset < 0)
+            {
+                return true;
+            }
+            auto data = CBglData::Factory(GetType(), IBglSceneryObject::ESceneryObjectType::Unknown);
+            if (data != nullptr)
+            {
+                window.SetPosition(offset);
+                if (!data->ReadBinary(window) || !data->Validate() || data->CalculateSize() != m_pending_sizes[item])
+                {
+                    return false;
+                }
+                m_data[item] = std::move(data);
+            }
+            m_pending_offsets[item] = -1;
+            return true;
+        }
+
+        auto CBglIndirectQmidLayer::ReadIndex(BinaryFileStream& in, std::map<int, int>& offsets_and_sizes) -> bool
+        {
+            const auto* layer_pointer = CBglLayer::GetLayerPointer();
+            in.SetPosition(layer_pointer->StreamOffset);
+
+            const auto qmid_count = static_cast<int>(layer_pointer->TileCount);
+            const auto base_position = in.GetPosition();
+
+            auto file_tiles = std::vector<SBglTilePointer>(qmid_count);
+            auto max_index = 0;
+            for (auto& pointer : file_tiles)
+            {
+                pointer = SBglTilePointer{};
+                pointer.ReadBinary(in, false);
+                if (!in)
+                {
+                    return false;
+                }
+                const auto new_index = static_cast<int>(pointer.StreamOffset + pointer.RecordCount);
+                if (new_index > max_index)
+                {
+                    max_index = new_index;
+                }
+            }
+
+            if (max_index < 0)
+            {
+                return false;
+            }
+
+            auto file_pointers = std::vector<SBglIndirectPointer>(max_index);
+            for (auto& pointer : file_pointers)
+            {
+                pointer.ReadBinary(in);
+                if (!in)
+                {
+                    return false;
+                }
+                offsets_and_sizes[static_cast<int>(pointer.StreamOffset)] = static_cast<int>(pointer.SizeBytes);
+            }
+
+            const auto pos = in.GetPosition();
+            if (pos != base_position + static_cast<int>(layer_pointer->SizeBytes))
+            {
+                return false;
+            }
+
+            // Records are read in the order of their offsets, so that order numbers them
+            auto record_indices = std::map<int, int>{};
+            for (const auto& offset_and_size : offsets_and_sizes)
+            {
+                record_indices.emplace(offset_and_size.first, static_cast<int>(record_indices.size()));
+            }
+
+            // Rows are laid out in QMID order whatever the order of the file, and repeated QMIDs share one
+            std::stable_sort(file_tiles.begin(), file_tiles.end(),
+                [](const SBglTilePointer& lhs, const SBglTilePointer& rhs) { return lhs.QmidLow < rhs.QmidLow; });
+
+            auto& keys = m_keys.write();
+            auto& tiles = m_tiles.write();
+            auto& entries = m_entries.write();
+            auto& pointers = m_pointers.write();
+            keys.clear();
+            tiles.clear();
+            entries.clear();
+            pointers.clear();
+            entries.reserve(file_pointers.size());
+            pointers.reserve(file_pointers.size());
+            for (const auto& file_tile : file_tiles)
+            {
+                if (file_tile.RecordCount == 0)
+                {
+                    continue;
+                }
+                const auto key = CPackedQmid{file_tile.QmidLow, 0}.Value();
+                if (keys.empty() || keys.back() != key)
+                {
+                    auto tile = file_tile;
+                    tile.StreamOffset = static_cast<uint32_t>(entries.size());
+                    tile.RecordCount = 0;
+                    keys.emplace_back(key);
+                    tiles.emplace_back(tile);
+                }
+                for (auto i = file_tile.StreamOffset; i < file_tile.StreamOffset + file_tile.RecordCount; ++i)
+                {
+                    const auto& pointer = file_pointers[i];
+                    entries.emplace_back(static_cast<uint32_t>(record_indices[static_cast<int>(pointer.StreamOffset)]));
+                    pointers.emplace_back(pointer);
+                    ++tiles.back().RecordCount;
+                }
+            }
+
+            m_removed.assign(offsets_and_sizes.size(), false);
+            m_removed_count = 0;
+            m_live_tile_count = static_cast<int>(tiles.size());
+            m_record_rows.clear();
+            m_record_tiles.clear();
+            return true;
+        }
+
+        auto CBglIndirectQmidLayer::LoadData(int index) -> bool
+        {
+            if (index >= static_cast<int>(m_pending_offsets.size()) || m_pending_offsets[index] < 0)
+            {
+                return true;
+            }
+            if (m_stream == nullptr || !m_stream->IsOpen())
+            {
+                return false;
+            }
+
+            // The record stays pending if it cannot be decoded, so a later call can retry it
+            auto data = CBglData::Factory(GetType(), IBglSceneryObject::ESceneryObjectType::Unknown);
+            if (data != nullptr)
+            {
+                const CStreamPositionGuard restore(*m_stream);
+                m_stream->SetPosition(m_pending_offsets[index]);
+                if (!data->ReadBinary(*m_stream) || !data->Validate() ||
+                    data->CalculateSize() != m_pending_sizes[index])
+                {
+                    return false;
+                }
+                m_data[index] = std::move(data);
+            }
+            m_pending_offsets[index] = -1;
+            return true;
+        }
+
+        auto CBglIndirectQmidLayer::CalculateSize() const -> int
+        {
+            auto data_size = 0;
+            for (const auto& data : m_data)
+            {
+                if (data != nullptr)
+                {
+                    data_size += data->CalculateSize();
+                }
+            }
+
+            return data_size;
+        }
+
+        auto CBglIndirectQmidLayer::CalculateDataPointersSize() const -> int
+        {
+            // Only live entries and tiles are written
+            auto entry_count = 0;
+            for (const auto& tile : *m_tiles)
+            {
+                entry_count += static_cast<int>(tile.RecordCount);
+            }
+            return static_cast<int>(sizeof(SBglIndirectPointer)) * entry_count +
+                   16 * m_live_tile_count; // TODO Constant
+        }
+
+        auto CBglIndirectQmidLayer::WriteBinaryPointer(BinaryFileStream& out, int offset_to_tile, int offset_to_layer)
+            -> bool
+        {
+            auto& data = m_layer_pointer.write();
+            data.Type = GetType();
+            data.TileCount = GetQmidCount();
+            data.DataClass = static_cast<std::underlying_type<EBglLayerType>::type>(EBglLayerClass::IndirectQmid);
+            data.HasQmidHigh = 0;
+            data.SizeBytes = CalculateDataPointersSize();
+            data.StreamOffset = offset_to_tile;
+
+            m_layer_pointer->WriteBinary(out);
+            return true;
+        }
+
+        auto CBglIndirectQmidLayer::WriteBinaryData(BinaryFileStream& out) -> bool
+        {
+            // First recalculate indirect pointers to data. Records are written in index order
+            // from here, skipping removed ones
+            auto position = out.GetPosition();
+            std::vector<SBglIndirectPointer> record_pointers(m_data.size(), SBglIndirectPointer{0, 0});
+            for (auto i = 0; i < static_cast<int>(m_data.size()); ++i)
+            {
+                if (m_data[i] != nullptr)
+                {
+                    const auto data_size = m_data[i]->CalculateSize();
+                    record_pointers[i] = SBglIndirectPointer{
+                        static_cast<uint32_t>(position), static_cast<uint32_t>(data_size)};
+                    position += data_size;
+                }
+            }
+
+            const auto& entries = m_entries.read();
+            auto& pointers = m_pointers.write();
+            for (const auto& tile : *m_tiles)
+            {
+                for (auto i = tile.StreamOffset; i < tile.StreamOffset + tile.RecordCount; ++i)
+                {
+                    pointers[i] = record_pointers[entries[i]];
+                }
+            }
+
+            // Then write the data
+            for (const auto& data : m_data)
+            {
+                if (data != nullptr && !data->WriteBinary(out))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        auto CBglIndirectQmidLayer::WriteBinaryDataPointers(BinaryFileStream& out) -> bool
+        {
+            // First write tile pointers (which use relative offsets, so must be at front). Free
+            // slots are left out, so the rows are numbered as they are written
+            auto first_entry = 0u;
+            for (const auto& tile : *m_tiles)
+            {
+                if (tile.RecordCount == 0)
+                {
+                    continue;
+                }
+                auto pointer = tile;
+                pointer.StreamOffset = first_entry;
+                pointer.WriteBinary(out, false);
+                if (!out)
+                {
+                    return false;
+                }
+                first_entry += tile.RecordCount;
+            }
+
+            // Then write the indirect pointers
+            const auto& pointers = m_pointers.read();
+            for (const auto& tile : *m_tiles)
+            {
+                for (auto i = tile.StreamOffset; i < tile.StreamOffset + tile.RecordCount; ++i)
+                {
+                    pointers[i].WriteBinary(out);
+                    if (!out)
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            if (!out)
+            {
+                return false;
+            }
+            return true;
+        }
+
+        auto CBglIndirectQmidLayer::GetTileQmids(std::vector<CPackedQmid>& qmids) const -> void
+        {
+            const auto& keys = m_keys.read();
+            const auto& tiles = m_tiles.read();
+            for (auto i = 0; i < static_cast<int>(keys.size()); ++i)
+            {
+                if (tiles[i].RecordCount > 0)
+                {
+                    qmids.emplace_back(keys[i]);
+                }
+            }
+        }
+
+        auto CBglIndirectQmidLayer::QueryRegion(const CQmidQuery& query, int min_level, int max_level,
+            std::vector<CPackedQmid>& qmids) const -> void
+        {
+            const auto& keys = m_keys.read();
+            const auto& tiles = m_tiles.read();
+            auto found = std::vector<int>{};
+            query.Select(keys, min_level, max_level, found);
+            for (const auto tile : found)
+            {
+                if (tiles[tile].RecordCount > 0)
+                {
+                    qmids.emplace_back(keys[tile]);
+                }
+            }
+        }
+
+        auto CBglIndirectQmidLayer::FindTile(CPackedQmid qmid) const -> int
+        {
+            const auto& keys = m_keys.read();
+            const auto it = std::lower_bound(keys.begin(), keys.end(), qmid.Value());
+            if (it == keys.end() || *it != qmid.Value())
+            {
+                return -1;
+            }
+            return static_cast<int>(it - keys.begin());
+        }
+
+        auto CBglIndirectQmidLayer::GetQmidCount() const -> int { return m_live_tile_count; }
+
+        auto CBglIndirectQmidLayer::HasQmid(CPackedQmid qmid) const -> bool
+        {
+            const auto tile = FindTile(qmid);
+            return tile >= 0 && m_tiles.read()[tile].RecordCount > 0;
+        }
+
+        auto CBglIndirectQmidLayer::GetDataPointerAtQmid(CPackedQmid qmid) const -> const SBglTilePointer*
+        {
+            const auto tile = FindTile(qmid);
+            if (tile >= 0 && m_tiles.read()[tile].RecordCount > 0)
+            {
+                return &m_tiles.read()[tile];
+            }
+            return nullptr;
+        }
+
+        auto CBglIndirectQmidLayer::GetDataCountAtQmid(CPackedQmid qmid) const -> int
+        {
+            const auto tile = FindTile(qmid);
+            if (tile >= 0)
+            {
+                return static_cast<int>(m_tiles.read()[tile].RecordCount);
+            }
+            return 0;
+        }
+
+        auto CBglIndirectQmidLayer::GetIndirectPointerCount() const -> int
+        {
+            return static_cast<int>(m_pointers->size());
+        }
+
+        auto CBglIndirectQmidLayer::GetIndirectPointerAtIndex(int index) const -> const SBglIndirectPointer*
+        {
+            return &m_pointers.read()[index];
+        }
+
+        auto CBglIndirectQmidLayer::GetIndirectPointerAtQmid(CPackedQmid qmid, int index) const
+            -> const SBglIndirectPointer*
+        {
+            const auto tile = FindTile(qmid);
+            if (tile >= 0)
+            {
+                return &m_pointers.read()[m_tiles.read()[tile].StreamOffset + index];
+            }
+            return nullptr;
+        }
+
+        auto CBglIndirectQmidLayer::GetDataIndexAtQmid(CPackedQmid qmid, int index) const -> int
+        {
+            const auto tile = FindTile(qmid);
+            if (tile < 0)
+            {
+                return 0;
+            }
+            return static_cast<int>(m_entries.read()[m_tiles.read()[tile].StreamOffset + index]);
+        }
+
+        auto CBglIndirectQmidLayer::GetDataCount() const -> int { return static_cast<int>(m_data.size()); }
+
+        auto CBglIndirectQmidLayer::GetDataAtIndex(int index) -> IBglData*
+        {
+            if (!LoadData(index))
+            {
+                return nullptr;
+            }
+            return m_data[index].get();
+        }
+
+        auto CBglIndirectQmidLayer::AddDataAtQmids(CPackedQmid* qmids, int count, const IBglData* data) -> void
+        {
+            const auto index = static_cast<int>(m_data.size());
+            m_data.emplace_back(static_cast<const CBglData*>(data)->Clone());
+
+            auto entries = std::vector<std::pair<CPackedQmid, int>>{};
+            entries.reserve(count);
+            for (auto i = 0; i < count; ++i)
+            {
+                entries.emplace_back(qmids[i], index);
+            }
+            AddTileEntries(entries);
+        }
+
+        auto CBglIndirectQmidLayer::AddDataAtQmids(const SBglQmidData* data, int count) -> void
+        {
+            // Each distinct record is cloned once, however many tiles list it
+            auto indices = std::unordered_map<const IBglData*, int>{};
+            auto entries = std::vector<std::pair<CPackedQmid, int>>{};
+            entries.reserve(count);
+            for (auto i = 0; i < count; ++i)
+            {
+                auto it = indices.find(data[i].Data);
+                if (it == indices.end())
+                {
+                    it = indices.emplace(data[i].Data, static_cast<int>(m_data.size())).first;
+                    m_data.emplace_back(static_cast<const CBglData*>(data[i].Data)->Clone());
+                }
+                entries.emplace_back(data[i].Qmid, it->second);
+            }
+            AddTileEntries(entries);
+        }
+
+        auto CBglIndirectQmidLayer::AddDataAtQmids(BglQmidRecords records) -> void
+        {
+            auto entries = std::vector<std::pair<CPackedQmid, int>>{};
+            entries.reserve(records.size());
+            m_data.reserve(m_data.size() + records.size());
+            for (auto& record : records)
+            {
+                entries.emplace_back(record.first, static_cast<int>(m_data.size()));
+                m_data.emplace_back(std::move(record.second));
+            }
+            AddTileEntries(entries);
+        }
+
+        // Rebuilds the tile rows and the entry slots in one pass over the existing tiles
+        // and the sorted entries. Entries of a tile follow those it already lists
+        auto CBglIndirectQmidLayer::AddTileEntries(std::vector<std::pair<CPackedQmid, int>>& entries) -> void
+        {
+            m_removed.resize(m_data.size(), false);
+            if (!m_pending_offsets.empty())
+            {
+                m_pending_offsets.resize(m_data.size(), -1);
+                m_pending_sizes.resize(m_data.size(), 0);
+            }
+            if (entries.empty())
+            {
+                return;
+            }
+            std::stable_sort(entries.begin(), entries.end(),
+                [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+            const auto& old_keys = m_keys.read();
+            const auto& old_tiles = m_tiles.read();
+            const auto& old_entries = m_entries.read();
+            const auto& old_pointers = m_pointers.read();
+            auto keys = std::vector<uint64_t>{};
+            auto tiles = std::vector<SBglTilePointer>{};
+            auto tile_entries = std::vector<uint32_t>{};
+            auto pointers = std::vector<SBglIndirectPointer>{};
+            keys.reserve(old_keys.size() + entries.size());
+            tiles.reserve(old_keys.size() + entries.size());
+            tile_entries.reserve(old_entries.size() + entries.size());
+            pointers.reserve(old_pointers.size() + entries.size());
+
+            // Only the live entries are carried over, so this also drops the free slots
+            const auto copy_tile = [&](int tile)
+            {
+                const auto& pointer = old_tiles[tile];
+                for (auto i = pointer.StreamOffset; i < pointer.StreamOffset + pointer.RecordCount; ++i)
+                {
+                    tile_entries.emplace_back(old_entries[i]);
+                    pointers.emplace_back(old_pointers[i]);
+                }
+            };
+
+            auto tile = 0;
+            auto next = size_t{0};
+            const auto tile_count = static_cast<int>(old_keys.size());
+            while (tile < tile_count || next < entries.size())
+            {
+                const auto first = static_cast<uint32_t>(tile_entries.size());
+                if (next == entries.size() || (tile < tile_count && old_keys[tile] < entries[next].first.Value()))
+                {
+                    if (old_tiles[tile].RecordCount > 0)
                     {
-                        const auto record_offset = static_cast<int>(it->second.StreamOffset);
-                        const auto record_count = static_cast<int>(it->second.RecordCount);
+                        auto pointer = old_tiles[tile];
+                        pointer.StreamOffset = first;
+                        copy_tile(tile);
+                        keys.emplace_back(old_keys[tile]);
+                        tiles.emplace_back(pointer);
+                    }
+                    ++tile;
+                    continue;
+                }
+
+                const auto qmid = entries[next].first;
+                auto pointer = SBglTilePointer{qmid.Low(), 0, 0, first, 0};
+                if (tile < tile_count && old_keys[tile] == qmid.Value())
+                {
+                    pointer = old_tiles[tile];
+                    pointer.StreamOffset = first;
+                    copy_tile(tile);
+                    ++tile;
+                }
+                for (; next < entries.size() && entries[next].first.Value() == qmid.Value(); ++next)
+                {
+                    const auto index = entries[next].second;
+                    const auto size = m_data[index]->CalculateSize();
+                    tile_entries.emplace_back(static_cast<uint32_t>(index));
+                    pointers.emplace_back(SBglIndirectPointer{0, static_cast<uint32_t>(size)});
+                }
+                pointer.RecordCount = static_cast<uint32_t>(tile_entries.size()) - first;
+                keys.emplace_back(qmid.Value());
+                tiles.emplace_back(pointer);
+            }
+
+            m_live_tile_count = static_cast<int>(tiles.size());
+            m_keys = std::move(keys);
+            m_tiles = std::move(tiles);
+            m_entries = std::move(tile_entries);
+            m_pointers = std::move(pointers);
+            m_record_rows.clear();
+            m_record_tiles.clear();
+        }
+
+        auto CBglIndirectQmidLayer::BuildRecordTiles() -> void
+        {
+            const auto& tiles = m_tiles.read();
+            const auto& entries = m_entries.read();
+            m_record_rows.assign(m_data.size() + 1, 0);
+            for (const auto& tile : tiles)
+            {
+                for (auto i = tile.StreamOffset; i < tile.StreamOffset + tile.RecordCount; ++i)
+                {
+                    ++m_record_rows[entries[i] + 1];
+                }
+            }
+            for (auto i = size_t{1}; i < m_record_rows.size(); ++i)
+            {
+                m_record_rows[i] += m_record_rows[i - 1];
+            }
+            m_record_tiles.resize(m_record_rows.back());
+            auto next = std::vector<uint32_t>(m_record_rows.begin(), m_record_rows.end() - 1);
+            for (auto tile = 0; tile < static_cast<int>(tiles.size()); ++tile)
+            {
+                const auto& pointer = tiles[tile];
+                for (auto i = pointer.StreamOffset; i < pointer.StreamOffset + pointer.RecordCount; ++i)
+                {
+                    m_record_tiles[next[entries[i]]++] = static_cast<uint32_t>(tile);
+                }
+            }
+        }
+
+        // The record becomes a tombstone, so no other index changes. Its entries are taken out of the
+        // tiles that list it, found through the record to tile rows rather than a scan of every tile
+        auto CBglIndirectQmidLayer::RemoveDataAtIndex(int index) -> void
+        {
+            if (index < 0 || index >= static_cast<int>(m_data.size()) || m_removed[index])
+            {
+                return;
+            }
+            if (m_record_rows.size() != m_data.size() + 1)
+            {
+                BuildRecordTiles();
+            }
+
+            auto& tiles = m_tiles.write();
+            auto& entries = m_entries.write();
+            auto& pointers = m_pointers.write();
+            for (auto i = m_record_rows[index]; i < m_record_rows[index + 1]; ++i)
+            {
+                auto& tile = tiles[m_record_tiles[i]];
+                const auto first = tile.StreamOffset;
+                auto last = first;
+                // Entries after a removed one move up, keeping their order, and free slots gather at the end
+                for (auto j = first; j < first + tile.RecordCount; ++j)
+                {
+                    if (entries[j] != static_cast<uint32_t>(index))
+                    {
+                        entries[last] = entries[j];
+                        pointers[last] = pointers[j];
+                        ++last;
+                    }
+                }
+                if (last == first + tile.RecordCount)
+                {
+                    continue;
+                }
+                std::fill(entries.begin() + last, entries.begin() + first + tile.RecordCount, s_free_entry);
+                tile.RecordCount = last - first;
+                if (tile.RecordCount == 0)
+                {
+                    --m_live_tile_count;
+                }
+            }
+
+            m_data[index].reset();
+            m_removed[index] = true;
+            ++m_removed_count;
+            if (index < static_cast<int>(m_pending_offsets.size()))
+            {
+                m_pending_offsets[index] = -1;
+            }
+        }
+
+        auto CBglIndirectQmidLayer::Compact() -> void
+        {
+            // Indices of the records that are kept, in their current order
+            auto indices = std::vector<uint32_t>(m_data.size(), s_free_entry);
+            auto count = 0u;
+            for (auto i = 0; i < static_cast<int>(m_data.size()); ++i)
+            {
+                if (!m_removed[i])
+                {
+                    indices[i] = count;
+                    if (static_cast<int>(count) != i)
+                    {
+                        m_data[count] = std::move(m_data[i]);
+                        if (!m_pending_offsets.empty())
+                        {
+                            m_pending_offsets[count] = m_pending_offsets[i];
+                            m_pending_sizes[count] = m_pending_sizes[i];
+                        }
+                    }
+                    ++count;
+                }
+            }
+            m_data.resize(count);
+            if (!m_pending_offsets.empty())
+            {
+                m_pending_offsets.resize(count);
+                m_pending_sizes.resize(count);
+            }
+            m_removed.assign(count, false);
+            m_removed_count = 0;
+
+            const auto& old_keys = m_keys.read();
+            const auto& old_tiles = m_tiles.read();
+            const auto& old_entries = m_entries.read();
+            const auto& old_pointers = m_pointers.read();
+            auto keys = std::vector<uint64_t>{};
+            auto tiles = std::vector<SBglTilePointer>{};
+            auto entries = std::vector<uint32_t>{};
+            auto pointers = std::vector<SBglIndirectPointer>{};
+            keys.reserve(m_live_tile_count);
+            tiles.reserve(m_live_tile_count);
+            for (auto tile = 0; tile < static_cast<int>(old_keys.size()); ++tile)
+            {
+                auto pointer = old_tiles[tile];
+                if (pointer.RecordCount == 0)
+                {
+                    continue;
+                }
+                for (auto i = pointer.StreamOffset; i < pointer.StreamOffset + pointer.RecordCount; ++i)
+                {
+                    entries.emplace_back(indices[old_entries[i]]);
+                    pointers.emplace_back(old_pointers[i]);
+                }
+                pointer.StreamOffset = static_cast<uint32_t>(entries.size()) - pointer.RecordCount;
+                keys.emplace_back(old_keys[tile]);
+                tiles.emplace_back(pointer);
+            }
+
+            m_keys = std::move(keys);
+            m_tiles = std::move(tiles);
+            m_entries = std::move(entries);
+            m_pointers = std::move(pointers);
+            m_record_rows.clear();
+            m_record_tiles.clear();
+        }
+
+        auto CBglDirectQmidLayer::GetSceneryObjectType(BinaryFileStream& in) -> IBglSceneryObject::ESceneryObjectType
+        {
+            const auto pos = in.GetPosition();
+            auto child_type = uint16_t{};
+            auto child_size = uint16_t{};
+            in >> child_type;
+            in >> child_size;
+            in.SetPosition(pos);
+
+            return static_cast<IBglSceneryObject::ESceneryObjectType>(child_type);
+        }
+
+        //******************************************************************************
+        // CBglGuidLayer
+        //******************************************************************************
+
+        CBglGuidLayer::CBglGuidLayer(const SBglLayerPointer& pointer, EBglLayerType type) :
+            CBglLayer(type, EBglLayerClass::GuidIndex, pointer)
+        {
+        }
+
+        CBglGuidLayer::CBglGuidLayer(const CBglGuidLayer& other) :
+            CBglLayer(other.GetType(), other.GetClass(), *other.GetLayerPointer()), m_pointer(other.m_pointer),
+            m_offsets(other.m_offsets), m_guids(other.m_guids), m_pending_offsets(other.m_pending_offsets),
+            m_stream(other.m_stream)
+        {
+            for (const auto& data : other.m_data)
+            {
+                m_data.emplace_back(data->Clone());
+            }
+        }
+
+        auto CBglGuidLayer::ReadBinary(BinaryFileStream& in) -> bool
+        {
+            if (!ReadIndex(in))
+            {
+                return false;
+            }
+
+            const auto pos = static_cast<int>(m_pointer->StreamOffset);
+            const auto count = static_cast<int>(m_pointer->RecordCount);
+            for (auto i = 0; i < count; ++i)
+            {
+                const auto& guid_pointer = m_guids.read()[i];
+                auto& data = m_data[i];
+
+                data = CBglData::Factory(GetType(), IBglSceneryObject::ESceneryObjectType::Unknown);
+                if (data == nullptr)
+                {
+                    continue;
+                }
+
+                in.SetPosition(pos + static_cast<int>(guid_pointer.StreamOffset));
+                data->ReadBinary(in);
 
-                        if (record_offset >= offset && record_offset + record_count < offset)
-                        {
-                            found = true;
-                            if (--it->second.RecordCount == 0)
-                            {
-                                it = m_tiles.write().erase(it);
-                                continue;
-                            }
-                        }
-                    }
-                    else
-                    {
-                        --it->second.RecordCount;
-                    }
-                    ++it;
+                if (!data->Validate())
+                {
+                    return false;
                 }
             }
+
+            if (!in)
+            {
+                return false;
+            }
+
+            return true;
         }
 
-        auto CBglDirectQmidLayer::GetSceneryObjectType(BinaryFileStream& in) -> IBglSceneryObject::ESceneryObjectType
+        auto CBglGuidLayer::ReadBinaryIndex(const std::shared_ptr<BinaryFileStream>& in) -> bool
         {
-            const auto pos = in.GetPosition();
-            auto child_type = uint16_t{};
-            auto child_size = uint16_t{};
-            in >> child_type;
-            in >> child_size;
-            in.SetPosition(pos);
+            if (!ReadIndex(*in))
+            {
+                return false;
+            }
 
-            return static_cast<IBglSceneryObject::ESceneryObjectType>(child_type);
+            const auto pos = static_cast<int>(m_pointer->StreamOffset);
+            m_pending_offsets.clear();
+            m_pending_offsets.reserve(m_guids->size());
+            for (const auto& guid_pointer : m_guids.read())
+            {
+                m_pending_offsets.emplace_back(pos + static_cast<int>(guid_pointer.StreamOffset));
+            }
+            m_stream = in;
+            return true;
         }
 
-        //******************************************************************************
-        // CBglGuidLayer
-        //******************************************************************************
+        auto CBglGuidLayer::Materialize() -> bool
+        {
+            for (auto i = 0; i < static_cast<int>(m_pending_offsets.size()); ++i)
+            {
+                if (!LoadData(i))
+                {
+                    return false;
+                }
+            }
+            m_pending_offsets.clear();
+            m_stream.reset();
+            return true;
+        }
 
-        CBglGuidLayer::CBglGuidLayer(const SBglLayerPointer& pointer, EBglLayerType type) :
-            CBglLayer(type, EBglLayerClass::GuidIndex, pointer)
+        auto CBglGuidLayer::GetPendingExtents(std::vector<SBglReadExtent>& extents) const -> void
         {
+            // Records carry no size in the index, so each one is bounded by the next record.
+            // The last one has no bound and is left for Materialize
+            std::vector<int> sorted_offsets;
+            sorted_offsets.reserve(m_pending_offsets.size());
+            for (const auto offset : m_pending_offsets)
+            {
+                if (offset >= 0)
+                {
+                    sorted_offsets.emplace_back(offset);
+                }
+            }
+            std::sort(sorted_offsets.begin(), sorted_offsets.end());
+
+            for (auto i = 0; i < static_cast<int>(m_pending_offsets.size()); ++i)
+            {
+                const auto offset = m_pending_offsets[i];
+                const auto next = std::upper_bound(sorted_offsets.begin(), sorted_offsets.end(), offset);
+                if (offset >= 0 && next != sorted_offsets.end())
+                {
+                    extents.push_back({offset, *next - offset, i});
+                }
+            }
         }
 
-        CBglGuidLayer::CBglGuidLayer(const CBglGuidLayer& other) :
-            CBglLayer(other.GetType(), other.GetClass(), *other.GetLayerPointer()), m_pointer(other.m_pointer),
-            m_offsets(other.m_offsets), m_guids(other.m_guids)
+        auto CBglGuidLayer::MaterializeExtent(BinaryFileStream& window, int item) -> bool
         {
-            for (const auto& data : other.m_data)
+            const auto offset = m_pending_offsets[item];
+            if (offset < 0)
             {
-                m_data.emplace_back(data->Clone());
+                return true;
+            }
+            auto data = CBglData::Factory(GetType(), IBglSceneryObject::ESceneryObjectType::Unknown);
+            if (data != nullptr)
+            {
+                window.SetPosition(offset);
+                if (!data->ReadBinary(window) || !data->Validate())
+                {
+                    return false;
+                }
+                m_data[item] = std::move(data);
             }
+            m_pending_offsets[item] = -1;
+            return true;
         }
 
-        auto CBglGuidLayer::ReadBinary(BinaryFileStream& in) -> bool
+        auto CBglGuidLayer::ReadIndex(BinaryFileStream& in) -> bool
         {
             assert(m_data.empty());
 
@@ -1500,8 +2558,6 @@ namespace flightsimlib
                 return false;
             }
 
-            const auto pos = in.GetPosition();
-
             const auto count = static_cast<int>(m_pointer->RecordCount);
             m_guids.write().resize(count);
             m_data.resize(count);
@@ -1519,31 +2575,33 @@ namespace flightsimlib
                 return false;
             }
 
-            for (auto i = 0; i < count; ++i)
-            {
-                const auto& guid_pointer = m_guids.read()[i];
-                auto& data = m_data[i];
-
-                data = CBglData::Factory(GetType(), IBglSceneryObject::ESceneryObjectType::Unknown);
-                if (data == nullptr)
-                {
-                    continue;
-                }
-
-                in.SetPosition(pos + static_cast<int>(guid_pointer.StreamOffset));
-                data->ReadBinary(in);
+            return true;
+        }
 
-                if (!data->Validate())
-                {
-                    return false;
-                }
+        auto CBglGuidLayer::LoadData(int index) const -> bool
+        {
+            if (index >= static_cast<int>(m_pending_offsets.size()) || m_pending_offsets[index] < 0)
+            {
+                return true;
             }
-
-            if (!in)
+            if (m_stream == nullptr || !m_stream->IsOpen())
             {
                 return false;
             }
 
+            // The record stays pending if it cannot be decoded, so a later call can retry it
+            auto data = CBglData::Factory(GetType(), IBglSceneryObject::ESceneryObjectType::Unknown);
+            if (data != nullptr)
+            {
+                const CStreamPositionGuard restore(*m_stream);
+                m_stream->SetPosition(m_pending_offsets[index]);
+                if (!data->ReadBinary(*m_stream) || !data->Validate())
+                {
+                    return false;
+                }
+                m_data[index] = std::move(data);
+            }
+            m_pending_offsets[index] = -1;
             return true;
         }
 
@@ -1654,7 +2712,7 @@ namespace flightsimlib
         {
             // TODO - need a non-const version
             const auto it = m_offsets.find(guid);
-            if (it != m_offsets.end())
+            if (it != m_offsets.end() && LoadData(it->second))
             {
                 return m_data[it->second].get();
             }
@@ -1670,6 +2728,10 @@ namespace flightsimlib
                 m_offsets[guid] = offset;
                 m_guids.write().emplace_back(SBglGuidPointer{guid, 0, 0});
                 m_data.emplace_back(static_cast<const CBglData*>(data)->Clone());
+                if (!m_pending_offsets.empty())
+                {
+                    m_pending_offsets.emplace_back(-1);
+                }
                 ++m_pointer.write().RecordCount;
             }
         }
@@ -1681,6 +2743,10 @@ namespace flightsimlib
             {
                 m_guids.write().erase(m_guids->begin() + it->second);
                 m_data.erase(m_data.begin() + it->second);
+                if (it->second < static_cast<int>(m_pending_offsets.size()))
+                {
+                    m_pending_offsets.erase(m_pending_offsets.begin() + it->second);
+                }
                 m_offsets.erase(it);
                 --m_pointer.write().RecordCount;
             }
@@ -1812,6 +2878,11 @@ namespace flightsimlib
 
         auto CBglExclusionLayer::GetExclusionAt(int index) -> IBglExclusion* { return &m_exclusions.write()[index]; }
 
+        auto CBglExclusionLayer::GetExclusionAt(int index) const -> const IBglExclusion*
+        {
+            return &m_exclusions.read()[index];
+        }
+
         auto CBglExclusionLayer::AddExclusion(const IBglExclusion* exclusion) -> void
         {
             m_exclusions.write().emplace_back(*static_cast<const CBglExclusion*>(exclusion));
@@ -1954,6 +3025,11 @@ namespace flightsimlib
 
         auto CBglTimeZoneLayer::GetTimeZoneAt(int index) -> IBglTimeZone* { return &m_timezones.write()[index]; }
 
+        auto CBglTimeZoneLayer::GetTimeZoneAt(int index) const -> const IBglTimeZone*
+        {
+            return &m_timezones.read()[index];
+        }
+
         auto CBglTimeZoneLayer::AddTimeZone(const IBglTimeZone* timezone) -> void
         {
             m_timezones.write().emplace_back(*static_cast<const CBglTimeZone*>(timezone));
@@ -1967,6 +3043,109 @@ namespace flightsimlib
             m_timezones.write().erase(iter);
         }
 
+        //******************************************************************************
+        // CBglReadPlanner
+        //******************************************************************************
+
+        CBglReadPlanner::CBglReadPlanner(int merge_gap, int max_read) : m_merge_gap(merge_gap), m_max_read(max_read) { }
+
+        auto CBglReadPlanner::AddLayer(CBglLayer& layer) -> void
+        {
+            std::vector<SBglReadExtent> extents;
+            layer.GetPendingExtents(extents);
+            m_extents.reserve(m_extents.size() + extents.size());
+            for (const auto& extent : extents)
+            {
+                AddExtent(layer, extent);
+            }
+        }
+
+        auto CBglReadPlanner::AddExtent(CBglLayer& layer, const SBglReadExtent& extent) -> void
+        {
+            m_extents.push_back({extent, &layer});
+        }
+
+        auto CBglReadPlanner::Execute(const IPositionalStream& source,
+            const std::shared_ptr<const IPositionalStream>& payload_source,
+            const std::shared_ptr<CStringPool>& string_pool) -> bool
+        {
+            const auto file_length = source.GetLength();
+            const auto end = std::remove_if(m_extents.begin(), m_extents.end(),
+                [file_length](const SPlannedExtent& planned)
+                {
+                    const auto& extent = planned.Extent;
+                    return extent.Offset < 0 || extent.Size <= 0 || extent.Size > file_length - extent.Offset;
+                });
+            m_statistics.FallbackCount += static_cast<int>(std::distance(end, m_extents.end()));
+            m_extents.erase(end, m_extents.end());
+
+            std::stable_sort(m_extents.begin(), m_extents.end(),
+                [](const SPlannedExtent& lhs, const SPlannedExtent& rhs)
+                { return lhs.Extent.Offset < rhs.Extent.Offset; });
+
+            std::vector<uint8_t> buffer;
+            auto window = BinaryFileStream{};
+            window.SetStringPool(string_pool);
+            const auto count = static_cast<int>(m_extents.size());
+            auto first = 0;
+            while (first < count)
+            {
+                // Grow the range while the next extent starts within the gap and the read stays bounded
+                const auto range_begin = m_extents[first].Extent.Offset;
+                auto range_end = range_begin + m_extents[first].Extent.Size;
+                auto last = first + 1;
+                while (last < count)
+                {
+                    const auto& extent = m_extents[last].Extent;
+                    const auto extent_end = std::max(range_end, extent.Offset + extent.Size);
+                    if (extent.Offset > range_end + m_merge_gap || extent_end - range_begin > m_max_read)
+                    {
+                        break;
+                    }
+                    range_end = extent_end;
+                    ++last;
+                }
+
+                const auto range_size = range_end - range_begin;
+                auto view = source.GetView(range_begin, range_size);
+                if (view.Empty())
+                {
+                    buffer.resize(static_cast<size_t>(range_size));
+                    if (!source.ReadAt(range_begin, buffer.data(), range_size))
+                    {
+                        return false;
+                    }
+                    view = SByteSpan{buffer.data(), range_size};
+                    ++m_statistics.ReadCount;
+                    m_statistics.BytesRead += range_size;
+                }
+
+                auto open_window = true;
+                for (auto i = first; i < last; ++i)
+                {
+                    // A failed decode latches the window, so start a fresh one
+                    if (open_window)
+                    {
+                        window.OpenView(view.Data, view.Length, range_begin);
+                        window.SetPayloadSource(payload_source);
+                        open_window = false;
+                    }
+                    const auto& planned = m_extents[i];
+                    ++m_statistics.RecordCount;
+                    m_statistics.BytesRequested += planned.Extent.Size;
+                    if (!planned.Layer->MaterializeExtent(window, planned.Extent.Item))
+                    {
+                        ++m_statistics.FallbackCount;
+                        open_window = true;
+                    }
+                }
+                first = last;
+            }
+
+            m_extents.clear();
+            return true;
+        }
+
         //******************************************************************************
         // CBglFile
         //******************************************************************************
@@ -1974,8 +3153,12 @@ namespace flightsimlib
         CBglFile::CBglFile() : CBglFile(L"") { }
 
         CBglFile::CBglFile(std::wstring file_name) :
-            m_file_name(std::move(file_name)), m_file_size(0), m_header(), m_dirty(false), m_stream(file_name)
+            m_file_name(std::move(file_name)), m_file_size(0), m_header(), m_dirty(false),
+            m_read_flags(EBglReadFlags::None), m_read_thread_count(0),
+            m_stream(std::make_shared<BinaryFileStream>(file_name))
         {
+            // Names too long to store inline are interned once per file, and the records keep the pool alive
+            m_stream->SetStringPool(std::make_shared<CStringPool>());
         }
 
         auto CBglFile::GetLayerCount() const -> int { return static_cast<int>(m_layers.size()); }
@@ -2064,49 +3247,94 @@ namespace flightsimlib
 
         bool CBglFile::Open()
         {
-            if (m_stream.IsOpen())
+            if (m_stream->IsOpen())
+            {
+                return true;
+            }
+            if (HasReadFlag(m_read_flags, EBglReadFlags::MemoryMapped))
             {
+                if (!m_stream->OpenMapped(m_file_name))
+                {
+                    return false;
+                }
+                m_file_size = m_stream->GetMappedSize();
                 return true;
             }
-            m_stream.Open(m_file_name);
-            if (!m_stream)
+            m_stream->Open(m_file_name);
+            if (!*m_stream)
             {
                 return false;
             }
-            m_stream.SetPosition(0, std::fstream::end);
-            m_file_size = m_stream.GetPosition();
-            m_stream.SetPosition(0, std::fstream::beg);
+            m_stream->SetPosition(0, std::fstream::end);
+            m_file_size = m_stream->GetPosition();
+            m_stream->SetPosition(0, std::fstream::beg);
             return true;
         }
 
         bool CBglFile::Close()
         {
-            m_stream.Close();
-            return m_stream ? true : false;
+            m_stream->Close();
+            return *m_stream ? true : false;
         }
 
         bool CBglFile::Write()
         {
-            if (m_stream.IsOpen())
+            // Records still pending from an index-only read live in the file we are about to truncate
+            for (const auto& layer : m_layers)
             {
-                m_stream.Close();
+                if (layer != nullptr && !layer->Materialize())
+                {
+                    return false;
+                }
             }
-            m_stream.Open(
-                m_file_name, std::fstream::out | std::fstream::in | std::fstream::binary | std::fstream::trunc);
-            if (!m_stream)
+
+            // Serialize the whole file into one buffer, write it next to the target, then swap it in.
+            // A crash part way through leaves the original file untouched
+            auto out = BinaryFileStream{};
+            out.OpenBuffer(CalculateFileSize());
+            if (!WriteHeader(out))
             {
                 return false;
             }
-            if (!WriteHeader())
+            if (!WriteAllLayers(out))
             {
                 return false;
             }
-            if (!WriteAllLayers())
+            const auto* buffer = out.GetBuffer();
+
+            const auto file_name = std::filesystem::path(m_file_name);
+            auto temp_name = file_name;
+            temp_name += L".tmp";
+            {
+                auto temp = std::ofstream(temp_name, std::ios::out | std::ios::binary | std::ios::trunc);
+                temp.write(reinterpret_cast<const char*>(buffer->data()), static_cast<std::streamsize>(buffer->size()));
+                temp.close();
+                if (!temp || !FlushFileToDisk(temp_name))
+                {
+                    std::error_code error;
+                    std::filesystem::remove(temp_name, error);
+                    return false;
+                }
+            }
+
+            // The target cannot be replaced while we still hold it open (or mapped) on Windows
+            if (m_stream->IsOpen())
+            {
+                m_stream->Close();
+            }
+            std::error_code error;
+            std::filesystem::rename(temp_name, file_name, error);
+            if (error)
             {
+                std::filesystem::remove(temp_name, error);
                 return false;
             }
+
+            m_file_size = static_cast<int>(buffer->size());
             m_dirty = false;
-            return true;
+
+            // Keep the file readable through this object, as it was before the write
+            return Open();
         }
 
         bool CBglFile::Read()
@@ -2123,6 +3351,9 @@ namespace flightsimlib
             {
                 return false;
             }
+            // Records decoded on demand after an index-only read come from the heap
+            m_arena = std::make_shared<CRecordArena>();
+            const auto scope = CRecordArenaScope{m_arena.get()};
             return ReadAllLayers();
         }
 
@@ -2142,70 +3373,291 @@ namespace flightsimlib
                 // TODO - This currently fails if the layer exists
                 //  m_layers[it->second] = ;
                 //  m_layers.emplace_back(static_cast<CBglLayer*>(layer));
+                // Direct layers share their tiles with the source until either file edits them
                 m_layers.emplace_back(layer->CloneLayer());
-                m_layer_offsets.emplace(layer->GetType(), static_cast<int>(m_layers.size()));
+                m_layer_offsets.emplace(layer->GetType(), static_cast<int>(m_layers.size()) - 1);
                 m_dirty = true;
                 return true;
             }
-            return false;
+            return false;
+        }
+
+        void CBglFile::RemoveLayer(EBglLayerType type)
+        {
+            const auto it = m_layer_offsets.find(type);
+            if (it != m_layer_offsets.end())
+            {
+                // TODO - this keeps a nullptr in the vector, otherwise we would have to shift all offsets
+                m_layers[it->second].reset();
+                m_layer_offsets.erase(it);
+                m_dirty = true;
+            }
+        }
+
+        bool CBglFile::IsDirty() const { return m_dirty; }
+
+        int CBglFile::GetFileSize() const { return m_file_size; }
+
+        auto CBglFile::GetReadFlags() const -> EBglReadFlags { return m_read_flags; }
+
+        auto CBglFile::SetReadFlags(EBglReadFlags flags) -> void { m_read_flags = flags; }
+
+        bool CBglFile::ReadAllLayers()
+        {
+            if (m_stream->GetPosition() != static_cast<int>(m_header.HeaderSize))
+            {
+                m_stream->SetPosition(m_header.HeaderSize);
+                if (!*m_stream)
+                {
+                    return false;
+                }
+            }
+            const auto count = static_cast<int>(m_header.LayerCount);
+            // remove static size to prevent nullptr layers
+            // m_layers.resize(count);
+            m_layers.reserve(count);
+
+            const auto index_only = HasReadFlag(m_read_flags, EBglReadFlags::IndexOnly);
+            const auto parallel = !index_only && HasReadFlag(m_read_flags, EBglReadFlags::Parallel);
+            const auto coalesced = !index_only && !parallel && HasReadFlag(m_read_flags, EBglReadFlags::Coalesced);
+            m_read_statistics = SBglReadStatistics{};
+
+            // The layer pointers are contiguous, so take them all before following any of them
+            std::vector<SBglLayerPointer> layer_pointers(count);
+            for (auto& layer_pointer : layer_pointers)
+            {
+                layer_pointer.ReadBinary(*m_stream);
+            }
+            if (!*m_stream)
+            {
+                return false;
+            }
+
+            // A coalesced or parallel read visits the tables in file order. Layers still keep the file's pointer order
+            std::vector<int> read_order(count);
+            for (auto i = 0; i < count; ++i)
+            {
+                read_order[i] = i;
+            }
+            if (coalesced || parallel)
+            {
+                std::stable_sort(read_order.begin(), read_order.end(), [&layer_pointers](int lhs, int rhs)
+                    { return layer_pointers[lhs].StreamOffset < layer_pointers[rhs].StreamOffset; });
+            }
+
+            std::vector<std::unique_ptr<CBglLayer>> layers(count);
+            // Layers listing a table already read, such as TACAN data also listed under a Photo32
+            // type, share the tiles of the first layer instead of decoding them again
+            std::vector<std::pair<CBglDirectQmidLayer*, const CBglDirectQmidLayer*>> aliases;
+            std::vector<const CBglLayer*> read_layers;
+            for (const auto i : read_order)
+            {
+                auto layer = CBglLayer::Factory(layer_pointers[i]);
+                if (layer == nullptr)
+                {
+                    continue; // TODO - Add an unknown layer type? So we keep the pointer
+                }
+                layer->SetRecordArena(m_arena);
+                if (const auto* source = FindTileSource(read_layers, layer_pointers[i]); source != nullptr)
+                {
+                    // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
+                    aliases.emplace_back(static_cast<CBglDirectQmidLayer*>(layer.get()), source);
+                    layers[i] = std::move(layer);
+                    continue;
+                }
+                const auto read = index_only || coalesced || parallel ? layer->ReadBinaryIndex(m_stream)
+                                                          : layer->ReadBinary(*m_stream);
+                if (!read)
+                {
+                    return false;
+                }
+                if (!*m_stream)
+                {
+                    return false;
+                }
+                read_layers.emplace_back(layer.get());
+                layers[i] = std::move(layer);
+            }
+
+            for (auto& layer : layers)
+            {
+                if (layer == nullptr)
+                {
+                    continue;
+                }
+                m_layer_offsets[layer->GetType()] = static_cast<int>(m_layers.size());
+                m_layers.emplace_back(std::move(layer));
+            }
+
+            auto read = true;
+            if (parallel)
+            {
+                read = ReadParallelRecords();
+            }
+            else if (coalesced)
+            {
+                read = ReadPlannedRecords();
+            }
+            for (const auto& [alias, source] : aliases)
+            {
+                alias->ShareTiles(*source);
+            }
+            return read;
+        }
+
+        auto CBglFile::FindTileSource(const std::vector<const CBglLayer*>& layers, const SBglLayerPointer& pointer)
+            -> const CBglDirectQmidLayer*
+        {
+            if (static_cast<EBglLayerClass>(pointer.DataClass) != EBglLayerClass::DirectQmid || pointer.TileCount == 0)
+            {
+                return nullptr;
+            }
+            for (const auto* layer : layers)
+            {
+                if (layer->GetClass() != EBglLayerClass::DirectQmid)
+                {
+                    continue;
+                }
+                const auto* other = layer->GetLayerPointer();
+                if (other->StreamOffset == pointer.StreamOffset && other->SizeBytes == pointer.SizeBytes &&
+                    other->TileCount == pointer.TileCount && other->HasQmidHigh == pointer.HasQmidHigh &&
+                    CBglLayer::GetRecordType(other->Type) == CBglLayer::GetRecordType(pointer.Type))
+                {
+                    // NOLINT(cppcoreguidelines-pro-type-static-cast-downcast)
+                    return static_cast<const CBglDirectQmidLayer*>(layer);
+                }
+            }
+            return nullptr;
         }
 
-        void CBglFile::RemoveLayer(EBglLayerType type)
+        bool CBglFile::ReadPlannedRecords()
         {
-            const auto it = m_layer_offsets.find(type);
-            if (it != m_layer_offsets.end())
+            auto planner = CBglReadPlanner{};
+            for (const auto& layer : m_layers)
             {
-                // TODO - this keeps a nullptr in the vector, otherwise we would have to shift all offsets
-                m_layers[it->second].reset();
-                m_layer_offsets.erase(it);
-                m_dirty = true;
+                planner.AddLayer(*layer);
             }
-        }
-
-        bool CBglFile::IsDirty() const { return m_dirty; }
 
-        int CBglFile::GetFileSize() const { return m_file_size; }
+            const auto payload_source = m_stream->GetPayloadSource();
+            const auto* source = m_stream->IsMapped() ? m_stream->GetMappedFile() : payload_source.get();
+            if (source == nullptr || !planner.Execute(*source, payload_source, m_stream->GetStringPool()))
+            {
+                return false;
+            }
+            m_read_statistics = planner.GetStatistics();
 
-        bool CBglFile::ReadAllLayers()
-        {
-            if (m_stream.GetPosition() != static_cast<int>(m_header.HeaderSize))
+            // Picks up whatever the plan could not place, and releases the shared stream
+            for (const auto& layer : m_layers)
             {
-                m_stream.SetPosition(m_header.HeaderSize);
-                if (!m_stream)
+                if (!layer->Materialize())
                 {
                     return false;
                 }
             }
-            const auto count = static_cast<int>(m_header.LayerCount);
-            // remove static size to prevent nullptr layers
-            // m_layers.resize(count);
-            m_layers.reserve(count);
+            return true;
+        }
 
-            for (auto i = 0; i < count; ++i)
+        bool CBglFile::ReadParallelRecords()
+        {
+            const auto payload_source = m_stream->GetPayloadSource();
+            const auto* source = m_stream->IsMapped() ? m_stream->GetMappedFile() : payload_source.get();
+            if (source == nullptr)
             {
-                auto layer_pointer = SBglLayerPointer{};
-                layer_pointer.ReadBinary(m_stream);
+                return false;
+            }
 
-                const auto next_position = m_stream.GetPosition();
+            auto thread_count = m_read_thread_count;
+            if (thread_count <= 0)
+            {
+                thread_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+            }
 
-                auto layer = CBglLayer::Factory(layer_pointer);
-                if (layer == nullptr)
+            std::vector<std::vector<SBglReadExtent>> layer_extents(m_layers.size());
+            auto total_size = int64_t{0};
+            for (auto i = 0u; i < m_layers.size(); ++i)
+            {
+                auto& extents = layer_extents[i];
+                m_layers[i]->GetPendingExtents(extents);
+                std::stable_sort(extents.begin(), extents.end(),
+                    [](const SBglReadExtent& lhs, const SBglReadExtent& rhs) { return lhs.Offset < rhs.Offset; });
+                for (const auto& extent : extents)
                 {
-                    continue; // TODO - Add an unknown layer type? So we keep the pointer
+                    total_size += extent.Size;
                 }
-                if (!layer->ReadBinary(m_stream))
+            }
+
+            // A few runs per thread keeps the pool busy when layers differ in size, and one
+            // large layer is split into contiguous runs of its tiles rather than read whole
+            const auto run_size = static_cast<int>(std::clamp(total_size / (thread_count * 4),
+                static_cast<int64_t>(CBglReadPlanner::s_default_merge_gap),
+                static_cast<int64_t>(CBglReadPlanner::s_default_max_read)));
+            std::vector<CBglReadPlanner> runs;
+            for (auto i = 0u; i < m_layers.size(); ++i)
+            {
+                auto run_begin = -1;
+                for (const auto& extent : layer_extents[i])
                 {
-                    return false;
+                    if (run_begin < 0 || extent.Offset + extent.Size - run_begin > run_size)
+                    {
+                        runs.emplace_back();
+                        run_begin = extent.Offset;
+                    }
+                    runs.back().AddExtent(*m_layers[i], extent);
                 }
-                if (!m_stream)
+            }
+
+            std::atomic<int> next_run{0};
+            std::atomic<bool> success{true};
+            auto worker = [&]()
+            {
+                const auto scope = CRecordArenaScope{m_arena.get()};
+                // Each worker interns into a pool of its own, so names never contend for a shared lock
+                const auto string_pool = std::make_shared<CStringPool>();
+                for (auto i = next_run++; i < static_cast<int>(runs.size()); i = next_run++)
                 {
-                    return false;
+                    if (!runs[i].Execute(*source, payload_source, string_pool))
+                    {
+                        success = false;
+                    }
                 }
+            };
 
-                m_layer_offsets[layer->GetType()] = static_cast<int>(m_layers.size());
-                m_layers.emplace_back(std::move(layer));
+            thread_count = std::min(thread_count, static_cast<int>(runs.size()));
+            std::vector<std::thread> threads;
+            threads.reserve(thread_count > 1 ? thread_count - 1 : 0);
+            for (auto i = 1; i < thread_count; ++i)
+            {
+                threads.emplace_back(worker);
+            }
+            worker();
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+            if (!success)
+            {
+                return false;
+            }
+
+            // Summed in run order so the totals do not depend on scheduling
+            m_read_statistics = SBglReadStatistics{};
+            for (const auto& run : runs)
+            {
+                const auto& statistics = run.GetStatistics();
+                m_read_statistics.RecordCount += statistics.RecordCount;
+                m_read_statistics.ReadCount += statistics.ReadCount;
+                m_read_statistics.BytesRequested += statistics.BytesRequested;
+                m_read_statistics.BytesRead += statistics.BytesRead;
+                m_read_statistics.FallbackCount += statistics.FallbackCount;
+            }
 
-                m_stream.SetPosition(next_position);
+            // Picks up whatever the runs could not place, and releases the shared stream
+            for (const auto& layer : m_layers)
+            {
+                if (!layer->Materialize())
+                {
+                    return false;
+                }
             }
             return true;
         }
@@ -2213,10 +3665,9 @@ namespace flightsimlib
         // File order for resample is currently all layers after header (required),
         // then all data, then all QMID pointers to tile data
         // Although this may just be a compiler constraint. bglcomp for example looks different
-        bool CBglFile::WriteAllLayers()
+        bool CBglFile::WriteAllLayers(BinaryFileStream& out)
         {
-            if (m_layers.size() != m_header.LayerCount ||
-                m_stream.GetPosition() != static_cast<int>(m_header.HeaderSize))
+            if (m_layers.size() != m_header.LayerCount || out.GetPosition() != static_cast<int>(m_header.HeaderSize))
             {
                 return false;
             }
@@ -2234,7 +3685,7 @@ namespace flightsimlib
             auto i = 0;
             for (const auto& layer : m_layers)
             {
-                if (!layer->WriteBinaryPointer(m_stream, data_size, layer_positions[i++]) || !m_stream)
+                if (!layer->WriteBinaryPointer(out, data_size, layer_positions[i++]) || !out)
                 {
                     return false;
                 }
@@ -2242,14 +3693,14 @@ namespace flightsimlib
             }
             for (const auto& layer : m_layers)
             {
-                if (!layer->WriteBinaryData(m_stream) || !m_stream)
+                if (!layer->WriteBinaryData(out) || !out)
                 {
                     return false;
                 }
             }
             for (const auto& layer : m_layers)
             {
-                if (!layer->WriteBinaryDataPointers(m_stream) && !m_stream)
+                if (!layer->WriteBinaryDataPointers(out) && !out)
                 {
                     return false;
                 }
@@ -2259,33 +3710,38 @@ namespace flightsimlib
 
         bool CBglFile::ReadHeader()
         {
-            if (!m_stream)
+            if (!*m_stream)
             {
                 return false;
             }
-            m_stream.SetPosition(0, std::fstream::beg);
-            m_header = SBglHeader::ReadBinary(m_stream);
-            if (!m_stream)
+            m_stream->SetPosition(0, std::fstream::beg);
+            m_header = SBglHeader::ReadBinary(*m_stream);
+            if (!*m_stream)
             {
                 return false;
             }
-            if (m_header.Version != Version())
+            return IsValidHeader(m_header);
+        }
+
+        auto CBglFile::IsValidHeader(const SBglHeader& header) -> bool
+        {
+            if (header.Version != Version())
             {
                 return false;
             }
-            if (m_header.FileMagic != FileMagic())
+            if (header.FileMagic != FileMagic())
             {
                 return false;
             }
-            if (m_header.HeaderSize != HeaderSize())
+            if (header.HeaderSize != HeaderSize())
             {
                 return false;
             }
-            if (m_header.QmidMagic != QmidMagic())
+            if (header.QmidMagic != QmidMagic())
             {
                 return false;
             }
-            const auto count = static_cast<int>(m_header.LayerCount);
+            const auto count = static_cast<int>(header.LayerCount);
             if (count < 0 || count > std::numeric_limits<int32_t>::max())
             {
                 return false;
@@ -2293,10 +3749,67 @@ namespace flightsimlib
             return true;
         }
 
-        bool CBglFile::WriteHeader()
+        auto CBglFile::PeekHeader(const std::filesystem::path& file_name, SBglHeader& header) -> bool
+        {
+            auto bytes = std::array<uint8_t, sizeof(SBglHeader)>{};
+            {
+                auto file = std::ifstream(file_name, std::ios::in | std::ios::binary);
+                file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+                if (!file)
+                {
+                    return false;
+                }
+            }
+            auto in = BinaryFileStream{};
+            in.OpenView(bytes.data(), static_cast<int>(bytes.size()), 0);
+            header = SBglHeader::ReadBinary(in);
+            return in && IsValidHeader(header);
+        }
+
+        auto CBglFile::IntersectsRegion(const SBglHeader& header, const SBglRegion& region) -> bool
+        {
+            const auto parents = std::array<uint32_t, 8>{header.PackedQMIDParent0, header.PackedQMIDParent1,
+                header.PackedQMIDParent2, header.PackedQMIDParent3, header.PackedQMIDParent4, header.PackedQMIDParent5,
+                header.PackedQMIDParent6, header.PackedQMIDParent7};
+            if (std::all_of(parents.begin(), parents.end(), [](uint32_t parent) { return parent == 0; }))
+            {
+                return true;
+            }
+
+            // A region across the antimeridian is tested as its two halves
+            const auto wraps = region.MinLongitude > region.MaxLongitude;
+            const auto overlaps = [&region, wraps](const SBglRegion& cell)
+            {
+                if (cell.MinLatitude > region.MaxLatitude || cell.MaxLatitude < region.MinLatitude)
+                {
+                    return false;
+                }
+                if (wraps)
+                {
+                    return cell.MaxLongitude >= region.MinLongitude || cell.MinLongitude <= region.MaxLongitude;
+                }
+                return cell.MinLongitude <= region.MaxLongitude && cell.MaxLongitude >= region.MinLongitude;
+            };
+            for (const auto parent : parents)
+            {
+                if (parent != 0 && overlaps(CPackedQmid{parent, 0}.Bounds()))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        auto CBglFile::IntersectsRegion(const std::filesystem::path& file_name, const SBglRegion& region) -> bool
         {
-            m_stream.SetPosition(0, std::fstream::beg);
-            if (!m_stream)
+            auto header = SBglHeader{};
+            return PeekHeader(file_name, header) && IntersectsRegion(header, region);
+        }
+
+        bool CBglFile::WriteHeader(BinaryFileStream& out)
+        {
+            out.SetPosition(0, std::fstream::beg);
+            if (!out)
             {
                 return false;
             }
@@ -2304,8 +3817,22 @@ namespace flightsimlib
             {
                 BuildHeader();
             }
-            SBglHeader::WriteBinary(m_stream, m_header);
-            return m_stream ? true : false;
+            SBglHeader::WriteBinary(out, m_header);
+            return out ? true : false;
+        }
+
+        int CBglFile::CalculateFileSize() const
+        {
+            auto file_size = static_cast<int>(HeaderSize());
+            for (const auto& layer : m_layers)
+            {
+                if (layer != nullptr)
+                {
+                    file_size += CBglLayer::CalculateLayerPointerSize() + layer->CalculateSize() +
+                                 layer->CalculateDataPointersSize();
+                }
+            }
+            return file_size;
         }
 
         bool CBglFile::BuildHeader()
@@ -2319,17 +3846,360 @@ namespace flightsimlib
             return ComputeHeaderQmids();
         }
 
-        // TODO Build Qmid Algorithm
         bool CBglFile::ComputeHeaderQmids()
         {
-            m_header.PackedQMIDParent0 = 0;
-            m_header.PackedQMIDParent1 = 0;
-            m_header.PackedQMIDParent2 = 0;
-            m_header.PackedQMIDParent3 = 0;
-            m_header.PackedQMIDParent4 = 0;
-            m_header.PackedQMIDParent5 = 0;
-            m_header.PackedQMIDParent6 = 0;
-            m_header.PackedQMIDParent7 = 0;
+            auto qmids = std::vector<CPackedQmid>{};
+            for (const auto& layer : m_layers)
+            {
+                // The terrain index lists coarse cells of its own, not the tiles of the file
+                if (layer != nullptr && layer->GetType() != EBglLayerType::TerrainIndex)
+                {
+                    layer->GetTileQmids(qmids);
+                }
+            }
+            SetHeaderQmids(m_header, qmids);
+            return true;
+        }
+
+        auto CBglFile::SetHeaderQmids(SBglHeader& header, const std::vector<CPackedQmid>& qmids) -> void
+        {
+            // The header holds 32 bit QMIDs, which reach level 15
+            constexpr auto max_level = 15;
+            constexpr auto max_parents = 8;
+
+            auto level = max_level;
+            for (const auto& qmid : qmids)
+            {
+                const auto qmid_level = qmid.Level();
+                if (qmid_level >= 0)
+                {
+                    level = std::min(level, qmid_level);
+                }
+            }
+
+            // Cells at the start level, then their parents until few enough remain. Sorted
+            // cells shifted to the parent level stay sorted, so each step is one unique pass
+            auto cells = std::vector<uint64_t>{};
+            cells.reserve(qmids.size());
+            for (const auto& qmid : qmids)
+            {
+                if (qmid.Level() >= 0)
+                {
+                    cells.emplace_back(qmid.Ancestor(level).Value());
+                }
+            }
+            std::sort(cells.begin(), cells.end());
+            cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+            while (static_cast<int>(cells.size()) > max_parents)
+            {
+                for (auto& cell : cells)
+                {
+                    cell >>= 2;
+                }
+                cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+            }
+
+            auto parents = std::array<uint32_t, max_parents>{};
+            std::copy(cells.begin(), cells.end(), parents.begin());
+            header.PackedQMIDParent0 = parents[0];
+            header.PackedQMIDParent1 = parents[1];
+            header.PackedQMIDParent2 = parents[2];
+            header.PackedQMIDParent3 = parents[3];
+            header.PackedQMIDParent4 = parents[4];
+            header.PackedQMIDParent5 = parents[5];
+            header.PackedQMIDParent6 = parents[6];
+            header.PackedQMIDParent7 = parents[7];
+        }
+
+
+        //******************************************************************************
+        // CBglStreamWriter
+        //******************************************************************************
+
+        CBglStreamWriter::~CBglStreamWriter() { Abort(); }
+
+        auto CBglStreamWriter::Open(const std::filesystem::path& file_name) -> bool
+        {
+            Abort();
+            m_file_name = file_name;
+            m_spill_name = file_name;
+            m_spill_name += L".spill";
+            m_spill.open(m_spill_name, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+            return m_spill.is_open();
+        }
+
+        auto CBglStreamWriter::AppendRecord(EBglLayerType type, CPackedQmid qmid, const uint8_t* data, int size) -> bool
+        {
+            if (!m_spill.is_open() || !m_spill || data == nullptr || size <= 0)
+            {
+                return false;
+            }
+
+            m_spill.write(reinterpret_cast<const char*>(data), size);
+            if (!m_spill)
+            {
+                return false;
+            }
+
+            auto layer_it = m_layer_offsets.find(type);
+            if (layer_it == m_layer_offsets.end())
+            {
+                layer_it = m_layer_offsets.emplace(type, static_cast<int>(m_layers.size())).first;
+                m_layers.push_back(SLayer{type, {}});
+            }
+
+            auto& tile = m_layers[layer_it->second].Tiles[qmid];
+            if (!tile.Extents.empty() && tile.Extents.back().Offset + tile.Extents.back().Size == m_spill_size)
+            {
+                tile.Extents.back().Size += size;
+            }
+            else
+            {
+                tile.Extents.push_back(SSpillExtent{m_spill_size, size});
+            }
+            ++tile.RecordCount;
+            tile.SizeBytes += size;
+
+            m_spill_size += size;
+            ++m_record_count;
+            return true;
+        }
+
+        auto CBglStreamWriter::AppendRecord(CPackedQmid qmid, CBglData& data) -> bool
+        {
+            auto out = BinaryFileStream{};
+            out.OpenBuffer(data.CalculateSize());
+            if (!data.WriteBinary(out))
+            {
+                return false;
+            }
+            const auto* buffer = out.GetBuffer();
+            return AppendRecord(data.GetType(), qmid, buffer->data(), static_cast<int>(buffer->size()));
+        }
+
+        // Same layout as CBglFile::Write: header, layer pointers, all tile data, then all tile tables
+        auto CBglStreamWriter::Finalize() -> bool
+        {
+            if (!m_spill.is_open())
+            {
+                return false;
+            }
+            m_spill.flush();
+            if (!m_spill)
+            {
+                Abort();
+                return false;
+            }
+
+            struct SLayerLayout
+            {
+                int64_t DataOffset = 0;
+                int64_t TableOffset = 0;
+                bool IsTerrain = false;
+                bool IsQmid64 = false;
+                // Terrain tables always carry the high QMID word, and a record count only when needed
+                bool HasRecordCount = true;
+                int EntrySize = 16;
+            };
+
+            const auto layer_count = static_cast<int>(m_layers.size());
+            const auto pointers_size =
+                static_cast<int>(CBglFile::HeaderSize()) + CBglLayer::CalculateLayerPointerSize() * layer_count;
+            auto position = static_cast<int64_t>(pointers_size);
+
+            std::vector<SLayerLayout> layouts(m_layers.size());
+            for (auto i = 0; i < layer_count; ++i)
+            {
+                auto& layout = layouts[i];
+                layout.DataOffset = position;
+                for (const auto& tile : m_layers[i].Tiles)
+                {
+                    position += tile.second.SizeBytes;
+                }
+
+                const auto& tiles = m_layers[i].Tiles;
+                layout.IsTerrain =
+                    CBglLayer::IsTrq1BglLayer(m_layers[i].Type) || CBglLayer::IsRcs1BglLayer(m_layers[i].Type);
+                if (layout.IsTerrain)
+                {
+                    layout.IsQmid64 = true;
+                    layout.HasRecordCount = std::any_of(
+                        tiles.begin(), tiles.end(), [](const auto& tile) { return tile.second.RecordCount != 1; });
+                    layout.EntrySize = layout.HasRecordCount ? 20 : 16;
+                }
+                else
+                {
+                    layout.IsQmid64 =
+                        std::any_of(tiles.begin(), tiles.end(), [](const auto& tile) { return tile.first.High() > 0; });
+                    layout.EntrySize = layout.IsQmid64 ? 20 : 16;
+                }
+            }
+            for (auto i = 0; i < layer_count; ++i)
+            {
+                layouts[i].TableOffset = position;
+                position += static_cast<int64_t>(m_layers[i].Tiles.size()) * layouts[i].EntrySize;
+            }
+
+            // Offsets are stored in 32 bits, but the reader handles them as int
+            if (position > static_cast<int64_t>(std::numeric_limits<int32_t>::max()))
+            {
+                Abort();
+                return false;
+            }
+
+            auto header = SBglHeader{};
+            header.Version = CBglFile::Version();
+            header.FileMagic = CBglFile::FileMagic();
+            header.HeaderSize = CBglFile::HeaderSize();
+            header.FileTime = 0; // TODO FILETIME library
+            header.QmidMagic = CBglFile::QmidMagic();
+            header.LayerCount = static_cast<uint32_t>(layer_count);
+            auto qmids = std::vector<CPackedQmid>{};
+            for (const auto& layer : m_layers)
+            {
+                if (layer.Type != EBglLayerType::TerrainIndex)
+                {
+                    for (const auto& tile : layer.Tiles)
+                    {
+                        qmids.emplace_back(tile.first);
+                    }
+                }
+            }
+            CBglFile::SetHeaderQmids(header, qmids);
+
+            auto table = BinaryFileStream{};
+            table.OpenBuffer(pointers_size);
+            SBglHeader::WriteBinary(table, header);
+            for (auto i = 0; i < layer_count; ++i)
+            {
+                const auto& layer = m_layers[i];
+                const auto& layout = layouts[i];
+                auto pointer = SBglLayerPointer{};
+                switch (layer.Type) // NOLINT(clang-diagnostic-switch-enum)
+                {
+                case EBglLayerType::Tacan:
+                    pointer.Type = EBglLayerType::TerrainPhoto32Jan;
+                    break;
+                case EBglLayerType::TacanIndex:
+                    pointer.Type = EBglLayerType::TerrainPhoto32Feb;
+                    break;
+                default:
+                    pointer.Type = layer.Type;
+                    break;
+                }
+                pointer.DataClass = static_cast<uint16_t>(EBglLayerClass::DirectQmid);
+                pointer.HasQmidHigh = !layout.IsTerrain && layout.IsQmid64 ? 1 : 0;
+                pointer.TileCount = static_cast<uint32_t>(layer.Tiles.size());
+                pointer.StreamOffset = static_cast<uint32_t>(layout.TableOffset);
+                pointer.SizeBytes = pointer.TileCount * static_cast<uint32_t>(layout.EntrySize);
+                pointer.WriteBinary(table);
+            }
+            if (!table)
+            {
+                Abort();
+                return false;
+            }
+
+            auto temp_name = m_file_name;
+            temp_name += L".tmp";
+            auto success = false;
+            {
+                auto out = std::ofstream(temp_name, std::ios::out | std::ios::binary | std::ios::trunc);
+                const auto* buffer = table.GetBuffer();
+                out.write(reinterpret_cast<const char*>(buffer->data()), static_cast<std::streamsize>(buffer->size()));
+
+                std::vector<char> copy_buffer;
+                success = static_cast<bool>(out);
+                for (auto i = 0; success && i < layer_count; ++i)
+                {
+                    for (const auto& tile : m_layers[i].Tiles)
+                    {
+                        if (!CopySpilledTile(tile.second, out, copy_buffer))
+                        {
+                            success = false;
+                            break;
+                        }
+                    }
+                }
+
+                for (auto i = 0; success && i < layer_count; ++i)
+                {
+                    const auto& layout = layouts[i];
+                    table.OpenBuffer(static_cast<int>(m_layers[i].Tiles.size()) * layout.EntrySize);
+                    auto offset = layout.DataOffset;
+                    for (const auto& tile : m_layers[i].Tiles)
+                    {
+                        table << tile.first.Low();
+                        if (layout.IsQmid64)
+                        {
+                            table << tile.first.High();
+                        }
+                        if (layout.HasRecordCount)
+                        {
+                            table << tile.second.RecordCount;
+                        }
+                        table << static_cast<uint32_t>(offset) << static_cast<uint32_t>(tile.second.SizeBytes);
+                        offset += tile.second.SizeBytes;
+                    }
+                    buffer = table.GetBuffer();
+                    out.write(
+                        reinterpret_cast<const char*>(buffer->data()), static_cast<std::streamsize>(buffer->size()));
+                    success = table && out;
+                }
+
+                out.close();
+                success = success && out && FlushFileToDisk(temp_name);
+            }
+
+            std::error_code error;
+            if (success)
+            {
+                std::filesystem::rename(temp_name, m_file_name, error);
+                success = !error;
+            }
+            if (!success)
+            {
+                std::filesystem::remove(temp_name, error);
+            }
+            Abort();
+            return success;
+        }
+
+        auto CBglStreamWriter::Abort() -> void
+        {
+            if (m_spill.is_open())
+            {
+                m_spill.close();
+                std::error_code error;
+                std::filesystem::remove(m_spill_name, error);
+            }
+            m_spill.clear();
+            m_spill_size = 0;
+            m_record_count = 0;
+            m_layers.clear();
+            m_layer_offsets.clear();
+        }
+
+        auto CBglStreamWriter::CopySpilledTile(const STile& tile, std::ofstream& out, std::vector<char>& buffer) -> bool
+        {
+            static constexpr int64_t s_copy_size = 1024 * 1024;
+            for (const auto& extent : tile.Extents)
+            {
+                m_spill.seekg(extent.Offset);
+                auto remaining = extent.Size;
+                while (remaining > 0)
+                {
+                    const auto count = std::min(remaining, s_copy_size);
+                    buffer.resize(static_cast<size_t>(std::max<int64_t>(count, buffer.size())));
+                    m_spill.read(buffer.data(), count);
+                    out.write(buffer.data(), count);
+                    if (!m_spill || !out)
+                    {
+                        return false;
+                    }
+                    remaining -= count;
+                }
+            }
             return true;
         }
 
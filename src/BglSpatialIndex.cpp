@@ -0,0 +1,438 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+//******************************************************************************
+//
+// File:     BglSpatialIndex.cpp
+//
+// Summary:  Nearest neighbour and radius searches over positioned records
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "BglSpatialIndex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <type_traits>
+
+
+namespace flightsimlib::io
+{
+
+
+static constexpr auto s_radians = 3.14159265358979323846 / 180.0;
+
+static auto ToUnit(double latitude, double longitude) -> std::array<double, 3>
+{
+    const auto phi = latitude * s_radians;
+    const auto lambda = longitude * s_radians;
+    return { std::cos(phi) * std::cos(lambda), std::cos(phi) * std::sin(lambda), std::sin(phi) };
+}
+
+// Great circle metres from a squared chord of the unit sphere
+static auto ToDistance(double chord_squared) -> double
+{
+    return 2.0 * std::asin(std::min(std::sqrt(chord_squared) / 2.0, 1.0)) * CQmidQuery::s_earth_radius;
+}
+
+template <typename T>
+static auto CollectRecords(CBglFile& file, EBglLayerType type, int file_index, std::vector<SBglSpatialItem>& items)
+    -> void
+{
+    auto record_index = 0;
+    file.ForEach<T>(
+        [&](const T& record)
+        {
+            auto item = SBglSpatialItem{};
+            item.Type = type;
+            item.FileIndex = file_index;
+            item.RecordIndex = record_index++;
+            item.Latitude = record.GetLatitude();
+            item.Longitude = record.GetLongitude();
+            if constexpr (std::is_same_v<T, CBglNdb>)
+            {
+                item.Icao = record.GetIcao();
+            }
+            else if constexpr (!std::is_same_v<T, CBglSceneryObject>)
+            {
+                item.Icao = record.GetIcaoIdent();
+            }
+            if (std::isfinite(item.Latitude) && std::isfinite(item.Longitude))
+            {
+                items.emplace_back(item);
+            }
+        });
+}
+
+
+//******************************************************************************
+// CBglSpatialIndex
+//******************************************************************************
+
+
+auto CBglSpatialIndex::CollectFile(CBglFile& file, int file_index, std::vector<SBglSpatialItem>& items) -> void
+{
+    CollectRecords<CBglAirport>(file, EBglLayerType::Airport, file_index, items);
+    CollectRecords<CBglAirportSummary>(file, EBglLayerType::AirportSummary, file_index, items);
+    CollectRecords<CBglNav>(file, EBglLayerType::Nav, file_index, items);
+    CollectRecords<CBglNdb>(file, EBglLayerType::Ndb, file_index, items);
+    CollectRecords<CBglTacan>(file, EBglLayerType::Tacan, file_index, items);
+    CollectRecords<CBglMarker>(file, EBglLayerType::Marker, file_index, items);
+    CollectRecords<CBglWaypoint>(file, EBglLayerType::Waypoint, file_index, items);
+    CollectRecords<CBglSceneryObject>(file, EBglLayerType::SceneryObject, file_index, items);
+}
+
+auto CBglSpatialIndex::Build(CBglFile& file) -> void
+{
+    auto items = std::vector<SBglSpatialItem>{};
+    CollectFile(file, 0, items);
+    BuildTree(std::move(items), 1);
+}
+
+auto CBglSpatialIndex::Build(const std::vector<std::filesystem::path>& files, int num_threads) -> bool
+{
+    if (num_threads <= 0)
+    {
+        num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    // Each file is collected on its own, then joined in file order so the result does not
+    // depend on scheduling
+    auto file_items = std::vector<std::vector<SBglSpatialItem>>(files.size());
+    std::atomic<int> next_file{0};
+    std::atomic<bool> success{true};
+    auto worker = [&]()
+    {
+        for (auto i = next_file++; i < static_cast<int>(files.size()); i = next_file++)
+        {
+            auto file = CBglFile{files[i].wstring()};
+            if (!file.Read())
+            {
+                success = false;
+                continue;
+            }
+            CollectFile(file, i, file_items[i]);
+        }
+    };
+
+    const auto thread_count = std::min(num_threads, static_cast<int>(files.size()));
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count > 1 ? thread_count - 1 : 0);
+    for (auto i = 1; i < thread_count; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    auto total = size_t{0};
+    for (const auto& items : file_items)
+    {
+        total += items.size();
+    }
+    auto items = std::vector<SBglSpatialItem>{};
+    items.reserve(total);
+    for (auto& collected : file_items)
+    {
+        items.insert(items.end(), collected.begin(), collected.end());
+        collected = {};
+    }
+    BuildTree(std::move(items), num_threads);
+    return success;
+}
+
+auto CBglSpatialIndex::NodeCount(int count) -> int
+{
+    if (count <= s_leaf_size)
+    {
+        return 1;
+    }
+    return 1 + NodeCount(count / 2) + NodeCount(count - count / 2);
+}
+
+auto CBglSpatialIndex::BuildTree(std::vector<SBglSpatialItem> items, int num_threads) -> void
+{
+    const auto count = static_cast<int>(items.size());
+    m_x.resize(count);
+    m_y.resize(count);
+    m_z.resize(count);
+    for (auto i = 0; i < count; ++i)
+    {
+        const auto unit = ToUnit(items[i].Latitude, items[i].Longitude);
+        m_x[i] = unit[0];
+        m_y[i] = unit[1];
+        m_z[i] = unit[2];
+    }
+    m_items = std::move(items);
+
+    m_nodes.clear();
+    if (count == 0)
+    {
+        return;
+    }
+    m_order.resize(count);
+    for (auto i = 0; i < count; ++i)
+    {
+        m_order[i] = i;
+    }
+    // Subtrees split off to their own threads until there is one per thread
+    auto parallel_depth = 0;
+    while ((1 << parallel_depth) < num_threads)
+    {
+        ++parallel_depth;
+    }
+    m_nodes.resize(NodeCount(count));
+    BuildNode(0, 0, count, parallel_depth);
+
+    // Lay the items out in tree order, so each leaf is a contiguous run
+    auto items_in_order = std::vector<SBglSpatialItem>(count);
+    auto x = std::vector<double>(count);
+    auto y = std::vector<double>(count);
+    auto z = std::vector<double>(count);
+    for (auto i = 0; i < count; ++i)
+    {
+        const auto source = m_order[i];
+        items_in_order[i] = m_items[source];
+        x[i] = m_x[source];
+        y[i] = m_y[source];
+        z[i] = m_z[source];
+    }
+    m_items = std::move(items_in_order);
+    m_x = std::move(x);
+    m_y = std::move(y);
+    m_z = std::move(z);
+    m_order = {};
+}
+
+auto CBglSpatialIndex::BuildNode(int node, int first, int end, int parallel_depth) -> void
+{
+    auto& current = m_nodes[node];
+    current.Min = { 1.0, 1.0, 1.0 };
+    current.Max = { -1.0, -1.0, -1.0 };
+    current.Types = 0;
+    current.First = first;
+    current.End = end;
+    current.Right = -1;
+    const std::vector<double>* axes[] = { &m_x, &m_y, &m_z };
+    for (auto i = first; i < end; ++i)
+    {
+        const auto item = m_order[i];
+        for (auto axis = 0; axis < 3; ++axis)
+        {
+            const auto value = (*axes[axis])[item];
+            current.Min[axis] = std::min(current.Min[axis], value);
+            current.Max[axis] = std::max(current.Max[axis], value);
+        }
+        current.Types |= TypeMask(m_items[item].Type);
+    }
+
+    const auto count = end - first;
+    if (count <= s_leaf_size)
+    {
+        return;
+    }
+
+    // Split at the median of the widest axis
+    auto axis = 0;
+    for (auto i = 1; i < 3; ++i)
+    {
+        if (current.Max[i] - current.Min[i] > current.Max[axis] - current.Min[axis])
+        {
+            axis = i;
+        }
+    }
+    const auto& values = *axes[axis];
+    const auto middle = first + count / 2;
+    std::nth_element(m_order.begin() + first, m_order.begin() + middle, m_order.begin() + end,
+        [&values](int lhs, int rhs) { return values[lhs] < values[rhs]; });
+
+    const auto right = node + 1 + NodeCount(count / 2);
+    current.Right = right;
+    if (parallel_depth > 0)
+    {
+        auto left = std::thread(&CBglSpatialIndex::BuildNode, this, node + 1, first, middle, parallel_depth - 1);
+        BuildNode(right, middle, end, parallel_depth - 1);
+        left.join();
+    }
+    else
+    {
+        BuildNode(node + 1, first, middle, 0);
+        BuildNode(right, middle, end, 0);
+    }
+}
+
+auto CBglSpatialIndex::NodeDistance(const SNode& node, const std::array<double, 3>& point) const -> double
+{
+    auto distance = 0.0;
+    for (auto axis = 0; axis < 3; ++axis)
+    {
+        const auto outside = std::max({ node.Min[axis] - point[axis], point[axis] - node.Max[axis], 0.0 });
+        distance += outside * outside;
+    }
+    return distance;
+}
+
+auto CBglSpatialIndex::FindNearest(double latitude, double longitude, int count,
+    std::vector<SBglSpatialMatch>& matches, uint64_t types) const -> void
+{
+    matches.clear();
+    if (count <= 0 || m_nodes.empty())
+    {
+        return;
+    }
+    const auto point = ToUnit(latitude, longitude);
+
+    // Max heap of the best candidates so far, on squared chord
+    auto best = std::vector<std::pair<double, int>>{};
+    best.reserve(count);
+    const auto bound = [&best, count]()
+    { return static_cast<int>(best.size()) < count ? std::numeric_limits<double>::max() : best.front().first; };
+
+    // Depth first, nearer child first. The tree is balanced, so its depth is below 32 and
+    // the stack never holds more than one pending sibling per level
+    std::pair<double, int> stack[64];
+    auto top = 0;
+    stack[top++] = { NodeDistance(m_nodes[0], point), 0 };
+    while (top > 0)
+    {
+        const auto [node_distance, index] = stack[--top];
+        const auto& node = m_nodes[index];
+        if (node_distance >= bound() || (node.Types & types) == 0)
+        {
+            continue;
+        }
+        if (node.Right < 0)
+        {
+            for (auto i = node.First; i < node.End; ++i)
+            {
+                if ((TypeMask(m_items[i].Type) & types) == 0)
+                {
+                    continue;
+                }
+                const auto dx = m_x[i] - point[0];
+                const auto dy = m_y[i] - point[1];
+                const auto dz = m_z[i] - point[2];
+                const auto distance = dx * dx + dy * dy + dz * dz;
+                if (static_cast<int>(best.size()) < count)
+                {
+                    best.emplace_back(distance, i);
+                    std::push_heap(best.begin(), best.end());
+                }
+                else if (distance < best.front().first)
+                {
+                    std::pop_heap(best.begin(), best.end());
+                    best.back() = { distance, i };
+                    std::push_heap(best.begin(), best.end());
+                }
+            }
+            continue;
+        }
+        const auto left_distance = NodeDistance(m_nodes[index + 1], point);
+        const auto right_distance = NodeDistance(m_nodes[node.Right], point);
+        if (left_distance <= right_distance)
+        {
+            stack[top++] = { right_distance, node.Right };
+            stack[top++] = { left_distance, index + 1 };
+        }
+        else
+        {
+            stack[top++] = { left_distance, index + 1 };
+            stack[top++] = { right_distance, node.Right };
+        }
+    }
+
+    std::sort_heap(best.begin(), best.end());
+    matches.reserve(best.size());
+    for (const auto& [distance, item] : best)
+    {
+        matches.push_back({ item, ToDistance(distance) });
+    }
+}
+
+auto CBglSpatialIndex::FindWithinRadius(double latitude, double longitude, double radius,
+    std::vector<SBglSpatialMatch>& matches, uint64_t types) const -> void
+{
+    matches.clear();
+    if (radius < 0.0 || m_nodes.empty())
+    {
+        return;
+    }
+    const auto point = ToUnit(latitude, longitude);
+    const auto angle = std::min(radius / CQmidQuery::s_earth_radius, 3.14159265358979323846);
+    const auto chord = 2.0 * std::sin(angle / 2.0);
+    const auto limit = chord * chord;
+
+    auto found = std::vector<std::pair<double, int>>{};
+    int stack[64];
+    auto top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const auto index = stack[--top];
+        const auto& node = m_nodes[index];
+        if ((node.Types & types) == 0 || NodeDistance(node, point) > limit)
+        {
+            continue;
+        }
+        if (node.Right >= 0)
+        {
+            stack[top++] = node.Right;
+            stack[top++] = index + 1;
+            continue;
+        }
+        for (auto i = node.First; i < node.End; ++i)
+        {
+            const auto dx = m_x[i] - point[0];
+            const auto dy = m_y[i] - point[1];
+            const auto dz = m_z[i] - point[2];
+            const auto distance = dx * dx + dy * dy + dz * dz;
+            if (distance <= limit && (TypeMask(m_items[i].Type) & types) != 0)
+            {
+                found.emplace_back(distance, i);
+            }
+        }
+    }
+
+    std::sort(found.begin(), found.end());
+    matches.reserve(found.size());
+    for (const auto& [distance, item] : found)
+    {
+        matches.push_back({ item, ToDistance(distance) });
+    }
+}
+
+
+}
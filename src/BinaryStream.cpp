@@ -39,88 +39,569 @@
 
 #include "BinaryStream.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 
 namespace flightsimlib::io
 {
 
 
+//******************************************************************************
+// CMappedFile
+//******************************************************************************
+
+
+CMappedFile::~CMappedFile()
+{
+    Close();
+}
+
+
+bool CMappedFile::Open(const std::filesystem::path& filename)
+{
+    Close();
+
+#ifdef _WIN32
+    const auto file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    const auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    const auto fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat status{};
+    if (fstat(fd, &status) != 0 || status.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    const auto size = static_cast<size_t>(status.st_size);
+    const auto view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    close(fd);
+    if (view == MAP_FAILED)
+    {
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = size;
+#endif
+
+    return true;
+}
+
+
+void CMappedFile::Close()
+{
+    if (m_data == nullptr)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+
+bool CMappedFile::ReadAt(int offset, void* out, int size) const
+{
+    const auto view = GetView(offset, size);
+    if (view.Data == nullptr)
+    {
+        return false;
+    }
+
+    std::memcpy(out, view.Data, static_cast<size_t>(size));
+    return true;
+}
+
+
+SByteSpan CMappedFile::GetView(int offset, int length) const
+{
+    if (m_data == nullptr || offset < 0 || length < 0 ||
+        static_cast<size_t>(offset) + static_cast<size_t>(length) > m_size)
+    {
+        return {};
+    }
+
+    return { m_data + offset, length };
+}
+
+
+//******************************************************************************
+// CPositionalFileStream
+//******************************************************************************
+
+
+CPositionalFileStream::~CPositionalFileStream()
+{
+    Close();
+}
+
+
+bool CPositionalFileStream::Open(const std::filesystem::path& filename)
+{
+    Close();
+
+#ifdef _WIN32
+    const auto file = CreateFileW(filename.c_str(), GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_length = static_cast<int>(size.QuadPart);
+#else
+    const auto fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat status{};
+    if (fstat(fd, &status) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    m_file = fd;
+    m_length = static_cast<int>(status.st_size);
+#endif
+
+    return true;
+}
+
+
+void CPositionalFileStream::Close()
+{
+    if (!IsOpen())
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    CloseHandle(m_file);
+    m_file = nullptr;
+#else
+    close(m_file);
+    m_file = -1;
+#endif
+
+    m_length = 0;
+}
+
+
+bool CPositionalFileStream::IsOpen() const
+{
+#ifdef _WIN32
+    return m_file != nullptr;
+#else
+    return m_file >= 0;
+#endif
+}
+
+
+bool CPositionalFileStream::ReadAt(int offset, void* out, int size) const
+{
+    if (!IsOpen() || offset < 0 || size < 0 || offset > m_length - size)
+    {
+        return false;
+    }
+
+    auto* dest = static_cast<uint8_t*>(out);
+    while (size > 0)
+    {
+#ifdef _WIN32
+        // The explicit offset makes this independent of the handle's file pointer
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(offset);
+        DWORD bytes_read = 0;
+        if (!ReadFile(m_file, dest, static_cast<DWORD>(size), &bytes_read, &overlapped) || bytes_read == 0)
+        {
+            return false;
+        }
+#else
+        const auto bytes_read = pread(m_file, dest, static_cast<size_t>(size), offset);
+        if (bytes_read <= 0)
+        {
+            return false;
+        }
+#endif
+        dest += bytes_read;
+        offset += static_cast<int>(bytes_read);
+        size -= static_cast<int>(bytes_read);
+    }
+
+    return true;
+}
+
+
+bool FlushFileToDisk(const std::filesystem::path& filename)
+{
+#ifdef _WIN32
+    const auto file = CreateFileW(filename.c_str(), GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    const auto flushed = FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+    return flushed;
+#else
+    const auto fd = open(filename.c_str(), O_WRONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    const auto flushed = fsync(fd) == 0;
+    close(fd);
+    return flushed;
+#endif
+}
+
+
+//******************************************************************************
+// BinaryFileStream
+//******************************************************************************
+
+
+bool BinaryFileStream::OpenMapped(const std::filesystem::path& filename)
+{
+    Close();
+
+    if (!m_mapping.Open(filename))
+    {
+        m_iostream.setstate(std::ios_base::failbit);
+        return false;
+    }
+
+    m_mapped_reader = std::make_unique<CBinaryReader>(m_mapping.GetData(), static_cast<int>(m_mapping.GetSize()));
+    m_reader = m_mapped_reader.get();
+    m_path = filename;
+    return true;
+}
+
+
+SByteSpan BinaryFileStream::GetMappedView(int offset, int length) const
+{
+    return m_mapping.GetView(offset, length);
+}
+
+
+std::shared_ptr<const IPositionalStream> BinaryFileStream::GetPayloadSource()
+{
+    if (m_payload_source == nullptr && !m_path.empty())
+    {
+        auto source = std::make_shared<CPositionalFileStream>();
+        if (source->Open(m_path))
+        {
+            m_payload_source = std::move(source);
+        }
+        else
+        {
+            // Don't retry for every record of the file
+            m_path.clear();
+        }
+    }
+
+    return m_payload_source;
+}
+
+
+void BinaryFileStream::OpenBuffer(int reserve_size)
+{
+    Close();
+
+    m_buffer = std::make_unique<CByteBufferStreambuf>(static_cast<size_t>(std::max(reserve_size, 0)));
+    m_iostream.rdbuf(m_buffer.get());
+}
+
+
+void BinaryFileStream::OpenView(const uint8_t* data, int length, int base_offset)
+{
+    Close();
+
+    m_mapped_reader = std::make_unique<CBinaryReader>(data, length, base_offset);
+    m_reader = m_mapped_reader.get();
+}
+
+
+void BinaryFileStream::DetachMemory()
+{
+    if (m_buffer != nullptr)
+    {
+        m_iostream.rdbuf(m_fstream.rdbuf());
+        m_buffer.reset();
+    }
+
+    m_reader = nullptr;
+    m_mapped_reader.reset();
+    m_mapping.Close();
+    m_path.clear();
+    m_payload_source.reset();
+}
+
+
+//******************************************************************************
+// CByteBufferStreambuf
+//******************************************************************************
+
+
+CByteBufferStreambuf::CByteBufferStreambuf(size_t reserve_size) :
+    m_current(0)
+{
+    m_buffer.reserve(reserve_size);
+}
+
+
+CByteBufferStreambuf::int_type CByteBufferStreambuf::underflow()
+{
+    if (m_current >= m_buffer.size())
+        return traits_type::eof();
+
+    return traits_type::to_int_type(static_cast<char>(m_buffer[m_current]));
+}
+
+
+CByteBufferStreambuf::int_type CByteBufferStreambuf::uflow()
+{
+    if (m_current >= m_buffer.size())
+        return traits_type::eof();
+
+    return traits_type::to_int_type(static_cast<char>(m_buffer[m_current++]));
+}
+
+
+CByteBufferStreambuf::int_type CByteBufferStreambuf::overflow(int_type ch)
+{
+    if (traits_type::eq_int_type(ch, traits_type::eof()))
+        return traits_type::not_eof(ch);
+
+    const auto value = traits_type::to_char_type(ch);
+    return xsputn(&value, 1) == 1 ? ch : traits_type::eof();
+}
+
+
+std::streamsize CByteBufferStreambuf::xsgetn(char_type* s, std::streamsize count)
+{
+    if (m_current >= m_buffer.size())
+        return 0;
+
+    const auto available = std::min<std::streamsize>(count, m_buffer.size() - m_current);
+    std::memcpy(s, m_buffer.data() + m_current, static_cast<size_t>(available));
+    m_current += static_cast<size_t>(available);
+    return available;
+}
+
+
+std::streamsize CByteBufferStreambuf::xsputn(const char_type* s, std::streamsize count)
+{
+    if (count <= 0)
+        return 0;
+
+    // Writing past the end grows the buffer, filling any gap with zeros like a sparse file
+    const auto end = m_current + static_cast<size_t>(count);
+    if (end > m_buffer.size())
+        m_buffer.resize(end);
+
+    std::memcpy(m_buffer.data() + m_current, s, static_cast<size_t>(count));
+    m_current = end;
+    return count;
+}
+
+
+std::streampos CByteBufferStreambuf::seekoff(std::streamoff off, std::ios_base::seekdir way,
+    std::ios_base::openmode which)
+{
+    auto base = std::streamoff{ 0 };
+    if (way == std::ios_base::cur)
+    {
+        base = static_cast<std::streamoff>(m_current);
+    }
+    else if (way == std::ios_base::end)
+    {
+        base = static_cast<std::streamoff>(m_buffer.size());
+    }
+
+    if (base + off < 0)
+        return -1;
+
+    m_current = static_cast<size_t>(base + off);
+    return static_cast<std::streamoff>(m_current);
+}
+
+
+std::streampos CByteBufferStreambuf::seekpos(std::streampos sp,
+    std::ios_base::openmode which)
+{
+    return seekoff(sp, std::ios_base::beg, which);
+}
+
+
+//******************************************************************************
+// CByteArrayStreambuf
+//******************************************************************************
+
+
 CByteArrayStreambuf::CByteArrayStreambuf(const uint8_t* begin, const size_t size) :
-	m_begin(begin),
-	m_end(begin + size),
-	m_current(m_begin)
+    m_begin(begin),
+    m_end(begin + size),
+    m_current(m_begin)
 {
-	assert(std::less_equal<>()(m_begin, m_end));
+    assert(std::less_equal<>()(m_begin, m_end));
 }
 
-	
+
 CByteArrayStreambuf::int_type CByteArrayStreambuf::underflow()
 {
-	if (m_current == m_end)
-		return traits_type::eof();
+    if (m_current == m_end)
+        return traits_type::eof();
 
-	return traits_type::to_int_type(*m_current);
+    return traits_type::to_int_type(*m_current);
 }
 
-	
+
 CByteArrayStreambuf::int_type CByteArrayStreambuf::uflow()
 {
-	if (m_current == m_end)
-		return traits_type::eof();
+    if (m_current == m_end)
+        return traits_type::eof();
 
-	return traits_type::to_int_type(*m_current++);
+    return traits_type::to_int_type(*m_current++);
 }
 
-	
+
 CByteArrayStreambuf::int_type CByteArrayStreambuf::pbackfail(int_type ch)
 {
-	if (m_current == m_begin || (ch != traits_type::eof() && ch != m_current[-1]))
-		return traits_type::eof();
+    if (m_current == m_begin || (ch != traits_type::eof() && ch != m_current[-1]))
+        return traits_type::eof();
 
-	return traits_type::to_int_type(*--m_current);
+    return traits_type::to_int_type(*--m_current);
 }
 
-	
+
 std::streamsize CByteArrayStreambuf::showmanyc()
 {
-	assert(std::less_equal<>()(m_current, m_end));
-	return m_end - m_current;
+    assert(std::less_equal<>()(m_current, m_end));
+    return m_end - m_current;
+}
+
+
+std::streamsize CByteArrayStreambuf::xsgetn(char_type* s, std::streamsize count)
+{
+    const auto available = std::min<std::streamsize>(count, m_end - m_current);
+    if (available <= 0)
+        return 0;
+
+    std::memcpy(s, m_current, static_cast<size_t>(available));
+    m_current += available;
+    return available;
 }
 
-	
+
 std::streampos CByteArrayStreambuf::seekoff(std::streamoff off, std::ios_base::seekdir way,
-	std::ios_base::openmode which)
+    std::ios_base::openmode which)
 {
-	if (way == std::ios_base::beg)
-	{
-		m_current = m_begin + off;
-	}
-	else if (way == std::ios_base::cur)
-	{
-		m_current += off;
-	}
-	else if (way == std::ios_base::end)
-	{
-		m_current = m_end;
-	}
+    if (way == std::ios_base::beg)
+    {
+        m_current = m_begin + off;
+    }
+    else if (way == std::ios_base::cur)
+    {
+        m_current += off;
+    }
+    else if (way == std::ios_base::end)
+    {
+        m_current = m_end;
+    }
 
-	if (m_current < m_begin || m_current > m_end)
-		return -1;
+    if (m_current < m_begin || m_current > m_end)
+        return -1;
 
-	return m_current - m_begin;
+    return m_current - m_begin;
 }
 
-	
+
 std::streampos CByteArrayStreambuf::seekpos(std::streampos sp,
-	std::ios_base::openmode which)
+    std::ios_base::openmode which)
 {
-	m_current = m_begin + sp;
+    m_current = m_begin + sp;
 
-	if (m_current < m_begin || m_current > m_end)
-		return -1;
+    if (m_current < m_begin || m_current > m_end)
+        return -1;
 
-	return m_current - m_begin;
+    return m_current - m_begin;
 }
 
 
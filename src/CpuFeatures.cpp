@@ -0,0 +1,106 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+//******************************************************************************
+//
+// File:     CpuFeatures.cpp
+//
+// Summary:  Run time detection of the instruction sets that the batch kernels
+//           are built for
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "CpuFeatures.h"
+
+#include <atomic>
+
+#if defined(FLIGHTSIMLIB_X64) && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+
+namespace flightsimlib::io
+{
+
+
+static auto DetectAvx2() -> bool
+{
+#if defined(FLIGHTSIMLIB_X64) && defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, 0, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+    // AVX, and the OS saving the upper halves of the registers on a context switch
+    constexpr auto osxsave = 1 << 27;
+    constexpr auto avx = 1 << 28;
+    __cpuidex(info, 1, 0);
+    if ((info[2] & (osxsave | avx)) != (osxsave | avx) || (_xgetbv(0) & 0x6) != 0x6)
+    {
+        return false;
+    }
+    constexpr auto avx2 = 1 << 5;
+    constexpr auto bmi2 = 1 << 8;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (avx2 | bmi2)) == (avx2 | bmi2);
+#elif defined(FLIGHTSIMLIB_X64)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2");
+#else
+    return false;
+#endif
+}
+
+static auto Avx2Enabled() -> std::atomic<bool>&
+{
+    static auto s_enabled = std::atomic<bool>{DetectAvx2()};
+    return s_enabled;
+}
+
+
+//******************************************************************************
+// CCpuFeatures
+//******************************************************************************
+
+
+auto CCpuFeatures::HasAvx2() -> bool
+{
+    return Avx2Enabled().load(std::memory_order_relaxed);
+}
+
+auto CCpuFeatures::SetAvx2Enabled(bool enabled) -> void
+{
+    Avx2Enabled().store(enabled && DetectAvx2(), std::memory_order_relaxed);
+}
+
+
+}
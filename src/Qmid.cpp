@@ -0,0 +1,438 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+//******************************************************************************
+//
+// File:     Qmid.cpp
+//
+// Summary:  Batch conversions between coordinates and QMID cells
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Qmid.h"
+
+#include "CpuFeatures.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef FLIGHTSIMLIB_X64
+#include <immintrin.h>
+#endif
+
+
+namespace flightsimlib::io
+{
+
+
+static constexpr auto s_pi = 3.14159265358979323846;
+static constexpr auto s_radians = s_pi / 180.0;
+
+// Degrees in [-180, 180)
+static auto WrapDegrees(double longitude) -> double
+{
+    const auto wrapped = std::fmod(longitude + 180.0, 360.0);
+    return (wrapped < 0.0 ? wrapped + 360.0 : wrapped) - 180.0;
+}
+
+// Cells of levels 0 and 1 reach past 180 degrees, so their span is tested a turn west as well
+static auto OverlapsLongitude(const SBglRegion& cell, const SBglRegion& region) -> bool
+{
+    const auto overlaps = [&region](double min_longitude, double max_longitude)
+    {
+        if (region.MinLongitude > region.MaxLongitude)
+        {
+            return max_longitude >= region.MinLongitude || min_longitude <= region.MaxLongitude;
+        }
+        return min_longitude <= region.MaxLongitude && max_longitude >= region.MinLongitude;
+    };
+    return overlaps(cell.MinLongitude, cell.MaxLongitude) ||
+        (cell.MaxLongitude > 180.0 && overlaps(cell.MinLongitude - 360.0, cell.MaxLongitude - 360.0));
+}
+
+static auto ContainsLongitude(const SBglRegion& region, double min_longitude, double max_longitude) -> bool
+{
+    if (region.MinLongitude > region.MaxLongitude)
+    {
+        return min_longitude >= region.MinLongitude || max_longitude <= region.MaxLongitude;
+    }
+    return min_longitude >= region.MinLongitude && max_longitude <= region.MaxLongitude;
+}
+
+
+#ifdef FLIGHTSIMLIB_X64
+
+// Spreads the low 32 bits of each lane to its even bits
+FLIGHTSIMLIB_TARGET_AVX2 static auto Spread4(__m256i bits) -> __m256i
+{
+    bits = _mm256_and_si256(_mm256_or_si256(bits, _mm256_slli_epi64(bits, 16)),
+        _mm256_set1_epi64x(0x0000FFFF0000FFFFll));
+    bits = _mm256_and_si256(_mm256_or_si256(bits, _mm256_slli_epi64(bits, 8)),
+        _mm256_set1_epi64x(0x00FF00FF00FF00FFll));
+    bits = _mm256_and_si256(_mm256_or_si256(bits, _mm256_slli_epi64(bits, 4)),
+        _mm256_set1_epi64x(0x0F0F0F0F0F0F0F0Fll));
+    bits = _mm256_and_si256(_mm256_or_si256(bits, _mm256_slli_epi64(bits, 2)),
+        _mm256_set1_epi64x(0x3333333333333333ll));
+    return _mm256_and_si256(_mm256_or_si256(bits, _mm256_slli_epi64(bits, 1)),
+        _mm256_set1_epi64x(0x5555555555555555ll));
+}
+
+// Four points per step, the same arithmetic as FromLatLon. Returns how many points were
+// converted, a multiple of four
+FLIGHTSIMLIB_TARGET_AVX2 static auto FromLatLonsAvx2(const double* latitudes, const double* longitudes, int count,
+    int level, uint64_t* qmids) -> int
+{
+    // max_pd returns its second operand when either is NaN, which sends NaN to cell 0 here too
+    const auto scale = static_cast<double>(1ull << level);
+    const auto zero = _mm256_setzero_pd();
+    const auto full_turn = _mm256_set1_pd(360.0);
+    const auto min_x = _mm256_set1_pd(-1.0e15);
+    const auto max_x = _mm256_set1_pd(1.0e15);
+    const auto u_scale = _mm256_set1_pd(scale / 480.0);
+    const auto v_scale = _mm256_set1_pd(scale / 360.0);
+    const auto max_u = _mm256_set1_pd(static_cast<double>(CPackedQmid::ColumnCount(level) - 1));
+    const auto max_v = _mm256_set1_pd(static_cast<double>(CPackedQmid::RowCount(level) - 1));
+    const auto marker = _mm256_set1_epi64x(static_cast<int64_t>(2ull << (2 * level)));
+    auto i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        auto x = _mm256_add_pd(_mm256_loadu_pd(longitudes + i), _mm256_set1_pd(180.0));
+        // Wrapped as in WrapLongitude, whole turns toward zero and then one more if it went negative.
+        // Anything too large to wrap, and NaN, fails the range test and goes to 0
+        const auto in_range = _mm256_and_pd(_mm256_cmp_pd(x, min_x, _CMP_GT_OQ), _mm256_cmp_pd(x, max_x, _CMP_LT_OQ));
+        const auto turns = _mm256_round_pd(_mm256_div_pd(x, full_turn), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        x = _mm256_sub_pd(x, _mm256_mul_pd(full_turn, turns));
+        x = _mm256_add_pd(x, _mm256_and_pd(_mm256_cmp_pd(x, zero, _CMP_LT_OQ), full_turn));
+        x = _mm256_and_pd(x, in_range);
+        x = _mm256_min_pd(_mm256_max_pd(_mm256_floor_pd(_mm256_mul_pd(x, u_scale)), zero), max_u);
+        auto y = _mm256_sub_pd(_mm256_set1_pd(90.0), _mm256_loadu_pd(latitudes + i));
+        y = _mm256_min_pd(_mm256_max_pd(_mm256_floor_pd(_mm256_mul_pd(y, v_scale)), zero), max_v);
+
+        const auto u = Spread4(_mm256_cvtepu32_epi64(_mm256_cvttpd_epi32(x)));
+        const auto v = Spread4(_mm256_cvtepu32_epi64(_mm256_cvttpd_epi32(y)));
+        const auto packed = _mm256_or_si256(marker, _mm256_or_si256(u, _mm256_slli_epi64(v, 1)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(qmids + i), packed);
+    }
+    return i;
+}
+
+// As ToCenters, with U and V gathered by pext
+FLIGHTSIMLIB_TARGET_AVX2 static auto ToCentersBmi2(const uint64_t* qmids, int count, double* latitudes,
+    double* longitudes) -> void
+{
+    for (auto i = 0; i < count; ++i)
+    {
+        const auto qmid = CPackedQmid{qmids[i]};
+        const auto level = qmid.Level();
+        if (level < 0)
+        {
+            latitudes[i] = std::numeric_limits<double>::quiet_NaN();
+            longitudes[i] = std::numeric_limits<double>::quiet_NaN();
+            continue;
+        }
+        const auto coordinates = level > 0 ? qmid.Value() & ((1ull << (2 * level)) - 1) : 0;
+        const auto u = _pext_u64(coordinates, 0x5555555555555555ull);
+        const auto v = _pext_u64(coordinates, 0xAAAAAAAAAAAAAAAAull);
+        const auto scale = static_cast<double>(1ull << level);
+        longitudes[i] = -180.0 + (static_cast<double>(u) + 0.5) * (480.0 / scale);
+        latitudes[i] = 90.0 - (static_cast<double>(v) + 0.5) * (360.0 / scale);
+    }
+}
+
+#endif
+
+
+//******************************************************************************
+// CPackedQmid
+//******************************************************************************
+
+
+auto CPackedQmid::FromLatLons(const double* latitudes, const double* longitudes, int count, int level,
+    uint64_t* qmids) -> void
+{
+    if (level < 0 || level > s_max_level)
+    {
+        for (auto i = 0; i < count; ++i)
+        {
+            qmids[i] = 0;
+        }
+        return;
+    }
+
+    auto i = 0;
+#ifdef FLIGHTSIMLIB_X64
+    if (CCpuFeatures::HasAvx2())
+    {
+        i = FromLatLonsAvx2(latitudes, longitudes, count, level, qmids);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        qmids[i] = FromLatLon(latitudes[i], longitudes[i], level).Value();
+    }
+}
+
+auto CPackedQmid::ToCenters(const uint64_t* qmids, int count, double* latitudes, double* longitudes) -> void
+{
+    // Levels differ from one cell to the next, so this stays scalar. Decoding is pext where available
+#ifdef FLIGHTSIMLIB_X64
+    if (CCpuFeatures::HasAvx2())
+    {
+        ToCentersBmi2(qmids, count, latitudes, longitudes);
+        return;
+    }
+#endif
+    for (auto i = 0; i < count; ++i)
+    {
+        const auto qmid = CPackedQmid{qmids[i]};
+        const auto level = qmid.Level();
+        if (level < 0)
+        {
+            latitudes[i] = std::numeric_limits<double>::quiet_NaN();
+            longitudes[i] = std::numeric_limits<double>::quiet_NaN();
+            continue;
+        }
+        const auto scale = static_cast<double>(1ull << level);
+        longitudes[i] = -180.0 + (static_cast<double>(qmid.U()) + 0.5) * (480.0 / scale);
+        latitudes[i] = 90.0 - (static_cast<double>(qmid.V()) + 0.5) * (360.0 / scale);
+    }
+}
+
+
+//******************************************************************************
+// CQmidQuery
+//******************************************************************************
+
+
+auto CQmidQuery::FromRegion(const SBglRegion& region) -> CQmidQuery
+{
+    auto query = CQmidQuery{};
+    query.m_bounds = region;
+    return query;
+}
+
+auto CQmidQuery::FromRadius(double latitude, double longitude, double radius) -> CQmidQuery
+{
+    auto query = CQmidQuery{};
+    query.m_is_radius = true;
+    query.m_latitude = std::clamp(latitude, -90.0, 90.0);
+    query.m_longitude = WrapDegrees(longitude);
+    query.m_radius = std::max(radius, 0.0);
+
+    const auto angle = query.m_radius / s_earth_radius;
+    const auto span = angle / s_radians;
+    auto& bounds = query.m_bounds;
+    bounds.MinLatitude = std::max(query.m_latitude - span, -90.0);
+    bounds.MaxLatitude = std::min(query.m_latitude + span, 90.0);
+    bounds.MinLongitude = -180.0;
+    bounds.MaxLongitude = 180.0;
+    // Away from the poles the circle spans the longitudes of its tangent meridians
+    if (bounds.MinLatitude > -90.0 && bounds.MaxLatitude < 90.0)
+    {
+        const auto half_width = std::asin(std::sin(angle) / std::cos(query.m_latitude * s_radians)) / s_radians;
+        if (half_width < 180.0)
+        {
+            bounds.MinLongitude = WrapDegrees(query.m_longitude - half_width);
+            bounds.MaxLongitude = WrapDegrees(query.m_longitude + half_width);
+        }
+    }
+    return query;
+}
+
+auto CQmidQuery::Intersects(CPackedQmid cell) const -> bool
+{
+    if (!cell.IsValid())
+    {
+        return false;
+    }
+    const auto bounds = cell.Bounds();
+    if (bounds.MinLatitude > m_bounds.MaxLatitude || bounds.MaxLatitude < m_bounds.MinLatitude ||
+        !OverlapsLongitude(bounds, m_bounds))
+    {
+        return false;
+    }
+    return !m_is_radius || Distance(bounds) <= m_radius;
+}
+
+auto CQmidQuery::Contains(CPackedQmid cell) const -> bool
+{
+    // Cells of levels 0 and 1 wrap onto themselves, and are never taken whole
+    if (cell.Level() < 2)
+    {
+        return false;
+    }
+    const auto bounds = cell.Bounds();
+    if (bounds.MinLatitude < -90.0 || bounds.MaxLongitude > 180.0)
+    {
+        return false;
+    }
+    if (!m_is_radius)
+    {
+        return bounds.MinLatitude >= m_bounds.MinLatitude && bounds.MaxLatitude <= m_bounds.MaxLatitude &&
+            ContainsLongitude(m_bounds, bounds.MinLongitude, bounds.MaxLongitude);
+    }
+    // The farthest point of a cell narrower than a half turn is one of its corners
+    const auto within = [this](double latitude, double longitude)
+    {
+        return Distance(SBglRegion{longitude, latitude, longitude, latitude}) <= m_radius;
+    };
+    return within(bounds.MinLatitude, bounds.MinLongitude) && within(bounds.MinLatitude, bounds.MaxLongitude) &&
+        within(bounds.MaxLatitude, bounds.MinLongitude) && within(bounds.MaxLatitude, bounds.MaxLongitude);
+}
+
+auto CQmidQuery::Distance(const SBglRegion& cell) const -> double
+{
+    const auto width = cell.MaxLongitude - cell.MinLongitude;
+    // Degrees east of the west edge, in [0, 360)
+    const auto east = WrapDegrees(m_longitude - cell.MinLongitude - 180.0) + 180.0;
+    if (east <= width)
+    {
+        // Due north or south of the cell
+        const auto degrees = std::max({cell.MinLatitude - m_latitude, m_latitude - cell.MaxLatitude, 0.0});
+        return degrees * s_radians * s_earth_radius;
+    }
+
+    // Otherwise the nearest point lies on the closer meridian edge. Within a quarter turn that is
+    // where the great circle through the point meets the meridian at a right angle, and beyond
+    // it the distance along the edge peaks inside, so the nearer corner wins
+    const auto offset = std::min(east - width, 360.0 - east) * s_radians;
+    const auto latitude = m_latitude * s_radians;
+    const auto to_edge = [latitude, offset](double edge_latitude)
+    {
+        const auto sin_latitude = std::sin((edge_latitude - latitude) / 2);
+        const auto sin_longitude = std::sin(offset / 2);
+        const auto a =
+            sin_latitude * sin_latitude + std::cos(latitude) * std::cos(edge_latitude) * sin_longitude * sin_longitude;
+        return 2.0 * std::asin(std::sqrt(std::min(a, 1.0))) * s_earth_radius;
+    };
+    const auto min_latitude = cell.MinLatitude * s_radians;
+    const auto max_latitude = cell.MaxLatitude * s_radians;
+    if (offset < s_pi / 2)
+    {
+        return to_edge(std::clamp(std::atan(std::tan(latitude) / std::cos(offset)), min_latitude, max_latitude));
+    }
+    return std::min(to_edge(min_latitude), to_edge(max_latitude));
+}
+
+auto CQmidQuery::Cover(int level, std::vector<SQmidRange>& ranges, int max_ranges) const -> void
+{
+    ranges.clear();
+    if (level < 0 || level > CPackedQmid::s_max_level)
+    {
+        return;
+    }
+
+    // Descends from the root, taking contained cells whole and splitting the rest until the level
+    // is reached or the budget would be exceeded
+    auto cells = std::vector<uint64_t>{CPackedQmid::FromCell(0, 0, 0).Value()};
+    auto next = std::vector<uint64_t>{};
+    for (auto depth = 0; !cells.empty(); ++depth)
+    {
+        const auto shift = 2 * (level - depth);
+        const auto split =
+            depth < level && static_cast<int>(ranges.size() + 4 * cells.size()) <= std::max(max_ranges, 1);
+        next.clear();
+        for (const auto value : cells)
+        {
+            const auto cell = CPackedQmid{value};
+            if (!Intersects(cell))
+            {
+                continue;
+            }
+            const auto contained = Contains(cell);
+            if (contained || !split)
+            {
+                ranges.push_back({value << shift, (value + 1) << shift, contained});
+                continue;
+            }
+            for (auto quadrant = 0; quadrant < 4; ++quadrant)
+            {
+                next.emplace_back(cell.Child(quadrant).Value());
+            }
+        }
+        cells.swap(next);
+    }
+
+    std::sort(ranges.begin(), ranges.end(),
+        [](const SQmidRange& lhs, const SQmidRange& rhs) { return lhs.First < rhs.First; });
+    auto merged = 0;
+    for (auto i = 0; i < static_cast<int>(ranges.size()); ++i)
+    {
+        if (merged > 0 && ranges[merged - 1].End == ranges[i].First &&
+            ranges[merged - 1].Contained == ranges[i].Contained)
+        {
+            ranges[merged - 1].End = ranges[i].End;
+        }
+        else
+        {
+            ranges[merged++] = ranges[i];
+        }
+    }
+    ranges.resize(merged);
+}
+
+auto CQmidQuery::Select(const std::vector<uint64_t>& keys, int min_level, int max_level,
+    std::vector<int>& indices) const -> void
+{
+    if (keys.empty())
+    {
+        return;
+    }
+    // Levels occupy disjoint bands of values, so sorted keys bound the levels worth covering
+    min_level = std::max(min_level, CPackedQmid{keys.front()}.Level());
+    max_level = std::min({max_level, CPackedQmid{keys.back()}.Level(), CPackedQmid::s_max_level});
+
+    auto ranges = std::vector<SQmidRange>{};
+    for (auto level = std::max(min_level, 0); level <= max_level; ++level)
+    {
+        const auto band = std::lower_bound(keys.begin(), keys.end(), 2ull << (2 * level));
+        if (band == keys.end() || (level < CPackedQmid::s_max_level && *band >= 4ull << (2 * level)))
+        {
+            continue;
+        }
+        Cover(level, ranges);
+        auto it = band;
+        for (const auto& range : ranges)
+        {
+            it = std::lower_bound(it, keys.end(), range.First);
+            for (; it != keys.end() && *it < range.End; ++it)
+            {
+                if (range.Contained || Intersects(CPackedQmid{*it}))
+                {
+                    indices.emplace_back(static_cast<int>(it - keys.begin()));
+                }
+            }
+        }
+    }
+}
+
+
+}
@@ -0,0 +1,241 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+//******************************************************************************
+//
+// File:     RasterPrefetch.cpp
+//
+// Summary:  Background reads of compressed raster payloads, so a streamer can
+//           queue the tiles it will need next without blocking on each one
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "RasterPrefetch.h"
+
+#include "BglData.h"
+#include "BinaryStream.h"
+
+#include <algorithm>
+
+
+namespace flightsimlib::io
+{
+
+
+//******************************************************************************
+// SRasterReadRequest
+//******************************************************************************
+
+
+auto SRasterReadRequest::FromRaster(const ITerrainRasterQuad1& raster, uint8_t* data_buffer, uint8_t* mask_buffer)
+    -> SRasterReadRequest
+{
+    auto request = SRasterReadRequest{};
+    request.DataOffset = raster.GetDataOffset();
+    request.DataLength = raster.GetDataLength();
+    // Rasters without a mask may still carry a stale offset
+    if (raster.GetHeader().SizeMask != 0)
+    {
+        request.MaskOffset = raster.GetMaskOffset();
+        request.MaskLength = raster.GetMaskLength();
+    }
+    request.DataBuffer = data_buffer;
+    request.MaskBuffer = mask_buffer;
+    return request;
+}
+
+auto SRasterReadRequest::FromBlock(const CRasterBlock& block, uint8_t* data_buffer, uint8_t* mask_buffer)
+    -> SRasterReadRequest
+{
+    auto request = SRasterReadRequest{};
+    request.DataOffset = block.DataOffset;
+    request.DataLength = block.DataLength;
+    request.MaskOffset = block.MaskOffset;
+    request.MaskLength = block.MaskLength;
+    request.DataBuffer = data_buffer;
+    request.MaskBuffer = mask_buffer;
+    return request;
+}
+
+
+//******************************************************************************
+// CRasterPrefetchQueue
+//******************************************************************************
+
+
+struct CRasterPrefetchQueue::SBatch
+{
+    std::shared_ptr<const IPositionalStream> File;
+    std::vector<SRasterReadRequest> Requests;
+    CompletionCallback OnComplete;
+    std::promise<bool> Promise;
+    std::atomic<int> Remaining{ 0 };
+    std::atomic<bool> Success{ true };
+};
+
+
+CRasterPrefetchQueue::CRasterPrefetchQueue(int num_threads) : m_pending(0), m_stopping(false)
+{
+    if (num_threads <= 0)
+    {
+        num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    m_threads.reserve(num_threads);
+    for (auto i = 0; i < num_threads; ++i)
+    {
+        m_threads.emplace_back(&CRasterPrefetchQueue::WorkerMain, this);
+    }
+}
+
+CRasterPrefetchQueue::~CRasterPrefetchQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_job_available.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+auto CRasterPrefetchQueue::Submit(std::shared_ptr<const IPositionalStream> file, std::vector<SRasterReadRequest> batch,
+    CompletionCallback on_complete) -> std::future<bool>
+{
+    auto state = std::make_shared<SBatch>();
+    auto future = state->Promise.get_future();
+    const auto count = static_cast<int>(batch.size());
+
+    if (count == 0)
+    {
+        state->Promise.set_value(true);
+        return future;
+    }
+    if (file == nullptr)
+    {
+        state->Promise.set_value(false);
+        return future;
+    }
+
+    state->File = std::move(file);
+    state->Requests = std::move(batch);
+    state->OnComplete = std::move(on_complete);
+    state->Remaining = count;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto i = 0; i < count; ++i)
+        {
+            m_jobs.push_back({ state, i });
+        }
+        m_pending += count;
+    }
+    m_job_available.notify_all();
+
+    return future;
+}
+
+void CRasterPrefetchQueue::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_pending == 0; });
+}
+
+void CRasterPrefetchQueue::WorkerMain()
+{
+    for (;;)
+    {
+        SJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_job_available.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            // Drain remaining work before exiting so every future is satisfied
+            if (m_jobs.empty())
+            {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        auto& batch = *job.Batch;
+        const auto& request = batch.Requests[job.Index];
+        const auto success = ExecuteRequest(*batch.File, request);
+        if (!success)
+        {
+            batch.Success = false;
+        }
+
+        if (batch.OnComplete)
+        {
+            batch.OnComplete(request, success);
+        }
+
+        if (--batch.Remaining == 0)
+        {
+            batch.Promise.set_value(batch.Success);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_pending == 0)
+            {
+                m_idle.notify_all();
+            }
+        }
+    }
+}
+
+bool CRasterPrefetchQueue::ExecuteRequest(const IPositionalStream& file, const SRasterReadRequest& request)
+{
+    if (request.DataLength > 0)
+    {
+        if (request.DataBuffer == nullptr || !file.ReadAt(request.DataOffset, request.DataBuffer, request.DataLength))
+        {
+            return false;
+        }
+    }
+
+    if (request.MaskLength > 0)
+    {
+        if (request.MaskBuffer == nullptr || !file.ReadAt(request.MaskOffset, request.MaskBuffer, request.MaskLength))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+}
@@ -0,0 +1,134 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     RecordArena.cpp
+//
+// Summary:  Bump allocation for parsed records, so reading a large file does not
+//           pay for one heap allocation per record, and closing it frees them at once
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "RecordArena.h"
+
+#include <new>
+
+
+namespace flightsimlib::io
+{
+
+
+namespace
+{
+
+// Prefixed to every record block, keeping the payload at the default new alignment
+struct alignas(std::max_align_t) SRecordHeader
+{
+    CRecordArena* Arena;
+};
+
+thread_local CRecordArena* s_current_arena = nullptr;
+
+}
+
+
+//******************************************************************************
+// CRecordArena
+//******************************************************************************
+
+
+CRecordArena::CRecordArena() : m_resource(s_initial_block_size) { }
+
+auto CRecordArena::GetAllocatedBytes() const -> size_t
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_allocated;
+}
+
+auto CRecordArena::AllocateRecord(size_t size) -> void*
+{
+    auto* arena = s_current_arena;
+    const auto total = sizeof(SRecordHeader) + size;
+    auto* header = static_cast<SRecordHeader*>(
+        arena != nullptr ? arena->allocate(total, alignof(SRecordHeader)) : ::operator new(total));
+    header->Arena = arena;
+    return header + 1;
+}
+
+auto CRecordArena::FreeRecord(void* pointer) noexcept -> void
+{
+    if (pointer == nullptr)
+    {
+        return;
+    }
+    auto* header = static_cast<SRecordHeader*>(pointer) - 1;
+    // Arena blocks go back when the arena does
+    if (header->Arena == nullptr)
+    {
+        ::operator delete(header);
+    }
+}
+
+auto CRecordArena::do_allocate(size_t bytes, size_t alignment) -> void*
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_allocated += bytes;
+    return m_resource.allocate(bytes, alignment);
+}
+
+auto CRecordArena::do_deallocate(void* /*pointer*/, size_t /*bytes*/, size_t /*alignment*/) -> void
+{
+}
+
+auto CRecordArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool
+{
+    return this == &other;
+}
+
+
+//******************************************************************************
+// CRecordArenaScope
+//******************************************************************************
+
+
+CRecordArenaScope::CRecordArenaScope(CRecordArena* arena) : m_previous(s_current_arena)
+{
+    s_current_arena = arena;
+}
+
+CRecordArenaScope::~CRecordArenaScope()
+{
+    s_current_arena = m_previous;
+}
+
+
+}
@@ -0,0 +1,161 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     StringPool.cpp
+//
+// Summary:  Interned storage for the many short names of airport and navaid
+//           records, so they do not each need a heap allocation
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "StringPool.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace flightsimlib::io
+{
+
+
+//******************************************************************************
+// CStringPool
+//******************************************************************************
+
+
+auto CStringPool::Intern(std::string_view value) -> std::string_view
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto it = m_strings.find(value);
+    if (it != m_strings.end())
+    {
+        return *it;
+    }
+
+    auto* storage = Allocate(value.size() + 1);
+    std::memcpy(storage, value.data(), value.size());
+    storage[value.size()] = '\0';
+
+    const auto interned = std::string_view{ storage, value.size() };
+    m_strings.insert(interned);
+    return interned;
+}
+
+
+auto CStringPool::GetCount() const -> int
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<int>(m_strings.size());
+}
+
+
+auto CStringPool::GetAllocatedBytes() const -> size_t
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_allocated;
+}
+
+
+auto CStringPool::Allocate(size_t size) -> char*
+{
+    if (size > m_remaining)
+    {
+        // Long strings get a block of their own rather than wasting the tail of the current one
+        const auto block_size = std::max(size, s_block_size);
+        m_blocks.emplace_back(new char[block_size]);
+        m_allocated += block_size;
+        if (block_size != s_block_size)
+        {
+            return m_blocks.back().get();
+        }
+        m_cursor = m_blocks.back().get();
+        m_remaining = block_size;
+    }
+
+    auto* storage = m_cursor;
+    m_cursor += size;
+    m_remaining -= size;
+    return storage;
+}
+
+
+//******************************************************************************
+// CPooledString
+//******************************************************************************
+
+
+CPooledString::CPooledString(std::string_view value)
+{
+    if (value.size() <= s_inline_capacity)
+    {
+        AssignInline(value);
+        return;
+    }
+
+    auto copy = std::make_shared<const std::string>(value);
+    m_data = copy->c_str();
+    m_size = static_cast<uint32_t>(copy->size());
+    m_owner = std::move(copy);
+}
+
+
+CPooledString::CPooledString(std::string_view value, const std::shared_ptr<CStringPool>& pool)
+{
+    if (pool == nullptr)
+    {
+        *this = CPooledString{ value };
+        return;
+    }
+    if (value.size() <= s_inline_capacity)
+    {
+        AssignInline(value);
+        return;
+    }
+
+    const auto interned = pool->Intern(value);
+    m_data = interned.data();
+    m_size = static_cast<uint32_t>(interned.size());
+    m_owner = pool;
+}
+
+
+auto CPooledString::AssignInline(std::string_view value) -> void
+{
+    std::memcpy(m_inline, value.data(), value.size());
+    m_inline[value.size()] = '\0';
+    m_size = static_cast<uint32_t>(value.size());
+}
+
+
+}
@@ -0,0 +1,128 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     AirportTableTests.cpp
+//
+// Summary:  Nearest airport searches with and without the AVX2 scan
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Test.h"
+
+#include "BglAirportTable.h"
+#include "BglData.h"
+#include "BglFile.h"
+#include "CpuFeatures.h"
+
+#include <random>
+
+
+namespace flightsimlib::tests
+{
+
+using namespace flightsimlib::io;
+
+using EFuelAvailability = IBglFuelAvailability::EFuelAvailability;
+
+FSL_TEST(NearestAirportsMatchWithoutAvx2)
+{
+    // Airports spread over the globe, with a mix of runways, flags and fuel. The count is not a
+    // whole number of blocks, so the padding rows are scanned too
+    auto random = std::mt19937{21};
+    auto latitude = std::uniform_real_distribution<double>(-89.0, 89.0);
+    auto longitude = std::uniform_real_distribution<double>(-180.0, 180.0);
+    auto length = std::uniform_real_distribution<float>(0.0f, 4000.0f);
+    auto airports = std::vector<std::unique_ptr<CBglData>>{};
+    auto listed = std::vector<SBglQmidData>{};
+    for (auto i = 0; i < 203; ++i)
+    {
+        auto data = CBglData::Factory(EBglLayerType::AirportSummary, IBglSceneryObject::ESceneryObjectType::Unknown);
+        auto* summary = data->AsAirportSummary();
+        summary->SetLatitude(latitude(random));
+        summary->SetLongitude(longitude(random));
+        summary->SetLongestRunwayLength(length(random));
+        summary->SetIcaoIdent(static_cast<uint32_t>(1000 + i));
+        summary->SetCom(i % 2 == 0);
+        summary->SetPavedRunway(i % 3 == 0);
+        summary->SetIlsApproach(i % 5 == 0);
+        summary->Set100Octane(static_cast<EFuelAvailability>(i % 4));
+        summary->SetJetA(static_cast<EFuelAvailability>(i / 4 % 4));
+        const auto qmid = CPackedQmid::FromLatLon(summary->GetLatitude(), summary->GetLongitude(), 9);
+        airports.emplace_back(std::move(data));
+        listed.push_back({qmid, airports.back().get()});
+    }
+    auto layer = CBglIndirectQmidLayer(SBglLayerPointer{EBglLayerType::AirportSummary, 0, 0, 0, 0, 0},
+        EBglLayerType::AirportSummary);
+    layer.AddDataAtQmids(listed.data(), static_cast<int>(listed.size()));
+    auto file = CBglFile{};
+    FSL_CHECK(file.TryMergeLayer(&layer));
+
+    auto table = CBglAirportTable{};
+    table.Build(file);
+    FSL_CHECK(table.GetCount() == static_cast<int>(airports.size()));
+
+    auto filters = std::vector<SBglAirportFilter>(6);
+    filters[1].MinRunwayLength = 1500.0f;
+    filters[2].RequiredFlags = CBglAirportTable::s_flag_com | CBglAirportTable::s_flag_paved_runway;
+    filters[3].ExcludedFlags = CBglAirportTable::s_flag_ils_approach;
+    filters[4].FuelMask = 0x3u << 4;
+    filters[4].FuelValue = static_cast<uint32_t>(EFuelAvailability::Yes) << 4;
+    filters[5].MaxDistance = 5.0e6;
+
+    const double points[][2] = {{0.0, 0.0}, {47.5, -122.3}, {-33.9, 151.2}, {89.9, 179.9}, {-60.0, -179.9}};
+    for (const auto& filter : filters)
+    {
+        for (const auto& point : points)
+        {
+            for (const auto count : {1, 7, 300})
+            {
+                auto vector = std::vector<SBglAirportMatch>{};
+                auto scalar = std::vector<SBglAirportMatch>{};
+                CCpuFeatures::SetAvx2Enabled(true);
+                table.FindNearest(point[0], point[1], count, filter, vector);
+                CCpuFeatures::SetAvx2Enabled(false);
+                table.FindNearest(point[0], point[1], count, filter, scalar);
+                FSL_CHECK(!scalar.empty());
+                FSL_CHECK(vector.size() == scalar.size());
+                for (auto i = 0; i < static_cast<int>(std::min(vector.size(), scalar.size())); ++i)
+                {
+                    FSL_CHECK(vector[i].Row == scalar[i].Row);
+                    FSL_CHECK(vector[i].Distance == scalar[i].Distance);
+                }
+            }
+        }
+    }
+    CCpuFeatures::SetAvx2Enabled(true);
+}
+
+} // namespace flightsimlib::tests
@@ -0,0 +1,114 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     BinaryStreamTests.cpp
+//
+// Summary:  CBinaryReader bounds and positions, and reads served from a
+//           mapping matching reads through the file stream
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Test.h"
+#include "TestData.h"
+
+#include "BglFile.h"
+#include "BinaryStream.h"
+
+
+namespace flightsimlib::tests
+{
+
+using namespace flightsimlib::io;
+
+FSL_TEST(BinaryReaderLatchesFailureAtEnd)
+{
+    const uint8_t data[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
+    auto reader = CBinaryReader(data, static_cast<int>(sizeof(data)));
+
+    auto value = uint32_t{};
+    FSL_CHECK(reader.Read(value));
+    FSL_CHECK(value == 0x04030201u);
+    FSL_CHECK(reader.GetRemaining() == 2);
+
+    FSL_CHECK(!reader.Read(value));
+    FSL_CHECK(reader.Fail());
+    FSL_CHECK(reader.GetPosition() == -1);
+    FSL_CHECK(reader.ReadType<uint8_t>() == 0);
+
+    reader.ClearFail();
+    FSL_CHECK(reader.GetPosition() == 4);
+    FSL_CHECK(reader.ReadType<uint16_t>() == 0x0605);
+    FSL_CHECK(!reader.Fail());
+}
+
+FSL_TEST(BinaryReaderPositionsAreFileRelative)
+{
+    const uint8_t data[] = {'a', 'b', '\0', 'c', 'd'};
+    auto reader = CBinaryReader(data, static_cast<int>(sizeof(data)), 100);
+
+    FSL_CHECK(reader.GetPosition() == 100);
+    FSL_CHECK(reader.ReadCStringView() == "ab");
+    FSL_CHECK(reader.GetPosition() == 103);
+
+    reader.SetPosition(101);
+    FSL_CHECK(reader.ReadStringView(1) == "b");
+
+    reader.SetPosition(99);
+    FSL_CHECK(reader.Fail());
+}
+
+FSL_TEST(MappedReadMatchesStreamRead)
+{
+    const auto source = GetRepositoryPath("examples/decompression/DeathValley_Elevations.bgl");
+    const auto flags = {EBglReadFlags::None, EBglReadFlags::MemoryMapped};
+    auto outputs = std::vector<std::vector<uint8_t>>{};
+
+    for (const auto read_flags : flags)
+    {
+        auto file = CBglFile(source.wstring());
+        file.SetReadFlags(read_flags);
+        FSL_CHECK(file.Read());
+        FSL_CHECK(file.HasLayer(EBglLayerType::TerrainElevation));
+
+        const auto output = GetScratchPath("mapped_" + std::to_string(static_cast<int>(read_flags)) + ".bgl");
+        file.Rename(output.wstring().c_str());
+        FSL_CHECK(file.Write());
+        file.Close();
+        outputs.push_back(ReadFileBytes(output));
+    }
+
+    FSL_CHECK(!outputs[0].empty());
+    FSL_CHECK(outputs[0] == outputs[1]);
+}
+
+} // namespace flightsimlib::tests
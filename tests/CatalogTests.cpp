@@ -0,0 +1,127 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     CatalogTests.cpp
+//
+// Summary:  Locations the CBglCatalog records for the files it indexes
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Test.h"
+#include "TestData.h"
+
+#include "BglCatalog.h"
+#include "BglData.h"
+#include "BglFile.h"
+
+#include <cstring>
+
+
+namespace flightsimlib::tests
+{
+
+using namespace flightsimlib::io;
+
+// Airports built in memory do not name themselves, so each is decoded from a record with a name
+static auto MakeAirport(uint32_t icao) -> std::unique_ptr<CBglData>
+{
+    static constexpr uint32_t s_name_size = 8;
+    auto header = SBglAirportData{};
+    header.Type = 0x3C;
+    header.Size = static_cast<uint32_t>(sizeof(SBglAirportData)) + s_name_size;
+    header.IcaoIdent = icao;
+
+    auto bytes = std::vector<uint8_t>(header.Size);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    const auto name_type = static_cast<uint16_t>(EBglLayerType::Name);
+    std::memcpy(&bytes[sizeof(header)], &name_type, sizeof(name_type));
+    std::memcpy(&bytes[sizeof(header) + sizeof(name_type)], &s_name_size, sizeof(s_name_size));
+    std::memcpy(&bytes[header.Size - 2], "AB", 2);
+
+    auto in = BinaryFileStream{};
+    in.OpenView(bytes.data(), static_cast<int>(bytes.size()), 0);
+    auto data = CBglData::Factory(EBglLayerType::Airport, IBglSceneryObject::ESceneryObjectType::Unknown);
+    data->ReadBinary(in);
+    return data;
+}
+
+FSL_TEST(CatalogLocatesEachAirportRecord)
+{
+    const auto root = GetScratchPath("catalog");
+    std::filesystem::create_directories(root);
+
+    // Each airport is listed under its own tile, and the first also under the last tile, so tile
+    // entries and records are numbered differently
+    auto qmids = std::vector<CPackedQmid>{CPackedQmid::FromCell(9, 30, 20), CPackedQmid::FromCell(9, 20, 20),
+        CPackedQmid::FromCell(9, 10, 20)};
+    auto airports = std::vector<std::unique_ptr<CBglData>>{};
+    auto listed = std::vector<SBglQmidData>{};
+    for (auto i = 0; i < static_cast<int>(qmids.size()); ++i)
+    {
+        airports.emplace_back(MakeAirport(static_cast<uint32_t>(100 + i)));
+        listed.push_back({qmids[i], airports.back().get()});
+    }
+    listed.push_back({qmids.back(), airports.front().get()});
+
+    auto layer = CBglIndirectQmidLayer(SBglLayerPointer{EBglLayerType::Airport, 0, 0, 0, 0, 0}, EBglLayerType::Airport);
+    layer.AddDataAtQmids(listed.data(), static_cast<int>(listed.size()));
+    auto file = CBglFile{};
+    FSL_CHECK(file.TryMergeLayer(&layer));
+    file.Rename((root / "airports.bgl").wstring().c_str());
+    FSL_CHECK(file.Write());
+
+    auto catalog = CBglCatalog(root);
+    FSL_CHECK(catalog.Update());
+    FSL_CHECK(catalog.GetFileCount() == 1);
+
+    // The extent of each airport is its own record, whose header holds its size and ICAO
+    const auto bytes = ReadFileBytes(root / "airports.bgl");
+    for (auto i = 0; i < static_cast<int>(qmids.size()); ++i)
+    {
+        auto locations = std::vector<SBglCatalogLocation>{};
+        FSL_CHECK(catalog.FindIcao(static_cast<uint32_t>(100 + i), locations) == 1);
+        if (locations.size() != 1 || locations[0].StreamOffset + locations[0].SizeBytes > bytes.size())
+        {
+            FSL_CHECK(false);
+            continue;
+        }
+        auto header = SBglAirportData{};
+        std::memcpy(&header, &bytes[locations[0].StreamOffset], sizeof(header));
+        FSL_CHECK(locations[0].LayerType == EBglLayerType::Airport);
+        FSL_CHECK(header.IcaoIdent == static_cast<uint32_t>(100 + i));
+        FSL_CHECK(header.Size == locations[0].SizeBytes);
+        FSL_CHECK(header.Size == static_cast<uint32_t>(airports[i]->CalculateSize()));
+    }
+}
+
+} // namespace flightsimlib::tests
@@ -0,0 +1,117 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     CopyOnWriteTests.cpp
+//
+// Summary:  Records that share their storage through CCopyOnWrite, which only
+//           copies it when a record is changed
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Test.h"
+#include "TestData.h"
+
+#include "BglData.h"
+#include "BglFile.h"
+#include "CopyOnWrite.h"
+
+
+namespace flightsimlib::tests
+{
+
+using namespace flightsimlib::io;
+
+FSL_TEST(CopyOnWriteCopiesOnlyWhenShared)
+{
+    const auto detaches = GetCopyOnWriteDetachCount();
+
+    auto value = CCopyOnWrite<int>(1);
+    value.write() = 2;
+    auto copy = value;
+    FSL_CHECK(copy.identity(value));
+    FSL_CHECK(*copy == 2);
+
+    copy.write() = 3;
+    FSL_CHECK(!copy.identity(value));
+    FSL_CHECK(*value == 2 && *copy == 3);
+    copy.write() = 4;
+
+#ifndef NDEBUG
+    FSL_CHECK(GetCopyOnWriteDetachCount() - detaches == 1);
+#else
+    FSL_CHECK(GetCopyOnWriteDetachCount() == detaches);
+#endif
+}
+
+FSL_TEST(ReadingRecordsCopiesNothing)
+{
+    const auto path = GetScratchPath("copy_on_write_markers.bgl");
+    FSL_CHECK(WriteMarkerFile(path, {CPackedQmid::FromCell(9, 4, 4), CPackedQmid::FromCell(9, 5, 4)}));
+
+    auto file = CBglFile(path.wstring());
+    FSL_CHECK(file.Read());
+    auto* layer = file.GetIndirectQmidLayer(EBglLayerType::Marker);
+    FSL_CHECK(layer != nullptr);
+    if (layer == nullptr)
+    {
+        return;
+    }
+
+    const auto detaches = GetCopyOnWriteDetachCount();
+
+    // Clones share the storage of the records they were made from
+    auto clones = std::vector<std::unique_ptr<CBglData>>{};
+    for (auto i = 0; i < layer->GetDataCount(); ++i)
+    {
+        clones.emplace_back(static_cast<const CBglData*>(layer->GetDataAtIndex(i))->Clone());
+    }
+    auto altitudes = 0.0;
+    file.ForEach<CBglMarker>([&altitudes](const CBglMarker& marker) { altitudes += marker.GetAltitude(); });
+    for (const auto& clone : clones)
+    {
+        altitudes += clone->AsMarker()->GetAltitude();
+    }
+    FSL_CHECK(altitudes == 2.0);
+    FSL_CHECK(GetCopyOnWriteDetachCount() == detaches);
+
+    // Changing a clone copies its storage, and leaves the record it was cloned from alone
+    const auto original = layer->GetDataAtIndex(0)->AsMarker()->GetAltitude();
+    clones[0]->AsMarker()->SetAltitude(10.0);
+    FSL_CHECK(clones[0]->AsMarker()->GetAltitude() == 10.0);
+    FSL_CHECK(layer->GetDataAtIndex(0)->AsMarker()->GetAltitude() == original);
+#ifndef NDEBUG
+    FSL_CHECK(GetCopyOnWriteDetachCount() - detaches == 1);
+#endif
+}
+
+} // namespace flightsimlib::tests
@@ -0,0 +1,354 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     DirectLayerTests.cpp
+//
+// Summary:  Tile lookups of the flat CBglDirectQmidLayer store against a map,
+//           QMIDs that repeat in the tile table of a file, and tile stores
+//           shared between layers
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Test.h"
+#include "TestData.h"
+
+#include "BglData.h"
+#include "BglFile.h"
+
+#include <cstring>
+#include <map>
+#include <random>
+#include <thread>
+
+
+namespace flightsimlib::tests
+{
+
+using namespace flightsimlib::io;
+
+static auto MakeElevationRecord() -> std::unique_ptr<CBglData>
+{
+    return CBglData::Factory(EBglLayerType::TerrainElevation, IBglSceneryObject::ESceneryObjectType::Unknown);
+}
+
+static auto GetSamplePath() -> std::filesystem::path
+{
+    return GetRepositoryPath("examples/decompression/DeathValley_Elevations.bgl");
+}
+
+// Visits every record of every tile, and returns how many were there
+static auto CountRecords(const CBglDirectQmidLayer& layer) -> int
+{
+    auto count = 0;
+    for (auto i = 0; i < layer.GetQmidCount(); ++i)
+    {
+        const auto* tile = layer.GetDataPointerAtIndex(i);
+        const auto qmid = CPackedQmid{tile->QmidLow, tile->QmidHigh};
+        for (auto j = 0; layer.GetDataAtQmid(qmid, j) != nullptr; ++j)
+        {
+            ++count;
+        }
+    }
+    return count;
+}
+
+FSL_TEST(DirectLayerLookupsMatchMap)
+{
+    auto random = std::mt19937(1234);
+    auto cell = std::uniform_int_distribution<uint32_t>(0, 63);
+
+    auto layer = CBglDirectQmidLayer(
+        SBglLayerPointer{EBglLayerType::TerrainElevation, 0, 0, 0, 0, 0}, EBglLayerType::TerrainElevation);
+    auto expected = std::map<CPackedQmid, int>{};
+
+    // Two batches, so the second one merges into existing tiles as well as adding new ones
+    for (auto batch = 0; batch < 2; ++batch)
+    {
+        auto records = BglQmidRecords{};
+        for (auto i = 0; i < 500; ++i)
+        {
+            const auto qmid = CPackedQmid::FromCell(6, cell(random), cell(random) % 32);
+            records.emplace_back(qmid, MakeElevationRecord());
+            ++expected[qmid];
+        }
+        layer.AddDataAtQmids(std::move(records));
+    }
+
+    FSL_CHECK(layer.GetQmidCount() == static_cast<int>(expected.size()));
+    auto mismatches = 0;
+    for (auto u = 0u; u < 64; ++u)
+    {
+        for (auto v = 0u; v < 32; ++v)
+        {
+            const auto qmid = CPackedQmid::FromCell(6, u, v);
+            const auto it = expected.find(qmid);
+            const auto count = it != expected.end() ? it->second : 0;
+            mismatches += layer.HasQmid(qmid) != (count > 0);
+            mismatches += layer.GetDataCountAtQmid(qmid) != count;
+        }
+    }
+    FSL_CHECK(mismatches == 0);
+    FSL_CHECK(!layer.HasQmid(CPackedQmid::FromCell(7, 0, 0)));
+}
+
+FSL_TEST(RepeatedQmidReadsEveryEntry)
+{
+    const auto path = GetScratchPath("repeated_qmid.bgl");
+    auto bytes = ReadFileBytes(GetSamplePath());
+    FSL_CHECK(bytes.size() > sizeof(SBglHeader) + sizeof(SBglLayerPointer));
+    if (bytes.size() <= sizeof(SBglHeader) + sizeof(SBglLayerPointer))
+    {
+        return;
+    }
+
+    // Give the second and third entries of the tile table the QMID of the first one. The sample
+    // has no high QMID words, so an entry starts with the low word
+    auto pointer = SBglLayerPointer{};
+    std::memcpy(&pointer, &bytes[sizeof(SBglHeader)], sizeof(pointer));
+    FSL_CHECK(pointer.Type == EBglLayerType::TerrainElevation && pointer.HasQmidHigh == 0);
+    const auto table = static_cast<size_t>(pointer.StreamOffset);
+    const auto entry_size = static_cast<size_t>(pointer.SizeBytes / pointer.TileCount);
+    for (auto entry = 1; entry <= 2; ++entry)
+    {
+        std::memcpy(&bytes[table + entry * entry_size], &bytes[table], sizeof(uint32_t));
+    }
+    FSL_CHECK(WriteFileBytes(path, bytes));
+
+    auto repeated_low = uint32_t{};
+    std::memcpy(&repeated_low, &bytes[table], sizeof(repeated_low));
+    const auto repeated = CPackedQmid{repeated_low, 0u};
+    const auto all_flags = {EBglReadFlags::None, EBglReadFlags::IndexOnly,
+        EBglReadFlags::IndexOnly | EBglReadFlags::MemoryMapped, EBglReadFlags::Coalesced, EBglReadFlags::Parallel};
+    for (const auto flags : all_flags)
+    {
+        auto file = CBglFile(path.wstring());
+        file.SetReadFlags(flags);
+        FSL_CHECK(file.Read());
+
+        auto* layer = file.GetDirectQmidLayer(EBglLayerType::TerrainElevation);
+        FSL_CHECK(layer != nullptr);
+        if (layer == nullptr)
+        {
+            continue;
+        }
+        FSL_CHECK(layer->GetQmidCount() == static_cast<int>(pointer.TileCount) - 2);
+
+        auto total = 0;
+        for (auto i = 0; i < layer->GetQmidCount(); ++i)
+        {
+            const auto* tile = layer->GetDataPointerAtIndex(i);
+            const auto qmid = CPackedQmid{tile->QmidLow, tile->QmidHigh};
+            const auto count = layer->GetDataCountAtQmid(qmid);
+            FSL_CHECK(count == static_cast<int>(tile->RecordCount));
+            for (auto j = 0; j < count; ++j)
+            {
+                total += layer->GetDataAtQmid(qmid, j) != nullptr;
+            }
+        }
+        FSL_CHECK(total == static_cast<int>(pointer.TileCount));
+        FSL_CHECK(layer->GetDataCountAtQmid(repeated) == 3);
+    }
+}
+
+FSL_TEST(EditingCloneLeavesSharedStore)
+{
+    auto layer = CBglDirectQmidLayer(
+        SBglLayerPointer{EBglLayerType::TerrainElevation, 0, 0, 0, 0, 0}, EBglLayerType::TerrainElevation);
+    const auto qmid = CPackedQmid::FromCell(4, 1, 2);
+    auto records = BglQmidRecords{};
+    records.emplace_back(qmid, MakeElevationRecord());
+    records.emplace_back(qmid, MakeElevationRecord());
+    layer.AddDataAtQmids(std::move(records));
+
+    auto clone = CBglDirectQmidLayer(layer);
+    FSL_CHECK(clone.IsSharingTiles(layer));
+
+    clone.RemoveDataAtQmid(qmid, 0);
+    FSL_CHECK(!clone.IsSharingTiles(layer));
+    FSL_CHECK(clone.GetDataCountAtQmid(qmid) == 1);
+    FSL_CHECK(layer.GetDataCountAtQmid(qmid) == 2);
+    FSL_CHECK(clone.GetDataAtQmid(qmid, 0) != layer.GetDataAtQmid(qmid, 0));
+}
+
+FSL_TEST(LookupsKeepStoreShared)
+{
+    auto layer = CBglDirectQmidLayer(
+        SBglLayerPointer{EBglLayerType::TerrainElevation, 0, 0, 0, 0, 0}, EBglLayerType::TerrainElevation);
+    const auto qmid = CPackedQmid::FromCell(4, 1, 2);
+    auto records = BglQmidRecords{};
+    records.emplace_back(qmid, MakeElevationRecord());
+    records.emplace_back(qmid, MakeElevationRecord());
+    layer.AddDataAtQmids(std::move(records));
+
+    auto clone = CBglDirectQmidLayer(layer);
+    const auto& original = layer;
+    const auto& reader = clone;
+    FSL_CHECK(clone.HasQmid(qmid));
+    FSL_CHECK(clone.GetDataCountAtQmid(qmid) == 2);
+    FSL_CHECK(reader.GetDataAtQmid(qmid, 1) == original.GetDataAtQmid(qmid, 1));
+    FSL_CHECK(CountRecords(clone) == 2);
+    FSL_CHECK(clone.IsSharingTiles(layer));
+
+    // Only a record that may be edited takes a copy of the tiles
+    FSL_CHECK(clone.GetDataAtQmid(qmid, 1) != nullptr);
+    FSL_CHECK(!clone.IsSharingTiles(layer));
+}
+
+FSL_TEST(WritingSharedLayerKeepsStoreShared)
+{
+    auto file = CBglFile(GetSamplePath().wstring());
+    FSL_CHECK(file.Read());
+    auto* layer = dynamic_cast<CBglDirectQmidLayer*>(file.GetDirectQmidLayer(EBglLayerType::TerrainElevation));
+    FSL_CHECK(layer != nullptr);
+    if (layer == nullptr)
+    {
+        return;
+    }
+    const auto clone = CBglDirectQmidLayer(*layer);
+    const auto first_offset = clone.GetDataPointerAtIndex(0)->StreamOffset;
+
+    const auto path = GetScratchPath("shared_store.bgl");
+    file.Rename(path.wstring().c_str());
+    FSL_CHECK(file.Write());
+    FSL_CHECK(clone.IsSharingTiles(*layer));
+    FSL_CHECK(clone.GetDataPointerAtIndex(0)->StreamOffset == first_offset);
+    FSL_CHECK(CountRecords(*layer) == CountRecords(clone));
+}
+
+FSL_TEST(ConcurrentReadersDecodeEachTileOnce)
+{
+    auto file = CBglFile(GetSamplePath().wstring());
+    file.SetReadFlags(EBglReadFlags::IndexOnly);
+    FSL_CHECK(file.Read());
+    const auto* layer =
+        dynamic_cast<const CBglDirectQmidLayer*>(file.GetDirectQmidLayer(EBglLayerType::TerrainElevation));
+    FSL_CHECK(layer != nullptr);
+    if (layer == nullptr)
+    {
+        return;
+    }
+
+    auto counts = std::vector<int>(4);
+    auto readers = std::vector<std::thread>{};
+    for (auto& count : counts)
+    {
+        readers.emplace_back([layer, &count] { count = CountRecords(*layer); });
+    }
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+    for (const auto count : counts)
+    {
+        FSL_CHECK(count == layer->GetQmidCount());
+    }
+    FSL_CHECK(layer->GetRecords()->size() == static_cast<size_t>(layer->GetQmidCount()));
+}
+
+// Writes a copy of the sample whose first tile points past the end of the file, and returns that
+// tile. Read index only, the tile is left pending and fails to decode
+static auto WriteBadTileFile(const std::filesystem::path& path) -> CPackedQmid
+{
+    auto bytes = ReadFileBytes(GetSamplePath());
+    auto pointer = SBglLayerPointer{};
+    std::memcpy(&pointer, &bytes[sizeof(SBglHeader)], sizeof(pointer));
+
+    const auto offset = static_cast<uint32_t>(bytes.size());
+    std::memcpy(&bytes[pointer.StreamOffset + 2 * sizeof(uint32_t)], &offset, sizeof(offset));
+    FSL_CHECK(WriteFileBytes(path, bytes));
+
+    auto low = uint32_t{};
+    std::memcpy(&low, &bytes[pointer.StreamOffset], sizeof(low));
+    return CPackedQmid{low, 0u};
+}
+
+FSL_TEST(FailedTileLoadStaysPending)
+{
+    const auto path = GetScratchPath("bad_tile.bgl");
+    const auto bad = WriteBadTileFile(path);
+    auto file = CBglFile(path.wstring());
+    file.SetReadFlags(EBglReadFlags::IndexOnly);
+    FSL_CHECK(file.Read());
+    auto* layer = dynamic_cast<CBglDirectQmidLayer*>(file.GetDirectQmidLayer(EBglLayerType::TerrainElevation));
+    FSL_CHECK(layer != nullptr);
+    if (layer == nullptr)
+    {
+        return;
+    }
+
+    FSL_CHECK(layer->GetDataAtQmid(bad, 0) == nullptr);
+    FSL_CHECK(CountRecords(*layer) == layer->GetQmidCount() - 1);
+    FSL_CHECK(layer->GetDataAtQmid(bad, 0) == nullptr);
+    FSL_CHECK(!layer->Materialize());
+}
+
+FSL_TEST(AddingToUndecodableTileFails)
+{
+    const auto path = GetScratchPath("bad_tile_add.bgl");
+    const auto bad = WriteBadTileFile(path);
+    auto file = CBglFile(path.wstring());
+    file.SetReadFlags(EBglReadFlags::IndexOnly);
+    FSL_CHECK(file.Read());
+    auto* layer = dynamic_cast<CBglDirectQmidLayer*>(file.GetDirectQmidLayer(EBglLayerType::TerrainElevation));
+    FSL_CHECK(layer != nullptr);
+    if (layer == nullptr)
+    {
+        return;
+    }
+
+    // Records for a tile that cannot be decoded are not added ahead of its own, and neither are the
+    // rest of the batch
+    const auto other = CPackedQmid{bad.Low() + 1, 0u};
+    const auto qmid_count = layer->GetQmidCount();
+    auto records = BglQmidRecords{};
+    records.emplace_back(bad, MakeElevationRecord());
+    records.emplace_back(other, MakeElevationRecord());
+    FSL_CHECK(!layer->AddDataAtQmids(std::move(records)));
+    FSL_CHECK(layer->GetQmidCount() == qmid_count);
+    FSL_CHECK(layer->GetDataAtQmid(bad, 0) == nullptr);
+    FSL_CHECK(!layer->HasQmid(other));
+
+    const auto record = MakeElevationRecord();
+    const auto cloned = SBglQmidData{bad, record.get()};
+    FSL_CHECK(!layer->AddDataAtQmids(&cloned, 1));
+    FSL_CHECK(layer->GetQmidCount() == qmid_count);
+
+    // A batch that leaves the tile alone goes in
+    records = BglQmidRecords{};
+    records.emplace_back(other, MakeElevationRecord());
+    FSL_CHECK(layer->AddDataAtQmids(std::move(records)));
+    FSL_CHECK(layer->GetQmidCount() == qmid_count + 1);
+    FSL_CHECK(layer->GetDataCountAtQmid(other) == 1);
+}
+
+} // namespace flightsimlib::tests
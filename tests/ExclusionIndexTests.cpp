@@ -0,0 +1,114 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     ExclusionIndexTests.cpp
+//
+// Summary:  Exclusion tests of many positions with and without the AVX2 scan
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Test.h"
+
+#include "BglData.h"
+#include "BglExclusionIndex.h"
+#include "CpuFeatures.h"
+
+#include <random>
+
+
+namespace flightsimlib::tests
+{
+
+using namespace flightsimlib::io;
+
+using ESceneryObjectType = IBglSceneryObject::ESceneryObjectType;
+
+FSL_TEST(ExcludedPositionsMatchWithoutAvx2)
+{
+    // Mostly small rectangles filed under their cells, a few wide enough to be tested for every
+    // position, each excluding all objects or a few of the types
+    auto random = std::mt19937{25};
+    auto latitude = std::uniform_real_distribution<double>(-89.0, 89.0);
+    auto longitude = std::uniform_real_distribution<double>(-179.0, 179.0);
+    auto extent = std::uniform_real_distribution<double>(0.0, 2.0);
+    auto index = CBglExclusionIndex{};
+    for (auto i = 0; i < 500; ++i)
+    {
+        const auto wide = i % 50 == 0 ? 15.0 : 1.0;
+        const auto min_latitude = latitude(random);
+        const auto min_longitude = longitude(random);
+        auto exclusion = CBglExclusion{};
+        exclusion.SetMinLatitude(min_latitude);
+        exclusion.SetMaxLatitude(std::min(min_latitude + wide * extent(random), 90.0));
+        exclusion.SetMinLongitude(min_longitude);
+        exclusion.SetMaxLongitude(std::min(min_longitude + wide * extent(random), 180.0));
+        if (i % 3 == 0)
+        {
+            exclusion.SetAll(true);
+        }
+        else
+        {
+            exclusion.SetGenericBuilding(i % 3 == 1);
+            exclusion.SetLibraryObject(i % 4 == 1);
+            exclusion.SetWindsock(i % 7 == 1);
+        }
+        index.Add(exclusion);
+    }
+    index.Build();
+
+    auto latitudes = std::vector<double>(20000);
+    auto longitudes = std::vector<double>(latitudes.size());
+    for (auto i = 0; i < static_cast<int>(latitudes.size()); ++i)
+    {
+        latitudes[i] = latitude(random);
+        longitudes[i] = longitude(random);
+    }
+    for (const auto type : {ESceneryObjectType::GenericBuilding, ESceneryObjectType::LibraryObject,
+             ESceneryObjectType::Windsock, ESceneryObjectType::Beacon})
+    {
+        auto vector = std::vector<uint64_t>{};
+        auto scalar = std::vector<uint64_t>{};
+        CCpuFeatures::SetAvx2Enabled(true);
+        const auto vector_count =
+            index.FilterExcluded(latitudes.data(), longitudes.data(), static_cast<int>(latitudes.size()), type, vector);
+        CCpuFeatures::SetAvx2Enabled(false);
+        const auto scalar_count =
+            index.FilterExcluded(latitudes.data(), longitudes.data(), static_cast<int>(latitudes.size()), type, scalar);
+        FSL_CHECK(scalar_count > 0 && scalar_count < static_cast<int>(latitudes.size()));
+        FSL_CHECK(vector_count == scalar_count);
+        FSL_CHECK(vector == scalar);
+    }
+    CCpuFeatures::SetAvx2Enabled(true);
+}
+
+} // namespace flightsimlib::tests
@@ -0,0 +1,138 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     ForEachTests.cpp
+//
+// Summary:  Typed traversal with CBglFile::ForEach against probing records
+//           with the As*() accessors
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Test.h"
+#include "TestData.h"
+
+#include "BglData.h"
+#include "BglFile.h"
+
+
+namespace flightsimlib::tests
+{
+
+using namespace flightsimlib::io;
+
+static auto WriteMarkers(const std::filesystem::path& path) -> bool
+{
+    return WriteMarkerFile(path, {CPackedQmid::FromCell(9, 1, 1), CPackedQmid::FromCell(9, 2, 1),
+                                     CPackedQmid::FromCell(9, 2, 1), CPackedQmid::FromCell(9, 3, 7)});
+}
+
+FSL_TEST(ForEachVisitsRecordsOfItsType)
+{
+    const auto path = GetScratchPath("for_each_markers.bgl");
+    FSL_CHECK(WriteMarkers(path));
+
+    for (const auto flags : {EBglReadFlags::None, EBglReadFlags::IndexOnly})
+    {
+        auto file = CBglFile(path.wstring());
+        file.SetReadFlags(flags);
+        FSL_CHECK(file.Read());
+
+        auto altitudes = 0.0;
+        FSL_CHECK(file.ForEach<CBglMarker>([&altitudes](const CBglMarker& marker)
+                      { altitudes += marker.GetAltitude(); }) == 4);
+        FSL_CHECK(altitudes == 6.0);
+        FSL_CHECK(file.ForEach<CBglNav>([](const CBglNav&) {}) == 0);
+    }
+}
+
+FSL_TEST(ForEachMatchesAccessorProbing)
+{
+    auto file = CBglFile(GetRepositoryPath("examples/decompression/DeathValley_Elevations.bgl").wstring());
+    FSL_CHECK(file.Read());
+
+    auto* layer = file.GetDirectQmidLayer(EBglLayerType::TerrainElevation);
+    FSL_CHECK(layer != nullptr);
+    if (layer == nullptr)
+    {
+        return;
+    }
+    auto probed_count = 0;
+    auto probed_length = int64_t{};
+    for (auto i = 0; i < layer->GetQmidCount(); ++i)
+    {
+        const auto* tile = layer->GetDataPointerAtIndex(i);
+        const auto qmid = CPackedQmid{tile->QmidLow, tile->QmidHigh};
+        for (auto j = 0; j < layer->GetDataCountAtQmid(qmid); ++j)
+        {
+            auto* data = layer->GetDataAtQmid(qmid, j);
+            if (data->AsTerrainElevation() != nullptr)
+            {
+                ++probed_count;
+                probed_length += data->AsRasterQuad1()->GetDataLength();
+            }
+        }
+    }
+
+    FSL_CHECK(file.ForEach<CBglTerrainElevation>([](const CBglTerrainElevation&) {}) == probed_count);
+
+    // Every terrain raster is a CTerrainRasterQuad1, so this also visits the other raster layers
+    auto length = int64_t{};
+    auto elevation_length = int64_t{};
+    FSL_CHECK(file.ForEach<CTerrainRasterQuad1>(
+                  [&](const CTerrainRasterQuad1& raster)
+                  {
+                      length += raster.GetDataLength();
+                      elevation_length += dynamic_cast<const CBglTerrainElevation*>(&raster) != nullptr
+                                              ? raster.GetDataLength()
+                                              : 0;
+                  }) >= probed_count);
+    FSL_CHECK(elevation_length == probed_length);
+    FSL_CHECK(length >= probed_length);
+}
+
+FSL_TEST(ForEachReportsRecordsThatFailToDecode)
+{
+    const auto path = GetScratchPath("for_each_markers_bad.bgl");
+    FSL_CHECK(WriteMarkers(path));
+    FSL_CHECK(MisstateMarkerSize(path, 1));
+
+    auto file = CBglFile(path.wstring());
+    file.SetReadFlags(EBglReadFlags::IndexOnly);
+    FSL_CHECK(file.Read());
+
+    auto visited = 0;
+    FSL_CHECK(file.ForEach<CBglMarker>([&visited](const CBglMarker&) { ++visited; }) == -1);
+    FSL_CHECK(visited == 0);
+}
+
+} // namespace flightsimlib::tests
@@ -0,0 +1,244 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     IndirectLayerTests.cpp
+//
+// Summary:  Records of CBglIndirectQmidLayer listed under their tiles after a
+//           read, copies of those records, and records removed from a layer
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Test.h"
+#include "TestData.h"
+
+#include "BglData.h"
+#include "BglFile.h"
+
+
+namespace flightsimlib::tests
+{
+
+using namespace flightsimlib::io;
+
+static auto MakeMarker(double altitude) -> std::unique_ptr<CBglData>
+{
+    auto data = CBglData::Factory(EBglLayerType::Marker, IBglSceneryObject::ESceneryObjectType::Unknown);
+    data->AsMarker()->SetAltitude(altitude);
+    return data;
+}
+
+FSL_TEST(ClonedRecordsCopyTheirSource)
+{
+    const auto marker = MakeMarker(5.0);
+    const auto clone = marker->Clone();
+    FSL_CHECK(clone != nullptr && clone->AsMarker()->GetAltitude() == 5.0);
+
+    // Adding by pointer clones the record into the layer
+    auto layer = CBglIndirectQmidLayer(SBglLayerPointer{EBglLayerType::Marker, 0, 0, 0, 0, 0}, EBglLayerType::Marker);
+    auto qmid = CPackedQmid::FromCell(9, 10, 20);
+    layer.AddDataAtQmids(&qmid, 1, marker.get());
+    FSL_CHECK(layer.GetDataCount() == 1);
+    FSL_CHECK(layer.GetDataAtIndex(0)->AsMarker()->GetAltitude() == 5.0);
+}
+
+FSL_TEST(IndirectLayerReportsItsClass)
+{
+    const auto path = GetScratchPath("class_markers.bgl");
+    FSL_CHECK(WriteMarkerFile(path, {CPackedQmid::FromCell(9, 10, 20)}));
+
+    auto file = CBglFile(path.wstring());
+    FSL_CHECK(file.Read());
+    const auto* layer = dynamic_cast<CBglLayer*>(file.GetIndirectQmidLayer(EBglLayerType::Marker));
+    FSL_CHECK(layer != nullptr && layer->GetClass() == EBglLayerClass::IndirectQmid);
+}
+
+FSL_TEST(ReadListsEachRecordUnderItsTile)
+{
+    // Records are written in this order, and their tiles in QMID order, so the two differ
+    const auto qmids = std::vector<CPackedQmid>{CPackedQmid::FromCell(9, 40, 20), CPackedQmid::FromCell(9, 30, 20),
+        CPackedQmid::FromCell(9, 40, 20), CPackedQmid::FromCell(9, 10, 20)};
+    const auto path = GetScratchPath("mapped_markers.bgl");
+    FSL_CHECK(WriteMarkerFile(path, qmids));
+
+    auto file = CBglFile(path.wstring());
+    FSL_CHECK(file.Read());
+    auto* layer = file.GetIndirectQmidLayer(EBglLayerType::Marker);
+    FSL_CHECK(layer != nullptr);
+    if (layer == nullptr)
+    {
+        return;
+    }
+    FSL_CHECK(layer->GetQmidCount() == 3);
+
+    // The altitude of each marker is its index in qmids
+    auto listed = std::vector<int>(qmids.size());
+    for (const auto qmid : {qmids[0], qmids[1], qmids[3]})
+    {
+        for (auto i = 0; i < layer->GetDataCountAtQmid(qmid); ++i)
+        {
+            auto* data = layer->GetDataAtIndex(layer->GetDataIndexAtQmid(qmid, i));
+            FSL_CHECK(data != nullptr);
+            if (data == nullptr)
+            {
+                continue;
+            }
+            const auto index = static_cast<int>(data->AsMarker()->GetAltitude());
+            FSL_CHECK(qmids[index] == qmid);
+            ++listed[index];
+        }
+    }
+    FSL_CHECK(listed == std::vector<int>(qmids.size(), 1));
+}
+
+// Sums the altitudes of the records each tile of the layer lists, so that a record listed under
+// two tiles is counted twice
+static auto SumListedAltitudes(CBglIndirectQmidLayer& layer, const std::vector<CPackedQmid>& qmids) -> double
+{
+    auto sum = 0.0;
+    for (const auto qmid : qmids)
+    {
+        for (auto i = 0; i < layer.GetDataCountAtQmid(qmid); ++i)
+        {
+            auto* data = layer.GetDataAtIndex(layer.GetDataIndexAtQmid(qmid, i));
+            FSL_CHECK(data != nullptr);
+            sum += data != nullptr ? data->AsMarker()->GetAltitude() : 0.0;
+        }
+    }
+    return sum;
+}
+
+FSL_TEST(RemovedRecordsKeepTheirIndices)
+{
+    auto layer = CBglIndirectQmidLayer(SBglLayerPointer{EBglLayerType::Marker, 0, 0, 0, 0, 0}, EBglLayerType::Marker);
+    auto qmids = std::vector<CPackedQmid>{CPackedQmid::FromCell(9, 10, 20), CPackedQmid::FromCell(9, 20, 20),
+        CPackedQmid::FromCell(9, 30, 20)};
+    for (auto i = 0; i < 3; ++i)
+    {
+        const auto marker = MakeMarker(static_cast<double>(i + 1));
+        layer.AddDataAtQmids(&qmids[i], 1, marker.get());
+    }
+    // The fourth record is listed under the first two tiles, and is the only record of the third
+    const auto shared = MakeMarker(10.0);
+    layer.AddDataAtQmids(qmids.data(), 3, shared.get());
+    FSL_CHECK(SumListedAltitudes(layer, qmids) == 36.0);
+
+    layer.RemoveDataAtIndex(2);
+    FSL_CHECK(layer.GetDataCount() == 4);
+    FSL_CHECK(layer.GetRemovedCount() == 1);
+    FSL_CHECK(layer.GetDataAtIndex(2) == nullptr);
+    FSL_CHECK(layer.GetDataAtIndex(3)->AsMarker()->GetAltitude() == 10.0);
+    FSL_CHECK(layer.GetDataCountAtQmid(qmids[2]) == 1);
+    FSL_CHECK(SumListedAltitudes(layer, qmids) == 33.0);
+
+    // Removing the shared record takes it out of every tile, and empties the third
+    layer.RemoveDataAtIndex(3);
+    FSL_CHECK(layer.GetRemovedCount() == 2);
+    FSL_CHECK(layer.GetQmidCount() == 2);
+    FSL_CHECK(!layer.HasQmid(qmids[2]));
+    FSL_CHECK(layer.GetDataCountAtQmid(qmids[0]) == 1 && layer.GetDataCountAtQmid(qmids[1]) == 1);
+    FSL_CHECK(SumListedAltitudes(layer, qmids) == 3.0);
+
+    // Removing a record twice changes nothing
+    layer.RemoveDataAtIndex(3);
+    FSL_CHECK(layer.GetRemovedCount() == 2);
+}
+
+FSL_TEST(CompactRenumbersLiveRecords)
+{
+    auto layer = CBglIndirectQmidLayer(SBglLayerPointer{EBglLayerType::Marker, 0, 0, 0, 0, 0}, EBglLayerType::Marker);
+    auto qmids = std::vector<CPackedQmid>{CPackedQmid::FromCell(9, 10, 20), CPackedQmid::FromCell(9, 20, 20)};
+    for (auto i = 0; i < 4; ++i)
+    {
+        const auto marker = MakeMarker(static_cast<double>(i + 1));
+        layer.AddDataAtQmids(&qmids[i % 2], 1, marker.get());
+    }
+    layer.RemoveDataAtIndex(0);
+    layer.RemoveDataAtIndex(2);
+    layer.Compact();
+
+    FSL_CHECK(layer.GetDataCount() == 2);
+    FSL_CHECK(layer.GetRemovedCount() == 0);
+    FSL_CHECK(layer.GetQmidCount() == 1);
+    FSL_CHECK(!layer.HasQmid(qmids[0]));
+    FSL_CHECK(layer.GetDataAtIndex(0)->AsMarker()->GetAltitude() == 2.0);
+    FSL_CHECK(layer.GetDataAtIndex(1)->AsMarker()->GetAltitude() == 4.0);
+    FSL_CHECK(layer.GetDataIndexAtQmid(qmids[1], 0) == 0 && layer.GetDataIndexAtQmid(qmids[1], 1) == 1);
+
+    // Records added after a compaction are numbered after the live ones
+    const auto marker = MakeMarker(5.0);
+    layer.AddDataAtQmids(&qmids[0], 1, marker.get());
+    FSL_CHECK(layer.GetDataIndexAtQmid(qmids[0], 0) == 2);
+    FSL_CHECK(SumListedAltitudes(layer, qmids) == 11.0);
+}
+
+FSL_TEST(RemovedRecordsAreNotWritten)
+{
+    auto qmids = std::vector<CPackedQmid>{};
+    for (auto i = 0; i < 4; ++i)
+    {
+        qmids.push_back(CPackedQmid::FromCell(9, 10 * i, 20));
+    }
+    const auto path = GetScratchPath("removed_markers.bgl");
+    FSL_CHECK(WriteMarkerFile(path, qmids));
+
+    const auto written_path = GetScratchPath("removed_markers_written.bgl");
+    {
+        auto file = CBglFile(path.wstring());
+        FSL_CHECK(file.Read());
+        auto* layer = file.GetIndirectQmidLayer(EBglLayerType::Marker);
+        FSL_CHECK(layer != nullptr);
+        if (layer == nullptr)
+        {
+            return;
+        }
+        layer->RemoveDataAtIndex(1);
+        file.Rename(written_path.wstring().c_str());
+        FSL_CHECK(file.Write());
+    }
+
+    auto file = CBglFile(written_path.wstring());
+    FSL_CHECK(file.Read());
+    auto* layer = dynamic_cast<CBglIndirectQmidLayer*>(file.GetIndirectQmidLayer(EBglLayerType::Marker));
+    FSL_CHECK(layer != nullptr);
+    if (layer == nullptr)
+    {
+        return;
+    }
+    FSL_CHECK(layer->GetDataCount() == 3);
+    FSL_CHECK(layer->GetQmidCount() == 3);
+    FSL_CHECK(!layer->HasQmid(qmids[1]));
+    // The altitude of each marker is its index in qmids, and the one at 1 was removed
+    FSL_CHECK(SumListedAltitudes(*layer, qmids) == 5.0);
+}
+
+} // namespace flightsimlib::tests
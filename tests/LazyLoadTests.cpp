@@ -0,0 +1,144 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     LazyLoadTests.cpp
+//
+// Summary:  Records decoded on demand by EBglReadFlags::IndexOnly reads, and
+//           what is left behind when one of them fails to decode
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Test.h"
+#include "TestData.h"
+
+#include "BglData.h"
+#include "BglFile.h"
+
+
+namespace flightsimlib::tests
+{
+
+using namespace flightsimlib::io;
+
+static constexpr int s_marker_count = 4;
+
+static auto WriteMarkers(const std::filesystem::path& path) -> bool
+{
+    auto qmids = std::vector<CPackedQmid>{};
+    for (auto i = 0; i < s_marker_count; ++i)
+    {
+        qmids.push_back(CPackedQmid::FromCell(9, 10 * i, 20));
+    }
+    return WriteMarkerFile(path, qmids);
+}
+
+FSL_TEST(IndexOnlyReadDecodesOnAccess)
+{
+    const auto path = GetScratchPath("lazy_markers.bgl");
+    FSL_CHECK(WriteMarkers(path));
+
+    for (const auto flags : {EBglReadFlags::IndexOnly, EBglReadFlags::IndexOnly | EBglReadFlags::MemoryMapped})
+    {
+        auto file = CBglFile(path.wstring());
+        file.SetReadFlags(flags);
+        FSL_CHECK(file.Read());
+
+        auto* layer = file.GetIndirectQmidLayer(EBglLayerType::Marker);
+        FSL_CHECK(layer != nullptr);
+        if (layer == nullptr)
+        {
+            continue;
+        }
+        FSL_CHECK(layer->GetDataCount() == s_marker_count);
+
+        auto altitudes = 0.0;
+        for (auto i = s_marker_count - 1; i >= 0; --i)
+        {
+            auto* data = layer->GetDataAtIndex(i);
+            FSL_CHECK(data != nullptr);
+            altitudes += data != nullptr ? data->AsMarker()->GetAltitude() : 0.0;
+        }
+        FSL_CHECK(altitudes == 6.0);
+    }
+}
+
+FSL_TEST(FailedLazyLoadStaysPending)
+{
+    const auto path = GetScratchPath("lazy_markers_bad.bgl");
+    FSL_CHECK(WriteMarkers(path));
+
+    FSL_CHECK(MisstateMarkerSize(path, s_marker_count - 1));
+
+    {
+        auto file = CBglFile(path.wstring());
+        FSL_CHECK(!file.Read());
+    }
+
+    for (const auto flags : {EBglReadFlags::IndexOnly, EBglReadFlags::IndexOnly | EBglReadFlags::MemoryMapped})
+    {
+        auto file = CBglFile(path.wstring());
+        file.SetReadFlags(flags);
+        FSL_CHECK(file.Read());
+
+        auto* layer = file.GetIndirectQmidLayer(EBglLayerType::Marker);
+        FSL_CHECK(layer != nullptr);
+        if (layer == nullptr)
+        {
+            continue;
+        }
+
+        // The failed record is visited first, so the others also show that the stream was
+        // put back where it was
+        auto failed_index = -1;
+        auto altitudes = 0.0;
+        for (auto i = s_marker_count - 1; i >= 0; --i)
+        {
+            auto* data = layer->GetDataAtIndex(i);
+            if (data == nullptr)
+            {
+                FSL_CHECK(failed_index == -1);
+                failed_index = i;
+                continue;
+            }
+            altitudes += data->AsMarker()->GetAltitude();
+        }
+        FSL_CHECK(failed_index != -1);
+        FSL_CHECK(altitudes == 3.0);
+
+        // Still pending, so a retry fails the same way rather than returning an empty record
+        FSL_CHECK(layer->GetDataAtIndex(failed_index) == nullptr);
+        FSL_CHECK(!dynamic_cast<CBglLayer*>(layer)->Materialize());
+    }
+}
+
+} // namespace flightsimlib::tests
@@ -0,0 +1,114 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     QmidTests.cpp
+//
+// Summary:  Batch QMID conversions against the single point ones they are
+//           vectorised from
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Test.h"
+
+#include "CpuFeatures.h"
+#include "Qmid.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+
+namespace flightsimlib::tests
+{
+
+using namespace flightsimlib::io;
+
+FSL_TEST(FromLatLonsMatchesFromLatLon)
+{
+    // Edges of the wrap and the clamps, values too large to wrap, and values that are not numbers
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    const auto infinity = std::numeric_limits<double>::infinity();
+    const auto longitudes = std::vector<double>{-180.0, 180.0, std::nextafter(360.0, 0.0) - 180.0, -180.000001,
+        540.0, -1.0e-20, 1234.5, -98765.4, 1.0e14, -1.0e15 - 180.0, 1.0e16, -1.0e16, infinity, -infinity, nan, 0.0};
+    const auto latitudes = std::vector<double>{90.0, -90.0, 89.99, -89.99, 0.0, 1.0e-20, 45.5, -45.5, 100.0, -100.0,
+        1.0e16, -1.0e16, nan, infinity, -infinity, 0.0};
+
+    // With the AVX2 kernel where the CPU has one, then with the portable loop
+    auto qmids = std::vector<uint64_t>(longitudes.size());
+    for (const auto avx2 : {true, false})
+    {
+        CCpuFeatures::SetAvx2Enabled(avx2);
+        for (auto level = 0; level <= CPackedQmid::s_max_level; ++level)
+        {
+            CPackedQmid::FromLatLons(latitudes.data(), longitudes.data(), static_cast<int>(longitudes.size()), level,
+                qmids.data());
+            for (auto i = 0; i < static_cast<int>(longitudes.size()); ++i)
+            {
+                FSL_CHECK(qmids[i] == CPackedQmid::FromLatLon(latitudes[i], longitudes[i], level).Value());
+            }
+        }
+    }
+    CCpuFeatures::SetAvx2Enabled(true);
+}
+
+FSL_TEST(ToCentersMatchesBounds)
+{
+    // The first and last cells of each level, one in the middle, and an empty cell
+    auto qmids = std::vector<uint64_t>{0};
+    for (auto level = 0; level <= CPackedQmid::s_max_level; ++level)
+    {
+        const auto columns = CPackedQmid::ColumnCount(level);
+        const auto rows = CPackedQmid::RowCount(level);
+        qmids.emplace_back(CPackedQmid::FromCell(level, 0, 0).Value());
+        qmids.emplace_back(CPackedQmid::FromCell(level, columns / 2, rows / 2).Value());
+        qmids.emplace_back(CPackedQmid::FromCell(level, columns - 1, rows - 1).Value());
+    }
+
+    auto latitudes = std::vector<double>(qmids.size());
+    auto longitudes = std::vector<double>(qmids.size());
+    for (const auto avx2 : {true, false})
+    {
+        CCpuFeatures::SetAvx2Enabled(avx2);
+        CPackedQmid::ToCenters(qmids.data(), static_cast<int>(qmids.size()), latitudes.data(), longitudes.data());
+        FSL_CHECK(std::isnan(latitudes[0]) && std::isnan(longitudes[0]));
+        for (auto i = 1; i < static_cast<int>(qmids.size()); ++i)
+        {
+            const auto bounds = CPackedQmid{qmids[i]}.Bounds();
+            FSL_CHECK(std::abs(latitudes[i] - (bounds.MinLatitude + bounds.MaxLatitude) / 2.0) < 1.0e-9);
+            FSL_CHECK(std::abs(longitudes[i] - (bounds.MinLongitude + bounds.MaxLongitude) / 2.0) < 1.0e-9);
+        }
+    }
+    CCpuFeatures::SetAvx2Enabled(true);
+}
+
+} // namespace flightsimlib::tests
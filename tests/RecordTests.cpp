@@ -0,0 +1,111 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     RecordTests.cpp
+//
+// Summary:  Accessors that records share through mixins such as CBglLLA
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Test.h"
+
+#include "BglData.h"
+
+#include <vector>
+
+
+namespace flightsimlib::tests
+{
+
+using namespace flightsimlib::io;
+
+FSL_TEST(CopiedRecordsReadTheirOwnPosition)
+{
+    auto airport = CBglAirport{};
+    airport.SetAltitude(100.0);
+    airport.Set100Octane(IBglFuelAvailability::EFuelAvailability::Yes);
+
+    auto copy = airport;
+    copy.SetAltitude(200.0);
+    FSL_CHECK(airport.GetAltitude() == 100.0);
+    FSL_CHECK(copy.GetAltitude() == 200.0);
+    FSL_CHECK(copy.HasAvgas());
+
+    // Moved as the vector grows, so each must still reach its own data afterwards
+    auto starts = std::vector<CBglStart>{};
+    for (auto i = 0; i < 16; ++i)
+    {
+        starts.emplace_back();
+        starts.back().SetAltitude(static_cast<double>(i));
+    }
+    auto altitudes = 0.0;
+    for (const auto& start : starts)
+    {
+        altitudes += start.GetAltitude();
+    }
+    FSL_CHECK(altitudes == 120.0);
+
+    auto moved = std::move(copy);
+    moved.Set100Octane(IBglFuelAvailability::EFuelAvailability::No);
+    FSL_CHECK(!moved.HasAvgas());
+    FSL_CHECK(moved.GetAltitude() == 200.0);
+}
+
+FSL_TEST(FuelFlagsFollowTheGrades)
+{
+    using EFuelAvailability = IBglFuelAvailability::EFuelAvailability;
+
+    auto airport = CBglAirport{};
+    airport.SetJetA(EFuelAvailability::Yes);
+    FSL_CHECK(airport.HasJetFuel());
+    airport.SetJetA(EFuelAvailability::No);
+    FSL_CHECK(!airport.HasJetFuel());
+
+    // A flag stays while another grade of its kind is still available
+    airport.Set100Octane(EFuelAvailability::Yes);
+    airport.SetMogas(EFuelAvailability::Yes);
+    airport.Set100Octane(EFuelAvailability::No);
+    FSL_CHECK(airport.HasAvgas());
+    airport.SetMogas(EFuelAvailability::No);
+    FSL_CHECK(!airport.HasAvgas());
+
+    auto summary = CBglAirportSummary{};
+    summary.SetJet5(EFuelAvailability::Yes);
+    summary.SetJetB(EFuelAvailability::Yes);
+    summary.SetJet5(EFuelAvailability::No);
+    FSL_CHECK(summary.HasJetFuel());
+    summary.SetJetB(EFuelAvailability::No);
+    FSL_CHECK(!summary.HasJetFuel());
+}
+
+} // namespace flightsimlib::tests
@@ -0,0 +1,65 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+#ifndef FLIGHTSIMLIB_TESTS_TEST_H
+#define FLIGHTSIMLIB_TESTS_TEST_H
+
+#include <filesystem>
+#include <string>
+
+// A test is a function registered under its name at static initialization, and run by TestMain.cpp.
+// A failed check reports its expression and location, and the test carries on
+#define FSL_TEST(name)                                                                                                 \
+    static void name();                                                                                                \
+    static const bool name##_registered = ::flightsimlib::tests::RegisterTest(#name, name);                            \
+    static void name()
+
+#define FSL_CHECK(expression)                                                                                          \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(expression))                                                                                             \
+        {                                                                                                              \
+            ::flightsimlib::tests::ReportFailure(__FILE__, __LINE__, #expression);                                     \
+        }                                                                                                              \
+    } while (false)
+
+namespace flightsimlib::tests
+{
+
+    using TestFunction = void (*)();
+
+    auto RegisterTest(const char* name, TestFunction function) -> bool;
+    auto ReportFailure(const char* file, int line, const char* expression) -> void;
+
+    // A path for a file the test writes, in a scratch directory emptied before the tests run
+    auto GetScratchPath(const std::string& name) -> std::filesystem::path;
+    // A file of the repository, such as the sample BGL of the examples
+    auto GetRepositoryPath(const std::string& relative_path) -> std::filesystem::path;
+
+} // namespace flightsimlib::tests
+
+#endif
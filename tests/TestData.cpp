@@ -0,0 +1,121 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     TestData.cpp
+//
+// Summary:  Small BGL files generated for the tests, and helpers to inspect
+//           and corrupt them
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "TestData.h"
+
+#include "BglData.h"
+#include "BglFile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+
+namespace flightsimlib::tests
+{
+
+using namespace flightsimlib::io;
+
+auto WriteMarkerFile(const std::filesystem::path& path, const std::vector<CPackedQmid>& qmids) -> bool
+{
+    auto layer = CBglIndirectQmidLayer(SBglLayerPointer{EBglLayerType::Marker, 0, 0, 0, 0, 0}, EBglLayerType::Marker);
+    auto records = BglQmidRecords{};
+    for (auto i = 0; i < static_cast<int>(qmids.size()); ++i)
+    {
+        auto data = CBglData::Factory(EBglLayerType::Marker, IBglSceneryObject::ESceneryObjectType::Unknown);
+        data->AsMarker()->SetAltitude(static_cast<double>(i));
+        records.emplace_back(qmids[i], std::move(data));
+    }
+    layer.AddDataAtQmids(std::move(records));
+
+    auto file = CBglFile{};
+    if (!file.TryMergeLayer(&layer))
+    {
+        return false;
+    }
+    file.Rename(path.wstring().c_str());
+    return file.Write();
+}
+
+auto GetMarkerOffset(int index) -> int
+{
+    return static_cast<int>(sizeof(SBglHeader) + sizeof(SBglLayerPointer)) + index * s_marker_size;
+}
+
+auto MisstateMarkerSize(const std::filesystem::path& path, int index) -> bool
+{
+    auto bytes = ReadFileBytes(path);
+    const auto entry = FindValues(bytes, {static_cast<uint32_t>(GetMarkerOffset(index)), s_marker_size});
+    if (entry < 0)
+    {
+        return false;
+    }
+    bytes[entry + sizeof(uint32_t)] = static_cast<uint8_t>(s_marker_size + 1);
+    return WriteFileBytes(path, bytes);
+}
+
+auto ReadFileBytes(const std::filesystem::path& path) -> std::vector<uint8_t>
+{
+    auto file = std::ifstream(path, std::ios::binary);
+    return std::vector<uint8_t>{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+auto WriteFileBytes(const std::filesystem::path& path, const std::vector<uint8_t>& bytes) -> bool
+{
+    auto file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(file);
+}
+
+auto FindValues(const std::vector<uint8_t>& bytes, const std::vector<uint32_t>& values) -> int
+{
+    auto pattern = std::vector<uint8_t>{};
+    for (const auto value : values)
+    {
+        for (auto shift = 0; shift < 32; shift += 8)
+        {
+            pattern.push_back(static_cast<uint8_t>(value >> shift));
+        }
+    }
+    const auto it = std::search(bytes.begin(), bytes.end(), pattern.begin(), pattern.end());
+    return it != bytes.end() ? static_cast<int>(it - bytes.begin()) : -1;
+}
+
+} // namespace flightsimlib::tests
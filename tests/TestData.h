@@ -0,0 +1,78 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+
+//******************************************************************************
+//
+// File:     TestData.h
+//
+// Summary:  Small BGL files generated for the tests, and helpers to inspect
+//           and corrupt them
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#ifndef FLIGHTSIMLIB_TESTS_TEST_DATA_H
+#define FLIGHTSIMLIB_TESTS_TEST_DATA_H
+
+#include "Qmid.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace flightsimlib::tests
+{
+
+    // Size of a marker record, which is fixed
+    static constexpr int s_marker_size = 28;
+
+    // Writes a file with one indirect marker layer and a marker at each QMID. The altitude of a
+    // marker is its index in qmids, so tests can tell the records apart after a read
+    auto WriteMarkerFile(const std::filesystem::path& path, const std::vector<io::CPackedQmid>& qmids) -> bool;
+
+    // The stream offset of the record at an index of qmids in a file written by WriteMarkerFile.
+    // Records follow the file header and the single layer pointer in the order they were added
+    auto GetMarkerOffset(int index) -> int;
+
+    // Records the marker at an index of qmids in the table of a file written by WriteMarkerFile
+    // as one byte longer than it decodes to, so decoding it fails
+    auto MisstateMarkerSize(const std::filesystem::path& path, int index) -> bool;
+
+    auto ReadFileBytes(const std::filesystem::path& path) -> std::vector<uint8_t>;
+
+    auto WriteFileBytes(const std::filesystem::path& path, const std::vector<uint8_t>& bytes) -> bool;
+
+    // Offset of the first occurrence of the little-endian values in bytes, or -1
+    auto FindValues(const std::vector<uint8_t>& bytes, const std::vector<uint32_t>& values) -> int;
+
+} // namespace flightsimlib::tests
+
+#endif
@@ -0,0 +1,138 @@
+//******************************************************************************
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 Sean Isom
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//******************************************************************************
+
+
+
+//******************************************************************************
+//
+// File:     TestMain.cpp
+//
+// Summary:  Runs every registered test and reports the checks that failed.
+//           Usage: tests [repository root], which defaults to the nearest
+//           directory above the working directory that holds flightsimlib.sln
+//
+// Author:   Sean Isom
+//
+//******************************************************************************
+
+
+#include "Test.h"
+
+#include <iostream>
+#include <system_error>
+#include <vector>
+
+
+namespace flightsimlib::tests
+{
+
+struct STestCase
+{
+    const char* Name;
+    TestFunction Function;
+};
+
+static auto GetTestCases() -> std::vector<STestCase>&
+{
+    static auto test_cases = std::vector<STestCase>{};
+    return test_cases;
+}
+
+static auto s_failure_count = 0;
+static auto s_repository_root = std::filesystem::path{};
+static auto s_scratch_directory = std::filesystem::path{};
+
+auto RegisterTest(const char* name, TestFunction function) -> bool
+{
+    GetTestCases().push_back({name, function});
+    return true;
+}
+
+auto ReportFailure(const char* file, int line, const char* expression) -> void
+{
+    std::cout << "    " << file << "(" << line << "): check failed: " << expression << "\n";
+    ++s_failure_count;
+}
+
+auto GetScratchPath(const std::string& name) -> std::filesystem::path { return s_scratch_directory / name; }
+
+auto GetRepositoryPath(const std::string& relative_path) -> std::filesystem::path
+{
+    return s_repository_root / relative_path;
+}
+
+static auto FindRepositoryRoot() -> std::filesystem::path
+{
+    std::error_code error;
+    for (auto directory = std::filesystem::current_path(error); !directory.empty();
+         directory = directory.parent_path())
+    {
+        if (std::filesystem::exists(directory / "flightsimlib.sln", error))
+        {
+            return directory;
+        }
+        if (directory == directory.parent_path())
+        {
+            break;
+        }
+    }
+    return {};
+}
+
+} // namespace flightsimlib::tests
+
+
+int main(int argc, char* argv[])
+{
+    using namespace flightsimlib::tests;
+
+    s_repository_root = argc > 1 ? std::filesystem::path{argv[1]} : FindRepositoryRoot();
+    if (s_repository_root.empty())
+    {
+        std::cout << "repository root not found, pass it as the first argument\n";
+        return 1;
+    }
+
+    s_scratch_directory = std::filesystem::temp_directory_path() / "flightsimlib_tests";
+    std::error_code error;
+    std::filesystem::remove_all(s_scratch_directory, error);
+    std::filesystem::create_directories(s_scratch_directory, error);
+
+    auto failed_tests = 0;
+    for (const auto& test_case : GetTestCases())
+    {
+        const auto failures_before = s_failure_count;
+        std::cout << test_case.Name << "\n";
+        test_case.Function();
+        if (s_failure_count != failures_before)
+        {
+            ++failed_tests;
+        }
+    }
+
+    std::cout << GetTestCases().size() - failed_tests << " of " << GetTestCases().size() << " tests passed\n";
+    return failed_tests == 0 ? 0 : 1;
+}